@@ -15,12 +15,15 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
-// This benchmark measures the performance of building a BoundingBoxTree (and
-// one call to compute_entities, which is dominated by building).
+// This benchmark measures the performance of building a BoundingBoxTree
+// with the median and surface area heuristic (SAH) builders, on a
+// uniform mesh and on a mesh graded towards one corner. Run with
+// --num_threads to build subtrees in parallel.
 //
 // First added:  2013-04-18
-// Last changed: 2013-06-25
+// Last changed: 2019-06-18
 
+#include <cmath>
 #include <vector>
 #include <dolfin.h>
 
@@ -30,17 +33,36 @@ using namespace dolfin;
 
 int main(int argc, char* argv[])
 {
+  parameters.parse(argc, argv);
+
   info("Build bounding box tree on UnitCubeMesh(%d, %d, %d)",
        SIZE, SIZE, SIZE);
 
   // Create mesh
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
 
-  // Create and build tree
-  tic();
+  // Create and build tree with each builder
   BoundingBoxTree tree;
-  tree.build(mesh);
-  info("BENCH %g", toc());
+  tic();
+  tree.build(mesh, 3, "median");
+  info("BENCH median %g", toc());
+
+  tic();
+  tree.build(mesh, 3, "sah");
+  info("BENCH sah %g", toc());
+
+  // Grade mesh towards the origin
+  std::vector<double>& x = mesh.geometry().x();
+  for (std::size_t i = 0; i < x.size(); i++)
+    x[i] = std::pow(x[i], 4);
+
+  tic();
+  tree.build(mesh, 3, "median");
+  info("BENCH median_graded %g", toc());
+
+  tic();
+  tree.build(mesh, 3, "sah");
+  info("BENCH sah_graded %g", toc());
 
   return 0;
 }
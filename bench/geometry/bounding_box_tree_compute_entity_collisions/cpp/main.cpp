@@ -15,11 +15,16 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
-// This benchmark measures the performance of compute_entity_collisions.
+// This benchmark measures the performance of compute_entity_collisions
+// for trees built with the median and surface area heuristic (SAH)
+// builders, on a uniform mesh and on a mesh graded towards one
+// corner. Compare with bounding_box_tree_build for the build times.
 //
 // First added:  2013-05-23
-// Last changed: 2013-09-04
+// Last changed: 2019-06-18
 
+#include <cmath>
+#include <string>
 #include <vector>
 #include <dolfin.h>
 
@@ -28,17 +33,12 @@ using namespace dolfin;
 #define NUM_REPS 5000000
 #define SIZE 64
 
-int main(int argc, char* argv[])
+// Compute collisions repeatedly for points along the diagonal
+double bench(const Mesh& mesh, std::string builder, bool graded)
 {
-  info("Compute entity collisions on UnitCubeMesh(%d, %d, %d)",
-       SIZE, SIZE, SIZE);
-
-  // Create mesh
-  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
-
   // First call
   BoundingBoxTree tree;
-  tree.build(mesh);
+  tree.build(mesh, mesh.topology().dim(), builder);
   Point point(0.0, 0.0, 0.0);
   tree.compute_entity_collisions(point);
 
@@ -46,15 +46,33 @@ int main(int argc, char* argv[])
   tic();
   for (int i = 0; i < NUM_REPS; i++)
   {
-    point.coordinates()[0] += 1.0 / static_cast<double>(NUM_REPS);
-    point.coordinates()[1] += 1.0 / static_cast<double>(NUM_REPS);
-    point.coordinates()[2] += 1.0 / static_cast<double>(NUM_REPS);
+    const double s = static_cast<double>(i + 1) / static_cast<double>(NUM_REPS);
+    const double t = graded ? std::pow(s, 4) : s;
+    point = Point(t, t, t);
     std::vector<unsigned int> entities = tree.compute_entity_collisions(point);
   }
-  const double t = toc();
+  return toc();
+}
+
+int main(int argc, char* argv[])
+{
+  info("Compute entity collisions on UnitCubeMesh(%d, %d, %d)",
+       SIZE, SIZE, SIZE);
+
+  // Create mesh
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
 
   // Report result
-  info("BENCH %g", t);
+  info("BENCH median %g", bench(mesh, "median", false));
+  info("BENCH sah %g", bench(mesh, "sah", false));
+
+  // Grade mesh towards the origin (and the points with it)
+  std::vector<double>& x = mesh.geometry().x();
+  for (std::size_t i = 0; i < x.size(); i++)
+    x[i] = std::pow(x[i], 4);
+
+  info("BENCH median_graded %g", bench(mesh, "median", true));
+  info("BENCH sah_graded %g", bench(mesh, "sah", true));
 
   return 0;
 }
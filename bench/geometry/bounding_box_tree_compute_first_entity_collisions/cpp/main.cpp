@@ -0,0 +1,69 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark compares locating a set of random points one at a
+// time with compute_first_entity_collision and as a batch with
+// compute_first_entity_collisions. Run with --num_threads to run the
+// batched queries in parallel.
+
+#include <random>
+#include <vector>
+#include <dolfin.h>
+
+using namespace dolfin;
+
+#define NUM_POINTS 2000000
+#define SIZE 64
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  info("Locate %d points in UnitCubeMesh(%d, %d, %d)",
+       NUM_POINTS, SIZE, SIZE, SIZE);
+
+  // Create mesh and tree
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+  BoundingBoxTree tree;
+  tree.build(mesh);
+
+  // Create random points
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  std::vector<Point> points(NUM_POINTS);
+  for (auto& p : points)
+    p = Point(distribution(generator), distribution(generator),
+              distribution(generator));
+
+  // Locate points one at a time
+  std::vector<unsigned int> cells(NUM_POINTS);
+  tic();
+  for (std::size_t i = 0; i < points.size(); i++)
+    cells[i] = tree.compute_first_entity_collision(points[i]);
+  info("BENCH single %g", toc());
+
+  // Locate points as a batch
+  tic();
+  std::vector<unsigned int> cells_batch
+    = tree.compute_first_entity_collisions(points);
+  info("BENCH batch %g", toc());
+
+  if (cells_batch != cells)
+    error("Batched point location does not match");
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Effect of mesh ordering on the memory locality of a vertex-based
+// cell assembly loop and of a sparse matrix-vector product with the
+// vertex adjacency matrix. A randomly ordered mesh stands in for a
+// poorly ordered (e.g. CAD-derived) mesh.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <dolfin.h>
+#include <dolfin/mesh/MeshRenumbering.h>
+
+using namespace dolfin;
+
+#define NUM_REPS 10
+#define SIZE 48
+
+// Use for quick testing
+//#define NUM_REPS 2
+//#define SIZE 16
+
+// Assemble cell volumes to vertices (lumped mass vector)
+double assemble(const Mesh& mesh, std::vector<double>& b)
+{
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::vector<double>& x = mesh.geometry().x();
+  const MeshConnectivity& cell_vertices = mesh.topology()(3, 0);
+  std::fill(b.begin(), b.end(), 0.0);
+
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    {
+      const unsigned int* v = cell_vertices(c);
+      double J[3][3];
+      for (std::size_t j = 0; j < 3; ++j)
+        for (std::size_t k = 0; k < gdim; ++k)
+          J[j][k] = x[v[j + 1]*gdim + k] - x[v[0]*gdim + k];
+      const double det
+        = J[0][0]*(J[1][1]*J[2][2] - J[1][2]*J[2][1])
+        - J[0][1]*(J[1][0]*J[2][2] - J[1][2]*J[2][0])
+        + J[0][2]*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
+      for (std::size_t j = 0; j < 4; ++j)
+        b[v[j]] += std::abs(det)/24.0;
+    }
+  }
+  return toc();
+}
+
+// Multiply with vertex adjacency (graph Laplacian) matrix
+double spmv(const Mesh& mesh, std::size_t& bandwidth)
+{
+  const std::size_t n = mesh.num_vertices();
+  std::vector<Eigen::Triplet<double>> entries;
+  bandwidth = 0;
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const unsigned int* v = c->entities(0);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      for (std::size_t j = 0; j < 4; ++j)
+      {
+        entries.push_back(Eigen::Triplet<double>(v[i], v[j],
+                                                 i == j ? 3.0 : -1.0));
+        bandwidth = std::max(bandwidth, (std::size_t) std::abs((int) v[i] - (int) v[j]));
+      }
+    }
+  }
+  EigenMatrix A(n, n);
+  A.mat().setFromTriplets(entries.begin(), entries.end());
+
+  Eigen::VectorXd x = Eigen::VectorXd::Ones(n), y(n);
+  tic();
+  for (int i = 0; i < 10*NUM_REPS; i++)
+  {
+    y.noalias() = A.mat()*x;
+    x.swap(y);
+    x /= x.norm();
+  }
+  return toc();
+}
+
+// Mean spread of vertex indices within cells
+double spread(const Mesh& mesh)
+{
+  const std::vector<unsigned int>& v = mesh.topology()(3, 0)();
+  double s = 0.0;
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    const auto minmax = std::minmax_element(v.begin() + 4*c,
+                                            v.begin() + 4*c + 4);
+    s += *minmax.second - *minmax.first;
+  }
+  return s/mesh.num_cells();
+}
+
+int main(int argc, char* argv[])
+{
+  info("Assembly and SpMV for orderings of unit cube of size %d x %d x %d (%d repetitions)",
+       SIZE, SIZE, SIZE, NUM_REPS);
+  parameters.parse(argc, argv);
+
+  UnitCubeMesh mesh(MPI_COMM_SELF, SIZE, SIZE, SIZE);
+
+  // Random ordering of cells and vertices
+  std::mt19937 generator(1);
+  std::vector<std::size_t> cell_order(mesh.num_cells());
+  std::vector<std::size_t> vertex_order(mesh.num_vertices());
+  std::iota(cell_order.begin(), cell_order.end(), 0);
+  std::iota(vertex_order.begin(), vertex_order.end(), 0);
+  std::shuffle(cell_order.begin(), cell_order.end(), generator);
+  std::shuffle(vertex_order.begin(), vertex_order.end(), generator);
+  const Mesh random = MeshRenumbering::renumber(mesh, cell_order,
+                                                vertex_order);
+
+  const std::vector<std::pair<std::string, Mesh>> meshes
+    = {{"original", mesh}, {"random", random},
+       {"hilbert", MeshRenumbering::renumber_by_space_filling_curve(random, "hilbert")},
+       {"morton", MeshRenumbering::renumber_by_space_filling_curve(random, "morton")}};
+
+  std::vector<double> b(mesh.num_vertices());
+  for (const auto& m : meshes)
+  {
+    std::size_t bandwidth = 0;
+    const double t_assemble = assemble(m.second, b);
+    const double t_spmv = spmv(m.second, bandwidth);
+    info("%-8s spread %10.1f  bandwidth %8d", m.first.c_str(),
+         spread(m.second), (int) bandwidth);
+    info("BENCH %s assemble %g", m.first.c_str(), t_assemble);
+    info("BENCH %s spmv %g", m.first.c_str(), t_spmv);
+  }
+
+  // To prevent optimizing the loops away
+  info("Sum is %g", std::accumulate(b.begin(), b.end(), 0.0));
+
+  return 0;
+}
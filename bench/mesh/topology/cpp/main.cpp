@@ -15,9 +15,26 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
+// This benchmark measures the computation of cell-cell connectivity,
+// and of edges, faces and face-edge connectivity. The latter are
+// computed both with the previous serial implementation (std::sort
+// of entity tuples and boost::unordered_map lookup), which is kept
+// below as a reference, and with the radix sort of
+// TopologyComputation on one thread and on the number of threads
+// given by --num_threads, all on the same mesh.
+//
 // First added:  2010-11-25
-// Last changed: 2012-12-12
+// Last changed: 2019-06-20
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <boost/multi_array.hpp>
+#include <boost/unordered_map.hpp>
 #include <dolfin.h>
 #include <dolfin/log/LogLevel.h>
 
@@ -30,36 +47,218 @@ using namespace dolfin;
 //#define NUM_REPS 2
 //#define SIZE 32
 
+// Use for 10^8 cells (needs several tens of GB of memory)
+//#define NUM_REPS 1
+//#define SIZE 256
+
+// Previous implementation of TopologyComputation::compute_entities
+// (sorting of entity tuples), returning the entity - vertex and cell
+// - entity connectivity instead of storing it in the mesh
+template<int N>
+std::size_t reference_entities(const Mesh& mesh, std::size_t dim,
+                               std::vector<std::array<std::int32_t, N>>& ev,
+                               std::vector<std::int32_t>& ce)
+{
+  const CellType& cell_type = mesh.type();
+  const std::int8_t num_entities = cell_type.num_entities(dim);
+  const int num_vertices = cell_type.num_vertices(dim);
+
+  // Create map from cell vertices to entity vertices
+  boost::multi_array<unsigned int, 2>
+    e_vertices(boost::extents[num_entities][num_vertices]);
+  std::vector<unsigned int> v(cell_type.num_vertices());
+  std::iota(v.begin(), v.end(), 0);
+  cell_type.create_entities(e_vertices, dim, v.data());
+
+  // ([vertices key], (cell_local_index, cell index), [entity vertices], entity index)
+  std::vector<std::tuple<std::array<std::int32_t, N>,
+                         std::pair<std::int8_t, std::int32_t>,
+                         std::array<std::int32_t, N>, std::int32_t>>
+    keyed_entities(num_entities*mesh.num_cells());
+
+  // Build list of keyed (by vertices) entities, with negative local
+  // index for non-ghost cells
+  int entity_counter = 0;
+  for (CellIterator c(mesh, "all"); !c.end(); ++c)
+  {
+    const unsigned int* vertices = c->entities(0);
+    for (std::int8_t i = 0; i < num_entities; ++i)
+    {
+      auto& entity = std::get<2>(keyed_entities[entity_counter]);
+      for (std::int8_t j = 0; j < num_vertices; ++j)
+        entity[j] = vertices[e_vertices[i][j]];
+      auto& entity_key = std::get<0>(keyed_entities[entity_counter]);
+      std::partial_sort_copy(entity.begin(), entity.end(),
+                             entity_key.begin(), entity_key.end());
+      if (!c->is_ghost())
+        std::get<1>(keyed_entities[entity_counter]) = {-i - 1, c->index()};
+      else
+        std::get<1>(keyed_entities[entity_counter]) = {i, c->index()};
+      ++entity_counter;
+    }
+  }
+
+  // Sort entities by key
+  std::sort(keyed_entities.begin(), keyed_entities.end());
+
+  // Compute entity indices (negative for ghost entities)
+  std::int32_t nonghost_index(0), ghost_index(-1);
+  std::array<std::int32_t, N> previous_key;
+  std::fill(previous_key.begin(), previous_key.end(), -1);
+  for (auto e = keyed_entities.begin(); e != keyed_entities.end(); ++e)
+  {
+    const auto& key = std::get<0>(*e);
+    if (key == previous_key)
+      std::get<3>(*e) = std::get<3>(*(e - 1));
+    else
+    {
+      if (std::get<1>(*e).first < 0)
+        std::get<3>(*e) = nonghost_index++;
+      else
+        std::get<3>(*e) = ghost_index--;
+      previous_key = key;
+    }
+    auto& local_index = std::get<1>(*e).first;
+    local_index = (local_index < 0) ? (-local_index - 1) : local_index;
+  }
+
+  // Build connectivity arrays (with ghost entities at the end)
+  const std::int32_t num_mesh_entities = nonghost_index - (ghost_index + 1);
+  ev.resize(num_mesh_entities);
+  ce.resize(num_entities*mesh.num_cells());
+  for (auto& entity : keyed_entities)
+  {
+    auto& e_index = std::get<3>(entity);
+    if (e_index < 0)
+      e_index = nonghost_index - (e_index + 1);
+    ev[e_index] = std::get<2>(entity);
+    const auto& cell = std::get<1>(entity);
+    ce[cell.second*num_entities + cell.first] = e_index;
+  }
+
+  return ev.size();
+}
+
+// Previous implementation of TopologyComputation::compute_from_map
+// (boost::unordered_map from sorted entity vertices to entity index)
+void reference_connectivity(const Mesh& mesh, std::size_t d0, std::size_t d1,
+                            std::vector<unsigned int>& connectivity)
+{
+  std::unique_ptr<CellType>
+    cell_type(CellType::create(mesh.type().entity_type(d0)));
+  connectivity.clear();
+  connectivity.reserve(mesh.num_entities(d0)*cell_type->num_entities(d1));
+
+  // Make a map from the sorted d1 entity vertices to the d1 entity index
+  boost::unordered_map<std::vector<unsigned int>, unsigned int>
+    entity_to_index;
+  entity_to_index.reserve(mesh.num_entities(d1));
+  const std::size_t num_verts_d1 = mesh.type().num_vertices(d1);
+  std::vector<unsigned int> key(num_verts_d1);
+  for (MeshEntityIterator e(mesh, d1, "all"); !e.end(); ++e)
+  {
+    std::partial_sort_copy(e->entities(0), e->entities(0) + num_verts_d1,
+                           key.begin(), key.end());
+    entity_to_index.insert({key, e->index()});
+  }
+
+  // Search for d1 entities of d0 in map, and recover index
+  boost::multi_array<unsigned int, 2> keys;
+  for (MeshEntityIterator e(mesh, d0, "all"); !e.end(); ++e)
+  {
+    cell_type->create_entities(keys, d1, e->entities(0));
+    for (const auto &p : keys)
+    {
+      std::partial_sort_copy(p.begin(), p.end(), key.begin(), key.end());
+      connectivity.push_back(entity_to_index.find(key)->second);
+    }
+  }
+}
+
+// Remove edges and faces, whose numbers are kept by Mesh::clean, so
+// that they are recomputed
+void clear_entities(Mesh& mesh)
+{
+  mesh.clean();
+  for (std::size_t d = 1; d < mesh.topology().dim(); d++)
+    mesh.topology().init(d, 0, 0);
+}
+
 int main(int argc, char* argv[])
 {
-  info("Creating cell-cell connectivity for unit cube of size %d x %d x %d (%d repetitions)",
+  info("Computing cell-cell connectivity, and edges, faces and face-edge connectivity for unit cube of size %d x %d x %d (%d repetitions)",
        SIZE, SIZE, SIZE, NUM_REPS);
 
-  set_log_level(DBG);
-
+  // Number of threads for the radix sort is set with --num_threads
   parameters.parse(argc, argv);
+  const int num_threads = parameters["num_threads"];
 
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
   const int D = mesh.topology().dim();
+  info("Number of cells: %d, number of threads: %d", mesh.num_cells(),
+       num_threads);
 
-  // Clear timing (if there is some)
-  { Timer t("Compute connectivity 3-3"); }
-  timing("Compute connectivity 3-3", TimingClear::clear);
-
+  // Cell-cell connectivity, on one thread as in previous runs of
+  // this benchmark
+  parameters["num_threads"] = 1;
+  tic();
   for (int i = 0; i < NUM_REPS; i++)
   {
     mesh.clean();
     mesh.init(D, D);
-    dolfin::cout << "Created unit cube: " << mesh << dolfin::endl;
   }
+  const double t_cell_cell = toc();
+  info("BENCH cell-cell %g", t_cell_cell);
 
-  // Report timings
-  list_timings(TimingClear::keep,
-               { TimingType::wall, TimingType::user, TimingType::system });
+  // Edges, faces and face-edge connectivity with the previous
+  // implementation, which needs the entities of the mesh for the
+  // face-edge connectivity
+  clear_entities(mesh);
+  mesh.init(1);
+  mesh.init(2);
+  std::vector<std::array<std::int32_t, 2>> edge_vertices;
+  std::vector<std::array<std::int32_t, 3>> face_vertices;
+  std::vector<std::int32_t> cell_edges, cell_faces;
+  std::vector<unsigned int> face_edges;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    reference_entities<2>(mesh, 1, edge_vertices, cell_edges);
+    reference_entities<3>(mesh, 2, face_vertices, cell_faces);
+    reference_connectivity(mesh, 2, 1, face_edges);
+  }
+  const double t_reference = toc();
+  info("BENCH reference %g", t_reference);
+  if (edge_vertices.size() != mesh.num_edges()
+      or face_vertices.size() != mesh.num_faces())
+  {
+    dolfin_error("main.cpp",
+                 "compare mesh entities",
+                 "Numbers of entities differ from reference implementation");
+  }
 
-  // Report timing
-  const auto t = timing("Compute connectivity 3-3", TimingClear::clear);
-  info("BENCH %g", std::get<1>(t));
+  // Edges, faces and face-edge connectivity with radix sort on one
+  // thread and on the given number of threads
+  std::vector<int> thread_counts = {1};
+  if (num_threads > 1)
+    thread_counts.push_back(num_threads);
+  double total = t_cell_cell + t_reference;
+  for (int threads : thread_counts)
+  {
+    parameters["num_threads"] = threads;
+    tic();
+    for (int i = 0; i < NUM_REPS; i++)
+    {
+      clear_entities(mesh);
+      mesh.init(1);
+      mesh.init(2);
+      mesh.init(2, 1);
+    }
+    const double t_radix = toc();
+    info("BENCH radix-%d %g", threads, t_radix);
+    total += t_radix;
+  }
+  info("BENCH %g", total);
 
   return 0;
 }
@@ -0,0 +1,139 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Compare mesh entity iterators with connectivity and coordinate
+// views for typical hot loops: cell-vertex traversal, gathering of
+// cell coordinates and facet-cell adjacency queries. Also time the
+// algorithms which have been migrated to views (bounding box tree
+// and boundary mesh construction).
+
+#include <dolfin.h>
+
+using namespace dolfin;
+
+#define NUM_REPS 10
+#define SIZE 64
+
+// Use for quick testing
+//#define NUM_REPS 2
+//#define SIZE 16
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  info("Iterators vs views on unit cube of size %d x %d x %d (%d repetitions)",
+       SIZE, SIZE, SIZE, NUM_REPS);
+
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+  const std::size_t D = mesh.topology().dim();
+  mesh.init(D - 1, D);
+
+  // Cell-vertex traversal
+  std::size_t sum = 0;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+    for (CellIterator c(mesh); !c.end(); ++c)
+      for (VertexIterator v(*c); !v.end(); ++v)
+        sum += v->index();
+  info("BENCH cell-vertex iterators  %g", toc());
+
+  tic();
+  const ConnectivityView cell_vertices(mesh, D, 0);
+  for (int i = 0; i < NUM_REPS; i++)
+    for (auto vertices : cell_vertices)
+      for (auto v : vertices)
+        sum += v;
+  info("BENCH cell-vertex view       %g", toc());
+
+  // Cell coordinates
+  std::vector<double> x;
+  double xsum = 0.0;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (CellIterator c(mesh); !c.end(); ++c)
+    {
+      c->get_coordinate_dofs(x);
+      xsum += x[0];
+    }
+  }
+  info("BENCH cell coordinates iterators  %g", toc());
+
+  tic();
+  const EntityCoordinatesView cells(mesh, D);
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (std::size_t c = 0; c < cells.size(); ++c)
+    {
+      cells.get(c, x);
+      xsum += x[0];
+    }
+  }
+  info("BENCH cell coordinates view       %g", toc());
+
+  // Facet-cell adjacency
+  std::size_t num_exterior = 0;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+    for (FacetIterator f(mesh); !f.end(); ++f)
+      num_exterior += f->exterior();
+  info("BENCH exterior facets iterators  %g", toc());
+
+  tic();
+  const ConnectivityView facet_cells(mesh, D - 1, D);
+  for (int i = 0; i < NUM_REPS; i++)
+    for (std::size_t f = 0; f < facet_cells.size(); ++f)
+      num_exterior += (facet_cells.size_global(f) == 1);
+  info("BENCH exterior facets view       %g", toc());
+
+  // Algorithms using views
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    BoundingBoxTree tree;
+    tree.build(mesh);
+  }
+  info("BENCH bounding box tree  %g", toc());
+
+  mesh.geometry().init_single_precision();
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    BoundingBoxTree tree;
+    tree.build(mesh);
+  }
+  info("BENCH bounding box tree (single precision geometry)  %g", toc());
+  mesh.geometry().init_single_precision(false);
+
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+    BoundaryMesh boundary(mesh, "exterior");
+  info("BENCH boundary mesh      %g", toc());
+
+  BoundaryMesh boundary(mesh, "exterior");
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+    boundary.update_coordinates(mesh);
+  info("BENCH boundary mesh update coordinates  %g", toc());
+
+  // To prevent optimizing the loops away
+  info("Sums are %llu %g %llu", (unsigned long long) sum, xsum,
+       (unsigned long long) num_exterior);
+
+  return 0;
+}
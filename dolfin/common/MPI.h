@@ -155,6 +155,21 @@ namespace dolfin
                              std::vector<std::vector<T>>& in_values,
                              std::vector<T>& out_values);
 
+    /// Send packed values to and receive packed values from the
+    /// neighbours of a distributed graph communicator (wrapper for
+    /// MPI_Neighbor_alltoallv). Sizes and offsets are given in number
+    /// of values for each neighbour, and recv_buffer must have been
+    /// sized by the caller. Values are sent as raw bytes, so that any
+    /// trivially copyable type can be exchanged.
+    template<typename T>
+      static void neighbor_all_to_all(MPI_Comm comm,
+                                      const std::vector<T>& send_buffer,
+                                      const std::vector<int>& send_sizes,
+                                      const std::vector<int>& send_offsets,
+                                      std::vector<T>& recv_buffer,
+                                      const std::vector<int>& recv_sizes,
+                                      const std::vector<int>& recv_offsets);
+
     /// Broadcast vector of value from broadcaster to all processes
     template<typename T>
       static void broadcast(MPI_Comm comm, std::vector<T>& value,
@@ -397,6 +412,40 @@ namespace dolfin
     #endif
   }
   //---------------------------------------------------------------------------
+  template<typename T>
+    void dolfin::MPI::neighbor_all_to_all(MPI_Comm comm,
+                                          const std::vector<T>& send_buffer,
+                                          const std::vector<int>& send_sizes,
+                                          const std::vector<int>& send_offsets,
+                                          std::vector<T>& recv_buffer,
+                                          const std::vector<int>& recv_sizes,
+                                          const std::vector<int>& recv_offsets)
+  {
+    #ifdef HAS_MPI
+    // Convert sizes and offsets to bytes
+    const int w = sizeof(T);
+    std::vector<int> ssizes(send_sizes.size()), soffsets(send_offsets.size());
+    for (std::size_t i = 0; i < send_sizes.size(); ++i)
+    {
+      ssizes[i] = w*send_sizes[i];
+      soffsets[i] = w*send_offsets[i];
+    }
+    std::vector<int> rsizes(recv_sizes.size()), roffsets(recv_offsets.size());
+    for (std::size_t i = 0; i < recv_sizes.size(); ++i)
+    {
+      rsizes[i] = w*recv_sizes[i];
+      roffsets[i] = w*recv_offsets[i];
+    }
+
+    MPI_Neighbor_alltoallv(send_buffer.data(), ssizes.data(), soffsets.data(),
+                           MPI_BYTE,
+                           recv_buffer.data(), rsizes.data(), roffsets.data(),
+                           MPI_BYTE, comm);
+    #else
+    dolfin_assert(send_buffer.empty() and recv_buffer.empty());
+    #endif
+  }
+  //---------------------------------------------------------------------------
   template<typename T>
     void dolfin::MPI::all_to_all(MPI_Comm comm,
                                  std::vector<std::vector<T>>& in_values,
@@ -0,0 +1,109 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __RADIX_SORT_H
+#define __RADIX_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Threads.h"
+
+namespace dolfin
+{
+
+  /// This class provides a thread-parallel, stable least significant
+  /// digit radix sort for arrays of records with fixed-size unsigned
+  /// integer keys. Records with multi-word keys (e.g. the sorted
+  /// vertex indices of mesh entities) are sorted by calling sort()
+  /// once for each word, starting with the least significant.
+
+  class RadixSort
+  {
+  public:
+
+    /// Stable sort of data by key(x), where key(x) returns an
+    /// unsigned integer in [0, max_key]. Only digits which are
+    /// needed to represent max_key are sorted.
+    template<typename T, typename Key>
+      static void sort(std::vector<T>& data, Key key, std::uint32_t max_key,
+                       std::size_t num_threads=1);
+
+  private:
+
+    // Number of bits per digit
+    static const unsigned int _bits = 11;
+
+  };
+
+  //---------------------------------------------------------------------------
+  // Implementation of RadixSort
+  //---------------------------------------------------------------------------
+  template<typename T, typename Key>
+    void RadixSort::sort(std::vector<T>& data, Key key, std::uint32_t max_key,
+                         std::size_t num_threads)
+  {
+    const std::size_t n = data.size();
+    num_threads = std::max<std::size_t>(1, std::min(num_threads, n));
+    const std::size_t num_buckets = 1 << _bits;
+    const std::uint32_t mask = num_buckets - 1;
+
+    std::vector<T> buffer(n);
+    std::vector<std::size_t> offsets(num_threads*num_buckets);
+    for (unsigned int shift = 0; shift < 32 and (max_key >> shift) > 0;
+         shift += _bits)
+    {
+      // Count digits in each chunk of the data
+      std::fill(offsets.begin(), offsets.end(), 0);
+      Threads::parallel_for(n, num_threads,
+                   [&](std::size_t begin, std::size_t end, std::size_t t)
+                   {
+                     std::size_t* count = offsets.data() + t*num_buckets;
+                     for (std::size_t i = begin; i < end; ++i)
+                       ++count[(key(data[i]) >> shift) & mask];
+                   });
+
+      // Compute position of first record of each chunk and digit,
+      // ordering chunks within a digit to keep the sort stable
+      std::size_t position = 0;
+      for (std::size_t b = 0; b < num_buckets; ++b)
+      {
+        for (std::size_t t = 0; t < num_threads; ++t)
+        {
+          const std::size_t count = offsets[t*num_buckets + b];
+          offsets[t*num_buckets + b] = position;
+          position += count;
+        }
+      }
+
+      // Move records to their position
+      Threads::parallel_for(n, num_threads,
+                   [&](std::size_t begin, std::size_t end, std::size_t t)
+                   {
+                     std::size_t* pos = offsets.data() + t*num_buckets;
+                     for (std::size_t i = begin; i < end; ++i)
+                       buffer[pos[(key(data[i]) >> shift) & mask]++] = data[i];
+                   });
+      data.swap(buffer);
+    }
+  }
+  //---------------------------------------------------------------------------
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __THREADS_H
+#define __THREADS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace dolfin
+{
+
+  /// This class provides simple thread-parallel loops over index
+  /// ranges, which are used by mesh and geometry algorithms when the
+  /// global parameter "num_threads" is larger than one.
+  ///
+  /// An exception thrown by the loop body (e.g. by dolfin_error) on
+  /// any thread is rethrown to the caller once all threads have
+  /// finished. If several threads throw, the exception from the
+  /// lowest numbered thread is rethrown. Note that the log functions
+  /// are not thread-safe and should not be called from the loop body.
+
+  class Threads
+  {
+  public:
+
+    /// Call f(begin, end, thread) for num_threads contiguous chunks
+    /// of [0, n) in parallel
+    template<typename F>
+      static void parallel_for(std::size_t n, std::size_t num_threads, F f);
+
+    /// Return (sorted) indices of nonzero entries of marker, computed
+    /// in parallel with a prefix sum over num_threads chunks
+    static std::vector<std::size_t>
+      marked_indices(const std::vector<std::uint8_t>& marker,
+                     std::size_t num_threads=1);
+
+  };
+
+  //---------------------------------------------------------------------------
+  // Implementation of Threads
+  //---------------------------------------------------------------------------
+  template<typename F>
+    void Threads::parallel_for(std::size_t n, std::size_t num_threads, F f)
+  {
+    num_threads = std::max<std::size_t>(1, std::min(num_threads, n));
+    if (num_threads == 1)
+    {
+      f(0, n, 0);
+      return;
+    }
+
+    // Exceptions cannot propagate out of a thread, so catch them and
+    // rethrow after all threads have been joined
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+      threads.push_back(std::thread([&f, &errors, n, num_threads, t]()
+        {
+          try
+          {
+            f(t*n/num_threads, (t + 1)*n/num_threads, t);
+          }
+          catch (...)
+          {
+            errors[t] = std::current_exception();
+          }
+        }));
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    for (auto& error : errors)
+    {
+      if (error)
+        std::rethrow_exception(error);
+    }
+  }
+  //---------------------------------------------------------------------------
+  inline std::vector<std::size_t>
+    Threads::marked_indices(const std::vector<std::uint8_t>& marker,
+                            std::size_t num_threads)
+  {
+    // Count marked entries in each chunk. Each thread counts into a
+    // local variable to avoid false sharing of adjacent offsets.
+    num_threads = std::max<std::size_t>(1, std::min(num_threads,
+                                                    marker.size()));
+    std::vector<std::size_t> offsets(num_threads + 1, 0);
+    parallel_for(marker.size(), num_threads,
+                 [&](std::size_t begin, std::size_t end, std::size_t t)
+                 {
+                   std::size_t count = 0;
+                   for (std::size_t i = begin; i < end; ++i)
+                     count += (marker[i] != 0);
+                   offsets[t + 1] = count;
+                 });
+
+    // Compute position of first entry of each chunk (prefix sum) and
+    // fill list of marked entries
+    for (std::size_t t = 0; t < num_threads; ++t)
+      offsets[t + 1] += offsets[t];
+    std::vector<std::size_t> indices(offsets.back());
+    parallel_for(marker.size(), num_threads,
+                 [&](std::size_t begin, std::size_t end, std::size_t t)
+                 {
+                   std::size_t pos = offsets[t];
+                   for (std::size_t i = begin; i < end; ++i)
+                     if (marker[i])
+                       indices[pos++] = i;
+                 });
+
+    return indices;
+  }
+  //---------------------------------------------------------------------------
+
+}
+
+#endif
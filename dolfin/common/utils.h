@@ -19,7 +19,7 @@
 // Modified by Garth N. Wells, 2013.
 //
 // First added:  2009-08-09
-// Last changed: 2013-01-03
+// Last changed: 2019-06-17
 
 #ifndef __DOLFIN_UTILS_H
 #define __DOLFIN_UTILS_H
@@ -71,6 +71,20 @@ namespace dolfin
   /// Return string representation of given array
   std::string to_string(const double* x, std::size_t n);
 
+  /// Return number of bytes allocated for the elements of a
+  /// std::vector
+  template<typename T>
+    std::size_t memory_usage(const std::vector<T>& x)
+  { return x.capacity()*sizeof(T); }
+
+  /// Return estimated number of bytes allocated for a node-based
+  /// container (std::set, std::map, std::unordered_map) with given
+  /// number of entries of type T. Each node is assumed to hold the
+  /// entry and up to four pointers.
+  template<typename T>
+    std::size_t node_memory_usage(std::size_t num_entries)
+  { return num_entries*(sizeof(T) + 4*sizeof(void*)); }
+
   /// Return a hash of a given object
   template <class T>
   std::size_t hash_local(const T& x)
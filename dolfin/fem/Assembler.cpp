@@ -30,6 +30,8 @@
 #include <dolfin/la/GenericTensor.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/ConnectivityView.h>
+#include <dolfin/mesh/EntityCoordinatesView.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Vertex.h>
 #include <dolfin/mesh/MeshData.h>
@@ -140,35 +142,41 @@ void Assembler::assemble_cells(
   // Check whether integral is domain-dependent
   bool use_domains = domains && !domains->empty();
 
+  // View of cell vertex coordinates, which are the coordinate dofs
+  // for affine geometry
+  const EntityCoordinatesView cell_coordinates(mesh, mesh.topology().dim());
+  const bool affine_geometry = (mesh.geometry().degree() == 1);
+
   // Assemble over cells
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
   Progress p(AssemblerBase::progress_message(A.rank(), "cells"),
              mesh.num_cells());
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  for (std::size_t c = 0; c < cell_coordinates.size(); ++c)
   {
     // Get integral for sub domain (if any)
     if (use_domains)
-      integral = ufc.get_cell_integral((*domains)[*cell]);
+      integral = ufc.get_cell_integral((*domains)[c]);
 
     // Skip if no integral on current domain
     if (!integral)
       continue;
 
-    // Check that cell is not a ghost
-    dolfin_assert(!cell->is_ghost());
-
     // Update to current cell
-    cell->get_cell_data(ufc_cell);
-    cell->get_coordinate_dofs(coordinate_dofs);
-    ufc.update(*cell, coordinate_dofs, ufc_cell,
+    const Cell cell(mesh, c);
+    cell.get_cell_data(ufc_cell);
+    if (affine_geometry)
+      cell_coordinates.get(c, coordinate_dofs);
+    else
+      cell.get_coordinate_dofs(coordinate_dofs);
+    ufc.update(cell, coordinate_dofs, ufc_cell,
                integral->enabled_coefficients());
 
     // Get local-to-global dof maps for cell
     bool empty_dofmap = false;
     for (std::size_t i = 0; i < form_rank; ++i)
     {
-      auto dmap = dofmaps[i]->cell_dofs(cell->index());
+      auto dmap = dofmaps[i]->cell_dofs(c);
       dofs[i] = ArrayView<const dolfin::la_index>(dmap.size(), dmap.data());
       empty_dofmap = empty_dofmap || dofs[i].size() == 0;
     }
@@ -185,7 +193,7 @@ void Assembler::assemble_cells(
     // Add entries to global tensor. Either store values cell-by-cell
     // (currently only available for functionals)
     if (is_cell_functional)
-      (*values)[cell->index()] = ufc.A[0];
+      (*values)[c] = ufc.A[0];
     else
       A.add_local(ufc.A.data(), dofs);
 
@@ -235,15 +243,22 @@ void Assembler::assemble_exterior_facets(
   mesh.init(D - 1, D);
   dolfin_assert(mesh.ordered());
 
+  // Views of facet-cell and cell-facet adjacency, and of cell vertex
+  // coordinates
+  const ConnectivityView facet_cells(mesh, D - 1, D);
+  const ConnectivityView cell_facets(mesh, D, D - 1, true);
+  const EntityCoordinatesView cell_coordinates(mesh, D, true);
+  const bool affine_geometry = (mesh.geometry().degree() == 1);
+
   // Assemble over exterior facets (the cells of the boundary)
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
   Progress p(AssemblerBase::progress_message(A.rank(), "exterior facets"),
              mesh.num_facets());
-  for (FacetIterator facet(mesh); !facet.end(); ++facet)
+  for (std::size_t f = 0; f < facet_cells.size(); ++f)
   {
     // Only consider exterior facets
-    if (!facet->exterior())
+    if (facet_cells.size_global(f) != 1)
     {
       p++;
       continue;
@@ -251,7 +266,7 @@ void Assembler::assemble_exterior_facets(
 
     // Get integral for sub domain (if any)
     if (use_domains)
-      integral = ufc.get_exterior_facet_integral((*domains)[*facet]);
+      integral = ufc.get_exterior_facet_integral((*domains)[f]);
 
     // Skip integral if zero
     if (!integral)
@@ -259,18 +274,25 @@ void Assembler::assemble_exterior_facets(
 
     // Get mesh cell to which mesh facet belongs (pick first, there is
     // only one)
-    dolfin_assert(facet->num_entities(D) == 1);
-    Cell mesh_cell(mesh, facet->entities(D)[0]);
+    dolfin_assert(facet_cells[f].size() == 1);
+    const std::size_t c = facet_cells[f][0];
+    Cell mesh_cell(mesh, c);
 
     // Check that cell is not a ghost
     dolfin_assert(!mesh_cell.is_ghost());
 
     // Get local index of facet with respect to the cell
-    const std::size_t local_facet = mesh_cell.index(*facet);
+    const ArrayView<const unsigned int> facets = cell_facets[c];
+    const std::size_t local_facet
+      = std::find(facets.begin(), facets.end(), f) - facets.begin();
+    dolfin_assert(local_facet < facets.size());
 
     // Update UFC cell
     mesh_cell.get_cell_data(ufc_cell, local_facet);
-    mesh_cell.get_coordinate_dofs(coordinate_dofs);
+    if (affine_geometry)
+      cell_coordinates.get(c, coordinate_dofs);
+    else
+      mesh_cell.get_coordinate_dofs(coordinate_dofs);
 
     // Update UFC object
     ufc.update(mesh_cell, coordinate_dofs, ufc_cell,
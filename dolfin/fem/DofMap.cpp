@@ -28,6 +28,7 @@
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/common/types.h>
+#include <dolfin/common/utils.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/LogStream.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
@@ -628,6 +629,21 @@ void DofMap::check_provided_entities(const ufc::dofmap& dofmap,
   }
 }
 //-----------------------------------------------------------------------------
+std::size_t DofMap::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(_dofmap)
+    + node_memory_usage<std::size_t>(_global_nodes.size())
+    + dolfin::memory_usage(_num_mesh_entities_global)
+    + dolfin::memory_usage(_ufc_local_to_local)
+    + node_memory_usage<int>(_neighbours.size())
+    + node_memory_usage<std::pair<int, std::vector<int>>>(_shared_nodes.size());
+  for (const auto& node : _shared_nodes)
+    bytes += dolfin::memory_usage(node.second);
+  if (_index_map)
+    bytes += _index_map->memory_usage();
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string DofMap::str(bool verbose) const
 {
   std::stringstream s;
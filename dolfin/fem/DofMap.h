@@ -400,6 +400,13 @@ namespace dolfin
     ///         An informal representation of the function space.
     std::string str(bool verbose) const;
 
+    /// Return number of bytes allocated for the dofmap, including
+    /// its index map
+    ///
+    /// @return    std::size_t
+    ///         Number of bytes.
+    std::size_t memory_usage() const;
+
   private:
 
     // Friends
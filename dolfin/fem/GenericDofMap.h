@@ -204,6 +204,10 @@ namespace dolfin
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const = 0;
 
+    /// Return number of bytes allocated for the dofmap, including
+    /// its index map
+    virtual std::size_t memory_usage() const = 0;
+
     /// Get block size
     virtual int block_size() const = 0;
 
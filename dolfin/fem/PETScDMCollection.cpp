@@ -635,23 +635,26 @@ void PETScDMCollection::find_exterior_points(MPI_Comm mpi_comm,
   num_recv_points /= dim;
 
   // Save distances and ids of nearest cells on this process
+  std::vector<Point> curr_points;
+  curr_points.reserve(num_recv_points);
+  for (const auto &p : recv_points)
+  {
+    unsigned int n_points = p.size()/dim;
+    for (unsigned int i = 0; i < n_points; ++i)
+      curr_points.push_back(Point(dim, &p[i*dim]));
+  }
+
+  const std::vector<std::pair<unsigned int, double>> find_points
+    = treec->compute_closest_entities(curr_points);
+
   std::vector<double> send_distance;
   std::vector<unsigned int> ids;
-
   send_distance.reserve(num_recv_points);
   ids.reserve(num_recv_points);
-
-  for (const auto &p : recv_points)
+  for (const auto &find_point : find_points)
   {
-    unsigned int n_points = p.size()/dim;
-    for (unsigned int i = 0; i < n_points; ++i)
-    {
-      const Point curr_point(dim, &p[i*dim]);
-      std::pair<unsigned int, double> find_point
-        = treec->compute_closest_entity(curr_point);
-      send_distance.push_back(find_point.second);
-      ids.push_back(find_point.first);
-    }
+    send_distance.push_back(find_point.second);
+    ids.push_back(find_point.first);
   }
 
   // All processes get the same distance information
@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -22,6 +23,7 @@
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/PointLocator.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/mesh/Cell.h>
@@ -121,86 +123,33 @@ PointSource::~PointSource()
 void PointSource::distribute_sources(const Mesh& mesh,
                                      const std::vector<std::pair<Point, double>>& sources)
 {
-  // Take a list of points, and assign to correct process
+  // Take a list of points, and assign to the lowest ranked process
+  // containing each point
   const MPI_Comm mpi_comm = mesh.mpi_comm();
-  const std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
-
-  // Collect up any points/values which are not local
-  std::vector<double> remote_points;
-  for (auto & s : sources)
+  std::vector<Point> points;
+  std::vector<double> magnitudes;
+  for (auto& s : sources)
   {
-    const Point& p = s.first;
-    double magnitude = s.second;
-
-    unsigned int cell_index = tree->compute_first_entity_collision(p);
-    if (cell_index == std::numeric_limits<unsigned int>::max())
-    {
-      remote_points.insert(remote_points.end(), p.coordinates(),
-                           p.coordinates() + 3);
-      remote_points.push_back(magnitude);
-    }
-    else
-      _sources.push_back({p, magnitude});
+    points.push_back(s.first);
+    magnitudes.push_back(s.second);
   }
+  const PointLocator locator(mesh, points);
 
-  // Send all non-local points out to all other processes
-  const int mpi_size = MPI::size(mpi_comm);
-  const int mpi_rank = MPI::rank(mpi_comm);
-  std::vector<std::vector<double>> remote_points_all(mpi_size);
-  MPI::all_gather(mpi_comm, remote_points, remote_points_all);
-
-  // Flatten result back into remote_points vector
-  // All processes will have the same data
-  remote_points.clear();
-  for (auto &q : remote_points_all)
-    remote_points.insert(remote_points.end(), q.begin(), q.end());
-
-  // Go through all received points, looking for any which are local
-  std::vector<int> point_count;
-  for (auto q = remote_points.begin(); q != remote_points.end(); q += 4)
+  // Check the points exist on some process
+  const std::size_t num_outside = std::count(locator.owners().begin(),
+                                             locator.owners().end(), -1);
+  if (MPI::sum(mpi_comm, num_outside) > 0)
   {
-    Point p(*q, *(q + 1), *(q + 2));
-    unsigned int cell_index = tree->compute_first_entity_collision(p);
-    point_count.push_back(cell_index != std::numeric_limits<unsigned int>::max());
-  }
-
-  // Send out the results of the search to all processes
-  std::vector<std::vector<int>> point_count_all(mpi_size);
-  MPI::all_gather(mpi_comm, point_count, point_count_all);
-
-  // Check the point exists on some process, and prioritise lower rank
-  for (std::size_t i = 0; i < point_count.size(); ++i)
-  {
-    bool found = false;
-    for (int j = 0; j < mpi_size; ++j)
-    {
-      // Clear higher ranked 'finds' if already found on a lower rank
-      // process
-      if (found)
-        point_count_all[j][i] = 0;
-
-      if (point_count_all[j][i] != 0)
-        found = true;
-    }
-    if (!found)
-    {
-      dolfin_error("PointSource.cpp",
-                   "apply point source to vector",
-                   "The point is outside of the domain"); // (%s)", p.str().c_str());
-    }
+    dolfin_error("PointSource.cpp",
+                 "apply point source to vector",
+                 "The point is outside of the domain");
   }
 
-  unsigned int i = 0;
-  for (auto q = remote_points.begin(); q != remote_points.end(); q += 4)
-  {
-    if (point_count_all[mpi_rank][i] == 1)
-    {
-      const Point p(*q, *(q + 1), *(q + 2));
-      double val = *(q + 3);
-      _sources.push_back({p, val});
-    }
-    ++i;
-  }
+  // Send magnitudes to owning processes
+  std::vector<double> owned_magnitudes;
+  locator.send_to_owners(magnitudes, 1, owned_magnitudes);
+  for (std::size_t i = 0; i < locator.num_owned(); ++i)
+    _sources.push_back({locator.owned_points()[i], owned_magnitudes[i]});
 }
 //-----------------------------------------------------------------------------
 void PointSource::apply(GenericVector& b)
@@ -25,6 +25,7 @@
 #include <dolfin/la/SparsityPattern.h>
 #include <dolfin/log/log.h>
 #include <dolfin/log/Progress.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
@@ -69,6 +70,19 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
   if (rank < 2)
     return;
 
+  // Use compact storage with row capacities estimated from cell
+  // connectivity
+  const std::string storage = parameters["sparsity_pattern_storage"];
+  if (init and storage == "compact")
+  {
+    std::vector<std::size_t> diagonal_capacity, off_diagonal_capacity;
+    estimate_row_capacity(diagonal_capacity, off_diagonal_capacity,
+                          sparsity_pattern.primary_dim(), mesh, dofmaps,
+                          cells, interior_facets, exterior_facets, vertices,
+                          diagonal);
+    sparsity_pattern.init_compact(diagonal_capacity, off_diagonal_capacity);
+  }
+
   // Vector to store macro-dofs, if required (for interior facets)
   std::vector<std::vector<dolfin::la_index>> macro_dofs(rank);
 
@@ -268,6 +282,108 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
     sparsity_pattern.apply();
 }
 //-----------------------------------------------------------------------------
+void SparsityPatternBuilder::estimate_row_capacity(
+  std::vector<std::size_t>& diagonal_capacity,
+  std::vector<std::size_t>& off_diagonal_capacity,
+  std::size_t primary_dim,
+  const Mesh& mesh,
+  const std::vector<const GenericDofMap*> dofmaps,
+  bool cells,
+  bool interior_facets,
+  bool exterior_facets,
+  bool vertices,
+  bool diagonal)
+{
+  dolfin_assert(dofmaps.size() == 2);
+  const std::size_t primary_codim = primary_dim == 0 ? 1 : 0;
+  const GenericDofMap& dofmap0 = *dofmaps[primary_dim];
+  const GenericDofMap& dofmap1 = *dofmaps[primary_codim];
+  const std::size_t local_size0
+    = dofmap0.index_map()->size(IndexMap::MapSize::OWNED);
+  const std::size_t local_size1
+    = dofmap1.index_map()->size(IndexMap::MapSize::OWNED);
+  const std::size_t global_size1
+    = dofmap1.index_map()->size(IndexMap::MapSize::GLOBAL);
+
+  diagonal_capacity.assign(local_size0, 0);
+  off_diagonal_capacity.assign(global_size1 > local_size1 ? local_size0 : 0, 0);
+
+  // Add couplings between all (local) row dofs and column dofs in
+  // the given arrays. Duplicates are counted, hence an upper bound.
+  auto add_couplings = [&](const std::vector<ArrayView<const dolfin::la_index>>& rows,
+                           const std::vector<ArrayView<const dolfin::la_index>>& cols)
+    {
+      std::size_t num_diagonal = 0, num_off_diagonal = 0;
+      for (const auto& block : cols)
+        for (const auto j : block)
+          ++((std::size_t) j < local_size1 ? num_diagonal : num_off_diagonal);
+
+      for (const auto& block : rows)
+      {
+        for (const auto i : block)
+        {
+          if ((std::size_t) i >= local_size0)
+            continue;
+          diagonal_capacity[i] += num_diagonal;
+          if (!off_diagonal_capacity.empty())
+            off_diagonal_capacity[i] += num_off_diagonal;
+        }
+      }
+    };
+
+  // Cell (and vertex and exterior facet) integrals couple dofs within
+  // a cell
+  if (cells or vertices or exterior_facets)
+  {
+    for (CellIterator cell(mesh); !cell.end(); ++cell)
+    {
+      auto dofs0 = dofmap0.cell_dofs(cell->index());
+      auto dofs1 = dofmap1.cell_dofs(cell->index());
+      add_couplings({ArrayView<const dolfin::la_index>(dofs0.size(), dofs0.data())},
+                    {ArrayView<const dolfin::la_index>(dofs1.size(), dofs1.data())});
+    }
+  }
+
+  // Interior facet integrals couple dofs of the two adjacent cells
+  if (interior_facets)
+  {
+    const std::size_t D = mesh.topology().dim();
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+    for (FacetIterator facet(mesh); !facet.end(); ++facet)
+    {
+      if (facet->num_entities(D) != 2)
+        continue;
+
+      std::vector<ArrayView<const dolfin::la_index>> rows, cols;
+      for (std::size_t k = 0; k < 2; ++k)
+      {
+        const std::size_t c = facet->entities(D)[k];
+        auto dofs0 = dofmap0.cell_dofs(c);
+        auto dofs1 = dofmap1.cell_dofs(c);
+        rows.push_back(ArrayView<const dolfin::la_index>(dofs0.size(),
+                                                         dofs0.data()));
+        cols.push_back(ArrayView<const dolfin::la_index>(dofs1.size(),
+                                                         dofs1.data()));
+      }
+      add_couplings(rows, cols);
+    }
+  }
+
+  // Diagonal entries
+  if (diagonal)
+  {
+    for (auto& capacity : diagonal_capacity)
+      ++capacity;
+  }
+
+  // A row cannot have more entries than the width of the block
+  for (auto& capacity : diagonal_capacity)
+    capacity = std::min(capacity, local_size1);
+  for (auto& capacity : off_diagonal_capacity)
+    capacity = std::min(capacity, global_size1 - local_size1);
+}
+//-----------------------------------------------------------------------------
 void SparsityPatternBuilder::build_multimesh_sparsity_pattern(
   SparsityPattern& sparsity_pattern,
   const MultiMeshForm& form)
@@ -62,6 +62,21 @@ namespace dolfin
 
   private:
 
+    // Compute upper estimates of the number of nonzeros in each
+    // local row of the diagonal and off-diagonal blocks from cell
+    // connectivity
+    static void
+      estimate_row_capacity(std::vector<std::size_t>& diagonal_capacity,
+                            std::vector<std::size_t>& off_diagonal_capacity,
+                            std::size_t primary_dim,
+                            const Mesh& mesh,
+                            const std::vector<const GenericDofMap*> dofmaps,
+                            bool cells,
+                            bool interior_facets,
+                            bool exterior_facets,
+                            bool vertices,
+                            bool diagonal);
+
     // Build sparsity pattern for interface part of multimesh form
     static void _build_multimesh_sparsity_pattern_interface
       (SparsityPattern& sparsity_pattern,
@@ -17,9 +17,14 @@
 //
 //
 // First added:  2014-02-12
-// Last changed:
+// Last changed: 2019-06-18
 
+#include <limits>
 #include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/geometry/PointLocator.h>
+#include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/common/RangedIndexSet.h>
@@ -114,13 +119,11 @@ void LagrangeInterpolator::interpolate(Function& u, const Function& u0)
   //      one only need to visit (and distribute) each interpolation
   //      point once.
   //   2) Create a map from dof to component index in Mixed Space.
-  //   3) Create bounding boxes for the partitioned mesh of u0 and
-  //      distribute to all processors.
-  //   4) Using bounding boxes, compute the processes that *may* own
-  //      the dofs of u.
-  //   5) Distribute interpolation points to potential owners who
-  //      subsequently tries to evaluate u0. If successful, return
-  //      values of u0 to owner.
+  //   3) Evaluate u0 at the interpolation points found on this
+  //      process.
+  //   4) Locate the remaining points on other processes (see
+  //      PointLocator), evaluate u0 on the owning processes and
+  //      return the values.
 
   // Get function spaces of Functions interpolating to/from
   dolfin_assert(u0.function_space());
@@ -161,30 +164,8 @@ void LagrangeInterpolator::interpolate(Function& u, const Function& u0)
   const std::size_t gdim0 = mesh0.geometry().dim();
   const std::size_t gdim1 = mesh1.geometry().dim();
 
-  // Get communicator
-  const MPI_Comm mpi_comm = V1.mesh()->mpi_comm();
-
-  // Create bounding box of mesh0
-  std::vector<double> x_min_max(2*gdim0);
-  std::vector<double> coordinates = mesh0.coordinates();
-  for (std::size_t i = 0; i < gdim0; ++i)
-  {
-    for (auto it = coordinates.begin() + i; it < coordinates.end(); it += gdim0)
-    {
-      x_min_max[i]         = std::min(x_min_max[i], *it);
-      x_min_max[gdim0 + i] = std::max(x_min_max[gdim0 + i], *it);
-    }
-  }
-
-  // Communicate bounding boxes
-  std::vector<std::vector<double>> bounding_boxes;
-  MPI::all_gather(mpi_comm, x_min_max, bounding_boxes);
-
-  // Create arrays used to evaluate one point
+  // Create array used to hold one point
   std::vector<double> x(gdim0);
-  std::vector<double> values(u0.value_size());
-  Array<double> _x(gdim0, x.data());
-  Array<double> _values(u0.value_size(), values.data());
 
   // Create vector to hold all local values of u
   std::vector<double> local_u_vector(u.vector()->local_size());
@@ -199,122 +180,142 @@ void LagrangeInterpolator::interpolate(Function& u, const Function& u0)
   extract_dof_component_map(dof_component_map, V1, &component);
 
   // Search this process first for all coordinates in u's local mesh
-  std::vector<double> points_not_found;
+  std::vector<double> local_points;
   for (const auto &map_it : coords_to_dofs)
   {
-    // Place interpolation point in x
-    std::copy(map_it.first.begin(), map_it.first.end(), x.begin());
+    local_points.insert(local_points.end(), map_it.first.begin(),
+                        map_it.first.end());
+  }
+  std::vector<double> local_values;
+  std::vector<bool> local_found;
+  eval_points(local_values, local_found, u0, local_points);
 
-    try
+  std::vector<double> points_not_found;
+  std::size_t j = 0;
+  for (const auto &map_it : coords_to_dofs)
+  {
+    if (local_found[j])
     { // Store values when point is found
-      u0.eval(_values, _x);
-      std::vector<std::size_t> dofs = map_it.second;
       for (const auto &d : map_it.second)
-        local_u_vector[d] = values[dof_component_map[d]];
+      {
+        local_u_vector[d]
+          = local_values[j*u0.value_size() + dof_component_map[d]];
+      }
     }
-    catch (std::exception &e)
+    else
     {
       // If not found then it must be searched on the other processes
-      points_not_found.insert(points_not_found.end(), x.begin(), x.end());
+      points_not_found.insert(points_not_found.end(), map_it.first.begin(),
+                              map_it.first.end());
     }
+    ++j;
   }
 
-  // Get number of MPI processes
-  std::size_t num_processes = MPI::size(mpi_comm);
-
-  // Remaining interpolation points must be found through MPI
-  // communication.  Check first using bounding boxes which process
-  // may own the points
-  std::vector<std::vector<double>> potential_points(num_processes);
+  // Remaining interpolation points must be found on other
+  // processes. Locate them in the mesh of u0 and evaluate u0 on the
+  // owning processes.
+  std::vector<Point> remote_points;
   for (std::size_t i = 0; i < points_not_found.size(); i += gdim1)
+    remote_points.push_back(Point(gdim1, points_not_found.data() + i));
+  const PointLocator locator(mesh0, remote_points);
+
+  const std::size_t value_size = u0.value_size();
+  std::vector<double> remote_values;
+  ufc::cell ufc_cell;
+  locator.evaluate(value_size,
+                   [&](unsigned int c, const Point& point, double* values)
+                   {
+                     std::copy(point.coordinates(),
+                               point.coordinates() + gdim0, x.begin());
+                     const Array<double> _x(gdim0, x.data());
+                     Array<double> _values(value_size, values);
+                     const Cell cell(mesh0, c);
+                     cell.get_cell_data(ufc_cell);
+                     u0.eval(_values, _x, cell, ufc_cell);
+                   }, remote_values);
+
+  // Move all found coefficients into the local_u_vector
+  for (std::size_t j = 0; j < remote_points.size(); ++j)
   {
-    std::copy(points_not_found.begin() + i,
-              points_not_found.begin() + i + gdim1, x.begin());
+    if (locator.owners()[j] < 0)
+      continue;
 
-    // Find potential owners
-    for (std::size_t p = 0; p < num_processes; p++)
-    {
-      if (p == MPI::rank(mpi_comm))
-        continue;
+    std::copy(points_not_found.begin() + j*gdim1,
+              points_not_found.begin() + (j + 1)*gdim1, x.begin());
 
-      // Check if in bounding box
-      if (in_bounding_box(x, bounding_boxes[p], 1e-12))
-      {
-        potential_points[p].insert(potential_points[p].end(),
-                                   x.begin(), x.end());
-      }
+    // Get the owned dofs sharing x
+    const std::vector<std::size_t>& dofs = coords_to_dofs[x];
+
+    // Place result in local_u_vector
+    for (const auto &d : dofs)
+    {
+      dolfin_assert(d <  local_u_vector.size());
+      local_u_vector[d]
+        = remote_values[j*value_size + dof_component_map[d]];
     }
   }
 
-  // Communicate all potential points
-  std::vector<std::vector<double>> potential_points_recv;
-  MPI::all_to_all(mpi_comm, potential_points, potential_points_recv);
+  // Set and finalize
+  u.vector()->set_local(local_u_vector);
+  u.vector()->apply("insert");
+}
+//-----------------------------------------------------------------------------
+void LagrangeInterpolator::eval_points(std::vector<double>& values,
+                                       std::vector<bool>& found,
+                                       const Function& u0,
+                                       const std::vector<double>& points)
+{
+  dolfin_assert(u0.function_space());
+  dolfin_assert(u0.function_space()->mesh());
+  const Mesh& mesh = *u0.function_space()->mesh();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t value_size = u0.value_size();
+  const std::size_t num_points = points.size()/gdim;
+
+  // Find the first cell containing each point
+  std::vector<Point> _points;
+  _points.reserve(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    _points.push_back(Point(gdim, points.data() + i*gdim));
+  const std::vector<unsigned int> cells
+    = mesh.bounding_box_tree()->compute_first_entity_collisions(_points);
 
-  // Now try to eval u0 for the received points
-  std::vector<std::vector<double>> coefficients_found(num_processes);
-  std::vector<std::vector<double>> points_found(num_processes);
+  // Create arrays used to evaluate one point
+  std::vector<double> x(gdim);
+  Array<double> _x(gdim, x.data());
+  ufc::cell ufc_cell;
 
-  for (std::size_t p = 0; p < num_processes; ++p)
+  values.resize(num_points*value_size);
+  found.assign(num_points, false);
+  for (std::size_t i = 0; i < num_points; ++i)
   {
-    if (p == MPI::rank(mpi_comm))
-      continue;
+    std::copy(points.begin() + i*gdim, points.begin() + (i + 1)*gdim,
+              x.begin());
+    Array<double> _values(value_size, values.data() + i*value_size);
 
-    std::vector<double>& points = potential_points_recv[p];
-    for (std::size_t j = 0; j < points.size()/gdim1; ++j)
+    if (cells[i] != std::numeric_limits<unsigned int>::max())
     {
-      std::copy(points.begin() + j*gdim1, points.begin() + (j + 1)*gdim1,
-                x.begin());
-
+      // Evaluate in cell containing point
+      const Cell cell(mesh, cells[i]);
+      cell.get_cell_data(ufc_cell);
+      u0.eval(_values, _x, cell, ufc_cell);
+      found[i] = true;
+    }
+    else
+    {
+      // Points outside all cells may still be evaluated if close to a
+      // cell or if u0 allows extrapolation
       try
       {
-        // push back when point is found
         u0.eval(_values, _x);
-        coefficients_found[p].insert(coefficients_found[p].end(),
-                                     values.begin(), values.end());
-        points_found[p].insert(points_found[p].end(), x.begin(), x.end());
+        found[i] = true;
       }
       catch (std::exception &e)
       {
-        // If not found then do nothing
-      }
-    }
-  }
-
-  // Send back the found coefficients and points
-  std::vector<std::vector<double>> coefficients_recv;
-  std::vector<std::vector<double>> points_recv;
-  MPI::all_to_all(mpi_comm, coefficients_found, coefficients_recv);
-  MPI::all_to_all(mpi_comm, points_found, points_recv);
-  for (std::size_t p = 0; p < num_processes; ++p)
-  {
-    if (p == MPI::rank(mpi_comm))
-      continue;
-
-    // Get the new values and points
-    const std::vector<double>& vals = coefficients_recv[p];
-    const std::vector<double>& pts = points_recv[p];
-
-    // Move all found coefficients into the local_u_vector
-    for (std::size_t j = 0; j < pts.size()/gdim1; ++j)
-    {
-      std::copy(pts.begin() + j*gdim1, pts.begin() + (j + 1)*gdim1, x.begin());
-
-      // Get the owned dofs sharing x
-      const std::vector<std::size_t>& dofs = coords_to_dofs[x];
-
-      // Place result in local_u_vector
-      for (const auto &d : dofs)
-      {
-        dolfin_assert(d <  local_u_vector.size());
-        local_u_vector[d]
-          = vals[j*u0.value_size() + dof_component_map[d]];
+        // Not found
       }
     }
   }
-
-  // Set and finalize
-  u.vector()->set_local(local_u_vector);
-  u.vector()->apply("insert");
 }
 //-----------------------------------------------------------------------------
 std::map<std::vector<double>, std::vector<std::size_t>,
@@ -409,25 +410,3 @@ LagrangeInterpolator::extract_dof_component_map(std::unordered_map<std::size_t,
   }
 }
 //-----------------------------------------------------------------------------
-bool
-LagrangeInterpolator::in_bounding_box(const std::vector<double>& point,
-                                      const std::vector<double>& bounding_box,
-                                      const double tol)
-{
-  // Return false if bounding box is empty
-  if (bounding_box.empty())
-    return false;
-
-  const std::size_t gdim = point.size();
-  dolfin_assert(bounding_box.size() == 2*gdim);
-  for (std::size_t i = 0; i < gdim; ++i)
-  {
-    if (!(point[i] >= (bounding_box[i] - tol)
-          && point[i] <= (bounding_box[gdim + i] + tol)))
-    {
-      return false;
-    }
-  }
-  return true;
-}
-//-----------------------------------------------------------------------------
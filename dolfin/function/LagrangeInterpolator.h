@@ -103,10 +103,13 @@ namespace dolfin
                                           const FunctionSpace& V,
                                           int* component);
 
-    // Return true if point lies within bounding box
-    static bool in_bounding_box(const std::vector<double>& point,
-                                const std::vector<double>& bounding_box,
-                                const double tol);
+    // Evaluate u0 at points (gdim coordinates per point), locating
+    // the points in the mesh of u0 with a single batched query. Sets
+    // found to true for the points where u0 could be evaluated.
+    static void eval_points(std::vector<double>& values,
+                            std::vector<bool>& found,
+                            const Function& u0,
+                            const std::vector<double>& points);
 
   };
 
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-09
-// Last changed: 2014-05-12
+// Last changed: 2019-06-18
 
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/geometry/Point.h>
@@ -45,14 +45,15 @@ void BoundingBoxTree::build(const Mesh& mesh)
   build(mesh, mesh.topology().dim());
 }
 //-----------------------------------------------------------------------------
-void BoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
+void BoundingBoxTree::build(const Mesh& mesh, std::size_t tdim,
+                            std::string builder)
 {
 
   _tree = GenericBoundingBoxTree::create(mesh.geometry().dim());
 
   // Build tree
   dolfin_assert(_tree);
-  _tree->build(mesh, tdim);
+  _tree->build(mesh, tdim, builder);
 
   // Store mesh
   _mesh = &mesh;
@@ -84,6 +85,48 @@ void BoundingBoxTree::build(const std::vector<Point>& points, std::size_t gdim)
   _tree->build(points);
 }
 //-----------------------------------------------------------------------------
+bool BoundingBoxTree::refit(double max_cost_ratio, bool update_global)
+{
+  // Check that tree has been built for mesh
+  _check_built();
+  if (!_mesh)
+  {
+    dolfin_error("BoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Bounding box tree has not been built for a mesh");
+  }
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  return _tree->refit(*_mesh, max_cost_ratio, update_global);
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::update_global_tree()
+{
+  // Check that tree has been built for mesh
+  _check_built();
+  if (!_mesh)
+  {
+    dolfin_error("BoundingBoxTree.cpp",
+                 "update global bounding box tree",
+                 "Bounding box tree has not been built for a mesh");
+  }
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  _tree->update_global_tree(_mesh->mpi_comm());
+}
+//-----------------------------------------------------------------------------
+double BoundingBoxTree::cost_ratio() const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  return _tree->cost_ratio();
+}
+//-----------------------------------------------------------------------------
 std::vector<unsigned int>
 BoundingBoxTree::compute_collisions(const Point& point) const
 {
@@ -167,6 +210,19 @@ BoundingBoxTree::compute_first_entity_collision(const Point& point) const
   return _tree->compute_first_entity_collision(point, *_mesh);
 }
 //-----------------------------------------------------------------------------
+std::vector<unsigned int>
+BoundingBoxTree::compute_first_entity_collisions(
+  const std::vector<Point>& points) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_first_entity_collisions(points, *_mesh);
+}
+//-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
 BoundingBoxTree::compute_closest_entity(const Point& point) const
 {
@@ -179,6 +235,45 @@ BoundingBoxTree::compute_closest_entity(const Point& point) const
   return _tree->compute_closest_entity(point, *_mesh);
 }
 //-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+BoundingBoxTree::compute_closest_entities(const Point& point,
+                                          std::size_t k) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_closest_entities(point, k, *_mesh);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+BoundingBoxTree::compute_entities_within_radius(const Point& point,
+                                                double r) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_entities_within_radius(point, r, *_mesh);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+BoundingBoxTree::compute_closest_entities(
+  const std::vector<Point>& points) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_closest_entities(points, *_mesh);
+}
+//-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
 BoundingBoxTree::compute_closest_point(const Point& point) const
 {
@@ -200,6 +295,11 @@ bool BoundingBoxTree::collides_entity(const Point& point) const
   return compute_first_entity_collision(point) != std::numeric_limits<unsigned int>::max();
 }
 //-----------------------------------------------------------------------------
+std::size_t BoundingBoxTree::memory_usage() const
+{
+  return sizeof(*this) + (_tree ? _tree->memory_usage() : 0);
+}
+//-----------------------------------------------------------------------------
 void BoundingBoxTree::_check_built() const
 {
   if (!_tree)
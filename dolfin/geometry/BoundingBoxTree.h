@@ -16,12 +16,13 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-09
-// Last changed: 2014-05-12
+// Last changed: 2019-06-18
 
 #ifndef __BOUNDING_BOX_TREE_H
 #define __BOUNDING_BOX_TREE_H
 
 #include <limits>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -31,6 +32,7 @@ namespace dolfin
   // Forward declarations
   class Point;
   class GenericBoundingBoxTree;
+  class HDF5File;
   class Mesh;
 
   /// This class implements a (distributed) axis aligned bounding box
@@ -62,7 +64,21 @@ namespace dolfin
     ///     dimension (std::size_t)
     ///         The entity dimension (topological dimension) for which
     ///         to compute the bounding box tree.
-    void build(const Mesh& mesh, std::size_t tdim);
+    ///     builder (std::string)
+    ///         The tree construction method: "median" (default)
+    ///         splits the entities at the median along the longest
+    ///         axis, "sah" splits them by a binned surface area
+    ///         heuristic. The "sah" build is slower, but gives less
+    ///         overlap between boxes and faster queries on graded
+    ///         meshes. Subtrees are built in parallel with the number
+    ///         of threads given by the parameter "num_threads".
+    ///
+    /// In 2D and 3D, the binary tree is also stored as a 4-wide
+    /// tree with a cache-friendly node layout, which is used by the
+    /// collision queries (for points and between trees). This
+    /// roughly doubles the memory used by the tree.
+    void build(const Mesh& mesh, std::size_t tdim,
+               std::string builder="median");
 
     /// Build bounding box tree for point cloud.
     ///
@@ -73,6 +89,41 @@ namespace dolfin
     ///         The geometric dimension.
     void build(const std::vector<Point>& points, std::size_t gdim);
 
+    /// Update the bounding boxes after the coordinates of the mesh
+    /// have changed but not its topology (e.g. after ALE::move),
+    /// keeping the structure of the tree. This is much faster than
+    /// a rebuild, but the boxes overlap more as the entities move
+    /// relative to each other, which is measured by cost_ratio(). In
+    /// parallel, this function is collective unless update_global is
+    /// false.
+    ///
+    /// *Arguments*
+    ///     max_cost_ratio (double)
+    ///         The tree is rebuilt (with the same entity dimension
+    ///         and builder) if cost_ratio() exceeds this value after
+    ///         the refit.
+    ///     update_global (bool)
+    ///         If false, only the tree of this process is refitted,
+    ///         and compute_process_collisions() fails until
+    ///         update_global_tree() has been called.
+    ///
+    /// *Returns*
+    ///     bool
+    ///         True if the tree was rebuilt.
+    bool refit(double max_cost_ratio=std::numeric_limits<double>::max(),
+               bool update_global=true);
+
+    /// Rebuild the global tree, used by compute_process_collisions(),
+    /// if the tree has been refitted without updating it on any
+    /// process. This function is collective.
+    void update_global_tree();
+
+    /// Return ratio between the cost of the tree (the total surface
+    /// area of its boxes relative to the root box) and the cost when
+    /// it was built. This is one after a build and grows when the
+    /// boxes overlap more after refitting.
+    double cost_ratio() const;
+
     /// Compute all collisions between bounding boxes and _Point_.
     ///
     /// *Returns*
@@ -198,14 +249,39 @@ namespace dolfin
     unsigned int
     compute_first_entity_collision(const Point& point) const;
 
-    /// Compute closest entity to _Point_.
+    /// Compute first collision between entities and each of the
+    /// given points. This gives the same result as calling
+    /// compute_first_entity_collision for each point, but is faster
+    /// for large numbers of points: the points are ordered along a
+    /// space-filling curve so that consecutive queries visit the
+    /// same part of the tree, and the queries are divided between
+    /// the number of threads given by the parameter "num_threads".
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         The local index for the first found entity that
+    ///         collides with (intersects) each point. For points not
+    ///         found, std::numeric_limits<unsigned int>::max() is
+    ///         returned.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<_Point_>)
+    ///         The points.
+    std::vector<unsigned int>
+    compute_first_entity_collisions(const std::vector<Point>& points) const;
+
+    /// Compute closest entity to _Point_. The tree is searched
+    /// best-first: nodes are visited in order of the distance from
+    /// the point to their bounding boxes, and the search stops when
+    /// the nearest remaining box is farther away than the closest
+    /// entity found.
     ///
     /// *Returns*
     ///     unsigned int
     ///         The local index for the entity that is closest to the
     ///         point. If more than one entity is at the same distance
-    ///         (or point contained in entity), then the first entity
-    ///         is returned.
+    ///         (or point contained in entity), then the entity with
+    ///         the lowest index is returned.
     ///     double
     ///         The distance to the closest entity.
     ///
@@ -215,6 +291,56 @@ namespace dolfin
     std::pair<unsigned int, double>
     compute_closest_entity(const Point& point) const;
 
+    /// Compute the k entities closest to _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<std::pair<unsigned int, double>>
+    ///         The local indices of the (at most) k closest entities
+    ///         and their distances to the point, sorted by distance.
+    ///         Entities at the same distance are sorted by index.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    ///     k (std::size_t)
+    ///         The number of entities.
+    std::vector<std::pair<unsigned int, double>>
+    compute_closest_entities(const Point& point, std::size_t k) const;
+
+    /// Compute all entities within given distance of _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<std::pair<unsigned int, double>>
+    ///         The local indices of the entities at distance at most r
+    ///         from the point and their distances, sorted by distance.
+    ///         Entities at the same distance are sorted by index.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    ///     r (double)
+    ///         The radius.
+    std::vector<std::pair<unsigned int, double>>
+    compute_entities_within_radius(const Point& point, double r) const;
+
+    /// Compute closest entity to each of the given points. This
+    /// gives the same result as calling compute_closest_entity for
+    /// each point, but is faster for large numbers of points (see
+    /// compute_first_entity_collisions).
+    ///
+    /// *Returns*
+    ///     std::vector<std::pair<unsigned int, double>>
+    ///         The local index for the closest entity and the distance
+    ///         to it for each point. If the tree is empty, the index
+    ///         std::numeric_limits<unsigned int>::max() and an
+    ///         infinite distance are returned.
+    ///
+    /// *Arguments*
+    ///     points (std::vector<_Point_>)
+    ///         The points.
+    std::vector<std::pair<unsigned int, double>>
+    compute_closest_entities(const std::vector<Point>& points) const;
+
     /// Compute closest point to _Point_. This function assumes
     /// that the tree has been built for a point cloud.
     ///
@@ -259,8 +385,15 @@ namespace dolfin
     ///         True iff the point is inside the tree.
     bool collides_entity(const Point& point) const;
 
+    /// Return number of bytes allocated for the tree (zero if the
+    /// tree has not been built)
+    std::size_t memory_usage() const;
+
   private:
 
+    // Friends (for reading and writing the tree)
+    friend class HDF5File;
+
     // Check that tree has been built
     void _check_built() const;
 
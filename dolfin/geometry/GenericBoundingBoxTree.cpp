@@ -16,28 +16,190 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-05-02
-// Last changed: 2016-11-15
+// Last changed: 2019-06-18
 
 // Define a maximum dimension used for a local array in the recursive
 // build function. Speeds things up compared to allocating it in each
 // recursion and is more convenient than sending it around.
 #define MAX_DIM 6
 
+// Number of bins along each axis for the surface area heuristic
+#define SAH_NUM_BINS 16
+
+// Size of cache lines (in bytes) for alignment of wide tree nodes
+#define CACHE_LINE_SIZE 64
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <thread>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/RadixSort.h>
+#include <dolfin/common/Threads.h>
+#include <dolfin/common/constants.h>
+#include <dolfin/common/utils.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/EntityCoordinatesView.h>
 #include <dolfin/mesh/MeshEntity.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
-#include "BoundingBoxTree1D.h" // used for internal point search tree
-#include "BoundingBoxTree2D.h" // used for internal point search tree
-#include "BoundingBoxTree3D.h" // used for internal point search tree
+#include <dolfin/parameter/GlobalParameters.h>
+#include "BoundingBoxTree1D.h"
+#include "BoundingBoxTree2D.h"
+#include "BoundingBoxTree3D.h"
 #include "GenericBoundingBoxTree.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Flag for leaf children of wide tree nodes
+  const unsigned int wide_leaf = 1u << 31;
+
+  // Marker for unused slots of wide tree nodes
+  const unsigned int wide_empty = std::numeric_limits<unsigned int>::max();
+
+  // Copy bounding box of given slot of a wide tree node
+  template <std::size_t gdim>
+  inline void wide_bbox(double* a, const double* b, std::size_t slot)
+  {
+    for (std::size_t j = 0; j < 2*gdim; ++j)
+      a[j] = b[4*j + slot];
+  }
+
+  // Return bit mask of the children of a wide tree node for which
+  // the given distances (positive outside the box) are non-positive
+  inline unsigned int wide_hits(const double* d)
+  {
+    return (d[0] <= 0.0) | ((d[1] <= 0.0) << 1) | ((d[2] <= 0.0) << 2)
+      | ((d[3] <= 0.0) << 3);
+  }
+
+  // Check which of the four child bounding boxes b of a wide tree
+  // node contain point x, with boxes widened as in
+  // BoundingBoxTree3D::point_in_bbox. The comparisons b0 <= x <= b1
+  // are written as max(b0 - x, x - b1) <= 0 (which is exact), so
+  // that the loops over the children are vectorized.
+  template <std::size_t gdim>
+  inline unsigned int wide_point_in_bboxes(const double* b, const double* x)
+  {
+    double d[4] = {-1.0, -1.0, -1.0, -1.0};
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        const double b0 = b[4*j + i];
+        const double b1 = b[4*(gdim + j) + i];
+        const double eps = DOLFIN_EPS_LARGE*(b1 - b0);
+        d[i] = std::max(d[i], std::max((b0 - eps) - x[j], x[j] - (b1 + eps)));
+      }
+    }
+    return wide_hits(d);
+  }
+
+  // Check which of the four child bounding boxes b of a wide tree
+  // node collide with bounding box a, with a widened as in
+  // BoundingBoxTree3D::bbox_in_bbox (with a as the node)
+  template <std::size_t gdim>
+  inline unsigned int wide_bboxes_in_bbox(const double* b, const double* a)
+  {
+    double d[4] = {-1.0, -1.0, -1.0, -1.0};
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double eps = DOLFIN_EPS_LARGE*(a[gdim + j] - a[j]);
+      const double a0 = a[j] - eps;
+      const double a1 = a[gdim + j] + eps;
+      for (std::size_t i = 0; i < 4; ++i)
+        d[i] = std::max(d[i], std::max(a0 - b[4*(gdim + j) + i],
+                                       b[4*j + i] - a1));
+    }
+    return wide_hits(d);
+  }
+
+  // Check which of the four child bounding boxes b of a wide tree
+  // node collide with bounding box a, with b widened as in
+  // BoundingBoxTree3D::bbox_in_bbox (with b as the node)
+  template <std::size_t gdim>
+  inline unsigned int wide_bbox_in_bboxes(const double* a, const double* b)
+  {
+    double d[4] = {-1.0, -1.0, -1.0, -1.0};
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        const double b0 = b[4*j + i];
+        const double b1 = b[4*(gdim + j) + i];
+        const double eps = DOLFIN_EPS_LARGE*(b1 - b0);
+        d[i] = std::max(d[i], std::max((b0 - eps) - a[gdim + j],
+                                       a[j] - (b1 + eps)));
+      }
+    }
+    return wide_hits(d);
+  }
+
+  // Return area measure of bounding box used by the surface area
+  // heuristic (half the surface area in 3D, half the perimeter in 2D
+  // and the length in 1D)
+  double bbox_area(const double* b, std::size_t gdim)
+  {
+    switch (gdim)
+    {
+    case 1:
+      return b[1] - b[0];
+    case 2:
+      return (b[2] - b[0]) + (b[3] - b[1]);
+    default:
+      {
+        const double dx = b[3] - b[0];
+        const double dy = b[4] - b[1];
+        const double dz = b[5] - b[2];
+        return dx*dy + dy*dz + dz*dx;
+      }
+    }
+  }
+
+  // Initialize empty bounding box
+  void bbox_init(double* b, std::size_t gdim)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      b[j] = std::numeric_limits<double>::max();
+      b[gdim + j] = -std::numeric_limits<double>::max();
+    }
+  }
+
+  // Grow bounding box a to contain bounding box b
+  void bbox_grow(double* a, const double* b, std::size_t gdim)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      a[j] = std::min(a[j], b[j]);
+      a[gdim + j] = std::max(a[gdim + j], b[gdim + j]);
+    }
+  }
+
+  // Compute bounding box of regular entity. Boxes are computed from
+  // the single precision coordinates if available (widened to
+  // contain the entities), while collisions with entities are
+  // always computed in double precision.
+  void entity_bbox(const EntityCoordinatesView& entities, std::size_t i,
+                   double* b)
+  {
+    if (entities.has_single_precision())
+      entities.bounding_box_single(i, b, b + entities.gdim());
+    else
+      entities.bounding_box(i, b, b + entities.gdim());
+  }
+}
+
 //-----------------------------------------------------------------------------
-GenericBoundingBoxTree::GenericBoundingBoxTree() : _tdim(0)
+GenericBoundingBoxTree::GenericBoundingBoxTree()
+  : _tdim(0), _global_tree_outdated(false), _builder("median"),
+    _build_cost(0.0), _cost(0.0), _wide_offset(0)
 {
   // Do nothing
 }
@@ -67,7 +229,16 @@ GenericBoundingBoxTree::create(unsigned int gdim)
   return tree;
 }
 //-----------------------------------------------------------------------------
-void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
+void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim,
+                                   std::string builder)
+{
+  build_local_tree(mesh, tdim, builder);
+  build_global_tree(mesh.mpi_comm());
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build_local_tree(const Mesh& mesh,
+                                              std::size_t tdim,
+                                              std::string builder)
 {
   // Check dimension
   if (tdim < 1 or tdim > mesh.topology().dim())
@@ -78,6 +249,15 @@ void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
                  mesh.topology().dim());
   }
 
+  // Check builder
+  if (builder != "median" and builder != "sah")
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute bounding box tree",
+                 "Unknown builder \"%s\" (use \"median\" or \"sah\")",
+                 builder.c_str());
+  }
+
   // Clear existing data if any
   clear();
 
@@ -88,44 +268,172 @@ void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
   // Initialize entities of given dimension if they don't exist
   mesh.init(tdim);
 
-  // Create bounding boxes for all entities (leaves)
+  // Create bounding boxes for all regular entities (leaves). Ghost
+  // entities are given empty boxes at the origin.
   const std::size_t _gdim = gdim();
   const unsigned int num_leaves = mesh.num_entities(tdim);
   std::vector<double> leaf_bboxes(2*_gdim*num_leaves);
-  for (MeshEntityIterator it(mesh, tdim); !it.end(); ++it)
-    compute_bbox_of_entity(leaf_bboxes.data() + 2*_gdim*it->index(), *it, _gdim);
+  const EntityCoordinatesView entities(mesh, tdim);
+  const std::size_t num_threads = parameters["num_threads"];
+  Threads::parallel_for(entities.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+                        {
+                          for (std::size_t i = begin; i < end; ++i)
+                            entity_bbox(entities, i,
+                                        leaf_bboxes.data() + 2*_gdim*i);
+                        });
 
   // Create leaf partition (to be sorted)
   std::vector<unsigned int> leaf_partition(num_leaves);
   for (unsigned int i = 0; i < num_leaves; ++i)
     leaf_partition[i] = i;
 
-  // Recursively build the bounding box tree from the leaves
-  _build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(), _gdim);
+  // Recursively build the bounding box tree from the leaves. A tree
+  // with n leaves has 2n - 1 nodes, so the storage is allocated
+  // up front and subtrees are built in parallel.
+  if (num_leaves > 0)
+  {
+    _bboxes.resize(2*num_leaves - 1);
+    _bbox_coordinates.resize(2*_gdim*_bboxes.size());
+    _build_subtree(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(),
+                   _gdim, 0, builder == "sah",
+                   std::max(num_threads, (std::size_t) 1));
+  }
+
+  // Store builder and cost for refitting
+  _builder = builder;
+  _build_cost = compute_cost(num_threads);
+  _cost = _build_cost;
+
+  // Build wide tree for collision queries
+  build_wide_tree(num_threads);
 
   log(PROGRESS,
-      "Computed bounding box tree with %d nodes for %d entities.",
-      num_bboxes(), num_leaves);
+      "Computed bounding box tree (%s) with %d nodes for %d entities.",
+      builder.c_str(), num_bboxes(), num_leaves);
+}
+//-----------------------------------------------------------------------------
+bool GenericBoundingBoxTree::refit(const Mesh& mesh, double max_cost_ratio,
+                                   bool update_global)
+{
+  // Check that tree matches mesh
+  const unsigned int num_leaves = (num_bboxes() + 1)/2;
+  if (_tdim == 0 or _tdim > mesh.topology().dim()
+      or mesh.num_entities(_tdim) != num_leaves
+      or mesh.geometry().dim() != gdim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Tree has not been built for entities of this mesh");
+  }
+  if (num_bboxes() == 0)
+    return false;
+
+  // Subtrees are stored in a contiguous range of nodes, from its
+  // first leaf (reached by following child_0) to its root. Split the
+  // tree into a number of subtrees to be refitted in parallel, and
+  // the nodes above them.
+  const std::size_t num_threads
+    = std::max((std::size_t) parameters["num_threads"], (std::size_t) 1);
+  std::vector<unsigned int> subtrees(1, num_bboxes() - 1);
+  std::vector<unsigned int> top_nodes;
+  while (subtrees.size() < 4*num_threads and top_nodes.size() < num_leaves)
+  {
+    std::vector<unsigned int> children;
+    for (auto node : subtrees)
+    {
+      const BBox& bbox = get_bbox(node);
+      if (is_leaf(bbox, node))
+        children.push_back(node);
+      else
+      {
+        top_nodes.push_back(node);
+        children.push_back(bbox.child_0);
+        children.push_back(bbox.child_1);
+      }
+    }
+    if (children.size() == subtrees.size())
+      break;
+    subtrees.swap(children);
+  }
 
-  const std::size_t mpi_size = MPI::size(mesh.mpi_comm());
-  if (mpi_size > 1)
+  // Recompute box of leaf from entity, or of other node from its
+  // children (ghost entities keep their empty boxes)
+  const std::size_t _gdim = gdim();
+  const EntityCoordinatesView entities(mesh, _tdim);
+  auto refit_node = [&](unsigned int node)
+    {
+      const BBox& bbox = get_bbox(node);
+      double* b = _bbox_coordinates.data() + 2*_gdim*node;
+      if (is_leaf(bbox, node))
+      {
+        if (bbox.child_1 < entities.size())
+          entity_bbox(entities, bbox.child_1, b);
+      }
+      else
+      {
+        const double* b0 = get_bbox_coordinates(bbox.child_0);
+        const double* b1 = get_bbox_coordinates(bbox.child_1);
+        for (std::size_t j = 0; j < _gdim; ++j)
+        {
+          b[j] = std::min(b0[j], b1[j]);
+          b[_gdim + j] = std::max(b0[_gdim + j], b1[_gdim + j]);
+        }
+      }
+    };
+
+  // Refit subtrees in parallel, children before parents
+  Threads::parallel_for(subtrees.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+                        {
+                          for (std::size_t i = begin; i < end; ++i)
+                          {
+                            unsigned int first = subtrees[i];
+                            while (!is_leaf(get_bbox(first), first))
+                              first = get_bbox(first).child_0;
+                            for (unsigned int n = first; n <= subtrees[i]; ++n)
+                              refit_node(n);
+                          }
+                        });
+
+  // Refit nodes above subtrees, children before parents
+  std::sort(top_nodes.begin(), top_nodes.end());
+  for (auto node : top_nodes)
+    refit_node(node);
+
+  // Copy new boxes to wide tree
+  update_wide_tree(num_threads);
+
+  // Rebuild tree if its cost has grown too large
+  _cost = compute_cost(num_threads);
+  bool rebuilt = false;
+  if (cost_ratio() > max_cost_ratio)
   {
-    // Send root node coordinates to all processes
-    std::vector<double> send_bbox(_bbox_coordinates.end() - _gdim*2,
-                                  _bbox_coordinates.end());
-    std::vector<double> recv_bbox;
-    MPI::all_gather(mesh.mpi_comm(), send_bbox, recv_bbox);
-    std::vector<unsigned int> global_leaves(mpi_size);
-    for (std::size_t i = 0; i != mpi_size; ++i)
-      global_leaves[i] = i;
+    log(PROGRESS,
+        "Rebuilding bounding box tree (cost ratio %g after refit).",
+        cost_ratio());
+    build_local_tree(mesh, _tdim, _builder);
+    rebuilt = true;
+  }
 
-    _global_tree = create(_gdim);
-    _global_tree->_build(recv_bbox,
-                         global_leaves.begin(), global_leaves.end(), _gdim);
+  // Update global tree, or mark it as out of date
+  if (update_global)
+    build_global_tree(mesh.mpi_comm());
+  else if (_global_tree)
+    _global_tree_outdated = true;
 
-    info("Computed global bounding box tree with %d boxes.",
-         _global_tree->num_bboxes());
-  }
+  return rebuilt;
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::update_global_tree(MPI_Comm mpi_comm)
+{
+  if (MPI::max(mpi_comm, (std::size_t) _global_tree_outdated) > 0)
+    build_global_tree(mpi_comm);
+}
+//-----------------------------------------------------------------------------
+double GenericBoundingBoxTree::cost_ratio() const
+{
+  return _build_cost > 0.0 ? _cost/_build_cost : 1.0;
 }
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::build(const std::vector<Point>& points)
@@ -149,9 +457,16 @@ void GenericBoundingBoxTree::build(const std::vector<Point>& points)
 std::vector<unsigned int>
 GenericBoundingBoxTree::compute_collisions(const Point& point) const
 {
-  // Call recursive find function
   std::vector<unsigned int> entities;
-  _compute_collisions(*this, point, num_bboxes() - 1, entities, 0);
+  if (has_wide_tree())
+  {
+    std::vector<unsigned int> stack;
+    compute_collisions_wide(point, 0, &entities, stack);
+  }
+
+  // Call recursive find function
+  else
+    _compute_collisions(*this, point, num_bboxes() - 1, entities, 0);
 
   return entities;
 }
@@ -168,10 +483,21 @@ std::pair<std::vector<unsigned int>, std::vector<unsigned int>>
   std::vector<unsigned int> entities_A;
   std::vector<unsigned int> entities_B;
 
-  // Call recursive find function
-  _compute_collisions(A, B,
-                      A.num_bboxes() - 1, B.num_bboxes() - 1,
-                      entities_A, entities_B, 0, 0);
+  // Search wide trees if available, otherwise call recursive find
+  // function
+  const std::size_t gdim_A = A.gdim();
+  if (A.has_wide_tree() and B.has_wide_tree() and gdim_A == 2
+      and B.gdim() == 2)
+    _compute_collisions_wide<2>(A, B, entities_A, entities_B, 0, 0);
+  else if (A.has_wide_tree() and B.has_wide_tree() and gdim_A == 3
+           and B.gdim() == 3)
+    _compute_collisions_wide<3>(A, B, entities_A, entities_B, 0, 0);
+  else
+  {
+    _compute_collisions(A, B,
+                        A.num_bboxes() - 1, B.num_bboxes() - 1,
+                        entities_A, entities_B, 0, 0);
+  }
 
   return std::make_pair(entities_A, entities_B);
 }
@@ -188,9 +514,16 @@ GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
-  // Call recursive find function to compute bounding box candidates
   std::vector<unsigned int> entities;
-  _compute_collisions(*this, point, num_bboxes() - 1, entities, &mesh);
+  if (has_wide_tree())
+  {
+    std::vector<unsigned int> stack;
+    compute_collisions_wide(point, &mesh, &entities, stack);
+  }
+
+  // Call recursive find function to compute bounding box candidates
+  else
+    _compute_collisions(*this, point, num_bboxes() - 1, entities, &mesh);
 
   return entities;
 }
@@ -198,6 +531,14 @@ GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
 std::vector<unsigned int>
 GenericBoundingBoxTree::compute_process_collisions(const Point& point) const
 {
+  if (_global_tree_outdated)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute process collisions",
+                 "Global bounding box tree is out of date after refitting. "
+                 "Call Mesh::update_bounding_box_tree() first");
+  }
+
   if (_global_tree)
     return _global_tree->compute_collisions(point);
 
@@ -222,10 +563,27 @@ GenericBoundingBoxTree::compute_entity_collisions(
   std::vector<unsigned int> entities_A;
   std::vector<unsigned int> entities_B;
 
-  // Call recursive find function
-  _compute_collisions(A, B,
-                      A.num_bboxes() - 1, B.num_bboxes() - 1,
-                      entities_A, entities_B, &mesh_A, &mesh_B);
+  // Search wide trees if available, otherwise call recursive find
+  // function
+  const std::size_t gdim_A = A.gdim();
+  if (A.has_wide_tree() and B.has_wide_tree() and gdim_A == 2
+      and B.gdim() == 2)
+  {
+    _compute_collisions_wide<2>(A, B, entities_A, entities_B,
+                                &mesh_A, &mesh_B);
+  }
+  else if (A.has_wide_tree() and B.has_wide_tree() and gdim_A == 3
+           and B.gdim() == 3)
+  {
+    _compute_collisions_wide<3>(A, B, entities_A, entities_B,
+                                &mesh_A, &mesh_B);
+  }
+  else
+  {
+    _compute_collisions(A, B,
+                        A.num_bboxes() - 1, B.num_bboxes() - 1,
+                        entities_A, entities_B, &mesh_A, &mesh_B);
+  }
 
   return std::make_pair(entities_A, entities_B);
 }
@@ -233,6 +591,12 @@ GenericBoundingBoxTree::compute_entity_collisions(
 unsigned int
 GenericBoundingBoxTree::compute_first_collision(const Point& point) const
 {
+  if (has_wide_tree())
+  {
+    std::vector<unsigned int> stack;
+    return compute_collisions_wide(point, 0, 0, stack);
+  }
+
   // Call recursive find function
   return _compute_first_collision(*this, point, num_bboxes() - 1);
 }
@@ -249,13 +613,79 @@ GenericBoundingBoxTree::compute_first_entity_collision(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
+  if (has_wide_tree())
+  {
+    std::vector<unsigned int> stack;
+    return compute_collisions_wide(point, &mesh, 0, stack);
+  }
+
   // Call recursive find function
   return _compute_first_entity_collision(*this, point, num_bboxes() - 1, mesh);
 }
 //-----------------------------------------------------------------------------
+std::vector<unsigned int>
+GenericBoundingBoxTree::compute_first_entity_collisions(
+  const std::vector<Point>& points,
+  const Mesh& mesh) const
+{
+  // Point in entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute collision between points and mesh entities",
+                 "Point-in-entity is only implemented for cells");
+  }
+
+  std::vector<unsigned int>
+    entities(points.size(), std::numeric_limits<unsigned int>::max());
+  if (points.empty() or num_bboxes() == 0)
+    return entities;
+
+  // Visit points along a space-filling curve, so that consecutive
+  // queries traverse mostly the same nodes of the tree
+  const std::size_t num_threads = parameters["num_threads"];
+  const std::vector<unsigned int> order
+    = compute_point_order(points, num_threads);
+
+  // Compute collisions for contiguous chunks of the ordered points
+  Threads::parallel_for(order.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+                        {
+                          std::vector<unsigned int> stack;
+                          for (std::size_t i = begin; i < end; ++i)
+                          {
+                            const unsigned int p = order[i];
+                            entities[p]
+                              = _compute_first_entity_collision(points[p],
+                                                                mesh,
+                                                                stack);
+                          }
+                        });
+
+  return entities;
+}
+//-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
 GenericBoundingBoxTree::compute_closest_entity(const Point& point,
                                                const Mesh& mesh) const
+{
+  const std::vector<std::pair<unsigned int, double>> closest
+    = compute_closest_entities(point, 1, mesh);
+
+  // Tree is empty
+  if (closest.empty())
+  {
+    return std::pair<unsigned int, double>(std::numeric_limits<unsigned int>::max(),
+                                           std::numeric_limits<double>::infinity());
+  }
+
+  return closest[0];
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+GenericBoundingBoxTree::compute_closest_entities(const Point& point,
+                                                 std::size_t k,
+                                                 const Mesh& mesh) const
 {
   // Closest entity only implemented for cells. Consider extending this.
   if (_tdim != mesh.topology().dim())
@@ -265,32 +695,96 @@ GenericBoundingBoxTree::compute_closest_entity(const Point& point,
                  "Closest-entity is only implemented for cells");
   }
 
-  // Compute point search tree if not already done
-  build_point_search_tree(mesh);
+  std::vector<std::pair<unsigned int, double>> entities;
+  if (k == 0 or num_bboxes() == 0)
+    return entities;
 
-  // Search point cloud to get a good starting guess
-  dolfin_assert(_point_search_tree);
-  std::pair<unsigned int, double> guess
-    = _point_search_tree->compute_closest_point(point);
-  double r = guess.second;
+  // Search without bound on the distance
+  std::vector<std::pair<double, unsigned int>> queue, closest;
+  _compute_closest_entities(point, mesh, k,
+                            std::numeric_limits<double>::infinity(),
+                            queue, closest);
 
-  // Return if we have found the point
-  if (r == 0.)
-    return guess;
+  entities.reserve(closest.size());
+  for (auto& c : closest)
+    entities.push_back({c.second, std::sqrt(c.first)});
+  return entities;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+GenericBoundingBoxTree::compute_entities_within_radius(const Point& point,
+                                                       double r,
+                                                       const Mesh& mesh) const
+{
+  // Closest entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute entities within radius of point",
+                 "Closest-entity is only implemented for cells");
+  }
 
-  // Initialize index and distance to closest entity
-  unsigned int closest_entity = std::numeric_limits<unsigned int>::max();
-  double R2 = r*r;
+  std::vector<std::pair<unsigned int, double>> entities;
+  if (r < 0.0 or num_bboxes() == 0)
+    return entities;
 
-  // Call recursive find function
-  _compute_closest_entity(*this, point, num_bboxes() - 1,
-                          mesh, closest_entity, R2);
+  // Search without bound on the number of entities
+  std::vector<std::pair<double, unsigned int>> queue, closest;
+  _compute_closest_entities(point, mesh,
+                            std::numeric_limits<std::size_t>::max(), r*r,
+                            queue, closest);
 
-  // Sanity check
-  dolfin_assert(closest_entity < std::numeric_limits<unsigned int>::max());
+  entities.reserve(closest.size());
+  for (auto& c : closest)
+    entities.push_back({c.second, std::sqrt(c.first)});
+  return entities;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<unsigned int, double>>
+GenericBoundingBoxTree::compute_closest_entities(const std::vector<Point>& points,
+                                                 const Mesh& mesh) const
+{
+  // Closest entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entities of points",
+                 "Closest-entity is only implemented for cells");
+  }
 
-  std::pair<unsigned int, double> ret(closest_entity, sqrt(R2));
-  return ret;
+  std::vector<std::pair<unsigned int, double>>
+    entities(points.size(),
+             std::pair<unsigned int, double>(std::numeric_limits<unsigned int>::max(),
+                                             std::numeric_limits<double>::infinity()));
+  if (points.empty() or num_bboxes() == 0)
+    return entities;
+
+  // Visit points along a space-filling curve, so that consecutive
+  // queries traverse mostly the same nodes of the tree
+  const std::size_t num_threads = parameters["num_threads"];
+  const std::vector<unsigned int> order
+    = compute_point_order(points, num_threads);
+
+  // Compute closest entities for contiguous chunks of the ordered
+  // points
+  Threads::parallel_for(order.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+                        {
+                          std::vector<std::pair<double, unsigned int>>
+                            queue, closest;
+                          for (std::size_t i = begin; i < end; ++i)
+                          {
+                            const unsigned int p = order[i];
+                            _compute_closest_entities(points[p], mesh, 1,
+                                                      std::numeric_limits<double>::infinity(),
+                                                      queue, closest);
+                            dolfin_assert(closest.size() == 1);
+                            entities[p].first = closest[0].second;
+                            entities[p].second = std::sqrt(closest[0].first);
+                          }
+                        });
+
+  return entities;
 }
 //-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
@@ -326,7 +820,172 @@ void GenericBoundingBoxTree::clear()
   _tdim = 0;
   _bboxes.clear();
   _bbox_coordinates.clear();
-  _point_search_tree.reset();
+  _build_cost = 0.0;
+  _cost = 0.0;
+  _wide_coordinates.clear();
+  _wide_offset = 0;
+  _wide_children.clear();
+  _wide_slots.clear();
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build_global_tree(MPI_Comm mpi_comm)
+{
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  if (mpi_size > 1)
+  {
+    // Send root node coordinates to all processes
+    const std::size_t _gdim = gdim();
+    std::vector<double> send_bbox(_bbox_coordinates.end() - _gdim*2,
+                                  _bbox_coordinates.end());
+    std::vector<double> recv_bbox;
+    MPI::all_gather(mpi_comm, send_bbox, recv_bbox);
+    std::vector<unsigned int> global_leaves(mpi_size);
+    for (std::size_t i = 0; i != mpi_size; ++i)
+      global_leaves[i] = i;
+
+    _global_tree = create(_gdim);
+    _global_tree->_build(recv_bbox,
+                         global_leaves.begin(), global_leaves.end(), _gdim);
+    _global_tree->build_wide_tree(1);
+
+    info("Computed global bounding box tree with %d boxes.",
+         _global_tree->num_bboxes());
+  }
+  _global_tree_outdated = false;
+}
+//-----------------------------------------------------------------------------
+double GenericBoundingBoxTree::compute_cost(std::size_t num_threads) const
+{
+  const std::size_t _gdim = gdim();
+  if (num_bboxes() == 0)
+    return 0.0;
+  const double root_area = bbox_area(get_bbox_coordinates(num_bboxes() - 1),
+                                     _gdim);
+  if (root_area <= 0.0)
+    return 0.0;
+
+  // Sum area of non-leaf boxes over chunks of nodes
+  num_threads = std::max(num_threads, (std::size_t) 1);
+  std::vector<double> area(num_threads, 0.0);
+  Threads::parallel_for(num_bboxes(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t t)
+                        {
+                          for (std::size_t n = begin; n < end; ++n)
+                            if (!is_leaf(get_bbox(n), n))
+                              area[t] += bbox_area(get_bbox_coordinates(n),
+                                                   _gdim);
+                        });
+
+  return std::accumulate(area.begin(), area.end(), 0.0)/root_area;
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build_wide_tree(std::size_t num_threads)
+{
+  _wide_coordinates.clear();
+  _wide_offset = 0;
+  _wide_children.clear();
+  _wide_slots.clear();
+
+  const std::size_t _gdim = gdim();
+  if ((_gdim != 2 and _gdim != 3) or num_bboxes() == 0)
+    return;
+
+  // Add slot for given binary node, and create wide tree node for it
+  // unless it is a leaf
+  std::vector<unsigned int> nodes;
+  auto add_slot = [&](unsigned int node)
+    {
+      const BBox& bbox = get_bbox(node);
+      _wide_slots.push_back(node);
+      if (is_leaf(bbox, node))
+      {
+        dolfin_assert(bbox.child_1 < wide_leaf);
+        _wide_children.push_back(bbox.child_1 | wide_leaf);
+      }
+      else
+      {
+        _wide_children.push_back(nodes.size() + 1);
+        nodes.push_back(node);
+      }
+    };
+  auto add_empty_slots = [&]()
+    {
+      while (_wide_slots.size() % 4 != 0)
+      {
+        _wide_slots.push_back(wide_empty);
+        _wide_children.push_back(wide_empty);
+      }
+    };
+
+  // Create first node for root, then nodes breadth-first. The slots
+  // of each node are the grandchildren of the binary node, or its
+  // children if these are leaves.
+  add_slot(num_bboxes() - 1);
+  add_empty_slots();
+  for (std::size_t n = 0; n < nodes.size(); ++n)
+  {
+    const BBox& bbox = get_bbox(nodes[n]);
+    for (auto child : {bbox.child_0, bbox.child_1})
+    {
+      const BBox& child_bbox = get_bbox(child);
+      if (is_leaf(child_bbox, child))
+        add_slot(child);
+      else
+      {
+        add_slot(child_bbox.child_0);
+        add_slot(child_bbox.child_1);
+      }
+    }
+    add_empty_slots();
+  }
+
+  // Allocate coordinates with room for aligning the first node
+  const std::size_t num_nodes = _wide_slots.size()/4;
+  const std::size_t align = CACHE_LINE_SIZE/sizeof(double);
+  _wide_coordinates.resize(8*_gdim*num_nodes + align - 1);
+  const std::size_t misalignment
+    = reinterpret_cast<std::uintptr_t>(_wide_coordinates.data())
+    % CACHE_LINE_SIZE;
+  _wide_offset = (CACHE_LINE_SIZE - misalignment) % CACHE_LINE_SIZE
+    / sizeof(double);
+
+  update_wide_tree(num_threads);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::update_wide_tree(std::size_t num_threads)
+{
+  if (!has_wide_tree())
+    return;
+
+  const std::size_t _gdim = gdim();
+  double* wide_coordinates = _wide_coordinates.data() + _wide_offset;
+  Threads::parallel_for(_wide_slots.size()/4,
+                        std::max(num_threads, (std::size_t) 1),
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+  {
+    for (std::size_t n = begin; n < end; ++n)
+    {
+      double* b = wide_coordinates + 8*_gdim*n;
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        const unsigned int node = _wide_slots[4*n + i];
+        if (node == wide_empty)
+        {
+          for (std::size_t j = 0; j < _gdim; ++j)
+          {
+            b[4*j + i] = std::numeric_limits<double>::infinity();
+            b[4*(_gdim + j) + i] = -std::numeric_limits<double>::infinity();
+          }
+        }
+        else
+        {
+          const double* c = get_bbox_coordinates(node);
+          for (std::size_t j = 0; j < 2*_gdim; ++j)
+            b[4*j + i] = c[j];
+        }
+      }
+    }
+  });
 }
 //-----------------------------------------------------------------------------
 unsigned int
@@ -370,6 +1029,190 @@ GenericBoundingBoxTree::_build(const std::vector<double>& leaf_bboxes,
   return add_bbox(bbox, b, gdim);
 }
 //-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::_build_subtree(
+  const std::vector<double>& leaf_bboxes,
+  const std::vector<unsigned int>::iterator& begin,
+  const std::vector<unsigned int>::iterator& end,
+  std::size_t gdim,
+  unsigned int offset,
+  bool sah,
+  std::size_t num_threads)
+{
+  dolfin_assert(begin < end);
+
+  // Root of subtree is stored last
+  const unsigned int node = offset + 2*(end - begin) - 2;
+  BBox& bbox = _bboxes[node];
+  double* b = _bbox_coordinates.data() + 2*gdim*node;
+
+  // Reached leaf
+  if (end - begin == 1)
+  {
+    // Store bounding box data
+    const unsigned int entity_index = *begin;
+    const double* leaf = leaf_bboxes.data() + 2*gdim*entity_index;
+    std::copy(leaf, leaf + 2*gdim, b);
+    bbox.child_0 = node;         // child_0 == node denotes a leaf
+    bbox.child_1 = entity_index; // index of entity contained in leaf
+    return;
+  }
+
+  // Split bounding boxes into two groups by the surface area
+  // heuristic, or at the median along the longest axis (also used
+  // when the heuristic finds no split, e.g. for coinciding boxes)
+  std::vector<unsigned int>::iterator middle = begin;
+  if (sah)
+    middle = sah_split(b, leaf_bboxes, begin, end, gdim);
+  if (middle == begin)
+  {
+    std::size_t axis;
+    compute_bbox_of_bboxes(b, axis, leaf_bboxes, begin, end);
+    middle = begin + (end - begin) / 2;
+    sort_bboxes(axis, leaf_bboxes, begin, middle, end);
+  }
+
+  // Subtree of first group is stored first, followed by subtree of
+  // second group and then this node
+  const unsigned int offset_1 = offset + 2*(middle - begin) - 1;
+  bbox.child_0 = offset_1 - 1;
+  bbox.child_1 = node - 1;
+
+  // Build subtrees, the first one in a new thread if there are
+  // threads left and enough work to make it worthwhile
+  if (num_threads > 1 and end - begin > 4096)
+  {
+    std::thread thread([&]()
+                       {
+                         _build_subtree(leaf_bboxes, begin, middle, gdim,
+                                        offset, sah, num_threads/2);
+                       });
+    _build_subtree(leaf_bboxes, middle, end, gdim, offset_1, sah,
+                   num_threads - num_threads/2);
+    thread.join();
+  }
+  else
+  {
+    _build_subtree(leaf_bboxes, begin, middle, gdim, offset, sah, 1);
+    _build_subtree(leaf_bboxes, middle, end, gdim, offset_1, sah, 1);
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<unsigned int>::iterator
+GenericBoundingBoxTree::sah_split(double* bbox,
+                                  const std::vector<double>& leaf_bboxes,
+                                  const std::vector<unsigned int>::iterator& begin,
+                                  const std::vector<unsigned int>::iterator& end,
+                                  std::size_t gdim) const
+{
+  // Compute bounding box of bounding boxes, and range of their
+  // midpoints (stored as sum of lower and upper corner)
+  double cmin[3], cmax[3];
+  bbox_init(bbox, gdim);
+  for (std::size_t j = 0; j < gdim; ++j)
+  {
+    cmin[j] = std::numeric_limits<double>::max();
+    cmax[j] = -std::numeric_limits<double>::max();
+  }
+  for (auto it = begin; it != end; ++it)
+  {
+    const double* b = leaf_bboxes.data() + 2*gdim*(*it);
+    bbox_grow(bbox, b, gdim);
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double c = b[j] + b[gdim + j];
+      cmin[j] = std::min(cmin[j], c);
+      cmax[j] = std::max(cmax[j], c);
+    }
+  }
+
+  // Bin index of box along axis (axes with no extent are skipped)
+  double scale[3];
+  for (std::size_t j = 0; j < gdim; ++j)
+    scale[j] = cmax[j] > cmin[j] ? SAH_NUM_BINS/(cmax[j] - cmin[j]) : 0.0;
+  auto bin = [&](const double* b, std::size_t j)
+    {
+      const std::size_t k = (b[j] + b[gdim + j] - cmin[j])*scale[j];
+      return std::min(k, (std::size_t) SAH_NUM_BINS - 1);
+    };
+
+  // Count boxes and compute bounding box of boxes in each bin
+  std::size_t bin_count[3][SAH_NUM_BINS] = {};
+  double bin_bbox[3][SAH_NUM_BINS][MAX_DIM];
+  for (std::size_t j = 0; j < gdim; ++j)
+    for (std::size_t k = 0; k < SAH_NUM_BINS; ++k)
+      bbox_init(bin_bbox[j][k], gdim);
+  for (auto it = begin; it != end; ++it)
+  {
+    const double* b = leaf_bboxes.data() + 2*gdim*(*it);
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      if (scale[j] == 0.0)
+        continue;
+      const std::size_t k = bin(b, j);
+      ++bin_count[j][k];
+      bbox_grow(bin_bbox[j][k], b, gdim);
+    }
+  }
+
+  // Find split between bins with lowest cost, where the cost of a
+  // split is the sum of the area times the number of boxes for each
+  // side. Sweep from the right to get area and count of the right
+  // side, then from the left to evaluate the cost.
+  double best_cost = std::numeric_limits<double>::max();
+  std::size_t best_axis = gdim;
+  std::size_t best_bin = 0;
+  for (std::size_t j = 0; j < gdim; ++j)
+  {
+    if (scale[j] == 0.0)
+      continue;
+
+    double right_area[SAH_NUM_BINS];
+    std::size_t right_count[SAH_NUM_BINS];
+    double b[MAX_DIM];
+    std::size_t n = 0;
+    bbox_init(b, gdim);
+    for (std::size_t k = SAH_NUM_BINS - 1; k > 0; --k)
+    {
+      if (bin_count[j][k] > 0)
+        bbox_grow(b, bin_bbox[j][k], gdim);
+      n += bin_count[j][k];
+      right_area[k] = n > 0 ? bbox_area(b, gdim) : 0.0;
+      right_count[k] = n;
+    }
+
+    n = 0;
+    bbox_init(b, gdim);
+    for (std::size_t k = 0; k < SAH_NUM_BINS - 1; ++k)
+    {
+      if (bin_count[j][k] > 0)
+        bbox_grow(b, bin_bbox[j][k], gdim);
+      n += bin_count[j][k];
+      if (n == 0 or right_count[k + 1] == 0)
+        continue;
+      const double cost = bbox_area(b, gdim)*n
+        + right_area[k + 1]*right_count[k + 1];
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        best_axis = j;
+        best_bin = k;
+      }
+    }
+  }
+
+  // No split found
+  if (best_axis == gdim)
+    return begin;
+
+  // Partition boxes by the best split
+  return std::partition(begin, end,
+                        [&](unsigned int i)
+                        {
+                          const double* b = leaf_bboxes.data() + 2*gdim*i;
+                          return bin(b, best_axis) <= best_bin;
+                        });
+}
+//-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::_build(const std::vector<Point>& points,
                                const std::vector<unsigned int>::iterator& begin,
@@ -628,45 +1471,263 @@ GenericBoundingBoxTree::_compute_first_entity_collision(const GenericBoundingBox
   return not_found;
 }
 //-----------------------------------------------------------------------------
+unsigned int
+GenericBoundingBoxTree::_compute_first_entity_collision(
+  const Point& point,
+  const Mesh& mesh,
+  std::vector<unsigned int>& stack) const
+{
+  dolfin_assert(_tdim == mesh.topology().dim());
+  if (has_wide_tree())
+    return compute_collisions_wide(point, &mesh, 0, stack);
+
+  // Visit nodes depth-first, with the first child before the second
+  stack.clear();
+  stack.push_back(num_bboxes() - 1);
+  while (!stack.empty())
+  {
+    const unsigned int node = stack.back();
+    stack.pop_back();
+
+    // If point is not in bounding box, then don't search further
+    if (!point_in_bbox(point.coordinates(), node))
+      continue;
+
+    // If box is a leaf (which we know contains the point), then check
+    // entity (child_1 denotes entity index for leaves)
+    const BBox& bbox = get_bbox(node);
+    if (is_leaf(bbox, node))
+    {
+      const Cell cell(mesh, bbox.child_1);
+      if (cell.collides(point))
+        return bbox.child_1;
+    }
+    else
+    {
+      stack.push_back(bbox.child_1);
+      stack.push_back(bbox.child_0);
+    }
+  }
+
+  // Point not found
+  return std::numeric_limits<unsigned int>::max();
+}
+//-----------------------------------------------------------------------------
+unsigned int
+GenericBoundingBoxTree::compute_collisions_wide(
+  const Point& point,
+  const Mesh* mesh,
+  std::vector<unsigned int>* entities,
+  std::vector<unsigned int>& stack) const
+{
+  if (gdim() == 2)
+    return _compute_collisions_wide<2>(point, mesh, entities, stack);
+  return _compute_collisions_wide<3>(point, mesh, entities, stack);
+}
+//-----------------------------------------------------------------------------
+template <std::size_t gdim>
+unsigned int
+GenericBoundingBoxTree::_compute_collisions_wide(
+  const Point& point,
+  const Mesh* mesh,
+  std::vector<unsigned int>* entities,
+  std::vector<unsigned int>& stack) const
+{
+  dolfin_assert(has_wide_tree());
+  const double* x = point.coordinates();
+  const double* wide_coordinates = _wide_coordinates.data() + _wide_offset;
+
+  // Visit children depth-first, in the order of the binary tree. The
+  // boxes of the binary nodes between a wide tree node and its
+  // children contain the child boxes, so they need not be checked.
+  stack.clear();
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const unsigned int child = stack.back();
+    stack.pop_back();
+
+    // Check entity of leaf (which we know contains the point)
+    if (child & wide_leaf)
+    {
+      const unsigned int entity_index = child & ~wide_leaf;
+      if (!mesh or Cell(*mesh, entity_index).collides(point))
+      {
+        if (!entities)
+          return entity_index;
+        entities->push_back(entity_index);
+      }
+      continue;
+    }
+
+    // Add children which contain the point, first child on top
+    const unsigned int hits
+      = wide_point_in_bboxes<gdim>(wide_coordinates + 8*gdim*child, x);
+    for (std::size_t i = 4; i-- > 0;)
+      if (hits & (1u << i))
+        stack.push_back(_wide_children[4*child + i]);
+  }
+
+  // Point not found
+  return std::numeric_limits<unsigned int>::max();
+}
+//-----------------------------------------------------------------------------
+template <std::size_t gdim>
 void
-GenericBoundingBoxTree::_compute_closest_entity(const GenericBoundingBoxTree& tree,
-                                                const Point& point,
-                                                unsigned int node,
-                                                const Mesh& mesh,
-                                                unsigned int& closest_entity,
-                                                double& R2)
+GenericBoundingBoxTree::_compute_collisions_wide(
+  const GenericBoundingBoxTree& A,
+  const GenericBoundingBoxTree& B,
+  std::vector<unsigned int>& entities_A,
+  std::vector<unsigned int>& entities_B,
+  const Mesh* mesh_A,
+  const Mesh* mesh_B)
 {
-  // Get bounding box for current node
-  const BBox& bbox = tree.get_bbox(node);
+  dolfin_assert(A.has_wide_tree() and B.has_wide_tree());
+  const double* wide_coordinates_A = A._wide_coordinates.data() + A._wide_offset;
+  const double* wide_coordinates_B = B._wide_coordinates.data() + B._wide_offset;
 
-  // If bounding box is outside radius, then don't search further
-  const double r2 = tree.compute_squared_distance_bbox(point.coordinates(), node);
-  if (r2 > R2)
+  // If root bounding boxes don't collide, then don't search further
+  if (!B.bbox_in_bbox(A.get_bbox_coordinates(A.num_bboxes() - 1),
+                      B.num_bboxes() - 1))
+  {
     return;
+  }
 
-  // If box is leaf (which we know is inside radius), then shrink radius
-  else if (tree.is_leaf(bbox, node))
+  // Visit pairs of colliding slots depth-first, starting from the
+  // slots of the roots
+  std::vector<std::pair<unsigned int, unsigned int>> stack(1, {0, 0});
+  double a[2*gdim];
+  while (!stack.empty())
   {
-    // Get entity (child_1 denotes entity index for leaves)
-    dolfin_assert(tree._tdim == mesh.topology().dim());
-    const unsigned int entity_index = bbox.child_1;
-    Cell cell(mesh, entity_index);
+    const unsigned int slot_A = stack.back().first;
+    const unsigned int slot_B = stack.back().second;
+    stack.pop_back();
 
-    // If entity is closer than best result so far, then return it
-    const double r2 = cell.squared_distance(point);
-    if (r2 < R2)
+    const unsigned int child_A = A._wide_children[slot_A];
+    const unsigned int child_B = B._wide_children[slot_B];
+    const bool is_leaf_A = child_A & wide_leaf;
+    const bool is_leaf_B = child_B & wide_leaf;
+
+    // If both are leaves (which we know collide), then add them
+    if (is_leaf_A and is_leaf_B)
     {
-      closest_entity = entity_index;
-      R2 = r2;
+      const unsigned int entity_index_A = child_A & ~wide_leaf;
+      const unsigned int entity_index_B = child_B & ~wide_leaf;
+
+      // If we have a mesh, check that the candidate is really a collision
+      if (mesh_A)
+      {
+        dolfin_assert(mesh_B);
+        Cell cell_A(*mesh_A, entity_index_A);
+        Cell cell_B(*mesh_B, entity_index_B);
+        if (!cell_A.collides(cell_B))
+          continue;
+      }
+      entities_A.push_back(entity_index_A);
+      entities_B.push_back(entity_index_B);
     }
-  }
 
-  // Check both children
-  else
+    // Descend A if B is a leaf, or if neither is a leaf and the node
+    // in A is higher in its binary tree (as for the binary trees)
+    else if (is_leaf_B
+             or (!is_leaf_A and A._wide_slots[slot_A] > B._wide_slots[slot_B]))
+    {
+      wide_bbox<gdim>(a, wide_coordinates_B + 8*gdim*(slot_B/4), slot_B % 4);
+      const unsigned int hits
+        = wide_bboxes_in_bbox<gdim>(wide_coordinates_A + 8*gdim*child_A, a);
+      for (std::size_t i = 4; i-- > 0;)
+        if (hits & (1u << i))
+          stack.push_back({4*child_A + i, slot_B});
+    }
+
+    // Otherwise descend B
+    else
+    {
+      wide_bbox<gdim>(a, wide_coordinates_A + 8*gdim*(slot_A/4), slot_A % 4);
+      const unsigned int hits
+        = wide_bbox_in_bboxes<gdim>(a, wide_coordinates_B + 8*gdim*child_B);
+      for (std::size_t i = 4; i-- > 0;)
+        if (hits & (1u << i))
+          stack.push_back({slot_A, 4*child_B + i});
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::_compute_closest_entities(
+  const Point& point,
+  const Mesh& mesh,
+  std::size_t k,
+  double R2,
+  std::vector<std::pair<double, unsigned int>>& queue,
+  std::vector<std::pair<double, unsigned int>>& closest) const
+{
+  dolfin_assert(k > 0);
+  dolfin_assert(_tdim == mesh.topology().dim());
+  const double* x = point.coordinates();
+
+  // The queue is a min-heap of nodes and the closest entities found
+  // so far are kept in a max-heap, so that the entity to be replaced
+  // is at the front. Pairs are ordered by squared distance and then
+  // by index, which makes the result independent of the traversal
+  // order when several entities are at the same distance.
+  const std::greater<std::pair<double, unsigned int>> nearest_first;
+  queue.clear();
+  closest.clear();
+  const unsigned int root = num_bboxes() - 1;
+  queue.push_back({compute_squared_distance_bbox(x, root), root});
+
+  while (!queue.empty())
   {
-    _compute_closest_entity(tree, point, bbox.child_0, mesh, closest_entity, R2);
-    _compute_closest_entity(tree, point, bbox.child_1, mesh, closest_entity, R2);
+    // Get node closest to point. Nodes are visited in order of their
+    // distance, so all remaining nodes are outside the radius if
+    // this one is.
+    std::pop_heap(queue.begin(), queue.end(), nearest_first);
+    const std::pair<double, unsigned int> top = queue.back();
+    queue.pop_back();
+    if (top.first > R2)
+      break;
+
+    const unsigned int node = top.second;
+    const BBox& bbox = _bboxes[node];
+    if (is_leaf(bbox, node))
+    {
+      // Get entity (child_1 denotes entity index for leaves)
+      const unsigned int entity_index = bbox.child_1;
+      const Cell cell(mesh, entity_index);
+      const double r2 = cell.squared_distance(point);
+      if (r2 > R2)
+        continue;
+
+      // Add entity and drop the farthest one if we have more than k
+      closest.push_back({r2, entity_index});
+      std::push_heap(closest.begin(), closest.end());
+      if (closest.size() > k)
+      {
+        std::pop_heap(closest.begin(), closest.end());
+        closest.pop_back();
+      }
+
+      // Shrink radius to the farthest of the k closest entities
+      if (closest.size() == k)
+        R2 = closest.front().first;
+    }
+    else
+    {
+      // Add children inside radius to queue
+      for (const unsigned int child : {bbox.child_0, bbox.child_1})
+      {
+        const double r2 = compute_squared_distance_bbox(x, child);
+        if (r2 <= R2)
+        {
+          queue.push_back({r2, child});
+          std::push_heap(queue.begin(), queue.end(), nearest_first);
+        }
+      }
+    }
   }
+
+  // Sort result by distance
+  std::sort_heap(closest.begin(), closest.end());
 }
 //-----------------------------------------------------------------------------
 void
@@ -704,55 +1765,50 @@ GenericBoundingBoxTree::_compute_closest_point(const GenericBoundingBoxTree& tre
   }
 }
 //-----------------------------------------------------------------------------
-void GenericBoundingBoxTree::build_point_search_tree(const Mesh& mesh) const
-{
-  // Don't build search tree if it already exists
-  if (_point_search_tree)
-    return;
-  info("Building point search tree to accelerate distance queries.");
-
-  // Create list of midpoints for all cells
-  std::vector<Point> points;
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
-    points.push_back(cell->midpoint());
-
-  // Select implementation
-  _point_search_tree = create(mesh.geometry().dim());
-
-  // Build tree
-  dolfin_assert(_point_search_tree);
-  _point_search_tree->build(points);
-}
-//-----------------------------------------------------------------------------
-void GenericBoundingBoxTree::compute_bbox_of_entity(double* b,
-                                                    const MeshEntity& entity,
-                                                    std::size_t gdim) const
+std::vector<unsigned int>
+GenericBoundingBoxTree::compute_point_order(const std::vector<Point>& points,
+                                            std::size_t num_threads) const
 {
-  // Get bounding box coordinates
-  double* xmin = b;
-  double* xmax = b + gdim;
-
-  // Get mesh entity data
-  const MeshGeometry& geometry = entity.mesh().geometry();
-  const size_t num_vertices = entity.num_entities(0);
-  const unsigned int* vertices = entity.entities(0);
-  dolfin_assert(num_vertices >= 2);
-
-  // Get coordinates for first vertex
-  const double* x = geometry.x(vertices[0]);
-  for (std::size_t j = 0; j < gdim; ++j)
-    xmin[j] = xmax[j] = x[j];
-
-  // Compute min and max over remaining vertices
-  for (unsigned int i = 1; i < num_vertices; ++i)
-  {
-    const double* x = geometry.x(vertices[i]);
-    for (std::size_t j = 0; j < gdim; ++j)
-    {
-      xmin[j] = std::min(xmin[j], x[j]);
-      xmax[j] = std::max(xmax[j], x[j]);
-    }
-  }
+  // Quantize coordinates relative to the root bounding box (points
+  // outside the box are moved to its boundary) and interleave their
+  // bits to a Morton code of at most 30 bits
+  const std::size_t _gdim = gdim();
+  const unsigned int bits = 30/_gdim;
+  const double max_q = (1u << bits) - 1;
+  const double* b = get_bbox_coordinates(num_bboxes() - 1);
+  double scale[3];
+  for (std::size_t j = 0; j < _gdim; ++j)
+    scale[j] = b[_gdim + j] > b[j] ? max_q/(b[_gdim + j] - b[j]) : 0.0;
+
+  std::vector<std::uint32_t> codes(points.size());
+  Threads::parallel_for(points.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+                        {
+                          for (std::size_t i = begin; i < end; ++i)
+                          {
+                            const double* x = points[i].coordinates();
+                            std::uint32_t q[3];
+                            for (std::size_t j = 0; j < _gdim; ++j)
+                            {
+                              const double s = (x[j] - b[j])*scale[j];
+                              q[j] = std::min(std::max(s, 0.0), max_q);
+                            }
+                            std::uint32_t code = 0;
+                            for (unsigned int k = 0; k < bits; ++k)
+                              for (std::size_t j = 0; j < _gdim; ++j)
+                                code |= ((q[j] >> k) & 1) << (k*_gdim + j);
+                            codes[i] = code;
+                          }
+                        });
+
+  // Sort points by code
+  std::vector<unsigned int> order(points.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  RadixSort::sort(order, [&codes](unsigned int i) { return codes[i]; },
+                  (1u << (bits*_gdim)) - 1, num_threads);
+
+  return order;
 }
 //-----------------------------------------------------------------------------
 void
@@ -775,6 +1831,18 @@ GenericBoundingBoxTree::sort_points(std::size_t axis,
   }
 }
 //-----------------------------------------------------------------------------
+std::size_t GenericBoundingBoxTree::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(_bboxes)
+    + dolfin::memory_usage(_bbox_coordinates)
+    + dolfin::memory_usage(_wide_coordinates)
+    + dolfin::memory_usage(_wide_children)
+    + dolfin::memory_usage(_wide_slots);
+  if (_global_tree)
+    bytes += _global_tree->memory_usage();
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string GenericBoundingBoxTree::str(bool verbose)
 {
   std::stringstream s;
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2013-04-23
-// Last changed: 2014-02-06
+// Last changed: 2019-06-18
 
 #ifndef __GENERIC_BOUNDING_BOX_TREE_H
 #define __GENERIC_BOUNDING_BOX_TREE_H
@@ -24,13 +24,16 @@
 #include <memory>
 #include <sstream>
 #include <set>
+#include <string>
 #include <vector>
+#include <dolfin/common/MPI.h>
 #include <dolfin/geometry/Point.h>
 
 namespace dolfin
 {
 
   // Forward declarations
+  class HDF5File;
   class Mesh;
   class MeshEntity;
 
@@ -50,12 +53,33 @@ namespace dolfin
     /// Factory function returning (empty) tree of appropriate dimension
     static std::shared_ptr<GenericBoundingBoxTree> create(unsigned int dim);
 
-    /// Build bounding box tree for mesh entities of given dimension
-    void build(const Mesh& mesh, std::size_t tdim);
+    /// Build bounding box tree for mesh entities of given dimension.
+    /// The builder is either "median" (split at the median along the
+    /// longest axis) or "sah" (binned surface area heuristic).
+    void build(const Mesh& mesh, std::size_t tdim,
+               std::string builder="median");
 
     /// Build bounding box tree for point cloud
     void build(const std::vector<Point>& points);
 
+    /// Recompute the bounding boxes of a tree built for mesh entities
+    /// after the mesh coordinates have changed, keeping the tree
+    /// structure. The tree is rebuilt if cost_ratio() exceeds
+    /// max_cost_ratio after the refit. Returns true if rebuilt. The
+    /// global tree is updated (collective) if update_global is true,
+    /// otherwise it is marked as out of date.
+    bool refit(const Mesh& mesh, double max_cost_ratio,
+               bool update_global=true);
+
+    /// Rebuild the global tree if it is out of date on any process
+    /// (collective)
+    void update_global_tree(MPI_Comm mpi_comm);
+
+    /// Return ratio between the surface area heuristic cost of the
+    /// tree and its cost when it was built (grows as boxes overlap
+    /// more after refitting)
+    double cost_ratio() const;
+
     /// Compute all collisions between bounding boxes and _Point_
     std::vector<unsigned int>
     compute_collisions(const Point& point) const;
@@ -85,18 +109,49 @@ namespace dolfin
     unsigned int compute_first_entity_collision(const Point& point,
                                               const Mesh& mesh) const;
 
+    /// Compute first collision between entities and each of the
+    /// points (batched, in parallel)
+    std::vector<unsigned int>
+    compute_first_entity_collisions(const std::vector<Point>& points,
+                                    const Mesh& mesh) const;
+
     /// Compute closest entity and distance to _Point_
     std::pair<unsigned int, double> compute_closest_entity(const Point& point,
                                                            const Mesh& mesh) const;
 
+    /// Compute the k closest entities and their distances to _Point_,
+    /// sorted by distance
+    std::vector<std::pair<unsigned int, double>>
+    compute_closest_entities(const Point& point, std::size_t k,
+                             const Mesh& mesh) const;
+
+    /// Compute all entities within distance r of _Point_ and their
+    /// distances, sorted by distance
+    std::vector<std::pair<unsigned int, double>>
+    compute_entities_within_radius(const Point& point, double r,
+                                   const Mesh& mesh) const;
+
+    /// Compute closest entity and distance to each of the points
+    /// (batched, in parallel)
+    std::vector<std::pair<unsigned int, double>>
+    compute_closest_entities(const std::vector<Point>& points,
+                             const Mesh& mesh) const;
+
     /// Compute closest point and distance to _Point_
     std::pair<unsigned int, double> compute_closest_point(const Point& point) const;
 
     /// Print out for debugging
     std::string str(bool verbose=false);
 
+    /// Return number of bytes allocated for the tree, including the
+    /// global tree if built
+    std::size_t memory_usage() const;
+
   protected:
 
+    // Friends (for reading and writing the node arrays)
+    friend class HDF5File;
+
     /// Bounding box data. Leaf nodes are indicated by setting child_0
     /// equal to the node itself. For leaf nodes, child_1 is set to the
     /// index of the entity contained in the leaf bounding box.
@@ -117,15 +172,63 @@ namespace dolfin
     /// List of bounding box coordinates
     std::vector<double> _bbox_coordinates;
 
-    /// Point search tree used to accelerate distance queries
-    mutable std::shared_ptr<GenericBoundingBoxTree> _point_search_tree;
-
     /// Global tree for mesh ownership of each process (same on all processes)
     std::shared_ptr<GenericBoundingBoxTree> _global_tree;
 
+    /// True if the tree has been refitted or rebuilt since the global
+    /// tree was built
+    bool _global_tree_outdated;
+
+    /// Builder used to build the tree ("median" or "sah")
+    std::string _builder;
+
+    /// Cost of tree when built and after last refit (see cost_ratio)
+    double _build_cost;
+    double _cost;
+
+    /// Wide tree used for collision queries for mesh entities in 2D
+    /// and 3D. Each node has four child slots, filled by collapsing
+    /// two levels of the binary tree (keeping the order of the
+    /// leaves). The first node only holds the root of the binary
+    /// tree. The bounding boxes of the four slots of a node are
+    /// stored axis by axis (the lower bounds along each axis followed
+    /// by the upper bounds), so that a point or box is tested against
+    /// all four with a few short loops which the compiler vectorizes.
+    /// The 8*gdim coordinates of a node fill whole cache lines, and
+    /// the nodes start at _wide_offset to align them with cache
+    /// lines. Unused slots have empty (inverted) boxes.
+    std::vector<double> _wide_coordinates;
+    std::size_t _wide_offset;
+
+    /// Child in each slot of the wide tree: the entity with the
+    /// highest bit set for leaves, otherwise a wide tree node
+    std::vector<unsigned int> _wide_children;
+
+    /// Node of the binary tree in each slot of the wide tree
+    std::vector<unsigned int> _wide_slots;
+
     /// Clear existing data if any
     void clear();
 
+    /// Build bounding box tree for mesh entities of given dimension
+    /// on this process, without the global tree
+    void build_local_tree(const Mesh& mesh, std::size_t tdim,
+                          std::string builder);
+
+    /// Build global tree from the root bounding boxes of all
+    /// processes (collective)
+    void build_global_tree(MPI_Comm mpi_comm);
+
+    /// Compute surface area heuristic cost of tree, the total area of
+    /// the non-leaf bounding boxes relative to the root box
+    double compute_cost(std::size_t num_threads) const;
+
+    /// Build wide tree from the binary tree (2D and 3D only)
+    void build_wide_tree(std::size_t num_threads);
+
+    /// Copy bounding boxes from the binary tree to the wide tree
+    void update_wide_tree(std::size_t num_threads);
+
     //--- Recursive build functions ---
 
     /// Build bounding box tree for entities (recursive)
@@ -134,6 +237,30 @@ namespace dolfin
                         const std::vector<unsigned int>::iterator& end,
                         std::size_t gdim);
 
+    /// Build bounding box tree for entities into preallocated
+    /// storage (recursive). The subtree for n leaves is stored in the
+    /// 2n - 1 nodes starting at offset, with its root last, which is
+    /// the same layout as for the serial build. Subtrees are built
+    /// concurrently when num_threads > 1.
+    void _build_subtree(const std::vector<double>& leaf_bboxes,
+                        const std::vector<unsigned int>::iterator& begin,
+                        const std::vector<unsigned int>::iterator& end,
+                        std::size_t gdim,
+                        unsigned int offset,
+                        bool sah,
+                        std::size_t num_threads);
+
+    /// Partition leaf bounding boxes by the split with the lowest
+    /// cost according to the binned surface area heuristic, and
+    /// return the split point. Computes the bounding box of all
+    /// leaves. Returns begin if no split could be found.
+    std::vector<unsigned int>::iterator
+    sah_split(double* bbox,
+              const std::vector<double>& leaf_bboxes,
+              const std::vector<unsigned int>::iterator& begin,
+              const std::vector<unsigned int>::iterator& end,
+              std::size_t gdim) const;
+
     /// Build bounding box tree for points (recursive)
     unsigned int _build(const std::vector<Point>& points,
                         const std::vector<unsigned int>::iterator& begin,
@@ -177,13 +304,59 @@ namespace dolfin
                                     unsigned int node,
                                     const Mesh& mesh);
 
-    // Compute closest entity (recursive)
-    static void _compute_closest_entity(const GenericBoundingBoxTree& tree,
-                                        const Point& point,
-                                        unsigned int node,
-                                        const Mesh& mesh,
-                                        unsigned int& closest_entity,
-                                        double& R2);
+    // Compute first entity collision (non-recursive, traversing the
+    // tree with the given stack in the same order as the recursive
+    // version)
+    unsigned int
+    _compute_first_entity_collision(const Point& point,
+                                    const Mesh& mesh,
+                                    std::vector<unsigned int>& stack) const;
+
+    //--- Search functions for the wide tree ---
+
+    // Compute collisions with point (non-recursive, using the given
+    // stack). Entities are checked exactly if a mesh is given. If
+    // entities is null, the first collision is returned, otherwise
+    // all collisions are added to entities (in the same order as for
+    // the binary tree).
+    unsigned int
+    compute_collisions_wide(const Point& point,
+                            const Mesh* mesh,
+                            std::vector<unsigned int>* entities,
+                            std::vector<unsigned int>& stack) const;
+
+    // Implementation of compute_collisions_wide for given dimension
+    template <std::size_t gdim>
+    unsigned int
+    _compute_collisions_wide(const Point& point,
+                             const Mesh* mesh,
+                             std::vector<unsigned int>* entities,
+                             std::vector<unsigned int>& stack) const;
+
+    // Compute collisions with tree (non-recursive, in a different
+    // order than for the binary trees). Both trees must have wide
+    // trees of the given dimension.
+    template <std::size_t gdim>
+    static void
+    _compute_collisions_wide(const GenericBoundingBoxTree& A,
+                             const GenericBoundingBoxTree& B,
+                             std::vector<unsigned int>& entities_A,
+                             std::vector<unsigned int>& entities_B,
+                             const Mesh* mesh_A,
+                             const Mesh* mesh_B);
+
+    // Compute the (at most) k closest entities with squared distance
+    // at most R2 (best-first, non-recursive). The nodes are visited
+    // in order of their distance to the point, using queue as a
+    // priority queue. The result is returned in closest as pairs of
+    // squared distance and entity, sorted by distance and then by
+    // entity index.
+    void _compute_closest_entities(const Point& point,
+                                   const Mesh& mesh,
+                                   std::size_t k,
+                                   double R2,
+                                   std::vector<std::pair<double, unsigned int>>& queue,
+                                   std::vector<std::pair<double, unsigned int>>& closest) const;
 
     // Compute closest point (recursive)
     static void
@@ -195,13 +368,11 @@ namespace dolfin
 
     //--- Utility functions ---
 
-    /// Compute point search tree if not already done
-    void build_point_search_tree(const Mesh& mesh) const;
-
-    /// Compute bounding box of mesh entity
-    void compute_bbox_of_entity(double* b,
-                                const MeshEntity& entity,
-                                std::size_t gdim) const;
+    /// Return order of points along a space-filling (Morton) curve
+    /// through the root bounding box, computed in parallel
+    std::vector<unsigned int>
+    compute_point_order(const std::vector<Point>& points,
+                        std::size_t num_threads) const;
 
     /// Sort points along given axis
     void sort_points(std::size_t axis,
@@ -237,6 +408,12 @@ namespace dolfin
       return _bboxes.size();
     }
 
+    /// Check whether the wide tree has been built
+    inline bool has_wide_tree() const
+    {
+      return !_wide_slots.empty();
+    }
+
     /// Add bounding box and point coordinates
     inline unsigned int add_point(const BBox& bbox,
                                   const Point& point,
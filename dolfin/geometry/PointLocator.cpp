@@ -0,0 +1,341 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <memory>
+#include <dolfin/common/Timer.h>
+#include <dolfin/mesh/Mesh.h>
+#include "BoundingBoxTree.h"
+#include "PointLocator.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Scale sizes or offsets by block size and add shift
+  std::vector<int> scale(const std::vector<int>& a, std::size_t block_size,
+                         std::size_t shift=0)
+  {
+    std::vector<int> b(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+      b[i] = block_size*a[i] + shift;
+    return b;
+  }
+
+  #ifdef HAS_MPI
+  // Create distributed graph communicator in which this process
+  // receives from sources and sends to destinations
+  MPI_Comm create_graph(MPI_Comm mpi_comm, const std::vector<int>& sources,
+                        const std::vector<int>& destinations)
+  {
+    MPI_Comm comm;
+    MPI_Dist_graph_create_adjacent(mpi_comm,
+                                   sources.size(), sources.data(),
+                                   MPI_UNWEIGHTED,
+                                   destinations.size(), destinations.data(),
+                                   MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                   &comm);
+    return comm;
+  }
+  #endif
+}
+
+//-----------------------------------------------------------------------------
+PointLocator::PointLocator(const Mesh& mesh, const std::vector<Point>& points)
+  : _points(points), _owners(points.size(), -1), _num_local(0),
+    _forward_comm(MPI_COMM_NULL), _reverse_comm(MPI_COMM_NULL)
+{
+  Timer timer("Locate points");
+
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const int rank = MPI::rank(mpi_comm);
+  mesh.update_bounding_box_tree();
+  const std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  // Locate points in cells of this process
+  const std::vector<unsigned int> cells
+    = tree->compute_first_entity_collisions(points);
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    if (cells[i] != not_found)
+      _owners[i] = rank;
+  }
+
+  // Query points (grouped by candidate process) that were sent to
+  // other processes and whether the candidate was selected as owner
+  std::vector<int> candidate_processes, candidate_sizes;
+  std::vector<std::size_t> candidate_indices;
+  std::vector<int> selected;
+
+  // Points received from other processes (grouped by querying
+  // process), the cells containing them and whether this process
+  // was selected as owner
+  std::vector<int> source_processes, source_sizes;
+  std::vector<double> recv_points;
+  std::vector<unsigned int> recv_cells;
+  std::vector<int> owned;
+
+  #ifdef HAS_MPI
+  if (num_processes > 1)
+  {
+    // Find other processes whose bounding box contains the
+    // points. Points found on this process only need to be checked
+    // on lower ranked processes.
+    std::vector<std::vector<std::size_t>> candidates(num_processes);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      for (auto p : tree->compute_process_collisions(points[i]))
+      {
+        if ((int) p < rank or ((int) p > rank and cells[i] == not_found))
+          candidates[p].push_back(i);
+      }
+    }
+
+    // Tell each process how many points it will receive
+    std::vector<std::vector<std::size_t>> send_counts(num_processes);
+    std::vector<std::vector<std::size_t>> recv_counts;
+    std::vector<int> candidate_offsets;
+    for (std::size_t p = 0; p < num_processes; ++p)
+    {
+      if (candidates[p].empty())
+        continue;
+      send_counts[p].push_back(candidates[p].size());
+      candidate_processes.push_back(p);
+      candidate_offsets.push_back(candidate_indices.size());
+      candidate_sizes.push_back(candidates[p].size());
+      candidate_indices.insert(candidate_indices.end(),
+                               candidates[p].begin(), candidates[p].end());
+    }
+    MPI::all_to_all(mpi_comm, send_counts, recv_counts);
+
+    std::vector<int> source_offsets;
+    std::size_t num_recv = 0;
+    for (std::size_t p = 0; p < num_processes; ++p)
+    {
+      if (recv_counts[p].empty())
+        continue;
+      source_processes.push_back(p);
+      source_offsets.push_back(num_recv);
+      source_sizes.push_back(recv_counts[p][0]);
+      num_recv += recv_counts[p][0];
+    }
+
+    // Create graph communicators between querying and candidate
+    // processes
+    MPI_Comm forward_comm = create_graph(mpi_comm, source_processes,
+                                         candidate_processes);
+    MPI_Comm reverse_comm = create_graph(mpi_comm, candidate_processes,
+                                         source_processes);
+
+    // Send points to candidate processes
+    std::vector<double> send_points;
+    send_points.reserve(3*candidate_indices.size());
+    for (auto i : candidate_indices)
+      send_points.insert(send_points.end(), points[i].coordinates(),
+                         points[i].coordinates() + 3);
+    recv_points.resize(3*num_recv);
+    MPI::neighbor_all_to_all(forward_comm, send_points,
+                             scale(candidate_sizes, 3),
+                             scale(candidate_offsets, 3), recv_points,
+                             scale(source_sizes, 3), scale(source_offsets, 3));
+
+    // Locate received points and reply if found
+    std::vector<Point> _recv_points(num_recv);
+    for (std::size_t k = 0; k < num_recv; ++k)
+      _recv_points[k] = Point(recv_points[3*k], recv_points[3*k + 1],
+                              recv_points[3*k + 2]);
+    recv_cells = tree->compute_first_entity_collisions(_recv_points);
+    std::vector<int> found(num_recv);
+    for (std::size_t k = 0; k < num_recv; ++k)
+      found[k] = recv_cells[k] != not_found;
+    std::vector<int> replies(candidate_indices.size());
+    MPI::neighbor_all_to_all(reverse_comm, found, source_sizes,
+                             source_offsets, replies, candidate_sizes,
+                             candidate_offsets);
+
+    // Select lowest ranked process containing each point as owner
+    for (std::size_t j = 0; j < candidate_processes.size(); ++j)
+    {
+      const int p = candidate_processes[j];
+      for (int k = candidate_offsets[j]; k < candidate_offsets[j] + candidate_sizes[j]; ++k)
+      {
+        const std::size_t i = candidate_indices[k];
+        if (replies[k] and (_owners[i] < 0 or p < _owners[i]))
+          _owners[i] = p;
+      }
+    }
+
+    // Tell candidate processes whether they own the points
+    selected.resize(candidate_indices.size());
+    for (std::size_t j = 0; j < candidate_processes.size(); ++j)
+      for (int k = candidate_offsets[j]; k < candidate_offsets[j] + candidate_sizes[j]; ++k)
+        selected[k] = _owners[candidate_indices[k]] == candidate_processes[j];
+    owned.resize(num_recv);
+    MPI::neighbor_all_to_all(forward_comm, selected, candidate_sizes,
+                             candidate_offsets, owned, source_sizes,
+                             source_offsets);
+
+    MPI_Comm_free(&forward_comm);
+    MPI_Comm_free(&reverse_comm);
+  }
+  #endif
+
+  // Store points owned by this process, first the local queries
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    if (_owners[i] == rank)
+    {
+      _local_indices.push_back(i);
+      _owned_points.push_back(points[i]);
+      _owned_cells.push_back(cells[i]);
+    }
+  }
+  _num_local = _local_indices.size();
+
+  // Group query indices by owner
+  for (std::size_t j = 0, k = 0; j < candidate_processes.size(); ++j)
+  {
+    const std::size_t size = _query_indices.size();
+    for (const std::size_t end = k + candidate_sizes[j]; k < end; ++k)
+    {
+      if (selected[k])
+        _query_indices.push_back(candidate_indices[k]);
+    }
+    if (_query_indices.size() > size)
+    {
+      _owner_processes.push_back(candidate_processes[j]);
+      _query_offsets.push_back(size);
+      _query_sizes.push_back(_query_indices.size() - size);
+    }
+  }
+
+  // Store points owned for other processes, grouped by querying
+  // process
+  for (std::size_t j = 0, k = 0; j < source_processes.size(); ++j)
+  {
+    const std::size_t size = _owned_cells.size();
+    for (const std::size_t end = k + source_sizes[j]; k < end; ++k)
+    {
+      if (owned[k])
+      {
+        _owned_points.push_back(Point(recv_points[3*k], recv_points[3*k + 1],
+                                      recv_points[3*k + 2]));
+        _owned_cells.push_back(recv_cells[k]);
+      }
+    }
+    if (_owned_cells.size() > size)
+    {
+      _querying_processes.push_back(source_processes[j]);
+      _owned_offsets.push_back(size - _num_local);
+      _owned_sizes.push_back(_owned_cells.size() - size);
+    }
+  }
+
+  if (num_processes > 1)
+    create_communicators(mpi_comm);
+}
+//-----------------------------------------------------------------------------
+PointLocator::~PointLocator()
+{
+  #ifdef HAS_MPI
+  if (_forward_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_forward_comm);
+  if (_reverse_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_reverse_comm);
+  #endif
+}
+//-----------------------------------------------------------------------------
+void PointLocator::send_to_owners(const std::vector<double>& values,
+                                  std::size_t block_size,
+                                  std::vector<double>& owned_values) const
+{
+  dolfin_assert(values.size() == block_size*_points.size());
+  owned_values.resize(block_size*_owned_cells.size());
+
+  // Copy values of points owned by this process
+  for (std::size_t k = 0; k < _num_local; ++k)
+  {
+    std::copy(values.begin() + block_size*_local_indices[k],
+              values.begin() + block_size*(_local_indices[k] + 1),
+              owned_values.begin() + block_size*k);
+  }
+
+  if (_forward_comm == MPI_COMM_NULL)
+    return;
+
+  // Send values of other points to owners
+  std::vector<double> send_buffer;
+  send_buffer.reserve(block_size*_query_indices.size());
+  for (auto i : _query_indices)
+    send_buffer.insert(send_buffer.end(), values.begin() + block_size*i,
+                       values.begin() + block_size*(i + 1));
+  MPI::neighbor_all_to_all(_forward_comm, send_buffer,
+                           scale(_query_sizes, block_size),
+                           scale(_query_offsets, block_size), owned_values,
+                           scale(_owned_sizes, block_size),
+                           scale(_owned_offsets, block_size,
+                                 block_size*_num_local));
+}
+//-----------------------------------------------------------------------------
+void PointLocator::send_to_queries(const std::vector<double>& owned_values,
+                                   std::size_t block_size,
+                                   std::vector<double>& values) const
+{
+  dolfin_assert(owned_values.size() == block_size*_owned_cells.size());
+  values.resize(block_size*_points.size());
+
+  // Copy values of points owned by this process
+  for (std::size_t k = 0; k < _num_local; ++k)
+  {
+    std::copy(owned_values.begin() + block_size*k,
+              owned_values.begin() + block_size*(k + 1),
+              values.begin() + block_size*_local_indices[k]);
+  }
+
+  if (_reverse_comm == MPI_COMM_NULL)
+    return;
+
+  // Receive values of other points from owners
+  std::vector<double> recv_buffer(block_size*_query_indices.size());
+  MPI::neighbor_all_to_all(_reverse_comm, owned_values,
+                           scale(_owned_sizes, block_size),
+                           scale(_owned_offsets, block_size,
+                                 block_size*_num_local),
+                           recv_buffer, scale(_query_sizes, block_size),
+                           scale(_query_offsets, block_size));
+  for (std::size_t k = 0; k < _query_indices.size(); ++k)
+  {
+    std::copy(recv_buffer.begin() + block_size*k,
+              recv_buffer.begin() + block_size*(k + 1),
+              values.begin() + block_size*_query_indices[k]);
+  }
+}
+//-----------------------------------------------------------------------------
+void PointLocator::create_communicators(MPI_Comm mpi_comm)
+{
+  #ifdef HAS_MPI
+  // In the forward direction data flows from querying processes to
+  // owning processes
+  _forward_comm = create_graph(mpi_comm, _querying_processes,
+                               _owner_processes);
+  _reverse_comm = create_graph(mpi_comm, _owner_processes,
+                               _querying_processes);
+  #endif
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __POINT_LOCATOR_H
+#define __POINT_LOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <dolfin/common/MPI.h>
+#include "Point.h"
+
+namespace dolfin
+{
+
+  class Mesh;
+
+  /// This class locates points on a distributed mesh and keeps the
+  /// routing between the processes that hold the points and the
+  /// processes that own them, so that repeated queries at the same
+  /// points (probes, time series, point sources) only need to
+  /// communicate values.
+  ///
+  /// Each process may give its own list of query points. The
+  /// processes whose cells may contain a point are found from the
+  /// global bounding box tree of the mesh, and the points are sent
+  /// to these processes only, using MPI-3 neighbourhood collectives.
+  /// A point contained in cells on several processes is owned by the
+  /// lowest ranked of them. Points outside the mesh have no owner.
+  ///
+  /// @code{.cpp}
+  ///
+  ///         const PointLocator locator(mesh, points);
+  ///         std::vector<double> values;
+  ///         locator.evaluate(value_size,
+  ///                          [&](unsigned int cell, const Point& x,
+  ///                              double* values) { ... }, values);
+  /// @endcode
+  ///
+  /// The locator refers to cells by their local index and is
+  /// invalidated if the mesh is changed or repartitioned.
+
+  class PointLocator
+  {
+  public:
+
+    /// Locate given points (may differ between processes) on the
+    /// mesh. This constructor is collective on the mesh communicator
+    PointLocator(const Mesh& mesh, const std::vector<Point>& points);
+
+    /// Destructor
+    ~PointLocator();
+
+    // Locators own MPI communicators and cannot be copied
+    PointLocator(const PointLocator& locator) = delete;
+    PointLocator& operator=(const PointLocator& locator) = delete;
+
+    /// Return number of query points on this process
+    std::size_t size() const
+    { return _points.size(); }
+
+    /// Return query points of this process
+    const std::vector<Point>& points() const
+    { return _points; }
+
+    /// Return owning process of each query point (-1 if the point is
+    /// outside the mesh)
+    const std::vector<int>& owners() const
+    { return _owners; }
+
+    /// Return number of query points (from any process) owned by
+    /// this process
+    std::size_t num_owned() const
+    { return _owned_cells.size(); }
+
+    /// Return query points (from any process) owned by this process
+    const std::vector<Point>& owned_points() const
+    { return _owned_points; }
+
+    /// Return local index of the cell containing each owned point
+    const std::vector<unsigned int>& owned_cells() const
+    { return _owned_cells; }
+
+    /// Send block_size values per query point to the owning
+    /// processes, where they are stored in owned_values in the order
+    /// of owned_points() (collective). Values of points outside the
+    /// mesh are ignored
+    void send_to_owners(const std::vector<double>& values,
+                        std::size_t block_size,
+                        std::vector<double>& owned_values) const;
+
+    /// Send block_size values per owned point back to the processes
+    /// holding the query points, where they are stored in values in
+    /// the order of points() (collective). The values of points
+    /// outside the mesh are not changed
+    void send_to_queries(const std::vector<double>& owned_values,
+                         std::size_t block_size,
+                         std::vector<double>& values) const;
+
+    /// Evaluate at all query points (collective). The function
+    /// eval(cell, x, values) is called on the owning process for each
+    /// owned point x, with the local index of the cell containing it,
+    /// and must write value_size values. The results are returned in
+    /// the order of points(), with NaN at points outside the mesh
+    template<typename Eval>
+      void evaluate(std::size_t value_size, Eval eval,
+                    std::vector<double>& values) const;
+
+  private:
+
+    // Build graph communicators for the final routing
+    void create_communicators(MPI_Comm mpi_comm);
+
+    // Query points and their owners
+    std::vector<Point> _points;
+    std::vector<int> _owners;
+
+    // Owned points and cells, first those queried by this process
+    // and then those queried by other processes (grouped by process)
+    std::vector<Point> _owned_points;
+    std::vector<unsigned int> _owned_cells;
+
+    // Query indices of the first _num_local owned points
+    std::vector<std::size_t> _local_indices;
+    std::size_t _num_local;
+
+    // Processes owning query points of this process, with query
+    // indices grouped by owner and sizes and offsets into packed
+    // buffers
+    std::vector<int> _owner_processes;
+    std::vector<std::size_t> _query_indices;
+    std::vector<int> _query_sizes, _query_offsets;
+
+    // Processes querying points owned by this process, with sizes and
+    // offsets of owned points (after the local ones) grouped by
+    // querying process
+    std::vector<int> _querying_processes;
+    std::vector<int> _owned_sizes, _owned_offsets;
+
+    // Distributed graph communicators from querying to owning
+    // processes (forward) and back (reverse)
+    MPI_Comm _forward_comm;
+    MPI_Comm _reverse_comm;
+
+  };
+
+  //---------------------------------------------------------------------------
+  // Implementation of PointLocator
+  //---------------------------------------------------------------------------
+  template<typename Eval>
+    void PointLocator::evaluate(std::size_t value_size, Eval eval,
+                                std::vector<double>& values) const
+  {
+    // Evaluate at owned points
+    std::vector<double> owned_values(_owned_cells.size()*value_size);
+    for (std::size_t i = 0; i < _owned_cells.size(); ++i)
+      eval(_owned_cells[i], _owned_points[i],
+           owned_values.data() + i*value_size);
+
+    // Send values to querying processes
+    values.assign(_points.size()*value_size,
+                  std::numeric_limits<double>::quiet_NaN());
+    send_to_queries(owned_values, value_size, values);
+  }
+  //---------------------------------------------------------------------------
+
+}
+
+#endif
@@ -15,6 +15,8 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <map>
+#include <mutex>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
@@ -26,46 +28,31 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 SimplexQuadrature::SimplexQuadrature(std::size_t tdim, std::size_t order)
+  : _rule(reference_rule(tdim, order))
 {
-  // Create and store quadrature rule for reference simplex
-  switch (tdim)
-  {
-  case 1:
-    setup_qr_reference_interval(order);
-    break;
-  case 2:
-    setup_qr_reference_triangle(order);
-    break;
-  case 3:
-    setup_qr_reference_tetrahedron(order);
-    break;
-  default:
-    dolfin_error("SimplexQuadrature.cpp",
-                 "setup quadrature rule for reference simplex",
-                 "Only implemented for topological dimension 1, 2, 3");
-  }
-
+  // Do nothing
 }
 //-----------------------------------------------------------------------------
 std::pair<std::vector<double>, std::vector<double>>
   SimplexQuadrature::compute_quadrature_rule(const Cell& cell) const
 {
   // Extract dimensions
-  const std::size_t tdim = cell.mesh().topology().dim();
   const std::size_t gdim = cell.mesh().geometry().dim();
+  dolfin_assert(cell.mesh().topology().dim() == _rule->tdim);
 
   // Get vertex coordinates
   std::vector<double> x;
   cell.get_coordinate_dofs(x);
+  dolfin_assert(x.size() >= (_rule->tdim + 1)*gdim);
 
-  // Convert to std::vector<Point>
-  std::vector<Point> s(tdim + 1);
-  for (std::size_t t = 0; t < tdim + 1; ++t)
-    for (std::size_t d = 0; d < gdim; ++d)
-      s[t][d] = x[gdim*t + d];
+  // Compute quadrature rule
+  std::pair<std::vector<double>, std::vector<double>> quadrature_rule;
+  quadrature_rule.first.resize(gdim*size());
+  quadrature_rule.second.resize(size());
+  compute_quadrature_rules(x.data(), 1, gdim, quadrature_rule.first.data(),
+                           quadrature_rule.second.data());
 
-  // Call function to compute quadrature rule
-  return compute_quadrature_rule(s, gdim);
+  return quadrature_rule;
 }
 //-----------------------------------------------------------------------------
 std::pair<std::vector<double>, std::vector<double>>
@@ -102,194 +89,156 @@ std::pair<std::vector<double>, std::vector<double>>
   SimplexQuadrature::compute_quadrature_rule_interval(const std::vector<Point>& coordinates,
 						      std::size_t gdim) const
 {
-  log(PROGRESS, "Create quadrature rule using given interval coordinates");
-
-  std::pair<std::vector<double>, std::vector<double>> quadrature_rule;
-
-  // Find the determinant of the Jacobian (inspired by ufc_geometry.h)
-  double det = -1;
-
-  switch (gdim)
-  {
-  case 1:
-  {
-      det = coordinates[1].x() - coordinates[0].x();
-      break;
-  }
-  case 2:
-  {
-    const std::array<double, 2> J = {{coordinates[1].x() - coordinates[0].x(),
-                                      coordinates[1].y() - coordinates[0].y()}};
-    const double det2 = J[0]*J[0] + J[1]*J[1];
-    det = std::sqrt(det2);
-    break;
-  }
-  case 3:
-  {
-    const std::array<double, 3>  J = {{coordinates[1].x() - coordinates[0].x(),
-                                       coordinates[1].y() - coordinates[0].y(),
-                                       coordinates[1].z() - coordinates[0].z()}};
-    const double det2 = J[0]*J[0] + J[1]*J[1];
-    det = std::sqrt(det2);
-    break;
-  }
-  default:
-    dolfin_error("SimplexQuadrature.cpp",
-                 "compute quadrature rule for interval",
-                 "Not implemented for dimension %d", gdim);
-  }
-
-  // Map (local) quadrature points (note that _p is a
-  // std::vector<std::vector<double> >)
-  quadrature_rule.first.resize(gdim*_p[0].size());
-  for (std::size_t i = 0; i < _p[0].size(); ++i)
-  {
-    for (std::size_t d = 0; d < gdim; ++d)
-    {
-      quadrature_rule.first[d + i*gdim]
-        = 0.5*(coordinates[0][d]*(1. - _p[0][i])
-	       + coordinates[1][d]*(1. + _p[0][i]));
-      dolfin_assert(std::isfinite(quadrature_rule.first[d + i*gdim]));
-    }
-  }
-  dolfin_assert(det >= 0);
-
-  // Store weights
-  quadrature_rule.second.assign(_w.size(), 0.5*std::abs(det));
-  for (std::size_t i = 0; i < _w.size(); ++i)
-  {
-    quadrature_rule.second[i] *= _w[i];
-    dolfin_assert(std::isfinite(quadrature_rule.second[i]));
-  }
-  dolfin_assert(quadrature_rule.first.size() == gdim*quadrature_rule.second.size());
-
-  return quadrature_rule;
+  dolfin_assert(coordinates.size() == 2);
+  return compute_quadrature_rule_simplex(coordinates, gdim);
 }
 //-----------------------------------------------------------------------------
 std::pair<std::vector<double>, std::vector<double>>
 SimplexQuadrature::compute_quadrature_rule_triangle(const std::vector<Point>& coordinates,
                                                     std::size_t gdim) const
 {
-  log(PROGRESS, "Create quadrature rule using given triangle coordinates");
-
-  std::pair<std::vector<double>, std::vector<double>> quadrature_rule;
-
-  // Find the determinant of the Jacobian (inspired by ufc_geometry.h)
-  double det = 0; // To keep compiler happy
-
-  switch (gdim)
-  {
-  case 2:
-  {
-    det = orient2d(coordinates[0], coordinates[1], coordinates[2]);
-
-    break;
-  }
-  case 3:
-  {
-    const std::array<double, 6> J = {{coordinates[1].x() - coordinates[0].x(),
-                                      coordinates[2].x() - coordinates[0].x(),
-                                      coordinates[1].y() - coordinates[0].y(),
-                                      coordinates[2].y() - coordinates[0].y(),
-                                      coordinates[1].z() - coordinates[0].z(),
-                                      coordinates[2].z() - coordinates[0].z()}};
-    const double d_0 = J[2]*J[5] - J[4]*J[3];
-    const double d_1 = J[4]*J[1] - J[0]*J[5];
-    const double d_2 = J[0]*J[3] - J[2]*J[1];
-    const double det2 = d_0*d_0 + d_1*d_1 + d_2*d_2;
-    det = std::sqrt(det2);
-
-    break;
-  }
-  default:
-    dolfin_error("SimplexQuadrature.cpp",
-                 "compute quadrature rule for triangle",
-                 "Not implemented for dimension ", gdim);
-  }
-
-  // Store points
-  quadrature_rule.first.resize(gdim*_p.size());
-  for (std::size_t i = 0; i < _p.size(); ++i)
-  {
-    for (std::size_t d = 0; d < gdim; ++d)
-    {
-      quadrature_rule.first[d + i*gdim]
-        = _p[i][0]*coordinates[0][d]
-        + _p[i][1]*coordinates[1][d]
-        + (1. - _p[i][0] - _p[i][1])*coordinates[2][d];
-      dolfin_assert(std::isfinite(quadrature_rule.first[d + i*gdim]));
-    }
-  }
-
-  // Store weights
-  quadrature_rule.second.assign(_w.size(), 0.5*std::abs(det));
-  for (std::size_t i = 0; i < _w.size(); ++i)
-  {
-    quadrature_rule.second[i] *= _w[i];
-    dolfin_assert(std::isfinite(quadrature_rule.second[i]));
-  }
-
-  dolfin_assert(quadrature_rule.first.size() == gdim*quadrature_rule.second.size());
-
-  return quadrature_rule;
+  dolfin_assert(coordinates.size() == 3);
+  return compute_quadrature_rule_simplex(coordinates, gdim);
 }
 //-----------------------------------------------------------------------------
 std::pair<std::vector<double>, std::vector<double>>
 SimplexQuadrature::compute_quadrature_rule_tetrahedron(const std::vector<Point>& coordinates,
                                                        std::size_t gdim) const
 {
-  log(PROGRESS, "Create quadrature rule using given tetrahedron coordinates");
-
-  std::pair<std::vector<double>, std::vector<double>> quadrature_rule;
-
-  // Find the determinant of the Jacobian (from ufc_geometry.h)
-  double det = 0; // To keep compiler happy
+  dolfin_assert(coordinates.size() == 4);
+  return compute_quadrature_rule_simplex(coordinates, gdim);
+}
+//-----------------------------------------------------------------------------
+void SimplexQuadrature::compute_quadrature_rules(const double* coordinates,
+                                                 std::size_t num_simplices,
+                                                 std::size_t gdim,
+                                                 double* points,
+                                                 double* weights,
+                                                 double factor) const
+{
+  const std::size_t tdim = _rule->tdim;
+  const std::size_t num_points = _rule->weights.size();
+  const double* p = _rule->points.data();
+  const double* w = _rule->weights.data();
 
-  switch (gdim)
-  {
-  case 3:
+  // Check dimensions once for the whole batch
+  if (gdim < tdim or gdim > 3 or (tdim == 2 and gdim == 1)
+      or (tdim == 3 and gdim != 3))
   {
-    const std::array<double, 9> J = {{coordinates[1].x() - coordinates[0].x(),
-                                      coordinates[2].x() - coordinates[0].x(),
-                                      coordinates[3].x() - coordinates[0].x(),
-                                      coordinates[1].y() - coordinates[0].y(),
-                                      coordinates[2].y() - coordinates[0].y(),
-                                      coordinates[3].y() - coordinates[0].y(),
-                                      coordinates[1].z() - coordinates[0].z(),
-                                      coordinates[2].z() - coordinates[0].z(),
-                                      coordinates[3].z() - coordinates[0].z()}};
-    const std::array<double, 3> d = {{J[4]*J[8] - J[5]*J[7],
-                                      J[2]*J[7] - J[1]*J[8],
-                                      J[1]*J[5] - J[2]*J[4]}};
-    det = J[0]*d[0] + J[3]*d[1] + J[6]*d[2];
-    break;
-  }
-  default:
     dolfin_error("SimplexQuadrature.cpp",
-                 "compute quadrature rule for tetrahedron",
-                 "Not implemented for dimension ", gdim);
+                 "compute quadrature rules for simplices",
+                 "Not implemented for topological dimension %d and geometric dimension %d",
+                 tdim, gdim);
   }
 
-  // Store points
-  quadrature_rule.first.resize(gdim*_p.size());
-  for (std::size_t i = 0; i < _p.size(); ++i)
+  for (std::size_t s = 0; s < num_simplices; ++s)
   {
-    for (std::size_t d = 0; d < gdim; ++d)
+    const double* x0 = coordinates + s*(tdim + 1)*gdim;
+    const double* x1 = x0 + gdim;
+    double* xq = points + s*num_points*gdim;
+    double* wq = weights + s*num_points;
+
+    // Compute scaling of the weights from the determinant of the
+    // Jacobian (inspired by ufc_geometry.h), and map the points
+    double scale = 0.0;
+    switch (tdim)
+    {
+    case 1:
+    {
+      double det = x1[0] - x0[0];
+      if (gdim > 1)
+      {
+        double det2 = 0.0;
+        for (std::size_t d = 0; d < gdim; ++d)
+          det2 += (x1[d] - x0[d])*(x1[d] - x0[d]);
+        det = std::sqrt(det2);
+      }
+      dolfin_assert(det >= 0);
+      scale = 0.5*std::abs(det);
+
+      for (std::size_t i = 0; i < num_points; ++i)
+        for (std::size_t d = 0; d < gdim; ++d)
+          xq[d + i*gdim] = 0.5*(x0[d]*(1. - p[i]) + x1[d]*(1. + p[i]));
+      break;
+    }
+    case 2:
+    {
+      const double* x2 = x1 + gdim;
+      double det = 0.0;
+      if (gdim == 2)
+        det = _orient2d(x0, x1, x2);
+      else
+      {
+        const double J[6] = {x1[0] - x0[0], x2[0] - x0[0],
+                             x1[1] - x0[1], x2[1] - x0[1],
+                             x1[2] - x0[2], x2[2] - x0[2]};
+        const double d_0 = J[2]*J[5] - J[4]*J[3];
+        const double d_1 = J[4]*J[1] - J[0]*J[5];
+        const double d_2 = J[0]*J[3] - J[2]*J[1];
+        det = std::sqrt(d_0*d_0 + d_1*d_1 + d_2*d_2);
+      }
+      scale = 0.5*std::abs(det);
+
+      for (std::size_t i = 0; i < num_points; ++i)
+      {
+        const double* pi = p + 2*i;
+        for (std::size_t d = 0; d < gdim; ++d)
+          xq[d + i*gdim] = pi[0]*x0[d] + pi[1]*x1[d]
+            + (1. - pi[0] - pi[1])*x2[d];
+      }
+      break;
+    }
+    case 3:
+    {
+      const double* x2 = x1 + 3;
+      const double* x3 = x2 + 3;
+      const double J[9] = {x1[0] - x0[0], x2[0] - x0[0], x3[0] - x0[0],
+                           x1[1] - x0[1], x2[1] - x0[1], x3[1] - x0[1],
+                           x1[2] - x0[2], x2[2] - x0[2], x3[2] - x0[2]};
+      const double d_0 = J[4]*J[8] - J[5]*J[7];
+      const double d_1 = J[2]*J[7] - J[1]*J[8];
+      const double d_2 = J[1]*J[5] - J[2]*J[4];
+      const double det = J[0]*d_0 + J[3]*d_1 + J[6]*d_2;
+      scale = std::abs(det)/6.0;
+
+      for (std::size_t i = 0; i < num_points; ++i)
+      {
+        const double* pi = p + 3*i;
+        for (std::size_t d = 0; d < 3; ++d)
+          xq[d + i*3] = pi[0]*x0[d] + pi[1]*x1[d] + pi[2]*x2[d]
+            + (1. - pi[0] - pi[1] - pi[2])*x3[d];
+      }
+      break;
+    }
+    }
+
+    // Store weights
+    for (std::size_t i = 0; i < num_points; ++i)
     {
-      quadrature_rule.first[d + i*gdim]
-        = _p[i][0]*coordinates[0][d]
-        + _p[i][1]*coordinates[1][d]
-        + _p[i][2]*coordinates[2][d]
-        + (1. - _p[i][0] - _p[i][1] - _p[i][2])*coordinates[3][d];
+      wq[i] = factor*(scale*w[i]);
+      dolfin_assert(std::isfinite(wq[i]));
     }
   }
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<double>, std::vector<double>>
+SimplexQuadrature::compute_quadrature_rule_simplex(const std::vector<Point>& coordinates,
+                                                   std::size_t gdim) const
+{
+  dolfin_assert(coordinates.size() == _rule->tdim + 1);
+  dolfin_assert(gdim <= 3);
 
-  // Store weights
-  quadrature_rule.second.assign(_w.size(), std::abs(det)/6.0);
-  for (std::size_t i = 0; i < _w.size(); ++i)
-    quadrature_rule.second[i] *= _w[i];
+  // Copy vertex coordinates to array
+  double x[12];
+  for (std::size_t v = 0; v < coordinates.size(); ++v)
+    for (std::size_t d = 0; d < gdim; ++d)
+      x[v*gdim + d] = coordinates[v][d];
 
-  dolfin_assert(quadrature_rule.first.size() == gdim*quadrature_rule.second.size());
+  std::pair<std::vector<double>, std::vector<double>> quadrature_rule;
+  quadrature_rule.first.resize(gdim*size());
+  quadrature_rule.second.resize(size());
+  compute_quadrature_rules(x, 1, gdim, quadrature_rule.first.data(),
+                           quadrature_rule.second.data());
 
   return quadrature_rule;
 }
@@ -312,9 +261,6 @@ SimplexQuadrature::compress(std::pair<std::vector<double>, std::vector<double>>&
     return std::vector<std::size_t>();
   }
 
-  log(PROGRESS, "Compressing %d quadrature points down to %d",
-      qr.second.size(), N_compressed_min);
-
   // Copy the input qr since we'll overwrite the input
   const std::pair<std::vector<double>, std::vector<double>> qr_input = qr;
 
@@ -325,11 +271,13 @@ SimplexQuadrature::compress(std::pair<std::vector<double>, std::vector<double>>&
   // A QR decomposition selects the subset of N columns (geometrically
   // the N columns with same volume as spanned by all M columns).
   Eigen::ColPivHouseholderQR<Eigen::MatrixXd> QR(V);
-  Eigen::MatrixXd Q = QR.householderQ();
 
   // We do not need the full Q matrix but only what's known as the
-  // "economy size" decomposition
-  Q *= Eigen::MatrixXd::Identity(V.rows(), std::min(V.rows(), V.cols()));
+  // "economy size" decomposition. Apply the Householder reflections
+  // to the first columns of the identity instead of forming the full
+  // (square) Q, which is expensive for large rules.
+  Eigen::MatrixXd Q = QR.householderQ()
+    *Eigen::MatrixXd::Identity(V.rows(), std::min(V.rows(), V.cols()));
 
   // We'll use Q^T
   Q.transposeInPlace();
@@ -371,21 +319,61 @@ SimplexQuadrature::compress(std::pair<std::vector<double>, std::vector<double>>&
   return indices;
 }
 //-----------------------------------------------------------------------------
-void SimplexQuadrature::setup_qr_reference_interval(std::size_t order)
-{
-  // Create quadrature rule with points on reference element [-1, 1].
-  _p.resize(1);
-  legendre_compute_glr(order, _p[0], _w);
-}
-//-----------------------------------------------------------------------------
-void SimplexQuadrature::setup_qr_reference_triangle(std::size_t order)
+std::shared_ptr<const SimplexQuadrature::ReferenceRule>
+SimplexQuadrature::reference_rule(std::size_t tdim, std::size_t order)
 {
-  // Create quadrature rule with points on reference triangle [0, 0],
-  // [1, 0] and [0, 1]
-  return dunavant_rule(order, _p, _w);
+  // Cache of reference rules, indexed by topological dimension and
+  // order. Rules are never removed, so the returned pointers stay
+  // valid and the rules are only read after creation.
+  static std::mutex cache_mutex;
+  static std::map<std::pair<std::size_t, std::size_t>,
+                  std::shared_ptr<const ReferenceRule>> cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  const auto key = std::make_pair(tdim, order);
+  auto it = cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
+  // Create quadrature rule for reference simplex
+  std::shared_ptr<ReferenceRule> rule(new ReferenceRule);
+  rule->tdim = tdim;
+  std::vector<std::vector<double>> p;
+  switch (tdim)
+  {
+  case 1:
+    // Create quadrature rule with points on reference element [-1, 1]
+    legendre_compute_glr(order, rule->points, rule->weights);
+    break;
+  case 2:
+    // Create quadrature rule with points on reference triangle [0, 0],
+    // [1, 0] and [0, 1]
+    dunavant_rule(order, p, rule->weights);
+    break;
+  case 3:
+    setup_qr_reference_tetrahedron(order, p, rule->weights);
+    break;
+  default:
+    dolfin_error("SimplexQuadrature.cpp",
+                 "setup quadrature rule for reference simplex",
+                 "Only implemented for topological dimension 1, 2, 3");
+  }
+
+  // Store points of triangle and tetrahedron contiguously
+  for (const std::vector<double>& point : p)
+  {
+    dolfin_assert(point.size() == tdim);
+    rule->points.insert(rule->points.end(), point.begin(), point.end());
+  }
+  dolfin_assert(rule->points.size() == tdim*rule->weights.size());
+
+  cache[key] = rule;
+  return rule;
 }
 //-----------------------------------------------------------------------------
-void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
+void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order,
+                                                       std::vector<std::vector<double>>& p,
+                                                       std::vector<double>& w)
 {
   // FIXME: Replace these hard coded rules by a general function
 
@@ -393,29 +381,29 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
   {
   case 1:
     // Assign weight 1 and midpoint
-    _w.assign(1, 1.);
-    _p.assign(1, std::vector<double>(3, 0.25));
+    w.assign(1, 1.);
+    p.assign(1, std::vector<double>(3, 0.25));
 
     break;
   case 2:
     // Assign weights
-    _w.assign(4, 0.25);
+    w.assign(4, 0.25);
 
     // Assign points
-    _p.assign(4, std::vector<double>(3, 0.138196601125011));
-    _p[0][0] = _p[1][1] = _p[2][2] = 0.585410196624969;
+    p.assign(4, std::vector<double>(3, 0.138196601125011));
+    p[0][0] = p[1][1] = p[2][2] = 0.585410196624969;
 
     break;
   case 3:
     // Assign weights
-    _w = { -4./5.,
+    w = { -4./5.,
            9./20.,
            9./20.,
            9./20.,
            9./20. };
 
     // Assign points
-    _p = { { 0.25,  0.25,  0.25  },
+    p = { { 0.25,  0.25,  0.25  },
 	   { 1./6., 1./6., 1./6. },
 	   { 1./6., 1./6., 0.5,  },
 	   { 1./6., 0.5,   1./6. },
@@ -425,7 +413,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
   case 4:
     // Assign weights
     // FIXME: Find new rule to avoid negative weight
-    _w = { -0.0789333333333330,
+    w = { -0.0789333333333330,
 	   0.0457333333333335,
 	   0.0457333333333335,
 	   0.0457333333333335,
@@ -438,7 +426,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
 	   0.1493333333333332 };
 
     // Assign points
-    _p = { { 0.2500000000000000, 0.2500000000000000, 0.2500000000000000 },
+    p = { { 0.2500000000000000, 0.2500000000000000, 0.2500000000000000 },
 	   { 0.0714285714285715, 0.0714285714285715, 0.0714285714285715 },
 	   { 0.0714285714285715, 0.0714285714285715, 0.7857142857142855 },
 	   { 0.0714285714285715, 0.7857142857142855, 0.0714285714285715 },
@@ -453,7 +441,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
     break;
   case 5:
     // Assign weights
-    _w = { 0.0734930431163618,
+    w = { 0.0734930431163618,
 	   0.0734930431163618,
 	   0.0734930431163618,
 	   0.0734930431163618,
@@ -469,7 +457,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
 	   0.0425460207770813 };
 
     // Assign points
-    _p = { { 0.0927352503108910, 0.0927352503108910, 0.0927352503108910 },
+    p = { { 0.0927352503108910, 0.0927352503108910, 0.0927352503108910 },
 	   { 0.7217942490673265, 0.0927352503108910, 0.0927352503108910 },
 	   { 0.0927352503108910, 0.7217942490673265, 0.0927352503108910 },
 	   { 0.0927352503108910, 0.0927352503108910, 0.7217942490673265 },
@@ -487,7 +475,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
     break;
   case 6:
     // Assign weights
-    _w = { 0.0399227502581678,
+    w = { 0.0399227502581678,
 	   0.0399227502581678,
 	   0.0399227502581678,
 	   0.0399227502581678,
@@ -513,7 +501,7 @@ void SimplexQuadrature::setup_qr_reference_tetrahedron(std::size_t order)
 	   0.0482142857142855 };
 
     // Assign points
-    _p = { { 0.2146028712591520, 0.2146028712591520, 0.2146028712591520 },
+    p = { { 0.2146028712591520, 0.2146028712591520, 0.2146028712591520 },
 	   { 0.3561913862225440, 0.2146028712591520, 0.2146028712591520 },
 	   { 0.2146028712591520, 0.3561913862225440, 0.2146028712591520 },
 	   { 0.2146028712591520, 0.2146028712591520, 0.3561913862225440 },
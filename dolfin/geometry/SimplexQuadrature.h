@@ -16,11 +16,12 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2014-02-24
-// Last changed: 2017-12-06
+// Last changed: 2019-06-18
 
 #ifndef __SIMPLEX_QUADRATURE_H
 #define __SIMPLEX_QUADRATURE_H
 
+#include <memory>
 #include <vector>
 #include <Eigen/Dense>
 #include "Point.h"
@@ -31,7 +32,11 @@ namespace dolfin
   // Forward declarations
   class Cell;
 
-  /// This class defines quadrature rules for simplices.
+  /// This class defines quadrature rules for simplices. The rules
+  /// on the reference simplex are computed once for each topological
+  /// dimension and order and are then shared by all SimplexQuadrature
+  /// objects. A SimplexQuadrature object may be used from several
+  /// threads at the same time.
 
   class SimplexQuadrature
   {
@@ -47,6 +52,10 @@ namespace dolfin
     ///
     SimplexQuadrature(std::size_t tdim, std::size_t order);
 
+    /// Return number of quadrature points per simplex
+    std::size_t size() const
+    { return _rule->weights.size(); }
+
     /// Compute quadrature rule for cell.
     ///
     /// *Arguments*
@@ -126,6 +135,33 @@ namespace dolfin
     compute_quadrature_rule_tetrahedron(const std::vector<Point>& coordinates,
 					std::size_t gdim) const;
 
+    /// Compute quadrature rules for a batch of simplices and store
+    /// them in preallocated arrays.
+    ///
+    /// *Arguments*
+    ///     coordinates (double*)
+    ///         Vertex coordinates of the simplices, an array of length
+    ///         num_simplices*(tdim + 1)*gdim (simplex by simplex,
+    ///         vertex by vertex).
+    ///     num_simplices (std::size_t)
+    ///         The number of simplices.
+    ///     gdim (std::size_t)
+    ///         The geometric dimension.
+    ///     points (double*)
+    ///         Array of length num_simplices*size()*gdim for the
+    ///         quadrature points.
+    ///     weights (double*)
+    ///         Array of length num_simplices*size() for the
+    ///         quadrature weights.
+    ///     factor (double)
+    ///         Factor multiplying all weights.
+    void compute_quadrature_rules(const double* coordinates,
+                                  std::size_t num_simplices,
+                                  std::size_t gdim,
+                                  double* points,
+                                  double* weights,
+                                  double factor=1.0) const;
+
     /// Compress a quadrature rule using algorithms from
     ///     Compression of multivariate discrete measures and applications
     ///     A. Sommariva, M. Vianello
@@ -151,10 +187,31 @@ namespace dolfin
 
   private:
 
-    // Setup quadrature rule on a reference simplex
-    void setup_qr_reference_interval(std::size_t order);
-    void setup_qr_reference_triangle(std::size_t order);
-    void setup_qr_reference_tetrahedron(std::size_t order);
+    // Quadrature rule on reference simplex. The points are stored
+    // point by point with tdim coordinates each: the point in [-1, 1]
+    // for the interval and the first tdim barycentric coordinates for
+    // the triangle and the tetrahedron.
+    struct ReferenceRule
+    {
+      std::size_t tdim;
+      std::vector<double> points;
+      std::vector<double> weights;
+    };
+
+    // Return quadrature rule on reference simplex, computed on first
+    // request and cached for the lifetime of the process
+    static std::shared_ptr<const ReferenceRule>
+      reference_rule(std::size_t tdim, std::size_t order);
+
+    // Setup quadrature rule on reference tetrahedron
+    static void setup_qr_reference_tetrahedron(std::size_t order,
+                                               std::vector<std::vector<double>>& p,
+                                               std::vector<double>& w);
+
+    // Compute quadrature rule for a single simplex given as points
+    std::pair<std::vector<double>, std::vector<double>>
+      compute_quadrature_rule_simplex(const std::vector<Point>& coordinates,
+                                      std::size_t gdim) const;
 
     // Utility function for computing a Vandermonde type matrix in a
     // Chebyshev basis
@@ -277,9 +334,8 @@ namespace dolfin
     static double ts_mult(std::vector<double>& u, double h, int n);
     static double rk2_leg(double t1, double t2, double x, int n);
 
-    // Quadrature rule on reference simplex (points and weights)
-    std::vector<std::vector<double> > _p;
-    std::vector<double> _w;
+    // Quadrature rule on reference simplex (shared)
+    std::shared_ptr<const ReferenceRule> _rule;
 
   };
 
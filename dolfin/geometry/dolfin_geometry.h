@@ -4,6 +4,7 @@
 // DOLFIN geometry interface
 
 #include <dolfin/geometry/Point.h>
+#include <dolfin/geometry/PointLocator.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/GenericBoundingBoxTree.h>
 #include <dolfin/geometry/BoundingBoxTree3D.h>
@@ -9,21 +9,6 @@ double dolfin::orient1d(double a, double b, double x)
   return 0.0;
 }
 //-----------------------------------------------------------------------------
-double dolfin::orient2d(const Point& a, const Point& b, const Point& c)
-{
-  return dolfin::_orient2d(a.coordinates(),
-                           b.coordinates(),
-                           c.coordinates());
-}
-//-----------------------------------------------------------------------------
-double dolfin::orient3d(const Point& a, const Point& b, const Point& c, const Point& d)
-{
-  return dolfin::_orient3d(a.coordinates(),
-                           b.coordinates(),
-                           c.coordinates(),
-                           d.coordinates());
-}
-//-----------------------------------------------------------------------------
 
 /*****************************************************************************/
 /*                                                                           */
@@ -1643,38 +1628,14 @@ REAL orient2dadapt(const REAL *pa, const REAL *pb, const REAL *pc, const REAL de
   return(D[Dlength - 1]);
 }
 
-REAL dolfin::_orient2d(const REAL *pa, const REAL *pb, const REAL *pc)
-/* REAL *pa; */
-/* REAL *pb; */
-/* REAL *pc; */
-{
-  REAL detleft, detright, det;
-  REAL detsum, errbound;
-
-  detleft = (pa[0] - pc[0]) * (pb[1] - pc[1]);
-  detright = (pa[1] - pc[1]) * (pb[0] - pc[0]);
-  det = detleft - detright;
+/* The floating-point filter of orient2d() is inlined in predicates.h, */
+/* which calls this routine only when the filter fails.                  */
 
-  if (detleft > 0.0) {
-    if (detright <= 0.0) {
-      return det;
-    } else {
-      detsum = detleft + detright;
-    }
-  } else if (detleft < 0.0) {
-    if (detright >= 0.0) {
-      return det;
-    } else {
-      detsum = -detleft - detright;
-    }
-  } else {
-    return det;
-  }
-
-  errbound = ccwerrboundA * detsum;
-  if ((det >= errbound) || (-det >= errbound)) {
-    return det;
-  }
+REAL dolfin::_orient2d_exact(const REAL *pa, const REAL *pb, const REAL *pc,
+                             REAL detsum)
+{
+  if (_predicate_statistics.load(std::memory_order_relaxed))
+    _count_predicate_exact(2);
 
   return orient2dadapt(pa, pb, pc, detsum);
 }
@@ -2315,47 +2276,14 @@ REAL orient3dadapt(const REAL *pa, const REAL *pb, const REAL *pc, const REAL *p
   return finnow[finlength - 1];
 }
 
-REAL dolfin::_orient3d(const REAL *pa, const REAL *pb, const REAL *pc, const REAL *pd)
-/* REAL *pa; */
-/* REAL *pb; */
-/* REAL *pc; */
-/* REAL *pd; */
-{
-  REAL adx, bdx, cdx, ady, bdy, cdy, adz, bdz, cdz;
-  REAL bdxcdy, cdxbdy, cdxady, adxcdy, adxbdy, bdxady;
-  REAL det;
-  REAL permanent, errbound;
-
-  adx = pa[0] - pd[0];
-  bdx = pb[0] - pd[0];
-  cdx = pc[0] - pd[0];
-  ady = pa[1] - pd[1];
-  bdy = pb[1] - pd[1];
-  cdy = pc[1] - pd[1];
-  adz = pa[2] - pd[2];
-  bdz = pb[2] - pd[2];
-  cdz = pc[2] - pd[2];
-
-  bdxcdy = bdx * cdy;
-  cdxbdy = cdx * bdy;
+/* The floating-point filter of orient3d() is inlined in predicates.h, */
+/* which calls this routine only when the filter fails.                  */
 
-  cdxady = cdx * ady;
-  adxcdy = adx * cdy;
-
-  adxbdy = adx * bdy;
-  bdxady = bdx * ady;
-
-  det = adz * (bdxcdy - cdxbdy)
-      + bdz * (cdxady - adxcdy)
-      + cdz * (adxbdy - bdxady);
-
-  permanent = (Absolute(bdxcdy) + Absolute(cdxbdy)) * Absolute(adz)
-            + (Absolute(cdxady) + Absolute(adxcdy)) * Absolute(bdz)
-            + (Absolute(adxbdy) + Absolute(bdxady)) * Absolute(cdz);
-  errbound = o3derrboundA * permanent;
-  if ((det > errbound) || (-det > errbound)) {
-    return det;
-  }
+REAL dolfin::_orient3d_exact(const REAL *pa, const REAL *pb, const REAL *pc,
+                             const REAL *pd, REAL permanent)
+{
+  if (_predicate_statistics.load(std::memory_order_relaxed))
+    _count_predicate_exact(3);
 
   return orient3dadapt(pa, pb, pc, pd, permanent);
 }
@@ -2369,4 +2297,41 @@ namespace dolfin
 {
   /// Initialize the predicate
   PredicateInitialization predicate_initialization;
+
+  /// Counters of predicate evaluations (orient2d, orient2d_exact,
+  /// orient3d, orient3d_exact), enabled by set_predicate_statistics
+  std::atomic<bool> _predicate_statistics(false);
+  std::atomic<std::size_t> _predicate_counts[4];
 }
+//-----------------------------------------------------------------------------
+void dolfin::_count_predicate(std::size_t dim)
+{
+  _predicate_counts[2*(dim - 2)].fetch_add(1, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+void dolfin::_count_predicate_exact(std::size_t dim)
+{
+  _predicate_counts[2*(dim - 2) + 1].fetch_add(1, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+void dolfin::set_predicate_statistics(bool enable)
+{
+  _predicate_statistics.store(enable);
+}
+//-----------------------------------------------------------------------------
+std::map<std::string, std::size_t> dolfin::predicate_statistics()
+{
+  std::map<std::string, std::size_t> stats;
+  stats["orient2d"] = _predicate_counts[0].load();
+  stats["orient2d_exact"] = _predicate_counts[1].load();
+  stats["orient3d"] = _predicate_counts[2].load();
+  stats["orient3d_exact"] = _predicate_counts[3].load();
+  return stats;
+}
+//-----------------------------------------------------------------------------
+void dolfin::reset_predicate_statistics()
+{
+  for (auto& count : _predicate_counts)
+    count.store(0);
+}
+//-----------------------------------------------------------------------------
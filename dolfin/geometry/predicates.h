@@ -12,32 +12,135 @@
 #ifndef __PREDICATES_H
 #define __PREDICATES_H
 
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <string>
+#include "Point.h"
+
 namespace dolfin
 {
 
-  class Point;
-
   /// Initialize tolerances for exact arithmetic
   void exactinit();
 
   /// Compute relative orientation of point x wrt segment [a, b]
   double orient1d(double a, double b, double x);
 
+  /// Bounds on the relative rounding error of the floating-point
+  /// evaluation of the orientation determinants (Shewchuk's error
+  /// bounds A, with epsilon = 2^-53 for IEEE double precision)
+  const double orient2d_errbound
+    = (3.0 + 16.0*(0.5*DBL_EPSILON))*(0.5*DBL_EPSILON);
+  const double orient3d_errbound
+    = (7.0 + 56.0*(0.5*DBL_EPSILON))*(0.5*DBL_EPSILON);
+
+  /// True if evaluations of the predicates are counted (see
+  /// set_predicate_statistics)
+  extern std::atomic<bool> _predicate_statistics;
+
+  /// Count evaluation of orient2d (dim = 2) or orient3d (dim = 3),
+  /// and evaluation by exact arithmetic
+  void _count_predicate(std::size_t dim);
+  void _count_predicate_exact(std::size_t dim);
+
+  /// Compute relative orientation of points a, b, c by exact
+  /// (adaptive) arithmetic, used by _orient2d when the sign is not
+  /// decided by the floating-point filter. The argument detsum is
+  /// the sum of the magnitudes of the two products of the
+  /// determinant.
+  double _orient2d_exact(const double* a, const double* b, const double* c,
+                         double detsum);
+
+  /// Compute relative orientation of points a, b, c, d by exact
+  /// (adaptive) arithmetic, used by _orient3d when the sign is not
+  /// decided by the floating-point filter. The argument permanent is
+  /// the determinant evaluated with the magnitudes of all terms.
+  double _orient3d_exact(const double* a, const double* b, const double* c,
+                         const double* d, double permanent);
+
   /// Compute relative orientation of points a, b, c. The orientation
   /// is such that orient2d(a, b, c) > 0 if a, b, c are ordered
   /// counter-clockwise.
-  double _orient2d(const double* a, const double* b, const double* c);
+  ///
+  /// The determinant is first evaluated in floating-point
+  /// arithmetic, which is returned if its magnitude exceeds the
+  /// bound on the rounding error, so that its sign is certain. This
+  /// is inlined, and only the rare (nearly) degenerate cases call
+  /// the exact evaluation.
+  inline double _orient2d(const double* a, const double* b, const double* c)
+  {
+    if (_predicate_statistics.load(std::memory_order_relaxed))
+      _count_predicate(2);
+
+    const double detleft = (a[0] - c[0])*(b[1] - c[1]);
+    const double detright = (a[1] - c[1])*(b[0] - c[0]);
+    const double det = detleft - detright;
+    const double detsum = std::abs(detleft) + std::abs(detright);
+    if (std::abs(det) >= orient2d_errbound*detsum)
+      return det;
+
+    return _orient2d_exact(a, b, c, detsum);
+  }
 
   /// Convenience function using dolfin::Point
-  double orient2d(const Point& a, const Point& b, const Point& c);
+  inline double orient2d(const Point& a, const Point& b, const Point& c)
+  { return _orient2d(a.coordinates(), b.coordinates(), c.coordinates()); }
 
   /// Compute relative orientation of points a, b, c, d. The
   /// orientation is such that orient3d(a, b, c, d) > 0 if a, b, c, d
-  /// are oriented according to the left hand rule.
-  double _orient3d(const double* a, const double* b, const double* c, const double* d);
+  /// are oriented according to the left hand rule. The determinant
+  /// is filtered as for _orient2d.
+  inline double _orient3d(const double* a, const double* b, const double* c,
+                          const double* d)
+  {
+    if (_predicate_statistics.load(std::memory_order_relaxed))
+      _count_predicate(3);
+
+    const double adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+    const double ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+    const double adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+
+    const double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    const double cdxady = cdx*ady, adxcdy = adx*cdy;
+    const double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+    const double det = adz*(bdxcdy - cdxbdy) + bdz*(cdxady - adxcdy)
+      + cdz*(adxbdy - bdxady);
+    const double permanent
+      = (std::abs(bdxcdy) + std::abs(cdxbdy))*std::abs(adz)
+      + (std::abs(cdxady) + std::abs(adxcdy))*std::abs(bdz)
+      + (std::abs(adxbdy) + std::abs(bdxady))*std::abs(cdz);
+    if (std::abs(det) > orient3d_errbound*permanent)
+      return det;
+
+    return _orient3d_exact(a, b, c, d, permanent);
+  }
 
   /// Convenience function using dolfin::Point
-  double orient3d(const Point& a, const Point& b, const Point& c, const Point& d);
+  inline double orient3d(const Point& a, const Point& b, const Point& c,
+                         const Point& d)
+  {
+    return _orient3d(a.coordinates(), b.coordinates(), c.coordinates(),
+                     d.coordinates());
+  }
+
+  /// Start or stop counting the evaluations of orient2d and orient3d.
+  /// Counting is disabled by default, since it slows down the
+  /// predicates.
+  void set_predicate_statistics(bool enable);
+
+  /// Return the number of evaluations of orient2d and orient3d since
+  /// counting was started ("orient2d" and "orient3d"), and the number
+  /// of these which were not decided by the floating-point filter
+  /// and needed exact arithmetic ("orient2d_exact" and
+  /// "orient3d_exact")
+  std::map<std::string, std::size_t> predicate_statistics();
+
+  /// Reset the counters of predicate_statistics
+  void reset_predicate_statistics();
 
   /// Class used for automatic initialization of tolerances at startup.
   /// A global instance is defined inside predicates.cpp to ensure that
@@ -35,13 +35,17 @@
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/GenericBoundingBoxTree.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/ConnectivityView.h>
 #include <dolfin/mesh/LocalMeshData.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/MeshPartitioning.h>
+#include <dolfin/mesh/MeshTopology.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
 #include <dolfin/mesh/MeshFunction.h>
 #include <dolfin/mesh/MeshValueCollection.h>
@@ -1945,6 +1949,444 @@ void HDF5File::read(Mesh& input_mesh,
 
 }
 //-----------------------------------------------------------------------------
+void HDF5File::write_topology_cache(const Mesh& mesh, const std::string name)
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  Timer t0("HDF5: write topology cache");
+
+  // Ensure group name starts with '/'
+  std::string group_name(name);
+  if (group_name[0] != '/')
+    group_name = "/" + name;
+  HDF5Interface::add_group(_hdf5_file_id, group_name);
+
+  // Number of entities, ghost offset and whether shared entities
+  // have been computed, for each dimension
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t tdim = topology.dim();
+  std::vector<std::size_t> sizes;
+  std::vector<std::size_t> num_global_entities;
+  for (std::size_t d = 0; d <= tdim; ++d)
+  {
+    sizes.push_back(topology.size(d));
+    sizes.push_back(topology.ghost_offset(d));
+    sizes.push_back(topology.have_shared_entities(d));
+    num_global_entities.push_back(topology.size_global(d));
+  }
+  write_local_data(group_name + "/sizes", sizes);
+
+  // Global numbering and ownership of entities which are not part of
+  // the mesh data (vertices and cells)
+  for (std::size_t d = 1; d < tdim; ++d)
+  {
+    const std::string d_str = std::to_string(d);
+    const std::vector<std::int64_t> empty;
+    write_local_data(group_name + "/global_indices_" + d_str,
+                     topology.have_global_indices(d)
+                     ? topology.global_indices(d) : empty);
+
+    // Flatten shared entities as (entity, number of processes,
+    // processes)
+    std::vector<std::int64_t> shared_entities;
+    if (topology.have_shared_entities(d))
+    {
+      for (auto& e : topology.shared_entities(d))
+      {
+        shared_entities.push_back(e.first);
+        shared_entities.push_back(e.second.size());
+        shared_entities.insert(shared_entities.end(), e.second.begin(),
+                               e.second.end());
+      }
+    }
+    write_local_data(group_name + "/shared_entities_" + d_str,
+                     shared_entities);
+  }
+
+  // Write connectivity which has been computed on any process (cell
+  // - vertex connectivity is part of the mesh data)
+  std::vector<std::size_t> connectivity;
+  for (std::size_t d0 = 0; d0 <= tdim; ++d0)
+  {
+    for (std::size_t d1 = 0; d1 <= tdim; ++d1)
+    {
+      const MeshConnectivity& c = topology(d0, d1);
+      const bool computed = !c.empty() and !c.compressed()
+        and !(d0 == tdim and d1 == 0);
+      if (MPI::max(_mpi_comm.comm(), (std::size_t) computed) == 0)
+        continue;
+      connectivity.push_back(d0*(tdim + 1) + d1);
+
+      // Extract connections, and offsets if the number of
+      // connections varies
+      std::vector<std::size_t> stride(1, 0);
+      std::vector<unsigned int> connections;
+      std::vector<std::size_t> offsets;
+      std::vector<unsigned int> num_global_connections;
+      if (computed)
+      {
+        const ConnectivityView view(c, topology.size(d0));
+        stride[0] = view.stride();
+        const std::size_t num_entities = view.size();
+        std::size_t size = 0;
+        for (std::size_t e = 0; e < num_entities; ++e)
+        {
+          if (stride[0] == 0)
+            offsets.push_back(size);
+          size += view[e].size();
+        }
+        if (stride[0] == 0)
+          offsets.push_back(size);
+        connections.assign(view.data(), view.data() + size);
+
+        // Global number of connections, if different from local
+        bool local = true;
+        for (std::size_t e = 0; e < num_entities and local; ++e)
+          local = (view.size_global(e) == view[e].size());
+        if (!local)
+        {
+          for (std::size_t e = 0; e < num_entities; ++e)
+            num_global_connections.push_back(view.size_global(e));
+        }
+      }
+
+      const std::string c_name = group_name + "/connectivity_"
+        + std::to_string(d0) + "_" + std::to_string(d1);
+      write_local_data(c_name + "/stride", stride);
+      write_local_data(c_name + "/connections", connections);
+      write_local_data(c_name + "/offsets", offsets);
+      write_local_data(c_name + "/num_global_connections",
+                       num_global_connections);
+    }
+  }
+
+  // Add attributes for validation of cache
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "mesh_hash",
+                               mesh.hash());
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "num_processes",
+                               (std::size_t) _mpi_comm.size());
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "tdim", tdim);
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name,
+                               "num_global_entities", num_global_entities);
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "connectivity",
+                               connectivity);
+}
+//-----------------------------------------------------------------------------
+bool HDF5File::read_topology_cache(Mesh& mesh, const std::string name) const
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  Timer t0("HDF5: read topology cache");
+
+  // Ensure group name starts with '/'
+  std::string group_name(name);
+  if (group_name[0] != '/')
+    group_name = "/" + name;
+
+  // Check that cache exists and matches mesh
+  if (!HDF5Interface::has_group(_hdf5_file_id, group_name))
+  {
+    warning("Topology cache \"%s\" not found in file.", name.c_str());
+    return false;
+  }
+  std::size_t num_processes = 0;
+  std::size_t tdim = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "num_processes",
+                               num_processes);
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "tdim", tdim);
+  if (num_processes != _mpi_comm.size() or tdim != mesh.topology().dim())
+  {
+    warning("Topology cache \"%s\" was written with a different number of processes or for a different mesh.",
+            name.c_str());
+    return false;
+  }
+  std::size_t mesh_hash = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "mesh_hash",
+                               mesh_hash);
+  if (mesh_hash != mesh.hash())
+  {
+    warning("Topology cache \"%s\" was written for a different mesh or partition.",
+            name.c_str());
+    return false;
+  }
+
+  // Restore entities which have not been computed
+  MeshTopology& topology = mesh.topology();
+  std::vector<std::size_t> sizes;
+  read_local_data(group_name + "/sizes", sizes);
+  dolfin_assert(sizes.size() == 3*(tdim + 1));
+  std::vector<std::size_t> num_global_entities;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name,
+                               "num_global_entities", num_global_entities);
+  for (std::size_t d = 1; d < tdim; ++d)
+  {
+    // Reading data sets is collective, so all processes read them if
+    // entities are restored on any process, and the processes which
+    // do not need the data discard it
+    const bool restore = sizes[3*d] > 0 and topology.size(d) == 0;
+    if (MPI::max(_mpi_comm.comm(), (std::size_t) restore) == 0)
+      continue;
+
+    const std::string d_str = std::to_string(d);
+    std::vector<std::int64_t> global_indices;
+    read_local_data(group_name + "/global_indices_" + d_str, global_indices);
+    std::vector<std::int64_t> data;
+    read_local_data(group_name + "/shared_entities_" + d_str, data);
+    if (!restore)
+      continue;
+
+    topology.init(d, sizes[3*d], num_global_entities[d]);
+    topology.init_ghost(d, sizes[3*d + 1]);
+    if (!global_indices.empty())
+    {
+      dolfin_assert(global_indices.size() == sizes[3*d]);
+      topology.set_global_indices(d, std::move(global_indices));
+    }
+
+    if (sizes[3*d + 2])
+    {
+      std::map<std::int32_t, std::set<unsigned int>>& shared_entities
+        = topology.shared_entities(d);
+      for (std::size_t i = 0; i < data.size(); i += data[i + 1] + 2)
+      {
+        shared_entities[data[i]].insert(data.begin() + i + 2,
+                                        data.begin() + i + 2 + data[i + 1]);
+      }
+    }
+  }
+
+  // Restore connectivity which has not been computed (collectively,
+  // as for the entities)
+  std::vector<std::size_t> connectivity;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "connectivity",
+                               connectivity);
+  for (auto dd : connectivity)
+  {
+    const std::size_t d0 = dd/(tdim + 1);
+    const std::size_t d1 = dd % (tdim + 1);
+    MeshConnectivity& c = topology(d0, d1);
+    const bool restore = c.empty();
+    if (MPI::max(_mpi_comm.comm(), (std::size_t) restore) == 0)
+      continue;
+
+    const std::string c_name = group_name + "/connectivity_"
+      + std::to_string(d0) + "_" + std::to_string(d1);
+    std::vector<std::size_t> stride;
+    read_local_data(c_name + "/stride", stride);
+    dolfin_assert(stride.size() == 1);
+    std::vector<unsigned int> connections;
+    read_local_data(c_name + "/connections", connections);
+    std::vector<std::size_t> offsets;
+    read_local_data(c_name + "/offsets", offsets);
+    std::vector<unsigned int> num_global_connections;
+    read_local_data(c_name + "/num_global_connections",
+                    num_global_connections);
+    if (!restore)
+      continue;
+
+    // Connectivity not computed on this process if no offsets
+    if (stride[0] > 0)
+      c.set(std::move(connections), stride[0]);
+    else if (!offsets.empty())
+      c.set(std::move(connections), offsets);
+    else
+      continue;
+
+    if (!num_global_connections.empty())
+      c.set_global_size(num_global_connections);
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+void HDF5File::write(const BoundingBoxTree& tree, const std::string name)
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  Timer t0("HDF5: write bounding box tree");
+
+  // Only trees for mesh entities are written
+  if (!tree._tree or !tree._mesh)
+  {
+    dolfin_error("HDF5File.cpp",
+                 "write bounding box tree",
+                 "Bounding box tree has not been built for a mesh");
+  }
+  const Mesh& mesh = *tree._mesh;
+
+  // Update global tree if the tree has been refitted without it
+  tree._tree->update_global_tree(mesh.mpi_comm());
+  const GenericBoundingBoxTree& _tree = *tree._tree;
+
+  // Ensure group name starts with '/'
+  std::string group_name(name);
+  if (group_name[0] != '/')
+    group_name = "/" + name;
+  HDF5Interface::add_group(_hdf5_file_id, group_name);
+
+  // Write node arrays of local tree (two children per node)
+  std::vector<unsigned int> children;
+  children.reserve(2*_tree._bboxes.size());
+  for (auto& bbox : _tree._bboxes)
+  {
+    children.push_back(bbox.child_0);
+    children.push_back(bbox.child_1);
+  }
+  write_local_data(group_name + "/children", children);
+  write_local_data(group_name + "/coordinates", _tree._bbox_coordinates);
+
+  // Cost of tree when built and now (see BoundingBoxTree::refit)
+  const std::vector<double> cost = {_tree._build_cost, _tree._cost};
+  write_local_data(group_name + "/cost", cost);
+
+  // Hashes of the part of the mesh on each process, to check the
+  // partition when reading
+  const std::vector<std::size_t> local_hash
+    = {mesh.topology().hash(), mesh.geometry().hash()};
+  write_local_data(group_name + "/local_hash", local_hash);
+
+  // Write global tree (same on all processes) from process 0
+  if (_tree._global_tree)
+  {
+    std::vector<unsigned int> global_children;
+    std::vector<double> global_coordinates;
+    if (_mpi_comm.rank() == 0)
+    {
+      for (auto& bbox : _tree._global_tree->_bboxes)
+      {
+        global_children.push_back(bbox.child_0);
+        global_children.push_back(bbox.child_1);
+      }
+      global_coordinates = _tree._global_tree->_bbox_coordinates;
+    }
+    write_local_data(group_name + "/global_children", global_children);
+    write_local_data(group_name + "/global_coordinates", global_coordinates);
+  }
+
+  // Add attributes for validation and restoring of tree
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "mesh_hash",
+                               mesh.hash());
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "num_processes",
+                               (std::size_t) _mpi_comm.size());
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "gdim",
+                               _tree.gdim());
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "tdim",
+                               _tree._tdim);
+  HDF5Interface::add_attribute(_hdf5_file_id, group_name, "builder",
+                               _tree._builder);
+}
+//-----------------------------------------------------------------------------
+bool HDF5File::read(BoundingBoxTree& tree, const std::string name,
+                    const Mesh& mesh) const
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  Timer t0("HDF5: read bounding box tree");
+
+  // Ensure group name starts with '/'
+  std::string group_name(name);
+  if (group_name[0] != '/')
+    group_name = "/" + name;
+
+  // Check that tree exists and matches mesh
+  if (!HDF5Interface::has_group(_hdf5_file_id, group_name))
+  {
+    warning("Bounding box tree \"%s\" not found in file.", name.c_str());
+    return false;
+  }
+  std::size_t num_processes = 0;
+  std::size_t gdim = 0;
+  std::size_t tdim = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "num_processes",
+                               num_processes);
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "gdim", gdim);
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "tdim", tdim);
+  if (num_processes != _mpi_comm.size() or gdim != mesh.geometry().dim()
+      or tdim > mesh.topology().dim())
+  {
+    warning("Bounding box tree \"%s\" was written with a different number of processes or for a different mesh.",
+            name.c_str());
+    return false;
+  }
+  std::size_t mesh_hash = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "mesh_hash",
+                               mesh_hash);
+  std::vector<std::size_t> local_hash;
+  read_local_data(group_name + "/local_hash", local_hash);
+  const bool local_match = local_hash.size() == 2
+    and local_hash[0] == mesh.topology().hash()
+    and local_hash[1] == mesh.geometry().hash();
+  if (mesh_hash != mesh.hash()
+      or MPI::min(_mpi_comm.comm(), (std::size_t) local_match) == 0)
+  {
+    warning("Bounding box tree \"%s\" was written for a different mesh or partition.",
+            name.c_str());
+    return false;
+  }
+
+  // Read node arrays of local tree
+  std::shared_ptr<GenericBoundingBoxTree> _tree
+    = GenericBoundingBoxTree::create(gdim);
+  std::vector<unsigned int> children;
+  read_local_data(group_name + "/children", children);
+  read_local_data(group_name + "/coordinates", _tree->_bbox_coordinates);
+  if (_tree->_bbox_coordinates.size() != gdim*children.size())
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read bounding box tree",
+                 "Number of node coordinates does not match number of nodes");
+  }
+  _tree->_bboxes.resize(children.size()/2);
+  for (std::size_t i = 0; i < _tree->_bboxes.size(); ++i)
+  {
+    _tree->_bboxes[i].child_0 = children[2*i];
+    _tree->_bboxes[i].child_1 = children[2*i + 1];
+  }
+  _tree->_tdim = tdim;
+  HDF5Interface::get_attribute(_hdf5_file_id, group_name, "builder",
+                               _tree->_builder);
+  std::vector<double> cost;
+  read_local_data(group_name + "/cost", cost);
+  dolfin_assert(cost.size() == 2);
+  _tree->_build_cost = cost[0];
+  _tree->_cost = cost[1];
+
+  // Collision queries use the wide tree, which is a copy of the
+  // binary tree in a different layout
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  _tree->build_wide_tree(num_threads);
+
+  // Read global tree (the whole data set on all processes)
+  if (HDF5Interface::has_dataset(_hdf5_file_id,
+                                 group_name + "/global_children"))
+  {
+    std::shared_ptr<GenericBoundingBoxTree> global_tree
+      = GenericBoundingBoxTree::create(gdim);
+    std::vector<unsigned int> global_children;
+    const std::string children_name = group_name + "/global_children";
+    const std::string coordinates_name = group_name + "/global_coordinates";
+    HDF5Interface::read_dataset(_hdf5_file_id, children_name,
+      {0, HDF5Interface::get_dataset_shape(_hdf5_file_id, children_name)[0]},
+      global_children);
+    HDF5Interface::read_dataset(_hdf5_file_id, coordinates_name,
+      {0, HDF5Interface::get_dataset_shape(_hdf5_file_id, coordinates_name)[0]},
+      global_tree->_bbox_coordinates);
+    global_tree->_bboxes.resize(global_children.size()/2);
+    for (std::size_t i = 0; i < global_tree->_bboxes.size(); ++i)
+    {
+      global_tree->_bboxes[i].child_0 = global_children[2*i];
+      global_tree->_bboxes[i].child_1 = global_children[2*i + 1];
+    }
+    global_tree->build_wide_tree(1);
+    _tree->_global_tree = global_tree;
+  }
+
+  // Initialize entities of the dimension of the tree, which are
+  // accessed by the entity queries
+  mesh.init(tdim);
+
+  tree._tree = _tree;
+  tree._mesh = &mesh;
+
+  return true;
+}
+//-----------------------------------------------------------------------------
 bool HDF5File::has_dataset(const std::string dataset_name) const
 {
   dolfin_assert(_hdf5_file_id > 0);
@@ -1976,5 +2418,54 @@ bool HDF5File::get_mpi_atomicity() const
   return HDF5Interface::get_mpi_atomicity(_hdf5_file_id);
 }
 //-----------------------------------------------------------------------------
+template <typename T>
+void HDF5File::write_local_data(const std::string dataset_name,
+                                const std::vector<T>& data)
+{
+  // Skip data set if empty on all processes
+  const std::size_t num_global_items = MPI::sum(_mpi_comm.comm(),
+                                                data.size());
+  if (num_global_items == 0)
+    return;
+
+  // Write data to file
+  const std::vector<std::int64_t> global_size(1, num_global_items);
+  const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
+  write_data(dataset_name, data, global_size, mpi_io);
+
+  // Add partitioning attribute to dataset
+  std::vector<std::size_t> partitions;
+  const std::vector<std::size_t>
+    offset(1, MPI::global_offset(_mpi_comm.comm(), data.size(), true));
+  MPI::gather(_mpi_comm.comm(), offset, partitions);
+  MPI::broadcast(_mpi_comm.comm(), partitions);
+  HDF5Interface::add_attribute(_hdf5_file_id, dataset_name, "partition",
+                               partitions);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void HDF5File::read_local_data(const std::string dataset_name,
+                               std::vector<T>& data) const
+{
+  data.clear();
+  if (!HDF5Interface::has_dataset(_hdf5_file_id, dataset_name))
+    return;
+
+  // Get partition from file
+  std::vector<std::size_t> partitions;
+  HDF5Interface::get_attribute(_hdf5_file_id, dataset_name, "partition",
+                               partitions);
+  dolfin_assert(partitions.size() == _mpi_comm.size());
+  const std::vector<std::int64_t> data_shape
+    = HDF5Interface::get_dataset_shape(_hdf5_file_id, dataset_name);
+  partitions.push_back(data_shape[0]);
+
+  // Read data of this process
+  const std::size_t process_num = _mpi_comm.rank();
+  const std::pair<std::int64_t, std::int64_t>
+    local_range(partitions[process_num], partitions[process_num + 1]);
+  HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range, data);
+}
+//-----------------------------------------------------------------------------
 
 #endif
@@ -35,6 +35,7 @@
 namespace dolfin
 {
 
+  class BoundingBoxTree;
   class CellType;
   class Function;
   class GenericVector;
@@ -124,6 +125,38 @@ namespace dolfin
               const std::int64_t expected_num_global_points,
               bool use_partition_from_file) const;
 
+    /// Write the computed topology of a Mesh (mesh entities, their
+    /// global numbering and ownership, and all computed
+    /// connectivity) to file. The data of each process is stored
+    /// separately, so it can only be restored with the same
+    /// partition (see read_topology_cache).
+    void write_topology_cache(const Mesh& mesh, const std::string name);
+
+    /// Restore the topology of a Mesh written by
+    /// write_topology_cache. The cache is used only if the number of
+    /// processes and the mesh hash (Mesh::hash) match those of the
+    /// mesh when the cache was written. Entities and connectivity
+    /// restored from the cache are not recomputed by Mesh::init.
+    /// Returns true if the cache was used.
+    bool read_topology_cache(Mesh& mesh, const std::string name) const;
+
+    /// Write a BoundingBoxTree built for the entities of a mesh to
+    /// file. The node arrays of each process are stored separately,
+    /// together with the global tree of the process bounding boxes,
+    /// so the tree can only be read with the same partition.
+    void write(const BoundingBoxTree& tree, const std::string name);
+
+    /// Read a BoundingBoxTree written by write(tree, name) for the
+    /// given mesh. The node arrays are read directly into the tree,
+    /// without rebuilding it. The tree is read only if the number of
+    /// processes, the mesh hash (Mesh::hash) and the part of the mesh
+    /// on each process match those of the mesh when the tree was
+    /// written. Returns true if the tree was read. To use the tree
+    /// for the queries of the mesh, pass it to
+    /// Mesh::set_bounding_box_tree.
+    bool read(BoundingBoxTree& tree, const std::string name,
+              const Mesh& mesh) const;
+
     /// Write MeshFunction to file in a format suitable for re-reading
     void write(const MeshFunction<std::size_t>& meshfunction,
                const std::string name);
@@ -229,6 +262,19 @@ namespace dolfin
       void read_mesh_value_collection_old(MeshValueCollection<T>& mesh_values,
                                           const std::string name) const;
 
+    // Write data local to each process to HDF5 data set, recording
+    // the offset of each process in the attribute "partition". Data
+    // sets which would be empty on all processes are not written.
+    template <typename T>
+      void write_local_data(const std::string dataset_name,
+                            const std::vector<T>& data);
+
+    // Read data of this process from HDF5 data set written by
+    // write_local_data (empty if data set does not exist)
+    template <typename T>
+      void read_local_data(const std::string dataset_name,
+                           std::vector<T>& data) const;
+
     // Write contiguous data to HDF5 data set. Data is flattened into
     // a 1D array, e.g. [x0, y0, z0, x1, y1, z1] for a vector in 3D
     template <typename T>
@@ -212,6 +212,9 @@ namespace dolfin
   template <> inline hid_t HDF5Interface::hdf5_type<int>()
   { return H5T_NATIVE_INT; }
   //---------------------------------------------------------------------------
+  template <> inline hid_t HDF5Interface::hdf5_type<unsigned int>()
+  { return H5T_NATIVE_UINT; }
+  //---------------------------------------------------------------------------
   template <> inline hid_t HDF5Interface::hdf5_type<std::int64_t>()
   { return H5T_NATIVE_INT64; }
   //---------------------------------------------------------------------------
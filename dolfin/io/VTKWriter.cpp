@@ -33,6 +33,7 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/MeshGeometry.h>
 #include <dolfin/mesh/MeshFunction.h>
 #include <dolfin/mesh/Vertex.h>
 #include "Encoder.h"
@@ -246,14 +247,27 @@ void VTKWriter::write_ascii_mesh(const Mesh& mesh, std::size_t cell_dim,
                  "Unable to open file \"%s\"", filename.c_str());
   }
 
-  // Write vertex positions
+  // Write vertex positions (in single precision if the mesh geometry
+  // has a single precision copy of the coordinates)
+  const bool single_precision = mesh.geometry().has_single_precision();
   file << "<Points>" << std::endl;
-  file << "<DataArray  type=\"Float64\"  NumberOfComponents=\"3\"  format=\""
-       << "ascii" << "\">";
-  for (VertexIterator v(mesh); !v.end(); ++v)
+  file << "<DataArray  type=\"" << (single_precision ? "Float32" : "Float64")
+       << "\"  NumberOfComponents=\"3\"  format=\"" << "ascii" << "\">";
+  if (single_precision)
+  {
+    const std::vector<float> x = single_precision_vertex_data(mesh);
+    file.precision(8);
+    for (std::size_t i = 0; i < x.size(); i += 3)
+      file << x[i] << " " << x[i + 1] << " " <<  x[i + 2] << "  ";
+    file.precision(16);
+  }
+  else
   {
-    Point p = v->point();
-    file << p.x() << " " << p.y() << " " <<  p.z() << "  ";
+    for (VertexIterator v(mesh); !v.end(); ++v)
+    {
+      Point p = v->point();
+      file << p.x() << " " << p.y() << " " <<  p.z() << "  ";
+    }
   }
   file << "</DataArray>" << std::endl <<  "</Points>" << std::endl;
 
@@ -311,21 +325,33 @@ void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
                  "Unable to open file \"%s\"", filename.c_str());
   }
 
-  // Write vertex positions
+  // Write vertex positions (in single precision if the mesh geometry
+  // has a single precision copy of the coordinates)
+  const bool single_precision = mesh.geometry().has_single_precision();
   file << "<Points>" << std::endl;
-  file << "<DataArray  type=\"Float64\"  NumberOfComponents=\"3\"  format=\""
-       << "binary" << "\">" << std::endl;
-  std::vector<double> vertex_data(3*mesh.num_vertices());
-  std::vector<double>::iterator vertex_entry = vertex_data.begin();
-  for (VertexIterator v(mesh); !v.end(); ++v)
+  file << "<DataArray  type=\"" << (single_precision ? "Float32" : "Float64")
+       << "\"  NumberOfComponents=\"3\"  format=\"" << "binary" << "\">"
+       << std::endl;
+  if (single_precision)
   {
-    const Point p = v->point();
-    *vertex_entry++ = p.x();
-    *vertex_entry++ = p.y();
-    *vertex_entry++ = p.z();
+    file << encode_stream(single_precision_vertex_data(mesh), compress)
+         << std::endl;
+  }
+  else
+  {
+    std::vector<double> vertex_data(3*mesh.num_vertices());
+    std::vector<double>::iterator vertex_entry = vertex_data.begin();
+    for (VertexIterator v(mesh); !v.end(); ++v)
+    {
+      const Point p = v->point();
+      *vertex_entry++ = p.x();
+      *vertex_entry++ = p.y();
+      *vertex_entry++ = p.z();
+    }
+
+    // Create encoded stream
+    file <<  encode_stream(vertex_data, compress) << std::endl;
   }
-  // Create encoded stream
-  file <<  encode_stream(vertex_data, compress) << std::endl;
   file << "</DataArray>" << std::endl <<  "</Points>" << std::endl;
 
   // Write cell connectivity
@@ -379,6 +405,23 @@ void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
   file.close();
 }
 //----------------------------------------------------------------------------
+std::vector<float> VTKWriter::single_precision_vertex_data(const Mesh& mesh)
+{
+  // Copy single precision coordinates, padded to 3D
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::vector<float>& x = mesh.geometry().x_single();
+  std::vector<float> vertex_data(3*mesh.num_vertices(), 0.0);
+  std::vector<float>::iterator vertex_entry = vertex_data.begin();
+  for (VertexIterator v(mesh); !v.end(); ++v)
+  {
+    std::copy(x.begin() + v->index()*gdim, x.begin() + (v->index() + 1)*gdim,
+              vertex_entry);
+    vertex_entry += 3;
+  }
+
+  return vertex_data;
+}
+//----------------------------------------------------------------------------
 std::uint8_t VTKWriter::vtk_cell_type(const Mesh& mesh,
                                       std::size_t cell_dim)
 {
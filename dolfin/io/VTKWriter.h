@@ -76,6 +76,9 @@ namespace dolfin
     static void write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
                                   std::string file, bool compress);
 
+    // Get single precision vertex coordinates, padded to 3D
+    static std::vector<float> single_precision_vertex_data(const Mesh& mesh);
+
     // Get VTK cell type
     static std::uint8_t vtk_cell_type(const Mesh& mesh, std::size_t cell_dim);
 
@@ -1872,7 +1872,15 @@ void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::string h5_path = group_name + "/geometry";
   const std::vector<std::int64_t> shape = {num_points, gdim};
 
-  add_data_item(comm, geometry_node, h5_id, h5_path, x, shape);
+  // Write coordinates in single precision if the mesh geometry has a
+  // single precision copy of the coordinates
+  if (mesh_geometry.has_single_precision())
+  {
+    const std::vector<float> x_single(x.begin(), x.end());
+    add_data_item(comm, geometry_node, h5_id, h5_path, x_single, shape);
+  }
+  else
+    add_data_item(comm, geometry_node, h5_id, h5_path, x, shape);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
@@ -21,13 +21,17 @@
 // First added:  2008-08-25
 // Last changed: 2012-03-15
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/NoDeleter.h>
 #include "dolfin/common/utils.h"
 #include "BlockVector.h"
 #include "DefaultFactory.h"
+#include "EigenMatrix.h"
+#include "EigenVector.h"
 #include "GenericVector.h"
 #include "Matrix.h"
 #include "BlockMatrix.h"
@@ -140,9 +144,36 @@ void BlockMatrix::mult(const BlockVector& x, BlockVector& y,
 
     const GenericMatrix& _matA = *matrices[row][0];
 
-    // Resize y and zero
+    // Resize y
     if (_y.empty())
       _matA.init_vector(_y, 0);
+
+    // Use Eigen directly if all blocks in the row are Eigen objects
+    // to avoid a temporary vector and a virtual call per block
+    bool eigen_row = has_type<EigenVector>(_y);
+    for (std::size_t col = 0; col < matrices.shape()[1] and eigen_row; ++col)
+    {
+      dolfin_assert(matrices[row][col]);
+      eigen_row = has_type<EigenMatrix>(*matrices[row][col])
+        and has_type<EigenVector>(*x.get_block(col));
+    }
+
+    if (eigen_row)
+    {
+      Eigen::VectorXd& y_vec = *as_type<EigenVector>(_y).vec();
+      y_vec.setZero();
+      for (std::size_t col = 0; col < matrices.shape()[1]; ++col)
+      {
+        const EigenMatrix& A = as_type<const EigenMatrix>(*matrices[row][col]);
+        const Eigen::VectorXd& x_vec
+          = *as_type<const EigenVector>(*x.get_block(col)).vec();
+        dolfin_assert(A.mat().cols() == x_vec.size());
+        dolfin_assert(A.mat().rows() == y_vec.size());
+        y_vec.noalias() += A.mat()*x_vec;
+      }
+      continue;
+    }
+
     _y.zero();
 
     // Loop over block columns
@@ -193,3 +224,120 @@ std::shared_ptr<GenericMatrix> BlockMatrix::schur_approximation(bool symmetry) c
   }
   return S;
 }
+//-----------------------------------------------------------------------------
+std::shared_ptr<EigenMatrix> BlockMatrix::monolithic(Ordering ordering) const
+{
+  Timer timer("Convert BlockMatrix to monolithic matrix");
+
+  const std::size_t m = matrices.shape()[0];
+  const std::size_t n = matrices.shape()[1];
+  if (m == 0 or n == 0)
+  {
+    dolfin_error("BlockMatrix.cpp",
+                 "convert block matrix to monolithic matrix",
+                 "Block matrix is empty");
+  }
+
+  dolfin_assert(matrices[0][0]);
+  if (MPI::size(matrices[0][0]->mpi_comm()) > 1)
+  {
+    dolfin_error("BlockMatrix.cpp",
+                 "convert block matrix to monolithic matrix",
+                 "Conversion is only supported in serial");
+  }
+
+  // Get sizes of block rows and columns, and check that they are
+  // consistent
+  std::vector<std::size_t> row_offsets(m + 1, 0), col_offsets(n + 1, 0);
+  for (std::size_t i = 0; i < m; ++i)
+    row_offsets[i + 1] = row_offsets[i] + matrices[i][0]->size(0);
+  for (std::size_t j = 0; j < n; ++j)
+    col_offsets[j + 1] = col_offsets[j] + matrices[0][j]->size(1);
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      dolfin_assert(matrices[i][j]);
+      if (matrices[i][j]->size(0) != row_offsets[i + 1] - row_offsets[i]
+          or matrices[i][j]->size(1) != col_offsets[j + 1] - col_offsets[j])
+      {
+        dolfin_error("BlockMatrix.cpp",
+                     "convert block matrix to monolithic matrix",
+                     "Size of block (%d, %d) does not match its block row and column",
+                     i, j);
+      }
+    }
+  }
+
+  if (ordering == Ordering::interleaved)
+  {
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      if (row_offsets[i + 1] - row_offsets[i] != row_offsets[1])
+      {
+        dolfin_error("BlockMatrix.cpp",
+                     "convert block matrix to monolithic matrix",
+                     "Interleaved ordering requires block rows of equal size");
+      }
+    }
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      if (col_offsets[j + 1] - col_offsets[j] != col_offsets[1])
+      {
+        dolfin_error("BlockMatrix.cpp",
+                     "convert block matrix to monolithic matrix",
+                     "Interleaved ordering requires block columns of equal size");
+      }
+    }
+  }
+
+  const std::size_t M = row_offsets[m];
+  const std::size_t N = col_offsets[n];
+
+  // Build compressed row storage. Rows are visited in monolithic
+  // order, so each row is assembled from the corresponding row of
+  // every block in the block row.
+  std::vector<int> outer(M + 1, 0);
+  std::vector<int> inner;
+  std::vector<double> values;
+  std::vector<std::pair<int, double>> row_entries;
+  std::vector<std::size_t> block_cols;
+  std::vector<double> block_values;
+  for (std::size_t r = 0; r < M; ++r)
+  {
+    // Block row and row within block
+    const std::size_t i = (ordering == Ordering::field_split)
+      ? std::upper_bound(row_offsets.begin(), row_offsets.end(), r)
+        - row_offsets.begin() - 1
+      : r % m;
+    const std::size_t k = (ordering == Ordering::field_split)
+      ? r - row_offsets[i] : r/m;
+
+    row_entries.clear();
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      matrices[i][j]->getrow(k, block_cols, block_values);
+      for (std::size_t c = 0; c < block_cols.size(); ++c)
+      {
+        const std::size_t col = (ordering == Ordering::field_split)
+          ? col_offsets[j] + block_cols[c] : block_cols[c]*n + j;
+        row_entries.push_back({col, block_values[c]});
+      }
+    }
+
+    std::sort(row_entries.begin(), row_entries.end());
+    for (const auto& entry : row_entries)
+    {
+      inner.push_back(entry.first);
+      values.push_back(entry.second);
+    }
+    outer[r + 1] = inner.size();
+  }
+
+  auto A = std::make_shared<EigenMatrix>(M, N);
+  A->mat() = Eigen::Map<const EigenMatrix::eigen_matrix_type>
+    (M, N, inner.size(), outer.data(), inner.data(), values.data());
+
+  return A;
+}
+//-----------------------------------------------------------------------------
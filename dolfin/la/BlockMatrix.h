@@ -33,6 +33,7 @@ namespace dolfin
 {
 
   // Forward declarations
+  class EigenMatrix;
   class GenericMatrix;
 
   /// Block Matrix
@@ -41,6 +42,13 @@ namespace dolfin
   {
   public:
 
+    /// Ordering of the degrees of freedom of a monolithic matrix. For
+    /// 'field_split' all rows (columns) of block 0 come first,
+    /// followed by block 1, etc. For 'interleaved' row (column) k of
+    /// each block are stored consecutively, which requires blocks of
+    /// equal size.
+    enum class Ordering {field_split, interleaved};
+
     /// Constructor
     BlockMatrix(std::size_t m=0, std::size_t n=0);
 
@@ -80,6 +88,14 @@ namespace dolfin
     std::shared_ptr<GenericMatrix>
       schur_approximation(bool symmetry=true) const;
 
+    /// Merge all blocks into a single matrix in compressed row
+    /// storage with the given ordering. Blocks are read with
+    /// getrow(), so any backend can be converted, but the result is
+    /// a serial Eigen matrix. Use EigenBlockView to access blocks of
+    /// the result without copying.
+    std::shared_ptr<EigenMatrix>
+      monolithic(Ordering ordering=Ordering::field_split) const;
+
   private:
 
     boost::multi_array<std::shared_ptr<GenericMatrix>, 2> matrices;
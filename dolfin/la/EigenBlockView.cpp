@@ -0,0 +1,217 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <dolfin/log/log.h>
+#include "EigenMatrix.h"
+#include "EigenVector.h"
+#include "EigenBlockView.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+template<typename F>
+void EigenBlockView::for_each_in_row(std::size_t k, F f) const
+{
+  const EigenMatrix::eigen_matrix_type& A = _matA->mat();
+  const std::size_t r = _row_offset + k*_row_stride;
+
+  // Column range of row r in compressed storage (the matrix may be
+  // uncompressed, in which case the row length is stored separately)
+  const int* inner = A.innerIndexPtr();
+  const double* values = A.valuePtr();
+  const int begin = A.outerIndexPtr()[r];
+  const int end = A.innerNonZeroPtr() ? begin + A.innerNonZeroPtr()[r]
+    : A.outerIndexPtr()[r + 1];
+
+  if (_col_stride == 1)
+  {
+    // Columns of the block are contiguous, skip to the first one
+    const int c0 = _col_offset;
+    const int c1 = _col_offset + _n;
+    for (const int* c = std::lower_bound(inner + begin, inner + end, c0);
+         c != inner + end and *c < c1; ++c)
+    {
+      f(*c - c0, values[c - inner]);
+    }
+  }
+  else
+  {
+    for (int p = begin; p < end; ++p)
+    {
+      const std::size_t c = inner[p];
+      if (c % _col_stride == _col_offset)
+        f(c/_col_stride, values[p]);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+EigenBlockView::EigenBlockView(std::shared_ptr<const EigenMatrix> A,
+                               const std::vector<std::size_t>& row_sizes,
+                               const std::vector<std::size_t>& col_sizes,
+                               BlockMatrix::Ordering ordering,
+                               std::size_t i, std::size_t j)
+  : _matA(A), _ordering(ordering)
+{
+  dolfin_assert(_matA);
+  dolfin_assert(i < row_sizes.size());
+  dolfin_assert(j < col_sizes.size());
+
+  const std::size_t M = std::accumulate(row_sizes.begin(), row_sizes.end(), std::size_t(0));
+  const std::size_t N = std::accumulate(col_sizes.begin(), col_sizes.end(), std::size_t(0));
+  if (M != _matA->size(0) or N != _matA->size(1))
+  {
+    dolfin_error("EigenBlockView.cpp",
+                 "create view of block of Eigen matrix",
+                 "Block sizes do not match size of matrix (%d x %d)",
+                 _matA->size(0), _matA->size(1));
+  }
+
+  _m = row_sizes[i];
+  _n = col_sizes[j];
+  if (ordering == BlockMatrix::Ordering::field_split)
+  {
+    _row_offset = std::accumulate(row_sizes.begin(), row_sizes.begin() + i, std::size_t(0));
+    _col_offset = std::accumulate(col_sizes.begin(), col_sizes.begin() + j, std::size_t(0));
+    _row_stride = 1;
+    _col_stride = 1;
+  }
+  else
+  {
+    if (std::count(row_sizes.begin(), row_sizes.end(), _m) != (int) row_sizes.size()
+        or std::count(col_sizes.begin(), col_sizes.end(), _n) != (int) col_sizes.size())
+    {
+      dolfin_error("EigenBlockView.cpp",
+                   "create view of block of Eigen matrix",
+                   "Interleaved ordering requires blocks of equal size");
+    }
+
+    _row_offset = i;
+    _col_offset = j;
+    _row_stride = row_sizes.size();
+    _col_stride = col_sizes.size();
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<std::vector<std::shared_ptr<EigenBlockView>>>
+EigenBlockView::split(std::shared_ptr<const EigenMatrix> A,
+                      const std::vector<std::size_t>& row_sizes,
+                      const std::vector<std::size_t>& col_sizes,
+                      BlockMatrix::Ordering ordering)
+{
+  std::vector<std::vector<std::shared_ptr<EigenBlockView>>>
+    views(row_sizes.size());
+  for (std::size_t i = 0; i < row_sizes.size(); ++i)
+  {
+    for (std::size_t j = 0; j < col_sizes.size(); ++j)
+    {
+      views[i].push_back(std::make_shared<EigenBlockView>(A, row_sizes,
+                                                          col_sizes,
+                                                          ordering, i, j));
+    }
+  }
+  return views;
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenBlockView::size(std::size_t dim) const
+{
+  dolfin_assert(dim < 2);
+  return dim == 0 ? _m : _n;
+}
+//-----------------------------------------------------------------------------
+void EigenBlockView::mult(const GenericVector& x, GenericVector& y) const
+{
+  const EigenVector& xx = as_type<const EigenVector>(x);
+  EigenVector& yy = as_type<EigenVector>(y);
+  if (xx.size() != _n)
+  {
+    dolfin_error("EigenBlockView.cpp",
+                 "compute matrix-vector product with Eigen block view",
+                 "Non-matching dimensions for matrix-vector product");
+  }
+
+  // Resize RHS if empty
+  if (yy.empty())
+    yy.init(_m);
+
+  if (yy.size() != _m)
+  {
+    dolfin_error("EigenBlockView.cpp",
+                 "compute matrix-vector product with Eigen block view",
+                 "Vector for matrix-vector result has wrong size");
+  }
+
+  const Eigen::VectorXd& x_vec = *xx.vec();
+  Eigen::VectorXd& y_vec = *yy.vec();
+  for (std::size_t k = 0; k < _m; ++k)
+  {
+    double sum = 0.0;
+    for_each_in_row(k, [&sum, &x_vec](std::size_t l, double value)
+                    { sum += value*x_vec[l]; });
+    y_vec[k] = sum;
+  }
+}
+//-----------------------------------------------------------------------------
+std::string EigenBlockView::str(bool verbose) const
+{
+  std::stringstream s;
+  if (verbose)
+  {
+    s << str(false) << std::endl << std::endl;
+    std::vector<std::size_t> columns;
+    std::vector<double> values;
+    for (std::size_t k = 0; k < _m; ++k)
+    {
+      getrow(k, columns, values);
+      s << "|";
+      for (std::size_t c = 0; c < columns.size(); ++c)
+        s << " (" << k << ", " << columns[c] << ", " << values[c] << ")";
+      s << " |" << std::endl;
+    }
+  }
+  else
+  {
+    s << "<EigenBlockView of size " << _m << " x " << _n << ">";
+  }
+
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void EigenBlockView::getrow(std::size_t row, std::vector<std::size_t>& columns,
+                            std::vector<double>& values) const
+{
+  dolfin_assert(row < _m);
+  columns.clear();
+  values.clear();
+  for_each_in_row(row, [&columns, &values](std::size_t l, double value)
+                  {
+                    columns.push_back(l);
+                    values.push_back(value);
+                  });
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenBlockView::nnz() const
+{
+  std::size_t num_nonzeros = 0;
+  for (std::size_t k = 0; k < _m; ++k)
+    for_each_in_row(k, [&num_nonzeros](std::size_t, double)
+                    { ++num_nonzeros; });
+  return num_nonzeros;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __EIGEN_BLOCK_VIEW_H
+#define __EIGEN_BLOCK_VIEW_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dolfin/common/MPI.h>
+#include "BlockMatrix.h"
+#include "GenericLinearOperator.h"
+
+namespace dolfin
+{
+
+  class EigenMatrix;
+
+  /// This class is a view of block (i, j) of a monolithic Eigen
+  /// matrix, e.g. created by BlockMatrix::monolithic. No data is
+  /// copied: the view holds a pointer to the monolithic matrix and
+  /// maps block indices to monolithic indices on the fly. The view
+  /// is invalidated if the sparsity of the monolithic matrix
+  /// changes.
+
+  class EigenBlockView : public GenericLinearOperator
+  {
+  public:
+
+    /// Create view of block (i, j) of monolithic matrix A, given the
+    /// sizes of the block rows and block columns and the ordering
+    /// of A
+    EigenBlockView(std::shared_ptr<const EigenMatrix> A,
+                   const std::vector<std::size_t>& row_sizes,
+                   const std::vector<std::size_t>& col_sizes,
+                   BlockMatrix::Ordering ordering,
+                   std::size_t i, std::size_t j);
+
+    /// Destructor
+    virtual ~EigenBlockView() {}
+
+    /// Create views of all blocks of monolithic matrix A
+    static std::vector<std::vector<std::shared_ptr<EigenBlockView>>>
+      split(std::shared_ptr<const EigenMatrix> A,
+            const std::vector<std::size_t>& row_sizes,
+            const std::vector<std::size_t>& col_sizes,
+            BlockMatrix::Ordering ordering);
+
+    //--- Implementation of the GenericLinearOperator interface ---
+
+    /// Return size of given dimension
+    virtual std::size_t size(std::size_t dim) const;
+
+    /// Compute matrix-vector product y = Ax
+    virtual void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Return informal string representation (pretty-print)
+    virtual std::string str(bool verbose) const;
+
+    /// Return MPI communicator
+    virtual MPI_Comm mpi_comm() const
+    { return MPI_COMM_SELF; }
+
+    //--- Special functions ---
+
+    /// Get non-zero values of given row of the block
+    void getrow(std::size_t row, std::vector<std::size_t>& columns,
+                std::vector<double>& values) const;
+
+    /// Return number of non-zero entries in the block
+    std::size_t nnz() const;
+
+  private:
+
+    // Call f(local column, value) for all entries of local row k
+    template<typename F>
+      void for_each_in_row(std::size_t k, F f) const;
+
+    // Monolithic matrix
+    std::shared_ptr<const EigenMatrix> _matA;
+
+    // Ordering of monolithic matrix
+    BlockMatrix::Ordering _ordering;
+
+    // Block size
+    std::size_t _m, _n;
+
+    // Row k (column l) of the block is row _row_offset +
+    // k*_row_stride (column _col_offset + l*_col_stride) of the
+    // monolithic matrix. The strides are 1 for field-split ordering
+    // and the number of block rows (columns) for interleaved ordering.
+    std::size_t _row_offset, _col_offset;
+    std::size_t _row_stride, _col_stride;
+
+  };
+
+}
+
+#endif
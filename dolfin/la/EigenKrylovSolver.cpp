@@ -17,6 +17,8 @@
 //
 // First added:  2015-02-04
 
+#include <algorithm>
+#include <cmath>
 #include <iostream> // Seem to be missing some Eigen headers
 #include <map>
 #include <string>
@@ -43,6 +45,7 @@ const std::map<std::string, std::string>
 EigenKrylovSolver::_methods_descr
 = { {"default",  "default Eigen Krylov method"},
     {"cg",       "Conjugate gradient method"},
+    {"pipecg",   "Pipelined conjugate gradient method"},
     {"bicgstab", "Biconjugate gradient stabilized method"},
     {"minres",   "Minimal residual"},
     {"gmres",    "Generalised minimal residual (GMRES)"}};
@@ -141,28 +144,112 @@ std::size_t EigenKrylovSolver::solve(const GenericLinearOperator& A,
 //-----------------------------------------------------------------------------
 std::size_t EigenKrylovSolver::solve(EigenVector& x, const EigenVector& b)
 {
-  Timer timer("Eigen Krylov solver");
-
-  // Check dimensions
-  dolfin_assert(_matA);
-  if (_matA->size(0) != b.size())
+  return solve_columns({&x}, {&b});
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenKrylovSolver::solve_multiple(
+  const std::vector<std::shared_ptr<GenericVector>>& x,
+  const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  if (x.size() != b.size())
   {
     dolfin_error("EigenKrylovSolver.cpp",
-                 "unable to solve linear system with Eigen Krylov solver",
-                 "Non-matching dimensions for linear system (matrix has %ld rows and right-hand side vector has %ld rows)",
-                 _matA->size(0), b.size());
+                 "unable to solve linear systems with Eigen Krylov solver",
+                 "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                 x.size(), b.size());
   }
 
-  // Re-initialize solution vector if necessary
-  if (x.empty())
+  std::vector<EigenVector*> _x;
+  std::vector<const EigenVector*> _b;
+  for (std::size_t i = 0; i < b.size(); ++i)
   {
-    _matA->init_vector(x, 1);
-    x.zero();
+    dolfin_assert(x[i] and b[i]);
+    _x.push_back(&as_type<EigenVector>(*x[i]));
+    _b.push_back(&as_type<const EigenVector>(*b[i]));
+  }
+
+  return solve_columns(_x, _b);
+}
+//-----------------------------------------------------------------------------
+std::size_t
+EigenKrylovSolver::solve_columns(const std::vector<EigenVector*>& x,
+                                 const std::vector<const EigenVector*>& b)
+{
+  Timer timer("Eigen Krylov solver");
+
+  dolfin_assert(_matA);
+  dolfin_assert(x.size() == b.size());
+  for (std::size_t i = 0; i < b.size(); ++i)
+  {
+    // Check dimensions
+    if (_matA->size(0) != b[i]->size())
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "unable to solve linear system with Eigen Krylov solver",
+                   "Non-matching dimensions for linear system (matrix has %ld rows and right-hand side vector has %ld rows)",
+                   _matA->size(0), b[i]->size());
+    }
+
+    // Re-initialize solution vector if necessary
+    if (x[i]->empty())
+    {
+      _matA->init_vector(*x[i], 1);
+      x[i]->zero();
+    }
   }
 
   log(PROGRESS, "Eigen Krylov solver starting to solve %i x %i system.",
       _matA->size(0), _matA->size(1));
 
+  // Use block CG for multiple right-hand sides
+  if (_method == "cg" and b.size() > 1)
+  {
+    // CG relies on the preconditioner being symmetric
+    if (_pc == "ilu")
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "unable to solve linear system with Eigen Krylov solver",
+                   "Block CG requires a symmetric preconditioner (\"none\" or \"jacobi\")");
+    }
+
+    if (_pc == "none")
+    {
+      Eigen::IdentityPreconditioner pc;
+      return call_block_cg(pc, x, b);
+    }
+    else
+    {
+      Eigen::DiagonalPreconditioner<double> pc;
+      return call_block_cg(pc, x, b);
+    }
+  }
+
+  // Use pipelined CG (one fused reduction per iteration) if requested
+  const bool pipelined = parameters["pipelined"].is_set()
+    ? parameters["pipelined"] : false;
+  if (_method == "pipecg" or (_method == "cg" and pipelined))
+  {
+    // The recurrences of pipelined CG rely on the preconditioner
+    // being symmetric
+    if (_pc == "ilu")
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "unable to solve linear system with Eigen Krylov solver",
+                   "Pipelined CG requires a symmetric preconditioner (\"none\" or \"jacobi\")");
+    }
+
+    if (_pc == "none")
+    {
+      Eigen::IdentityPreconditioner pc;
+      return call_pipelined_cg(pc, x, b);
+    }
+    else
+    {
+      Eigen::DiagonalPreconditioner<double> pc;
+      return call_pipelined_cg(pc, x, b);
+    }
+  }
+
   std::size_t num_iterations = 0;
 
   if (_method == "cg")
@@ -325,23 +412,22 @@ void EigenKrylovSolver::init(const std::string method,
 }
 //-----------------------------------------------------------------------------
 template <typename Solver>
-std::size_t EigenKrylovSolver::call_solver(Solver& solver,
-                                           GenericVector& x,
-                                           const GenericVector& b)
+std::size_t
+EigenKrylovSolver::call_solver(Solver& solver,
+                               const std::vector<EigenVector*>& x,
+                               const std::vector<const EigenVector*>& b)
 {
   std::string timer_title = "Eigen Krylov solver (" + _method + ")";
   Timer timer(timer_title);
 
-  EigenVector& _x = as_type<EigenVector>(x);
-  const EigenVector& _b = as_type<const EigenVector>(b);
-
   if (parameters["relative_tolerance"].is_set())
     solver.setTolerance(parameters["relative_tolerance"]);
 
   if (parameters["maximum_iterations"].is_set())
     solver.setMaxIterations((int) parameters["maximum_iterations"]);
 
-  // Prepare solver
+  // Prepare solver (computes the preconditioner once for all
+  // right-hand sides)
   solver.compute(_matA->mat());
   if (solver.info() != Eigen::Success)
   {
@@ -350,49 +436,353 @@ std::size_t EigenKrylovSolver::call_solver(Solver& solver,
                  "Preconditioner might fail");
   }
 
-  // Call approriate solve function
-  dolfin_assert(_b.vec());
-  dolfin_assert(_x.vec());
-  if (parameters["nonzero_initial_guess"].is_set())
+  const bool nonzero_guess = parameters["nonzero_initial_guess"].is_set()
+    ? parameters["nonzero_initial_guess"] : false;
+  bool error_on_nonconvergence = parameters["error_on_nonconvergence"].is_set() ? parameters["error_on_nonconvergence"] : true;
+
+  int max_num_iterations = 0;
+  for (std::size_t i = 0; i < b.size(); ++i)
   {
-    const bool nonzero_guess = parameters["nonzero_initial_guess"];
+    // Call approriate solve function
+    dolfin_assert(b[i]->vec());
+    dolfin_assert(x[i]->vec());
     if (nonzero_guess)
-      *_x.vec() = solver.solveWithGuess(*_b.vec(), *_x.vec());
+      *x[i]->vec() = solver.solveWithGuess(*b[i]->vec(), *x[i]->vec());
     else
-      *_x.vec() = solver.solve(*_b.vec());
+      *x[i]->vec() = solver.solve(*b[i]->vec());
+
+    // Get number of solver iterations
+    const int num_iterations = solver.iterations();
+    max_num_iterations = std::max(max_num_iterations, num_iterations);
+
+    // Handle case that solver fails to converge
+    if (solver.info() != Eigen::Success)
+    {
+      if (num_iterations >= solver.maxIterations())
+      {
+        if (error_on_nonconvergence)
+        {
+          dolfin_error("EigenKrylovSolver.cpp",
+                       "solve A.x = b",
+                       "Max iterations (%d) exceeded", solver.maxIterations());
+        }
+        else
+        {
+          warning("Krylov solver did not converge in %i iterations",
+                  solver.maxIterations());
+        }
+      }
+      else
+      {
+        dolfin_error("EigenKrylovSolver.cpp",
+                     "solve A.x = b",
+                     "Solver failed");
+      }
+    }
   }
-  else
-    *_x.vec() = solver.solve(*_b.vec());
 
-  // Get number of solver iterations
-  const int num_iterations = solver.iterations();
+  return max_num_iterations;
+}
+//-----------------------------------------------------------------------------
+template <typename Preconditioner>
+std::size_t
+EigenKrylovSolver::call_block_cg(Preconditioner& pc,
+                                 const std::vector<EigenVector*>& x,
+                                 const std::vector<const EigenVector*>& b)
+{
+  std::string timer_title = "Eigen Krylov solver (block cg)";
+  Timer timer(timer_title);
+
+  const EigenMatrix::eigen_matrix_type& A = _matA->mat();
+  const std::size_t n = A.rows();
+  const std::size_t s = b.size();
+
+  // Tolerances follow the Eigen solvers: column i has converged when
+  // |r_i| <= max(rtol*|b_i|, atol)
+  const double rtol = parameters["relative_tolerance"].is_set()
+    ? (double) parameters["relative_tolerance"]
+    : Eigen::NumTraits<double>::epsilon();
+  const double atol = parameters["absolute_tolerance"].is_set()
+    ? (double) parameters["absolute_tolerance"] : 0.0;
+  const int max_iterations = parameters["maximum_iterations"].is_set()
+    ? (int) parameters["maximum_iterations"] : 2*A.cols();
+  const bool nonzero_guess = parameters["nonzero_initial_guess"].is_set()
+    ? parameters["nonzero_initial_guess"] : false;
+
+  pc.compute(A);
+  if (pc.info() != Eigen::Success)
+  {
+    dolfin_error("EigenKrylovSolver.cpp",
+                 "prepare Krylov solver",
+                 "Preconditioner might fail");
+  }
+
+  // Pack solution and right-hand sides into blocks
+  Eigen::MatrixXd X(n, s), R(n, s);
+  std::vector<double> threshold(s);
+  for (std::size_t i = 0; i < s; ++i)
+  {
+    if (nonzero_guess)
+      X.col(i) = *x[i]->vec();
+    else
+      X.col(i).setZero();
+    R.col(i) = *b[i]->vec();
+    threshold[i] = std::max(rtol*R.col(i).norm(), atol);
+  }
+  if (nonzero_guess)
+    R.noalias() -= A*X;
+
+  // Indices of columns which have not converged
+  std::vector<std::size_t> active;
+  for (std::size_t i = 0; i < s; ++i)
+    if (R.col(i).norm() > threshold[i])
+      active.push_back(i);
+
+  // Select columns (given by position) of a block
+  auto select = [](const Eigen::MatrixXd& M, const std::vector<std::size_t>& c)
+    {
+      Eigen::MatrixXd S(M.rows(), c.size());
+      for (std::size_t j = 0; j < c.size(); ++j)
+        S.col(j) = M.col(c[j]);
+      return S;
+    };
+
+  // Apply preconditioner to each column
+  auto precondition = [&pc](const Eigen::MatrixXd& M)
+    {
+      Eigen::MatrixXd Z(M.rows(), M.cols());
+      for (int j = 0; j < M.cols(); ++j)
+        Z.col(j) = pc.solve(M.col(j));
+      return Z;
+    };
+
+  // Orthonormal basis for the range of a block. Linearly dependent
+  // directions are dropped, which avoids breakdown when right-hand
+  // sides (or residuals) are (nearly) linearly dependent.
+  auto orthonormalize = [](const Eigen::MatrixXd& M)
+    {
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(M);
+      qr.setThreshold(std::sqrt(Eigen::NumTraits<double>::epsilon()));
+      const Eigen::MatrixXd Q = qr.householderQ();
+      return Eigen::MatrixXd(Q.leftCols(qr.rank()));
+    };
+
+  // Breakdown-free block CG (Ji and Li, 2017). The search space P
+  // has at most as many columns as there are unconverged right-hand
+  // sides.
+  R = select(R, active);
+  Eigen::MatrixXd P = orthonormalize(precondition(R));
+  Eigen::MatrixXd Q;
+
+  int num_iterations = 0;
+  bool breakdown = false;
+  while (!active.empty() and num_iterations < max_iterations)
+  {
+    // No search directions are left if the preconditioned residuals
+    // are (numerically) in the span of the previous directions
+    if (P.cols() == 0)
+    {
+      breakdown = true;
+      break;
+    }
+
+    // Step length for all search directions
+    Q.noalias() = A*P;
+    const Eigen::LDLT<Eigen::MatrixXd> PQ(P.transpose()*Q);
+    const Eigen::MatrixXd alpha = PQ.solve(P.transpose()*R);
+
+    // Update solution and residual
+    const Eigen::MatrixXd dX = P*alpha;
+    for (std::size_t j = 0; j < active.size(); ++j)
+      X.col(active[j]) += dX.col(j);
+    R.noalias() -= Q*alpha;
+    ++num_iterations;
+
+    // Remove converged columns from the block (deflation)
+    std::vector<std::size_t> keep;
+    for (std::size_t j = 0; j < active.size(); ++j)
+      if (R.col(j).norm() > threshold[active[j]])
+        keep.push_back(j);
+
+    if (keep.size() < active.size())
+    {
+      std::vector<std::size_t> still_active;
+      for (auto j : keep)
+        still_active.push_back(active[j]);
+      active = still_active;
+      if (active.empty())
+        break;
+      R = select(R, keep);
+    }
+
+    // Update search directions, A-orthogonal to the previous ones
+    const Eigen::MatrixXd Z = precondition(R);
+    const Eigen::MatrixXd beta = -PQ.solve(Q.transpose()*Z);
+    P = orthonormalize(Z + P*beta);
+  }
+
+  // Unpack solution
+  for (std::size_t i = 0; i < s; ++i)
+    *x[i]->vec() = X.col(i);
 
   // Handle case that solver fails to converge
+  if (!active.empty())
+  {
+    bool error_on_nonconvergence = parameters["error_on_nonconvergence"].is_set() ? parameters["error_on_nonconvergence"] : true;
+    if (breakdown and error_on_nonconvergence)
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "solve A.X = B",
+                   "Block CG broke down after %d iterations, as no linearly independent search directions are left",
+                   num_iterations);
+    }
+    else if (breakdown)
+    {
+      warning("Block CG broke down after %i iterations", num_iterations);
+    }
+    else if (error_on_nonconvergence)
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "solve A.X = B",
+                   "Max iterations (%d) exceeded", max_iterations);
+    }
+    else
+    {
+      warning("Krylov solver did not converge in %i iterations",
+              max_iterations);
+    }
+  }
+
+  return num_iterations;
+}
+//-----------------------------------------------------------------------------
+template <typename Preconditioner>
+std::size_t
+EigenKrylovSolver::call_pipelined_cg(Preconditioner& pc,
+                                     const std::vector<EigenVector*>& x,
+                                     const std::vector<const EigenVector*>& b)
+{
+  std::string timer_title = "Eigen Krylov solver (pipelined cg)";
+  Timer timer(timer_title);
+
+  const EigenMatrix::eigen_matrix_type& A = _matA->mat();
+  const std::size_t n = A.rows();
+
+  // Tolerances follow the Eigen solvers: converged when
+  // |r| <= max(rtol*|b|, atol)
+  const double rtol = parameters["relative_tolerance"].is_set()
+    ? (double) parameters["relative_tolerance"]
+    : Eigen::NumTraits<double>::epsilon();
+  const double atol = parameters["absolute_tolerance"].is_set()
+    ? (double) parameters["absolute_tolerance"] : 0.0;
+  const int max_iterations = parameters["maximum_iterations"].is_set()
+    ? (int) parameters["maximum_iterations"] : 2*A.cols();
+  const bool nonzero_guess = parameters["nonzero_initial_guess"].is_set()
+    ? parameters["nonzero_initial_guess"] : false;
+  const bool report = parameters["report"].is_set()
+    ? parameters["report"] : false;
   bool error_on_nonconvergence = parameters["error_on_nonconvergence"].is_set() ? parameters["error_on_nonconvergence"] : true;
-  if (solver.info() != Eigen::Success)
+
+  pc.compute(A);
+  if (pc.info() != Eigen::Success)
   {
-    if (num_iterations >= solver.maxIterations())
+    dolfin_error("EigenKrylovSolver.cpp",
+                 "prepare Krylov solver",
+                 "Preconditioner might fail");
+  }
+
+  int max_num_iterations = 0;
+  for (std::size_t c = 0; c < b.size(); ++c)
+  {
+    Eigen::VectorXd& xc = *x[c]->vec();
+    const Eigen::VectorXd& bc = *b[c]->vec();
+    if (!nonzero_guess)
+      xc.setZero();
+
+    // Pipelined CG (Ghysels and Vanroose, 2014). The inner products
+    // of an iteration are computed together (a single global
+    // reduction in parallel) and only consumed after the next
+    // preconditioner application and matrix-vector product, so that
+    // the reduction can overlap with them.
+    Eigen::VectorXd r = bc - A*xc;
+    Eigen::VectorXd u = pc.solve(r);
+    Eigen::VectorXd w = A*u;
+    Eigen::VectorXd m(n), nv(n);
+    Eigen::VectorXd p = Eigen::VectorXd::Zero(n), s = p, q = p, z = p;
+
+    const double threshold = std::max(rtol*bc.norm(), atol);
+    double gamma_old = 0.0, alpha = 0.0;
+    int num_iterations = 0;
+    std::size_t num_reductions = 0;
+    bool converged = false;
+    while (num_iterations < max_iterations)
+    {
+      // Fused reduction: (r, u), (w, u) and (r, r)
+      double gamma = 0.0, delta = 0.0, rr = 0.0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        gamma += r[i]*u[i];
+        delta += w[i]*u[i];
+        rr += r[i]*r[i];
+      }
+      ++num_reductions;
+
+      if (std::sqrt(rr) <= threshold)
+      {
+        converged = true;
+        break;
+      }
+
+      // Work overlapping the reduction
+      m = pc.solve(w);
+      nv.noalias() = A*m;
+
+      double beta = 0.0;
+      if (num_iterations > 0)
+      {
+        beta = gamma/gamma_old;
+        alpha = gamma/(delta - beta*gamma/alpha);
+      }
+      else
+        alpha = gamma/delta;
+      gamma_old = gamma;
+
+      z = nv + beta*z;
+      q = m + beta*q;
+      s = w + beta*s;
+      p = u + beta*p;
+      xc += alpha*p;
+      r -= alpha*s;
+      u -= alpha*q;
+      w -= alpha*z;
+      ++num_iterations;
+    }
+
+    max_num_iterations = std::max(max_num_iterations, num_iterations);
+    if (report)
+    {
+      info("Eigen Krylov solver (pipecg, %s) %s in %d iterations with %ld global reductions.",
+           _pc.c_str(), converged ? "converged" : "failed to converge",
+           num_iterations, num_reductions);
+    }
+
+    // Handle case that solver fails to converge
+    if (!converged)
     {
       if (error_on_nonconvergence)
       {
         dolfin_error("EigenKrylovSolver.cpp",
                      "solve A.x = b",
-                     "Max iterations (%d) exceeded", solver.maxIterations());
+                     "Max iterations (%d) exceeded", max_iterations);
       }
       else
       {
         warning("Krylov solver did not converge in %i iterations",
-                solver.maxIterations());
+                max_iterations);
       }
     }
-    else
-    {
-      dolfin_error("EigenKrylovSolver.cpp",
-                   "solve A.x = b",
-                   "Solver failed");
-    }
   }
 
-  return num_iterations;
+  return max_num_iterations;
 }
 //-----------------------------------------------------------------------------
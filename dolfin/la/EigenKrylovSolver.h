@@ -22,6 +22,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 #include <dolfin/common/types.h>
 #include "GenericLinearSolver.h"
 
@@ -80,6 +81,15 @@ namespace dolfin
     std::size_t solve(const EigenMatrix& A, EigenVector& x,
                       const EigenVector& b);
 
+    /// Solve linear systems Ax_i = b_i for multiple right-hand sides
+    /// and return number of iterations. The conjugate gradient method
+    /// uses a block CG iteration with dense block operations, other
+    /// methods compute the preconditioner once for all right-hand
+    /// sides.
+    std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -101,10 +111,30 @@ namespace dolfin
     // Initialize solver
     void init(const std::string method, const std::string pc="default");
 
+    // Check dimensions and solve for all right-hand sides
+    std::size_t solve_columns(const std::vector<EigenVector*>& x,
+                              const std::vector<const EigenVector*>& b);
+
     // Call with an actual solver
     template <typename Solver>
-    std::size_t call_solver(Solver& solver, GenericVector& x,
-                            const GenericVector& b);
+    std::size_t call_solver(Solver& solver,
+                            const std::vector<EigenVector*>& x,
+                            const std::vector<const EigenVector*>& b);
+
+    // Solve with the block conjugate gradient method and the given
+    // preconditioner. Columns are removed from the block as they
+    // converge.
+    template <typename Preconditioner>
+    std::size_t call_block_cg(Preconditioner& pc,
+                              const std::vector<EigenVector*>& x,
+                              const std::vector<const EigenVector*>& b);
+
+    // Solve with the pipelined conjugate gradient method and the
+    // given preconditioner, for each right-hand side
+    template <typename Preconditioner>
+    std::size_t call_pipelined_cg(Preconditioner& pc,
+                                  const std::vector<EigenVector*>& x,
+                                  const std::vector<const EigenVector*>& b);
 
     // Chosen Krylov method
     std::string _method;
@@ -61,6 +61,7 @@ class EigenLUSolver::EigenLUImplBase
 {
 public:
   virtual void solve(EigenVector &x, const EigenVector &b) = 0;
+  virtual void solve(Eigen::MatrixXd &X, const Eigen::MatrixXd &B) = 0;
   virtual ~EigenLUImplBase() {}
 };
 
@@ -105,6 +106,18 @@ public:
     }
   }
 
+  void solve(Eigen::MatrixXd &X, const Eigen::MatrixXd &B) override
+  {
+    X = _solver->solve(B);
+
+    if (_solver->info() != Eigen::Success)
+    {
+      dolfin_error("EigenLUSolver.cpp",
+                   "solve A.X = B",
+                   "Solver failed");
+    }
+  }
+
 private:
   std::shared_ptr<Solver> _solver;
   typename Solver::MatrixType _A;
@@ -230,69 +243,8 @@ std::size_t EigenLUSolver::solve(GenericVector& x, const GenericVector& b)
   if (x.empty())
     _matA->init_vector(x, 1);
 
-  // Initialize Eigen LU solver and compute factorization
-  if (!_impl) {
-    if (_method == "sparselu")
-    {
-      typedef Eigen::SparseLU<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                              Eigen::COLAMDOrdering<int>> Solver;
-
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-    else if (_method == "cholesky")
-    {
-      typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                                    Eigen::Lower> Solver;
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#ifdef HAS_CHOLMOD
-    else if (_method == "cholmod")
-    {
-      typedef Eigen::CholmodDecomposition<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                                          Eigen::Lower> Solver;
-      auto solver = std::make_shared<Solver>();
-      solver->setMode(Eigen::CholmodLDLt);
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#endif
-#ifdef EIGEN_PASTIX_SUPPORT
-    else if (_method == "pastix")
-    {
-      typedef Eigen::PastixLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#endif
-#ifdef EIGEN_PARDISO_SUPPORT
-    else if (_method == "pardiso")
-    {
-      typedef Eigen::PardisoLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#endif
-#ifdef EIGEN_SUPERLU_SUPPORT
-    else if (_method == "superlu")
-    {
-      typedef Eigen::SuperLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#endif
-#ifdef HAS_UMFPACK
-    else if (_method == "umfpack")
-    {
-      typedef Eigen::UmfPackLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
-      auto solver = std::make_shared<Solver>();
-      _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
-    }
-#endif
-    else
-      dolfin_error("EigenLUSolver.cpp", "solve A.x =b",
-                   "Unknown method \"%s\"", _method.c_str());
-  }
+  // Compute factorization
+  factorize();
 
   // Solve linear system
   _impl->solve(_x, _b);
@@ -317,6 +269,54 @@ std::size_t EigenLUSolver::solve(const EigenMatrix& A, EigenVector& x,
   return solve(x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t EigenLUSolver::solve_multiple(
+  const std::vector<std::shared_ptr<GenericVector>>& x,
+  const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  const std::string timer_title = "Eigen LU solver (" + _method + ")";
+  Timer timer(timer_title);
+
+  dolfin_assert(_matA);
+  if (x.size() != b.size())
+  {
+    dolfin_error("EigenLUSolver.cpp",
+                 "solve linear systems using Eigen LU solver",
+                 "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                 x.size(), b.size());
+  }
+
+  // Pack right-hand sides into columns of a dense matrix
+  const std::size_t n = _matA->size(0);
+  Eigen::MatrixXd B(n, b.size());
+  for (std::size_t i = 0; i < b.size(); ++i)
+  {
+    dolfin_assert(b[i]);
+    if (b[i]->size() != n)
+    {
+      dolfin_error("EigenLUSolver.cpp",
+                   "solve linear systems using Eigen LU solver",
+                   "Non-matching dimensions for right-hand side %d", i);
+    }
+    B.col(i) = *as_type<const EigenVector>(*b[i]).vec();
+  }
+
+  // Compute factorization and solve for all columns
+  factorize();
+  Eigen::MatrixXd X;
+  _impl->solve(X, B);
+
+  // Unpack solution
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    if (x[i]->empty())
+      _matA->init_vector(*x[i], 1);
+    *as_type<EigenVector>(*x[i]).vec() = X.col(i);
+  }
+
+  return 1;
+}
+//-----------------------------------------------------------------------------
 std::string EigenLUSolver::str(bool verbose) const
 {
   std::stringstream s;
@@ -343,3 +343,71 @@ std::string EigenLUSolver::select_solver(const std::string method) const
   return method;
 }
 //-----------------------------------------------------------------------------
+void EigenLUSolver::factorize()
+{
+  if (_impl)
+    return;
+
+  // Initialize Eigen LU solver and compute factorization
+  if (_method == "sparselu")
+  {
+    typedef Eigen::SparseLU<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                            Eigen::COLAMDOrdering<int>> Solver;
+
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+  else if (_method == "cholesky")
+  {
+    typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                                  Eigen::Lower> Solver;
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#ifdef HAS_CHOLMOD
+  else if (_method == "cholmod")
+  {
+    typedef Eigen::CholmodDecomposition<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                                        Eigen::Lower> Solver;
+    auto solver = std::make_shared<Solver>();
+    solver->setMode(Eigen::CholmodLDLt);
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#endif
+#ifdef EIGEN_PASTIX_SUPPORT
+  else if (_method == "pastix")
+  {
+    typedef Eigen::PastixLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#endif
+#ifdef EIGEN_PARDISO_SUPPORT
+  else if (_method == "pardiso")
+  {
+    typedef Eigen::PardisoLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#endif
+#ifdef EIGEN_SUPERLU_SUPPORT
+  else if (_method == "superlu")
+  {
+    typedef Eigen::SuperLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#endif
+#ifdef HAS_UMFPACK
+  else if (_method == "umfpack")
+  {
+    typedef Eigen::UmfPackLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> Solver;
+    auto solver = std::make_shared<Solver>();
+    _impl.reset(new EigenLUImpl<Solver>(solver, *_matA));
+  }
+#endif
+  else
+    dolfin_error("EigenLUSolver.cpp", "solve A.x =b",
+                 "Unknown method \"%s\"", _method.c_str());
+}
+//-----------------------------------------------------------------------------
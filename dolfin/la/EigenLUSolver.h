@@ -70,6 +70,14 @@ namespace dolfin
     std::size_t solve(const EigenMatrix& A, EigenVector& x,
                       const EigenVector& b);
 
+    /// Solve linear systems Ax_i = b_i for multiple right-hand
+    /// sides. The factorization is computed once and all right-hand
+    /// sides are solved for with a single multi-column triangular
+    /// solve.
+    std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -98,6 +106,9 @@ namespace dolfin
     // Select LU solver type
     std::string select_solver(const std::string method) const;
 
+    // Compute factorization of operator if not already computed
+    void factorize();
+
     // Operator (the matrix)
     std::shared_ptr<const EigenMatrix> _matA;
 
@@ -354,6 +354,18 @@ EigenMatrix:: data() const
                          _matA.valuePtr(), _matA.nonZeros());
 }
 //----------------------------------------------------------------------------
+std::size_t EigenMatrix::memory_usage() const
+{
+  // Values and column indices, row offsets and (if not compressed)
+  // row sizes
+  std::size_t bytes = sizeof(*this)
+    + _matA.data().allocatedSize()*(sizeof(double) + sizeof(int))
+    + (_matA.outerSize() + 1)*sizeof(int);
+  if (!_matA.isCompressed())
+    bytes += _matA.outerSize()*sizeof(int);
+  return bytes;
+}
+//----------------------------------------------------------------------------
 std::string EigenMatrix::str(bool verbose) const
 {
   std::stringstream s;
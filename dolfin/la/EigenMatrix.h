@@ -212,6 +212,9 @@ namespace dolfin
     void compress()
     {  _matA.makeCompressed(); }
 
+    /// Return number of bytes allocated for the matrix
+    std::size_t memory_usage() const;
+
     /// Access value of given entry
     double operator() (dolfin::la_index i, dolfin::la_index j) const
     { return _matA.coeff(i, j); }
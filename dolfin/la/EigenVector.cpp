@@ -16,17 +16,22 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <unordered_set>
 
 #include <dolfin/log/log.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/Array.h>
+#include <dolfin/common/utils.h>
 #include "EigenVector.h"
 #include "EigenFactory.h"
 #include "GenericLinearAlgebraFactory.h"
+#include "GhostScatter.h"
+#include "IndexMap.h"
 
 using namespace dolfin;
 
@@ -39,22 +44,23 @@ EigenVector::EigenVector() : EigenVector(MPI_COMM_SELF)
 EigenVector::EigenVector(MPI_Comm comm) : _x(new Eigen::VectorXd),
                                           _mpi_comm(comm)
 {
-  // Check size of communicator
-  check_mpi_size(comm);
+  // Do nothing
 }
 //-----------------------------------------------------------------------------
 EigenVector::EigenVector(MPI_Comm comm, std::size_t N)
-  : _x(new Eigen::VectorXd(N)), _mpi_comm(comm)
+  : _x(new Eigen::VectorXd), _mpi_comm(comm)
 {
-  // Check size of communicator
-  check_mpi_size(comm);
-
-  // Zero vector
-  _x->setZero();
+  // Initialise and zero vector
+  init(N);
 }
 //-----------------------------------------------------------------------------
 EigenVector::EigenVector(const EigenVector& x)
-  : _x(new Eigen::VectorXd(*(x._x))), _mpi_comm(x._mpi_comm.comm())
+  : _x(new Eigen::VectorXd(*(x._x))), _mpi_comm(x._mpi_comm.comm()),
+    _index_map(x._index_map), _scatter(x._scatter),
+    _ghost_values(x._ghost_values),
+    _ghost_global_to_local(x._ghost_global_to_local),
+    _ghost_stash(x._ghost_stash.size(), 0.0),
+    _ghost_stash_set(x._ghost_stash_set.size(), 0)
 {
   // Do nothing
 }
@@ -76,10 +82,71 @@ std::shared_ptr<GenericVector> EigenVector::copy() const
   return y;
 }
 //-----------------------------------------------------------------------------
+void EigenVector::init(std::size_t N)
+{
+  if (MPI::size(mpi_comm()) == 1)
+    init(std::make_pair(0, N));
+  else
+    init(MPI::local_range(mpi_comm(), N));
+}
+//-----------------------------------------------------------------------------
+void EigenVector::init(std::pair<std::size_t, std::size_t> range)
+{
+  std::vector<std::size_t> local_to_global_map;
+  std::vector<la_index> ghost_indices;
+  init(range, local_to_global_map, ghost_indices);
+}
+//-----------------------------------------------------------------------------
+void EigenVector::init(std::pair<std::size_t, std::size_t> range,
+                       const std::vector<std::size_t>& local_to_global_map,
+                       const std::vector<la_index>& ghost_indices)
+{
+  if (!empty())
+  {
+    dolfin_error("EigenVector.cpp",
+                 "calling EigenVector::init(...)",
+                 "Cannot call init for a non-empty vector. Use EigenVector::resize instead");
+  }
+
+  const std::size_t local_size = range.second - range.first;
+  if (MPI::size(mpi_comm()) == 1)
+  {
+    if (!ghost_indices.empty())
+    {
+      dolfin_error("EigenVector.cpp",
+                   "calling EigenVector::init(...)",
+                   "Ghost values require a distributed vector");
+    }
+
+    dolfin_assert(range.first == 0);
+    resize(local_size);
+    return;
+  }
+
+  // Build distributed layout with ghost entries
+  _index_map = std::make_shared<IndexMap>(mpi_comm(), local_size, 1);
+  dolfin_assert(_index_map->local_range() == range);
+  std::vector<std::size_t> ghosts(ghost_indices.begin(), ghost_indices.end());
+  _index_map->set_local_to_global(ghosts);
+
+  // Build persistent scatter plan for ghost updates (collective)
+  _scatter = std::make_shared<GhostScatter>(*_index_map);
+
+  _ghost_global_to_local.clear();
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+    _ghost_global_to_local[ghosts[i]] = i;
+
+  _x->resize(local_size);
+  _x->setZero();
+  _ghost_values.assign(ghosts.size(), 0.0);
+  _ghost_stash.assign(ghosts.size(), 0.0);
+  _ghost_stash_set.assign(ghosts.size(), 0);
+}
+//-----------------------------------------------------------------------------
 bool EigenVector::empty() const
 {
   dolfin_assert(_x);
-  if (_x->size() == 0)
+  if (size() == 0)
     return true;
   else
     return false;
@@ -87,27 +154,108 @@ bool EigenVector::empty() const
 //-----------------------------------------------------------------------------
 std::size_t EigenVector::size() const
 {
-  return _x->size();
+  if (distributed())
+    return _index_map->size(IndexMap::MapSize::GLOBAL);
+  else
+    return _x->size();
 }
 //-----------------------------------------------------------------------------
 std::pair<std::int64_t, std::int64_t> EigenVector::local_range() const
 {
-  return std::make_pair(0, size());
+  if (distributed())
+    return _index_map->local_range();
+  else
+    return std::make_pair(0, size());
 }
 //-----------------------------------------------------------------------------
 bool EigenVector::owns_index(std::size_t i) const
 {
-  if (i < size())
+  const auto range = local_range();
+  if ((std::int64_t) i >= range.first and (std::int64_t) i < range.second)
     return true;
   else
     return false;
 }
 //-----------------------------------------------------------------------------
+std::size_t EigenVector::global_to_local(std::size_t i) const
+{
+  if (!distributed())
+    return i;
+
+  const auto range = _index_map->local_range();
+  if (i >= range.first and i < range.second)
+    return i - range.first;
+
+  const auto ghost = _ghost_global_to_local.find(i);
+  if (ghost == _ghost_global_to_local.end())
+  {
+    dolfin_error("EigenVector.cpp",
+                 "access entry of Eigen vector",
+                 "Global index %d is neither owned nor ghosted by this process",
+                 i);
+  }
+
+  return _x->size() + ghost->second;
+}
+//-----------------------------------------------------------------------------
+void EigenVector::set_local_value(std::size_t i, double value)
+{
+  const std::size_t n = _x->size();
+  if (i < n)
+    (*_x)(i) = value;
+  else
+  {
+    dolfin_assert(i - n < _ghost_stash.size());
+    _ghost_stash[i - n] = value;
+    _ghost_stash_set[i - n] = 1;
+  }
+}
+//-----------------------------------------------------------------------------
+void EigenVector::add_local_value(std::size_t i, double value)
+{
+  const std::size_t n = _x->size();
+  if (i < n)
+    (*_x)(i) += value;
+  else
+  {
+    dolfin_assert(i - n < _ghost_stash.size());
+    _ghost_stash[i - n] += value;
+    _ghost_stash_set[i - n] = 1;
+  }
+}
+//-----------------------------------------------------------------------------
+void EigenVector::get(double* block, std::size_t m,
+                      const dolfin::la_index* rows) const
+{
+  if (!distributed())
+  {
+    get_local(block, m, rows);
+    return;
+  }
+
+  const std::size_t n = _x->size();
+  for (std::size_t i = 0; i < m; i++)
+  {
+    const std::size_t index = global_to_local(rows[i]);
+    block[i] = index < n ? (*_x)(index) : _ghost_values[index - n];
+  }
+}
+//-----------------------------------------------------------------------------
 void EigenVector::get_local(double* block, std::size_t m,
                             const dolfin::la_index* rows) const
 {
+  const std::size_t n = _x->size();
   for (std::size_t i = 0; i < m; i++)
-    block[i] = (*_x)(rows[i]);
+  {
+    const std::size_t index = rows[i];
+    if (index < n)
+      block[i] = (*_x)(index);
+    else
+    {
+      dolfin_assert(index - n < _ghost_values.size());
+      block[i] = _ghost_values[index - n];
+    }
+  }
 }
 //-----------------------------------------------------------------------------
 void EigenVector::get_local(std::vector<double>& values) const
@@ -117,14 +265,14 @@ void EigenVector::get_local(std::vector<double>& values) const
 //-----------------------------------------------------------------------------
 void EigenVector::set_local(const std::vector<double>& values)
 {
-  dolfin_assert(values.size() == size());
+  dolfin_assert(values.size() == local_size());
   Eigen::Map<const Eigen::VectorXd> _values(values.data(), values.size());
   *_x = _values;
 }
 //-----------------------------------------------------------------------------
 void EigenVector::add_local(const Array<double>& values)
 {
-  dolfin_assert(values.size() == size());
+  dolfin_assert(values.size() == local_size());
   Eigen::Map<const Eigen::VectorXd> _values(values.data(), values.size());
   *_x += _values;
 }
@@ -138,52 +286,122 @@ void EigenVector::gather(GenericVector& x,
 void EigenVector::gather(std::vector<double>& x,
                          const std::vector<dolfin::la_index>& indices) const
 {
+  // Entries must be owned or ghosted by this process
   const std::size_t _size = indices.size();
   x.resize(_size);
   dolfin_assert(x.size() == _size);
-  for (std::size_t i = 0; i < _size; i++)
-    x[i] = (*_x)(indices[i]);
+  get(x.data(), _size, indices.data());
 }
 //-----------------------------------------------------------------------------
 void EigenVector::gather_on_zero(std::vector<double>& x) const
 {
-  get_local(x);
+  if (!distributed())
+  {
+    get_local(x);
+    return;
+  }
+
+  std::vector<double> values;
+  get_local(values);
+  MPI::gather(mpi_comm(), values, x);
 }
 //-----------------------------------------------------------------------------
 void EigenVector::set(const double* block, std::size_t m,
                       const dolfin::la_index* rows)
 {
   for (std::size_t i = 0; i < m; i++)
-    (*_x)(rows[i]) = block[i];
+    set_local_value(global_to_local(rows[i]), block[i]);
+}
+//-----------------------------------------------------------------------------
+void EigenVector::set_local(const double* block, std::size_t m,
+                            const dolfin::la_index* rows)
+{
+  for (std::size_t i = 0; i < m; i++)
+    set_local_value(rows[i], block[i]);
 }
 //-----------------------------------------------------------------------------
 void EigenVector::add(const double* block, std::size_t m,
                       const dolfin::la_index* rows)
 {
   for (std::size_t i = 0; i < m; i++)
-    (*_x)(rows[i]) += block[i];
+    add_local_value(global_to_local(rows[i]), block[i]);
+}
+//-----------------------------------------------------------------------------
+void EigenVector::add_local(const double* block, std::size_t m,
+                            const dolfin::la_index* rows)
+{
+  for (std::size_t i = 0; i < m; i++)
+    add_local_value(rows[i], block[i]);
 }
 //-----------------------------------------------------------------------------
 void EigenVector::apply(std::string mode)
 {
-  // Do nothing
+  if (!distributed())
+    return;
+
+  Timer timer("Apply (EigenVector)");
+  dolfin_assert(_scatter);
+
+  // Send stashed ghost contributions to owners
+  if (mode == "add")
+  {
+    _scatter->reverse(_ghost_stash.data(),
+                      [this](std::size_t i, double value)
+                      { (*_x)(i) += value; });
+  }
+  else if (mode == "insert")
+  {
+    std::vector<std::pair<double, int>> values(_ghost_stash.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+      values[i] = std::make_pair(_ghost_stash[i], _ghost_stash_set[i]);
+    _scatter->reverse(values.data(),
+                      [this](std::size_t i, const std::pair<double, int>& value)
+                      { if (value.second) (*_x)(i) = value.first; });
+  }
+  else
+  {
+    dolfin_error("EigenVector.cpp",
+                 "finalise vector",
+                 "Unknown mode \"%s\"", mode.c_str());
+  }
+
+  std::fill(_ghost_stash.begin(), _ghost_stash.end(), 0.0);
+  std::fill(_ghost_stash_set.begin(), _ghost_stash_set.end(), 0);
+
+  // Update ghost values from owners
+  update_ghost_values();
+}
+//-----------------------------------------------------------------------------
+void EigenVector::update_ghost_values()
+{
+  if (!_scatter)
+    return;
+
+  dolfin_assert(_x);
+  _scatter->forward(_x->data(), _ghost_values.data());
 }
 //-----------------------------------------------------------------------------
 void EigenVector::zero()
 {
   dolfin_assert(_x);
   _x->setZero();
+  std::fill(_ghost_values.begin(), _ghost_values.end(), 0.0);
+  std::fill(_ghost_stash.begin(), _ghost_stash.end(), 0.0);
+  std::fill(_ghost_stash_set.begin(), _ghost_stash_set.end(), 0);
 }
 //-----------------------------------------------------------------------------
 double EigenVector::norm(std::string norm_type) const
 {
   dolfin_assert(_x);
+
+  // Local contribution (squared for the l2 norm when distributed)
+  double _norm = 0.0;
   if (norm_type == "l1")
-    return _x->lpNorm<1>();
+    _norm = _x->lpNorm<1>();
   else if (norm_type == "l2")
-    return _x->lpNorm<2>();
+    _norm = distributed() ? _x->squaredNorm() : _x->lpNorm<2>();
   else if (norm_type == "linf")
-    return _x->lpNorm<Eigen::Infinity>();
+    _norm = _x->size() > 0 ? _x->lpNorm<Eigen::Infinity>() : 0.0;
   else
   {
     dolfin_error("EigenVector.cpp",
@@ -191,42 +409,81 @@ double EigenVector::norm(std::string norm_type) const
                  "Unknown norm type (\"%s\")", norm_type.c_str());
   }
 
-  return 0.0;
+  if (!distributed())
+    return _norm;
+  else if (norm_type == "linf")
+    return MPI::max(mpi_comm(), _norm);
+  else if (norm_type == "l2")
+    return std::sqrt(MPI::sum(mpi_comm(), _norm));
+  else
+    return MPI::sum(mpi_comm(), _norm);
 }
 //-----------------------------------------------------------------------------
 double EigenVector::min() const
 {
   dolfin_assert(_x);
-  return _x->minCoeff();
+  if (!distributed())
+    return _x->minCoeff();
+
+  const double _min = _x->size() > 0 ? _x->minCoeff()
+    : std::numeric_limits<double>::max();
+  return MPI::min(mpi_comm(), _min);
 }
 //-----------------------------------------------------------------------------
 double EigenVector::max() const
 {
   dolfin_assert(_x);
-  return _x->maxCoeff();
+  if (!distributed())
+    return _x->maxCoeff();
+
+  const double _max = _x->size() > 0 ? _x->maxCoeff()
+    : std::numeric_limits<double>::lowest();
+  return MPI::max(mpi_comm(), _max);
 }
 //-----------------------------------------------------------------------------
 double EigenVector::sum() const
 {
   dolfin_assert(_x);
-  return _x->sum();
+  if (!distributed())
+    return _x->sum();
+  return MPI::sum(mpi_comm(), _x->sum());
 }
 //-----------------------------------------------------------------------------
 double EigenVector::sum(const Array<std::size_t>& rows) const
 {
+  // In parallel, send rows to the owning process so that repeated
+  // entries are only summed once
+  std::vector<std::size_t> local_rows;
+  std::size_t offset = 0;
+  if (distributed())
+  {
+    std::vector<std::vector<std::size_t>>
+      send_rows(MPI::size(mpi_comm()));
+    for (std::size_t i = 0; i < rows.size(); ++i)
+      send_rows[_index_map->global_index_owner(rows[i])].push_back(rows[i]);
+    MPI::all_to_all(mpi_comm(), send_rows, local_rows);
+    offset = _index_map->local_range().first;
+  }
+  else
+    local_rows.assign(rows.data(), rows.data() + rows.size());
+
   std::unordered_set<std::size_t> row_set;
   double _sum = 0.0;
-  for (std::size_t i = 0; i < rows.size(); ++i)
+  for (std::size_t i = 0; i < local_rows.size(); ++i)
   {
-    const std::size_t index = rows[i];
-    dolfin_assert(index < size());
+    const std::size_t index = local_rows[i] - offset;
+    dolfin_assert(index < local_size());
     if (row_set.find(index) == row_set.end())
     {
       _sum += (*_x)[index];
       row_set.insert(index);
     }
   }
-  return _sum;
+
+  if (distributed())
+    return MPI::sum(mpi_comm(), _sum);
+  else
+    return _sum;
 }
 //-----------------------------------------------------------------------------
 void EigenVector::axpy(double a, const GenericVector& y)
@@ -241,12 +498,15 @@ void EigenVector::axpy(double a, const GenericVector& y)
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
   (*_x) = _x->array() + a * _y->array();
+  update_ghost_values();
 }
 //-----------------------------------------------------------------------------
 void EigenVector::abs()
 {
   dolfin_assert(_x);
   (*_x) = _x->array().abs();
+  for (auto& value : _ghost_values)
+    value = std::abs(value);
 }
 //-----------------------------------------------------------------------------
 double EigenVector::inner(const GenericVector& y) const
@@ -254,6 +514,8 @@ double EigenVector::inner(const GenericVector& y) const
   dolfin_assert(_x);
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
+  if (distributed())
+    return MPI::sum(mpi_comm(), _x->dot(*_y));
   return _x->dot(*_y);
 }
 //-----------------------------------------------------------------------------
@@ -273,9 +535,19 @@ const EigenVector& EigenVector::operator= (const EigenVector& v)
                  "Consider using the copy constructor instead");
   }
 
+  // Check that vector local ranges are equal (relevant in parallel)
+  if (local_range() != v.local_range())
+  {
+    dolfin_error("EigenVector.cpp",
+                 "assign one vector to another",
+                 "Vectors must have the same parallel layout when assigning. "
+                 "Consider using the copy constructor instead");
+  }
+
   dolfin_assert(_x);
   dolfin_assert(v.vec());
   *_x = *(v.vec());
+  update_ghost_values();
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -283,6 +555,7 @@ const EigenVector& EigenVector::operator= (double a)
 {
   dolfin_assert(_x);
   _x->setConstant(a);
+  std::fill(_ghost_values.begin(), _ghost_values.end(), a);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -290,6 +563,8 @@ const EigenVector& EigenVector::operator*= (const double a)
 {
   dolfin_assert(_x);
   (*_x) *= a;
+  for (auto& value : _ghost_values)
+    value *= a;
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -299,12 +574,15 @@ const EigenVector& EigenVector::operator*= (const GenericVector& y)
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
   (*_x) = _x->cwiseProduct(*_y);
+  update_ghost_values();
   return *this;
 }
 //-----------------------------------------------------------------------------
 const EigenVector& EigenVector::operator/= (const double a)
 {
   (*_x) /= a;
+  for (auto& value : _ghost_values)
+    value /= a;
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -313,12 +591,15 @@ const EigenVector& EigenVector::operator+= (const GenericVector& y)
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
   *_x = _x->array() + _y->array();
+  update_ghost_values();
   return *this;
 }
 //-----------------------------------------------------------------------------
 const EigenVector& EigenVector::operator+= (double a)
 {
   *_x = _x->array() + a;
+  for (auto& value : _ghost_values)
+    value += a;
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -327,15 +608,27 @@ const EigenVector& EigenVector::operator-= (const GenericVector& y)
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
   *_x = _x->array() - _y->array();
+  update_ghost_values();
   return *this;
 }
 //-----------------------------------------------------------------------------
 const EigenVector& EigenVector::operator-= (double a)
 {
   *_x = _x->array() - a;
+  for (auto& value : _ghost_values)
+    value -= a;
   return *this;
 }
 //-----------------------------------------------------------------------------
+std::size_t EigenVector::memory_usage() const
+{
+  return sizeof(*this) + _x->size()*sizeof(double)
+    + dolfin::memory_usage(_ghost_values)
+    + node_memory_usage<std::pair<std::size_t, std::size_t>>(_ghost_global_to_local.size())
+    + dolfin::memory_usage(_ghost_stash)
+    + dolfin::memory_usage(_ghost_stash_set);
+}
+//-----------------------------------------------------------------------------
 std::string EigenVector::str(bool verbose) const
 {
   std::stringstream s;
@@ -367,6 +660,13 @@ GenericLinearAlgebraFactory& EigenVector::factory() const
 //-----------------------------------------------------------------------------
 void EigenVector::resize(std::size_t N)
 {
+  if (distributed())
+  {
+    dolfin_error("EigenVector.cpp",
+                 "resize Eigen vector",
+                 "Cannot resize a distributed vector");
+  }
+
   if (size() == N)
     return;
   else
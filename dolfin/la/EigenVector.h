@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,8 @@ namespace dolfin
 {
 
   template<typename T> class Array;
+  class GhostScatter;
+  class IndexMap;
 
   /// This class provides a simple vector class based on Eigen.
   /// It is a simple wrapper for a Eigen vector implementing the
@@ -41,6 +44,11 @@ namespace dolfin
   /// The interface is intentionally simple. For advanced usage,
   /// access the underlying Eigen vector and use the standard Eigen
   /// interface which is documented at http://eigen.tuxfamily.org
+  ///
+  /// In parallel, the Eigen vector holds the entries owned by the
+  /// process. Ghost entries are stored separately and are updated
+  /// from their owners by update_ghost_values(). Contributions to
+  /// ghost entries are sent to the owning process by apply().
 
   class EigenVector : public GenericVector
   {
@@ -85,55 +93,17 @@ namespace dolfin
     virtual std::shared_ptr<GenericVector> copy() const;
 
     /// Initialize vector to size N
-    virtual void init(std::size_t N)
-    {
-      if (!empty())
-      {
-        dolfin_error("EigenVector.cpp",
-                     "calling EigenVector::init(...)",
-                     "Cannot call init for a non-empty vector. Use EigenVector::resize instead");
-      }
-      resize(N);
-    }
+    virtual void init(std::size_t N);
 
     /// Resize vector with given ownership range
-    virtual void init(std::pair<std::size_t, std::size_t> range)
-    {
-      if (!empty())
-      {
-        dolfin_error("EigenVector.cpp",
-                     "calling EigenVector::init(...)",
-                     "Cannot call init for a non-empty vector. Use EigenVector::resize instead");
-      }
-
-      dolfin_assert(range.first == 0);
-      const std::size_t size = range.second - range.first;
-      resize(size);
-    }
-
-    /// Resize vector with given ownership range and with ghost values
+    virtual void init(std::pair<std::size_t, std::size_t> range);
+
+    /// Resize vector with given ownership range and with ghost
+    /// values. Ghost values are communicated through a persistent
+    /// GhostScatter plan
     virtual void init(std::pair<std::size_t, std::size_t> range,
                       const std::vector<std::size_t>& local_to_global_map,
-                      const std::vector<la_index>& ghost_indices)
-    {
-      if (!empty())
-      {
-        dolfin_error("EigenVector.cpp",
-                     "calling EigenVector::init(...)",
-                     "Cannot call init for a non-empty vector. Use EigenVector::resize instead");
-      }
-
-      if (!ghost_indices.empty())
-      {
-        dolfin_error("EigenVector.cpp",
-                     "calling EigenVector::init(...)",
-                     "EigenVector does not support ghost values");
-      }
-
-      dolfin_assert(range.first == 0);
-      const std::size_t size = range.second - range.first;
-      resize(size);
-    }
+                      const std::vector<la_index>& ghost_indices);
 
     // Bring init function from GenericVector into scope
     using GenericVector::init;
@@ -146,7 +116,7 @@ namespace dolfin
 
     /// Return local size of vector
     virtual std::size_t local_size() const
-    { return size(); }
+    { return _x->size(); }
 
     /// Return local ownership range of a vector
     virtual std::pair<std::int64_t, std::int64_t> local_range() const;
@@ -156,8 +126,7 @@ namespace dolfin
 
     /// Get block of values using global indices
     virtual void get(double* block, std::size_t m,
-                     const dolfin::la_index* rows) const
-    { get_local(block, m, rows); }
+                     const dolfin::la_index* rows) const;
 
     /// Get block of values using local indices
     virtual void get_local(double* block, std::size_t m,
@@ -169,8 +138,7 @@ namespace dolfin
 
     /// Set block of values using local indices
     virtual void set_local(const double* block, std::size_t m,
-                           const dolfin::la_index* rows)
-    { set(block, m, rows); }
+                           const dolfin::la_index* rows);
 
     /// Add block of values using global indices
     virtual void add(const double* block, std::size_t m,
@@ -178,8 +146,7 @@ namespace dolfin
 
     /// Add block of values using local indices
     virtual void add_local(const double* block, std::size_t m,
-                           const dolfin::la_index* rows)
-    { add(block, m, rows); }
+                           const dolfin::la_index* rows);
 
     /// Get all values on local process
     virtual void get_local(std::vector<double>& values) const;
@@ -263,6 +230,17 @@ namespace dolfin
     /// Resize vector to size N
     virtual void resize(std::size_t N);
 
+    /// Update ghost values from the owning processes
+    void update_ghost_values();
+
+    /// Return number of ghost entries on this process
+    std::size_t num_ghosts() const
+    { return _ghost_values.size(); }
+
+    /// Return number of bytes allocated for the vector (owned and
+    /// ghost entries)
+    std::size_t memory_usage() const;
+
     /// Return reference to Eigen vector (const version)
     std::shared_ptr<const Eigen::VectorXd> vec() const
     { return _x; }
@@ -290,22 +268,39 @@ namespace dolfin
 
   private:
 
-    static void check_mpi_size(const MPI_Comm comm)
-    {
-      if (dolfin::MPI::size(comm) > 1)
-      {
-        dolfin_error("EigenVector.cpp",
-                     "creating EigenVector",
-                     "EigenVector does not support parallel communicators");
-      }
-    }
-
-    // Pointer to Eigen vector object
+    // Return true if vector is distributed across processes
+    bool distributed() const
+    { return (bool) _index_map; }
+
+    // Map global index to local index (owned or ghost)
+    std::size_t global_to_local(std::size_t i) const;
+
+    // Set or add a value by local index, stashing ghost contributions
+    // for communication in apply()
+    void set_local_value(std::size_t i, double value);
+    void add_local_value(std::size_t i, double value);
+
+    // Pointer to Eigen vector object (owned entries)
     std::shared_ptr<Eigen::VectorXd> _x;
 
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
 
+    // Distributed layout (null for vectors on a single process)
+    std::shared_ptr<IndexMap> _index_map;
+
+    // Persistent communication plan for ghost updates
+    std::shared_ptr<GhostScatter> _scatter;
+
+    // Ghost values, and map from global index to ghost position
+    std::vector<double> _ghost_values;
+    std::unordered_map<std::size_t, std::size_t> _ghost_global_to_local;
+
+    // Pending contributions to ghost entries, communicated to the
+    // owning process in apply()
+    std::vector<double> _ghost_stash;
+    std::vector<int> _ghost_stash_set;
+
   };
 
 }
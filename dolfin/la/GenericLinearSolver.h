@@ -18,6 +18,7 @@
 #ifndef __GENERIC_LINEAR_SOLVER_H
 #define __GENERIC_LINEAR_SOLVER_H
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <dolfin/common/Variable.h>
@@ -65,6 +66,33 @@ namespace dolfin
     /// Solve linear system Ax = b
     virtual std::size_t solve(GenericVector& x, const GenericVector& b) = 0;
 
+    /// Solve linear systems Ax_i = b_i for a block of right-hand
+    /// sides with the same operator, and return the number of
+    /// iterations (maximum over all right-hand sides). The default
+    /// implementation solves for each right-hand side in turn.
+    /// Backends may override this to reuse a factorization or to use
+    /// a block Krylov method.
+    virtual std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b)
+    {
+      if (x.size() != b.size())
+      {
+        dolfin_error("GenericLinearSolver.h",
+                     "solve linear systems with multiple right-hand sides",
+                     "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                     x.size(), b.size());
+      }
+
+      std::size_t num_iterations = 0;
+      for (std::size_t i = 0; i < b.size(); ++i)
+      {
+        dolfin_assert(x[i] and b[i]);
+        num_iterations = std::max(num_iterations, solve(*x[i], *b[i]));
+      }
+      return num_iterations;
+    }
+
     // FIXME: This should not be needed. Need to cleanup linear solver
     // name jungle: default, lu, iterative, direct, krylov, etc
     /// Return parameter type: "krylov_solver" or "lu_solver"
@@ -0,0 +1,111 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <map>
+#include <dolfin/common/Timer.h>
+#include "IndexMap.h"
+#include "GhostScatter.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+GhostScatter::GhostScatter(const IndexMap& index_map)
+  : _forward_comm(MPI_COMM_NULL), _reverse_comm(MPI_COMM_NULL)
+{
+  Timer timer("Build ghost scatter plan");
+
+  const MPI_Comm mpi_comm = index_map.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::size_t bs = index_map.block_size();
+  const std::size_t offset = index_map.local_range().first/bs;
+
+  const std::vector<std::size_t>& ghosts
+    = index_map.local_to_global_unowned();
+  const std::vector<int>& ghost_owners = index_map.off_process_owner();
+  dolfin_assert(ghosts.size() == ghost_owners.size());
+
+  // Group ghost (block) positions by owning process
+  std::map<int, std::vector<std::size_t>> owner_to_ghosts;
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+    owner_to_ghosts[ghost_owners[i]].push_back(i);
+
+  // Send global (block) indices of ghosts to owners and build the
+  // ghost side of the plan
+  std::vector<std::vector<std::size_t>> send_indices(num_processes);
+  for (const auto& owner : owner_to_ghosts)
+  {
+    _ghost_owners.push_back(owner.first);
+    _ghost_offsets.push_back(_ghost_indices.size());
+    for (auto i : owner.second)
+    {
+      send_indices[owner.first].push_back(ghosts[i]);
+      for (std::size_t c = 0; c < bs; ++c)
+        _ghost_indices.push_back(bs*i + c);
+    }
+    _ghost_sizes.push_back(_ghost_indices.size() - _ghost_offsets.back());
+  }
+
+  // Receive indices owned by this process that are ghosted
+  // elsewhere, and build the owner side of the plan
+  std::vector<std::vector<std::size_t>> recv_indices;
+  MPI::all_to_all(mpi_comm, send_indices, recv_indices);
+  for (std::size_t p = 0; p < recv_indices.size(); ++p)
+  {
+    if (recv_indices[p].empty())
+      continue;
+
+    _sharing_processes.push_back(p);
+    _owned_offsets.push_back(_owned_indices.size());
+    for (auto index : recv_indices[p])
+    {
+      dolfin_assert(index >= offset);
+      for (std::size_t c = 0; c < bs; ++c)
+        _owned_indices.push_back(bs*(index - offset) + c);
+    }
+    _owned_sizes.push_back(_owned_indices.size() - _owned_offsets.back());
+  }
+
+  #ifdef HAS_MPI
+  // Create graph communicators. In the forward direction data flows
+  // from owners to processes holding ghosts.
+  MPI_Dist_graph_create_adjacent(mpi_comm,
+                                 _ghost_owners.size(), _ghost_owners.data(),
+                                 MPI_UNWEIGHTED,
+                                 _sharing_processes.size(),
+                                 _sharing_processes.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                 &_forward_comm);
+  MPI_Dist_graph_create_adjacent(mpi_comm,
+                                 _sharing_processes.size(),
+                                 _sharing_processes.data(),
+                                 MPI_UNWEIGHTED,
+                                 _ghost_owners.size(), _ghost_owners.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                 &_reverse_comm);
+  #endif
+}
+//-----------------------------------------------------------------------------
+GhostScatter::~GhostScatter()
+{
+  #ifdef HAS_MPI
+  if (_forward_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_forward_comm);
+  if (_reverse_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_reverse_comm);
+  #endif
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __GHOST_SCATTER_H
+#define __GHOST_SCATTER_H
+
+#include <cstddef>
+#include <vector>
+#include <dolfin/common/MPI.h>
+
+namespace dolfin
+{
+
+  class IndexMap;
+
+  /// This class is a persistent communication plan for the ghost
+  /// (unowned) entries of an IndexMap. It is built once from
+  /// IndexMap::local_to_global_unowned and
+  /// IndexMap::off_process_owner and can then be used to send owned
+  /// values to all processes that ghost them (forward scatter), or
+  /// to send ghost contributions back to the owning process (reverse
+  /// scatter).
+  ///
+  /// Communication is performed with MPI-3 neighbourhood collectives
+  /// on distributed graph communicators, so only processes that share
+  /// ghost entries exchange data. Values are addressed by local
+  /// (unblocked) index: owned entries are in [0, n_owned) and ghost
+  /// entries are in [0, n_ghosts), ordered as in the IndexMap.
+
+  class GhostScatter
+  {
+  public:
+
+    /// Create scatter plan for the unowned entries of an IndexMap.
+    /// This constructor is collective on the IndexMap communicator
+    explicit GhostScatter(const IndexMap& index_map);
+
+    /// Destructor
+    ~GhostScatter();
+
+    // Scatter plans own MPI communicators and cannot be copied
+    GhostScatter(const GhostScatter& scatter) = delete;
+    GhostScatter& operator=(const GhostScatter& scatter) = delete;
+
+    /// Send owned values to processes which ghost them and store
+    /// the received values in ghost_values (collective)
+    template<typename T>
+      void forward(const T* owned_values, T* ghost_values) const;
+
+    /// Send ghost values to the owning processes. For each received
+    /// value, op(owned_index, value) is called on the owner
+    /// (collective)
+    template<typename T, typename Op>
+      void reverse(const T* ghost_values, Op op) const;
+
+    /// Number of owned entries which are ghosted by other processes
+    /// (counted once per ghosting process)
+    std::size_t num_shared() const
+    { return _owned_indices.size(); }
+
+    /// Number of ghost entries
+    std::size_t num_ghosts() const
+    { return _ghost_indices.size(); }
+
+    /// Number of neighbouring processes
+    std::size_t num_neighbours() const
+    { return _ghost_owners.size() + _sharing_processes.size(); }
+
+  private:
+
+    // Distributed graph communicators for the forward (owner ->
+    // ghost) and reverse (ghost -> owner) directions
+    MPI_Comm _forward_comm;
+    MPI_Comm _reverse_comm;
+
+    // Processes owning our ghosts, and processes ghosting our owned
+    // entries (neighbour order of the graph communicators)
+    std::vector<int> _ghost_owners;
+    std::vector<int> _sharing_processes;
+
+    // Local indices of owned entries to send, grouped by sharing
+    // process, with sizes and offsets into packed buffer
+    std::vector<std::size_t> _owned_indices;
+    std::vector<int> _owned_sizes, _owned_offsets;
+
+    // Ghost positions grouped by owning process, with sizes and
+    // offsets into packed buffer
+    std::vector<std::size_t> _ghost_indices;
+    std::vector<int> _ghost_sizes, _ghost_offsets;
+
+  };
+
+  //---------------------------------------------------------------------------
+  // Implementation of GhostScatter
+  //---------------------------------------------------------------------------
+  template<typename T>
+    void GhostScatter::forward(const T* owned_values, T* ghost_values) const
+  {
+    // Pack owned values for each sharing process
+    std::vector<T> send_buffer(_owned_indices.size());
+    for (std::size_t i = 0; i < _owned_indices.size(); ++i)
+      send_buffer[i] = owned_values[_owned_indices[i]];
+
+    std::vector<T> recv_buffer(_ghost_indices.size());
+    MPI::neighbor_all_to_all(_forward_comm, send_buffer, _owned_sizes,
+                             _owned_offsets, recv_buffer, _ghost_sizes,
+                             _ghost_offsets);
+
+    // Unpack into ghost positions
+    for (std::size_t i = 0; i < _ghost_indices.size(); ++i)
+      ghost_values[_ghost_indices[i]] = recv_buffer[i];
+  }
+  //---------------------------------------------------------------------------
+  template<typename T, typename Op>
+    void GhostScatter::reverse(const T* ghost_values, Op op) const
+  {
+    // Pack ghost values for each owning process
+    std::vector<T> send_buffer(_ghost_indices.size());
+    for (std::size_t i = 0; i < _ghost_indices.size(); ++i)
+      send_buffer[i] = ghost_values[_ghost_indices[i]];
+
+    std::vector<T> recv_buffer(_owned_indices.size());
+    MPI::neighbor_all_to_all(_reverse_comm, send_buffer, _ghost_sizes,
+                             _ghost_offsets, recv_buffer, _owned_sizes,
+                             _owned_offsets);
+
+    // Apply received contributions to owned entries
+    for (std::size_t i = 0; i < _owned_indices.size(); ++i)
+      op(_owned_indices[i], recv_buffer[i]);
+  }
+  //---------------------------------------------------------------------------
+
+}
+
+#endif
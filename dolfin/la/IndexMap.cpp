@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <dolfin/common/utils.h>
 #include "IndexMap.h"
 
 using namespace dolfin;
@@ -144,3 +145,10 @@ MPI_Comm IndexMap::mpi_comm() const
   return _mpi_comm.comm();
 }
 //----------------------------------------------------------------------------
+std::size_t IndexMap::memory_usage() const
+{
+  return sizeof(*this) + dolfin::memory_usage(_all_ranges)
+    + dolfin::memory_usage(_local_to_global)
+    + dolfin::memory_usage(_off_process_owner);
+}
+//----------------------------------------------------------------------------
@@ -91,6 +91,9 @@ namespace dolfin
     /// Return MPI communicator
     MPI_Comm mpi_comm() const;
 
+    /// Return number of bytes allocated for the map
+    std::size_t memory_usage() const;
+
   private:
 
     // MPI Communicator
@@ -41,6 +41,7 @@ Parameters KrylovSolver::default_parameters()
   p.add<bool>("monitor_convergence");
   p.add<bool>("error_on_nonconvergence");
   p.add<bool>("nonzero_initial_guess");
+  p.add<bool>("pipelined");
 
   return p;
 }
@@ -115,6 +116,16 @@ std::size_t KrylovSolver::solve(const GenericLinearOperator& A,
   return solver->solve(A, x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t KrylovSolver::solve_multiple(
+  const std::vector<std::shared_ptr<GenericVector>>& x,
+  const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  dolfin_assert(solver);
+  Timer timer("Krylov solver");
+  solver->parameters.update(parameters);
+  return solver->solve_multiple(x, b);
+}
+//-----------------------------------------------------------------------------
 void KrylovSolver::init(std::string method, std::string preconditioner,
                         MPI_Comm comm)
 {
@@ -34,6 +34,11 @@ namespace dolfin
   /// This class defines an interface for a Krylov solver. The
   /// appropriate solver is chosen on the basis of the matrix/vector
   /// type.
+  ///
+  /// If the parameter "pipelined" is true, the CG and GMRES methods
+  /// are replaced by pipelined variants (where available in the
+  /// backend), which need a single global reduction per iteration and
+  /// overlap it with the matrix-vector product and preconditioner.
 
   class KrylovSolver : public GenericLinearSolver
   {
@@ -76,6 +81,11 @@ namespace dolfin
     std::size_t solve(const GenericLinearOperator& A,
                       GenericVector& x, const GenericVector& b);
 
+    /// Solve linear systems Ax_i = b_i for multiple right-hand sides
+    std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Default parameter values
     static Parameters default_parameters();
 
@@ -83,6 +83,17 @@ std::size_t LUSolver::solve(const GenericLinearOperator& A, GenericVector& x,
   return solver->solve(A, x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t LUSolver::solve_multiple(
+  const std::vector<std::shared_ptr<GenericVector>>& x,
+  const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  dolfin_assert(solver);
+
+  Timer timer("LU solver");
+  solver->parameters.update(parameters);
+  return solver->solve_multiple(x, b);
+}
+//-----------------------------------------------------------------------------
 void LUSolver::init(MPI_Comm comm, std::string method)
 {
   // Get default linear algebra factory
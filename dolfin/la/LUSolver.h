@@ -20,6 +20,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "GenericLinearSolver.h"
 #include <dolfin/common/MPI.h>
 
@@ -64,6 +65,11 @@ namespace dolfin
     std::size_t solve(const GenericLinearOperator& A, GenericVector& x,
                       const GenericVector& b);
 
+    /// Solve linear systems Ax_i = b_i for multiple right-hand sides
+    std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Default parameter values
     static Parameters default_parameters()
     {
@@ -21,6 +21,7 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
 #include <petsclog.h>
 
 #include <dolfin/common/MPI.h>
@@ -48,6 +49,10 @@ const std::map<std::string, const KSPType> PETScKrylovSolver::_methods
     {"tfqmr",      KSPTFQMR},
     {"richardson", KSPRICHARDSON},
     {"bicgstab",   KSPBCGS},
+    {"pipecg",     KSPPIPECG},
+    {"pipecr",     KSPPIPECR},
+    {"pgmres",     KSPPGMRES},
+    {"pipefgmres", KSPPIPEFGMRES},
     #if PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR <= 7 && PETSC_VERSION_RELEASE == 1
     {"nash",       KSPNASH},
     {"stcg",       KSPSTCG}
@@ -64,7 +69,19 @@ PETScKrylovSolver::_methods_descr
   {"minres",     "Minimal residual method"},
   {"tfqmr",      "Transpose-free quasi-minimal residual method"},
   {"richardson", "Richardson method"},
-  {"bicgstab",   "Biconjugate gradient stabilized method"} };
+  {"bicgstab",   "Biconjugate gradient stabilized method"},
+  {"pipecg",     "Pipelined conjugate gradient method"},
+  {"pipecr",     "Pipelined conjugate residual method"},
+  {"pgmres",     "Pipelined generalized minimal residual method"},
+  {"pipefgmres", "Pipelined flexible generalized minimal residual method"} };
+
+// Map from PETSc Krylov method to its pipelined variant
+const std::map<std::string, std::string>
+PETScKrylovSolver::_pipelined_methods
+= { {KSPCG,     KSPPIPECG},
+    {KSPCR,     KSPPIPECR},
+    {KSPGMRES,  KSPPGMRES},
+    {KSPFGMRES, KSPPIPEFGMRES} };
 
 //-----------------------------------------------------------------------------
 std::map<std::string, std::string> PETScKrylovSolver::methods()
@@ -307,11 +324,64 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
     preconditioner_set = true;
   }
 
+  // Switch to pipelined variant of Krylov method (before the norm
+  // type is set, since pipelined methods support different norms)
+  const bool pipelined = this->parameters["pipelined"].is_set()
+    ? this->parameters["pipelined"] : false;
+  if (pipelined)
+  {
+    // KSP type is not set for the "default" method (GMRES). The
+    // method is mapped from the base method, which is stored so it
+    // can be restored.
+    KSPType ksp_type;
+    ierr = KSPGetType(_ksp, &ksp_type);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetType");
+    if (_base_ksp_type.empty())
+      _base_ksp_type = ksp_type ? ksp_type : KSPGMRES;
+    const std::string type = _base_ksp_type;
+
+    auto method = _pipelined_methods.find(type);
+    if (method != _pipelined_methods.end())
+    {
+      ierr = KSPSetType(_ksp, method->second.c_str());
+      if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSetType");
+    }
+    else if (std::none_of(_pipelined_methods.begin(),
+                          _pipelined_methods.end(),
+                          [&type](const std::pair<std::string, std::string>& m)
+                          { return m.second == type; }))
+    {
+      warning("PETSc Krylov method \"%s\" has no pipelined variant.",
+              type.c_str());
+    }
+  }
+  else if (!_base_ksp_type.empty())
+  {
+    // Restore base method after a pipelined solve
+    ierr = KSPSetType(_ksp, _base_ksp_type.c_str());
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSetType");
+    _base_ksp_type.clear();
+  }
+
   // Set convergence norm type
   if (this->parameters["convergence_norm_type"].is_set())
   {
     const std::string convergence_norm_type
       = this->parameters["convergence_norm_type"];
+
+    // Pipelined CG computes the preconditioned residual norm only
+    // through an additional reduction, which PETSc does not support
+    KSPType ksp_type;
+    ierr = KSPGetType(_ksp, &ksp_type);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetType");
+    if (ksp_type and std::string(ksp_type) == KSPPIPECG
+        and convergence_norm_type == "preconditioned")
+    {
+      dolfin_error("PETScKrylovSolver.cpp",
+                   "solve linear system using PETSc Krylov solver",
+                   "Pipelined CG does not support the preconditioned norm. Use \"natural\" or \"true\" for convergence_norm_type");
+    }
+
     set_norm_type(get_norm_type(convergence_norm_type));
   }
 
@@ -334,6 +404,12 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
         M, N);
   }
 
+  // Count global reductions during solve (PETSc counts reductions
+  // on communicators with more than one process only)
+  #if defined(PETSC_USE_LOG)
+  const PetscLogDouble num_reductions0 = petsc_allreduce_ct + petsc_gather_ct;
+  #endif
+
   // Solve system
   if (!transpose)
   {
@@ -346,6 +422,13 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
     if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSolve");
   }
 
+  #if defined(PETSC_USE_LOG)
+  const double num_reductions
+    = petsc_allreduce_ct + petsc_gather_ct - num_reductions0;
+  #else
+  const double num_reductions = -1.0;
+  #endif
+
   // Update ghost values in solution vector
   x.update_ghost_values();
 
@@ -383,7 +466,7 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
 
   // Report results
   if (report && dolfin::MPI::rank(this->mpi_comm()) == 0)
-    write_report(num_iterations, reason);
+    write_report(num_iterations, reason, num_reductions);
 
   return num_iterations;
 }
@@ -602,7 +685,8 @@ std::size_t PETScKrylovSolver::_solve(const PETScBaseMatrix& A, PETScVector& x,
 }
 //-----------------------------------------------------------------------------
 void PETScKrylovSolver::write_report(int num_iterations,
-                                     KSPConvergedReason reason)
+                                     KSPConvergedReason reason,
+                                     double num_reductions)
 {
   dolfin_assert(_ksp);
 
@@ -665,6 +749,14 @@ void PETScKrylovSolver::write_report(int num_iterations,
         ksp_type, pc_type, num_iterations);
   }
 
+  // Report measured number of global reductions (including those of
+  // the preconditioner), which limit scalability on many processes
+  if (num_reductions > 0.0 and num_iterations > 0)
+  {
+    log(PROGRESS, "PETSc Krylov solver (%s) global reductions per iteration: %.1f (%.0f in total).",
+        ksp_type, num_reductions/num_iterations, num_reductions);
+  }
+
   if (pc_type_str == PCASM || pc_type_str == PCBJACOBI)
   {
     log(PROGRESS, "PETSc Krylov solver preconditioner (%s) submethods: (%s, %s)",
@@ -198,8 +198,10 @@ namespace dolfin
     std::size_t _solve(const PETScBaseMatrix& A, PETScVector& x,
                        const PETScVector& b);
 
-    // Report the number of iterations
-    void write_report(int num_iterations, KSPConvergedReason reason);
+    // Report the number of iterations, and the number of global
+    // reductions if counted (non-negative)
+    void write_report(int num_iterations, KSPConvergedReason reason,
+                      double num_reductions);
 
     void check_dimensions(const PETScBaseMatrix& A, const GenericVector& x,
                           const GenericVector& b) const;
@@ -210,9 +212,16 @@ namespace dolfin
     // Available solvers descriptions
     static const std::map<std::string, std::string> _methods_descr;
 
+    // Map from Krylov method to its pipelined variant
+    static const std::map<std::string, std::string> _pipelined_methods;
+
     // PETSc solver pointer
     KSP _ksp;
 
+    // Krylov method replaced by its pipelined variant (empty unless
+    // the parameter "pipelined" is set)
+    std::string _base_ksp_type;
+
     // Preconditioner
     std::shared_ptr<PETScPreconditioner> _preconditioner;
 
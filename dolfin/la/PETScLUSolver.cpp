@@ -17,6 +17,7 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
 #include <petscksp.h>
 #include <petscpc.h>
 #include <dolfin/common/constants.h>
@@ -269,6 +270,123 @@ std::size_t PETScLUSolver::solve(const PETScMatrix& A, PETScVector& x,
   return solve(x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t PETScLUSolver::solve_multiple(
+  const std::vector<std::shared_ptr<GenericVector>>& x,
+  const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  Timer timer("PETSc LU solver (multiple right-hand sides)");
+
+  if (x.size() != b.size())
+  {
+    dolfin_error("PETScLUSolver.cpp",
+                 "solve linear systems using PETSc LU solver",
+                 "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                 x.size(), b.size());
+  }
+
+  if (b.empty())
+    return 0;
+
+  PetscErrorCode ierr;
+  KSP ksp = _solver.ksp();
+
+  // Get PETSc operator
+  Mat _A, _P;
+  ierr = KSPGetOperators(ksp, &_A, &_P);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "KSPGetOperators");
+  dolfin_assert(_A);
+  PETScBaseMatrix A(_A);
+
+  // Compute factorization (does nothing if operator is unchanged)
+  ierr = KSPSetUp(ksp);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "KSPSetUp");
+  PC pc;
+  ierr = KSPGetPC(ksp, &pc);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "KSPGetPC");
+  Mat F;
+  ierr = PCFactorGetMatrix(pc, &F);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "PCFactorGetMatrix");
+
+  // Create dense matrices with one column per right-hand side and
+  // the row layout of the operator
+  PetscInt m_local, n_local, M, N;
+  ierr = MatGetLocalSize(_A, &m_local, &n_local);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatGetLocalSize");
+  ierr = MatGetSize(_A, &M, &N);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatGetSize");
+  const PetscInt num_rhs = b.size();
+  Mat B, X;
+  ierr = MatCreateDense(mpi_comm(), m_local, PETSC_DECIDE, M, num_rhs, NULL, &B);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatCreateDense");
+  ierr = MatCreateDense(mpi_comm(), n_local, PETSC_DECIDE, N, num_rhs, NULL, &X);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatCreateDense");
+
+  // Copy right-hand sides into (column-major) columns of B
+  PetscScalar* B_array;
+  ierr = MatDenseGetArray(B, &B_array);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseGetArray");
+  for (std::size_t i = 0; i < b.size(); ++i)
+  {
+    dolfin_assert(b[i]);
+    const PETScVector& _b = as_type<const PETScVector>(*b[i]);
+    if (_b.size() != (std::size_t) M)
+    {
+      dolfin_error("PETScLUSolver.cpp",
+                   "solve linear systems using PETSc LU solver",
+                   "Non-matching dimensions for right-hand side %d", i);
+    }
+
+    const PetscScalar* b_array;
+    ierr = VecGetArrayRead(_b.vec(), &b_array);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecGetArrayRead");
+    std::copy(b_array, b_array + m_local, B_array + i*m_local);
+    ierr = VecRestoreArrayRead(_b.vec(), &b_array);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecRestoreArrayRead");
+  }
+  ierr = MatDenseRestoreArray(B, &B_array);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseRestoreArray");
+
+  ierr = MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyEnd");
+  ierr = MatAssemblyBegin(X, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(X, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyEnd");
+
+  // Solve for all right-hand sides with the factored matrix
+  ierr = MatMatSolve(F, B, X);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatMatSolve");
+
+  // Copy columns of X into solution vectors
+  const PetscScalar* X_array;
+  ierr = MatDenseGetArrayRead(X, &X_array);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseGetArrayRead");
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    PETScVector& _x = as_type<PETScVector>(*x[i]);
+    if (_x.empty())
+      A.init_vector(_x, 1);
+
+    PetscScalar* x_array;
+    ierr = VecGetArray(_x.vec(), &x_array);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecGetArray");
+    std::copy(X_array + i*n_local, X_array + (i + 1)*n_local, x_array);
+    ierr = VecRestoreArray(_x.vec(), &x_array);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecRestoreArray");
+    _x.update_ghost_values();
+  }
+  ierr = MatDenseRestoreArrayRead(X, &X_array);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseRestoreArrayRead");
+
+  MatDestroy(&B);
+  MatDestroy(&X);
+
+  return 1;
+}
+//-----------------------------------------------------------------------------
 void PETScLUSolver::set_options_prefix(std::string options_prefix)
 {
   _solver.set_options_prefix(options_prefix);
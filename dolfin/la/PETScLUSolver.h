@@ -30,6 +30,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <petscmat.h>
 #include <petscpc.h>
 #include <dolfin/common/MPI.h>
@@ -91,6 +92,13 @@ namespace dolfin
     std::size_t solve(const PETScMatrix& A, PETScVector& x,
                       const PETScVector& b);
 
+    /// Solve linear systems Ax_i = b_i for multiple right-hand
+    /// sides. The factorization is computed once and all right-hand
+    /// sides are solved for with MatMatSolve.
+    std::size_t
+      solve_multiple(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Sets the prefix used by PETSc when searching the options
     /// database
     void set_options_prefix(std::string options_prefix);
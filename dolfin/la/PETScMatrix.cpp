@@ -634,6 +634,17 @@ void PETScMatrix::set_from_options()
   MatSetFromOptions(_matA);
 }
 //-----------------------------------------------------------------------------
+std::size_t PETScMatrix::memory_usage() const
+{
+  if (!_matA)
+    return sizeof(*this);
+
+  MatInfo info;
+  PetscErrorCode ierr = MatGetInfo(_matA, MAT_LOCAL, &info);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetInfo");
+  return sizeof(*this) + (std::size_t) info.memory;
+}
+//-----------------------------------------------------------------------------
 const PETScMatrix& PETScMatrix::operator= (const PETScMatrix& A)
 {
   if (!A.mat())
@@ -223,6 +223,10 @@ namespace dolfin
     /// Call PETSc function MatSetFromOptions on the PETSc Mat object
     void set_from_options();
 
+    /// Return number of bytes allocated by PETSc for the local part
+    /// of the matrix
+    std::size_t memory_usage() const;
+
     /// Assignment operator
     const PETScMatrix& operator= (const PETScMatrix& A);
 
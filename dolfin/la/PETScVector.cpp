@@ -858,6 +858,34 @@ Vec PETScVector::vec() const
   return _x;
 }
 //-----------------------------------------------------------------------------
+std::size_t PETScVector::memory_usage() const
+{
+  if (!_x)
+    return sizeof(*this);
+
+  // Use local form, which includes ghost entries, if vector is
+  // ghosted
+  PetscErrorCode ierr;
+  PetscInt n = 0;
+  Vec xg;
+  ierr = VecGhostGetLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostGetLocalForm");
+  if (xg)
+  {
+    ierr = VecGetLocalSize(xg, &n);
+    CHECK_ERROR("VecGetLocalSize");
+  }
+  else
+  {
+    ierr = VecGetLocalSize(_x, &n);
+    CHECK_ERROR("VecGetLocalSize");
+  }
+  ierr = VecGhostRestoreLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostRestoreLocalForm");
+
+  return sizeof(*this) + n*sizeof(PetscScalar);
+}
+//-----------------------------------------------------------------------------
 void PETScVector::reset(Vec vec)
 {
   dolfin_assert(_x);
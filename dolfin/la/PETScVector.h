@@ -259,6 +259,10 @@ namespace dolfin
     /// Return pointer to PETSc Vec object
     Vec vec() const;
 
+    /// Return number of bytes allocated for the local entries of the
+    /// vector (including ghost entries)
+    std::size_t memory_usage() const;
+
     /// Assignment operator
     const PETScVector& operator= (const PETScVector& x);
 
@@ -23,8 +23,11 @@
 // Last changed: 2014-11-26
 
 #include <algorithm>
+#include <limits>
+#include <numeric>
 
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/utils.h>
 #include <dolfin/log/LogStream.h>
 #include <dolfin/la/IndexMap.h>
 #include "SparsityPattern.h"
@@ -33,7 +36,7 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+  : _primary_dim(primary_dim), _mpi_comm(comm), _storage(Storage::set)
 {
   // Do nothing
 }
@@ -41,7 +44,7 @@ SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim)
 SparsityPattern::SparsityPattern(MPI_Comm comm,
   const std::vector<std::shared_ptr<const IndexMap>> index_maps,
   std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+  : _primary_dim(primary_dim), _mpi_comm(comm), _storage(Storage::set)
 {
   init(index_maps);
 }
@@ -60,6 +63,11 @@ void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> in
   off_diagonal.clear();
   non_local.clear();
   full_rows.clear();
+  _storage = Storage::set;
+  _compact_diagonal.clear();
+  _compact_off_diagonal.clear();
+  _off_diagonal_columns.clear();
+  _off_diagonal_column_map.clear();
 
   // Check that primary dimension is valid
   if (_primary_dim > 1)
@@ -96,6 +104,39 @@ void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> in
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::init_compact(
+  const std::vector<std::size_t>& diagonal_capacity,
+  const std::vector<std::size_t>& off_diagonal_capacity)
+{
+  dolfin_assert(!_index_maps.empty());
+  dolfin_assert(diagonal_capacity.size() == diagonal.size());
+
+  // Local column indices are stored as 32-bit integers
+  const std::size_t primary_codim = _primary_dim == 0 ? 1 : 0;
+  const std::size_t local_size1
+    = _index_maps[primary_codim]->size(IndexMap::MapSize::OWNED);
+  if (local_size1 > std::numeric_limits<std::uint32_t>::max()
+      or diagonal.size() > std::numeric_limits<std::uint32_t>::max())
+  {
+    dolfin_error("SparsityPattern.cpp",
+                 "initialise compact sparsity pattern",
+                 "Local size exceeds range of 32-bit indices");
+  }
+
+  // Allocate rows with given capacities
+  _compact_diagonal.init(diagonal_capacity);
+  if (!off_diagonal.empty())
+  {
+    dolfin_assert(off_diagonal_capacity.size() == off_diagonal.size());
+    _compact_off_diagonal.init(off_diagonal_capacity);
+  }
+
+  // Release set storage
+  std::vector<set_type>().swap(diagonal);
+  std::vector<set_type>().swap(off_diagonal);
+  _storage = Storage::compact;
+}
+//-----------------------------------------------------------------------------
 void SparsityPattern::insert_global(dolfin::la_index i, dolfin::la_index j)
 {
   const std::vector<ArrayView<const dolfin::la_index>> entries =
@@ -202,9 +243,17 @@ void SparsityPattern::insert_entries(
     // Sequential mode, do simple insertion if not full row
     for (const auto &i_index : map_i)
     {
-      dolfin_assert(i_index < (dolfin::la_index) diagonal.size());
+      dolfin_assert(i_index < (dolfin::la_index) num_rows());
       if (!has_full_rows || full_rows.find(i_index) == full_rows_end)
-        diagonal[i_index].insert(map_j.begin(), map_j.end());
+      {
+        if (_storage == Storage::set)
+          diagonal[i_index].insert(map_j.begin(), map_j.end());
+        else
+        {
+          for (const auto &j_index : map_j)
+            insert_diagonal(i_index, j_index);
+        }
+      }
     }
   }
   else
@@ -230,14 +279,10 @@ void SparsityPattern::insert_entries(
           if ((dolfin::la_index) local_range1.first <= J
               && J < (dolfin::la_index) local_range1.second)
           {
-            dolfin_assert(I < (dolfin::la_index) diagonal.size());
-            diagonal[I].insert(J);
+            insert_diagonal(I, J);
           }
           else
-          {
-            dolfin_assert(I < (dolfin::la_index) off_diagonal.size());
-            off_diagonal[I].insert(J);
-          }
+            insert_off_diagonal(I, J);
         }
       }
       else
@@ -289,6 +334,8 @@ std::size_t SparsityPattern::num_nonzeros() const
     nz += slice.size();
   for (const auto& slice : off_diagonal)
     nz += slice.size();
+  nz += _compact_diagonal.num_entries();
+  nz += _compact_off_diagonal.num_entries();
 
   // Contribution from full rows
   const std::size_t local_size0 =
@@ -305,11 +352,11 @@ std::size_t SparsityPattern::num_nonzeros() const
 void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
   // Resize vector
-  num_nonzeros.resize(diagonal.size());
+  num_nonzeros.resize(num_rows());
 
   // Get number of nonzeros per generalised row
-  for (auto slice = diagonal.begin(); slice != diagonal.end(); ++slice)
-    num_nonzeros[slice - diagonal.begin()] = slice->size();
+  for (std::size_t i = 0; i < num_nonzeros.size(); ++i)
+    num_nonzeros[i] = diagonal_row_size(i);
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -326,16 +373,17 @@ void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzer
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
-  // Resize vector
-  num_nonzeros.resize(off_diagonal.size());
-
   // Return if there is no off-diagonal
-  if (off_diagonal.empty())
+  if (!has_off_diagonal())
+  {
+    num_nonzeros.clear();
     return;
+  }
 
   // Compute number of nonzeros per generalised row
-  for (auto slice = off_diagonal.begin(); slice != off_diagonal.end(); ++slice)
-    num_nonzeros[slice - off_diagonal.begin()] = slice->size();
+  num_nonzeros.resize(num_rows());
+  for (std::size_t i = 0; i < num_nonzeros.size(); ++i)
+    num_nonzeros[i] = off_diagonal_row_size(i);
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -355,7 +403,7 @@ void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_no
 void SparsityPattern::num_local_nonzeros(std::vector<std::size_t>& num_nonzeros) const
 {
   num_nonzeros_diagonal(num_nonzeros);
-  if (!off_diagonal.empty())
+  if (has_off_diagonal())
   {
     std::vector<std::size_t> tmp;
     num_nonzeros_off_diagonal(tmp);
@@ -467,38 +515,52 @@ void SparsityPattern::apply()
       if (local_range1.first <= J &&
           J < local_range1.second)
       {
-        dolfin_assert(i_index < diagonal.size());
-        diagonal[i_index].insert(J);
+        insert_diagonal(i_index, J);
       }
       else
-      {
-        dolfin_assert(i_index < off_diagonal.size());
-        off_diagonal[i_index].insert(J);
-      }
+        insert_off_diagonal(i_index, J);
     }
   }
 
   // Clear non-local entries
   non_local.clear();
+
+  // Sort rows and release unused capacity
+  if (_storage == Storage::compact)
+    compact();
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(diagonal)
+    + dolfin::memory_usage(off_diagonal) + dolfin::memory_usage(non_local)
+    + _compact_diagonal.memory_usage() + _compact_off_diagonal.memory_usage()
+    + dolfin::memory_usage(_off_diagonal_columns)
+    + node_memory_usage<std::pair<std::size_t, std::uint32_t>>(_off_diagonal_column_map.size());
+  for (const auto& row : diagonal)
+    bytes += dolfin::memory_usage(row.set());
+  for (const auto& row : off_diagonal)
+    bytes += dolfin::memory_usage(row.set());
+  return bytes;
 }
 //-----------------------------------------------------------------------------
 std::string SparsityPattern::str(bool verbose) const
 {
   // Print each row
   std::stringstream s;
-  for (std::size_t i = 0; i < diagonal.size(); i++)
+  for (std::size_t i = 0; i < num_rows(); i++)
   {
     if (primary_dim() == 0)
       s << "Row " << i << ":";
     else
       s << "Col " << i << ":";
 
-    for (const auto& entry : diagonal[i])
+    for (const auto& entry : diagonal_row(i))
       s << " " << entry;
 
-    if (!off_diagonal.empty())
+    if (has_off_diagonal())
     {
-      for (const auto& entry : off_diagonal[i])
+      for (const auto& entry : off_diagonal_row(i))
         s << " " << entry;
     }
 
@@ -511,9 +573,9 @@ std::string SparsityPattern::str(bool verbose) const
 std::vector<std::vector<std::size_t>>
 SparsityPattern::diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(diagonal.size());
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), diagonal[i].begin(), diagonal[i].end());
+  std::vector<std::vector<std::size_t>> v(num_rows());
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = diagonal_row(i);
 
   if (type == Type::sorted)
   {
@@ -544,9 +606,11 @@ SparsityPattern::diagonal_pattern(Type type) const
 std::vector<std::vector<std::size_t>>
   SparsityPattern::off_diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(off_diagonal.size());
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), off_diagonal[i].begin(), off_diagonal[i].end());
+  std::vector<std::vector<std::size_t>> v;
+  if (has_off_diagonal())
+    v.resize(num_rows());
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = off_diagonal_row(i);
 
   if (type == Type::sorted)
   {
@@ -581,13 +645,16 @@ void SparsityPattern::info_statistics() const
 {
   // Count nonzeros in diagonal block
   std::size_t num_nonzeros_diagonal = 0;
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    num_nonzeros_diagonal += diagonal[i].size();
+  for (std::size_t i = 0; i < num_rows(); ++i)
+    num_nonzeros_diagonal += diagonal_row_size(i);
 
   // Count nonzeros in off-diagonal block
   std::size_t num_nonzeros_off_diagonal = 0;
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    num_nonzeros_off_diagonal += off_diagonal[i].size();
+  if (has_off_diagonal())
+  {
+    for (std::size_t i = 0; i < num_rows(); ++i)
+      num_nonzeros_off_diagonal += off_diagonal_row_size(i);
+  }
 
   // Count nonzeros in non-local block
   const std::size_t num_nonzeros_non_local = non_local.size()/2;
@@ -618,3 +685,232 @@ void SparsityPattern::info_statistics() const
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::insert_diagonal(std::size_t i, std::size_t J)
+{
+  if (_storage == Storage::set)
+  {
+    dolfin_assert(i < diagonal.size());
+    diagonal[i].insert(J);
+  }
+  else
+  {
+    const std::size_t primary_codim = _primary_dim == 0 ? 1 : 0;
+    const std::size_t offset1 = _index_maps[primary_codim]->local_range().first;
+    _compact_diagonal.insert(i, J - offset1);
+  }
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::insert_off_diagonal(std::size_t i, std::size_t J)
+{
+  if (_storage == Storage::set)
+  {
+    dolfin_assert(i < off_diagonal.size());
+    off_diagonal[i].insert(J);
+  }
+  else
+  {
+    // Number off-diagonal columns locally in order of appearance
+    const auto column = _off_diagonal_column_map.insert(
+      {J, (std::uint32_t) _off_diagonal_columns.size()});
+    if (column.second)
+      _off_diagonal_columns.push_back(J);
+    _compact_off_diagonal.insert(i, column.first->second);
+  }
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::num_rows() const
+{
+  if (_storage == Storage::set)
+    return diagonal.size();
+  else
+    return _compact_diagonal.num_rows();
+}
+//-----------------------------------------------------------------------------
+bool SparsityPattern::has_off_diagonal() const
+{
+  if (_storage == Storage::set)
+    return !off_diagonal.empty();
+  else
+    return _compact_off_diagonal.num_rows() > 0;
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::diagonal_row_size(std::size_t i) const
+{
+  if (_storage == Storage::set)
+    return diagonal[i].size();
+  else
+    return _compact_diagonal.sizes[i];
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::off_diagonal_row_size(std::size_t i) const
+{
+  if (_storage == Storage::set)
+    return off_diagonal[i].size();
+  else
+    return _compact_off_diagonal.sizes[i];
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> SparsityPattern::diagonal_row(std::size_t i) const
+{
+  if (_storage == Storage::set)
+    return std::vector<std::size_t>(diagonal[i].begin(), diagonal[i].end());
+
+  const std::size_t primary_codim = _primary_dim == 0 ? 1 : 0;
+  const std::size_t offset1 = _index_maps[primary_codim]->local_range().first;
+  const std::uint32_t* columns = _compact_diagonal.row(i);
+  std::vector<std::size_t> row(_compact_diagonal.sizes[i]);
+  for (std::size_t j = 0; j < row.size(); ++j)
+    row[j] = offset1 + columns[j];
+  return row;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> SparsityPattern::off_diagonal_row(std::size_t i) const
+{
+  if (_storage == Storage::set)
+  {
+    return std::vector<std::size_t>(off_diagonal[i].begin(),
+                                    off_diagonal[i].end());
+  }
+
+  const std::uint32_t* columns = _compact_off_diagonal.row(i);
+  std::vector<std::size_t> row(_compact_off_diagonal.sizes[i]);
+  for (std::size_t j = 0; j < row.size(); ++j)
+    row[j] = _off_diagonal_columns[columns[j]];
+  return row;
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::compact()
+{
+  dolfin_assert(_storage == Storage::compact);
+
+  // Renumber off-diagonal columns in increasing global order so that
+  // sorted local columns are also sorted globally
+  const std::size_t num_columns = _off_diagonal_columns.size();
+  std::vector<std::uint32_t> order(num_columns);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [this](std::uint32_t a, std::uint32_t b)
+            { return _off_diagonal_columns[a] < _off_diagonal_columns[b]; });
+  std::vector<std::uint32_t> new_index(num_columns);
+  std::vector<std::size_t> columns(num_columns);
+  for (std::size_t k = 0; k < num_columns; ++k)
+  {
+    new_index[order[k]] = k;
+    columns[k] = _off_diagonal_columns[order[k]];
+    _off_diagonal_column_map[columns[k]] = k;
+  }
+  _off_diagonal_columns = std::move(columns);
+
+  for (std::size_t i = 0; i < _compact_off_diagonal.num_rows(); ++i)
+  {
+    std::uint32_t* row = _compact_off_diagonal.columns.data()
+      + _compact_off_diagonal.offsets[i];
+    for (std::size_t j = 0; j < _compact_off_diagonal.sizes[i]; ++j)
+      row[j] = new_index[row[j]];
+  }
+  for (auto& entry : _compact_off_diagonal.overflow)
+    entry.second = new_index[entry.second];
+
+  // Sort rows, merge overflow entries and release unused capacity
+  _compact_diagonal.compact();
+  _compact_off_diagonal.compact();
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::CompactBlock::init(const std::vector<std::size_t>& capacity)
+{
+  offsets.resize(capacity.size() + 1);
+  offsets[0] = 0;
+  std::partial_sum(capacity.begin(), capacity.end(), offsets.begin() + 1);
+  columns.resize(offsets.back());
+  sizes.assign(capacity.size(), 0);
+  overflow.clear();
+  num_unique_overflow = 0;
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::CompactBlock::insert(std::size_t i, std::uint32_t column)
+{
+  dolfin_assert(i < sizes.size());
+
+  // Rows are short, so a linear search is faster than a set lookup
+  std::uint32_t* begin = columns.data() + offsets[i];
+  std::uint32_t* end = begin + sizes[i];
+  if (std::find(begin, end, column) != end)
+    return;
+
+  if (offsets[i] + sizes[i] < offsets[i + 1])
+  {
+    *end = column;
+    ++sizes[i];
+  }
+  else
+  {
+    // Assembly inserts the same entries once per cell, so remove
+    // duplicates whenever the overflow list has doubled in size since
+    // the last time. This keeps it bounded by twice the number of
+    // distinct entries which did not fit into their rows.
+    overflow.push_back({(std::uint32_t) i, column});
+    if (overflow.size() >= 2*std::max(num_unique_overflow, (std::size_t) 64))
+    {
+      std::sort(overflow.begin(), overflow.end());
+      overflow.erase(std::unique(overflow.begin(), overflow.end()),
+                     overflow.end());
+      num_unique_overflow = overflow.size();
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::CompactBlock::compact()
+{
+  // Nothing to do for uninitialised (e.g. serial off-diagonal) blocks
+  if (offsets.empty())
+    return;
+
+  std::sort(overflow.begin(), overflow.end());
+  auto entry = overflow.begin();
+
+  std::vector<std::uint32_t> new_columns;
+  new_columns.reserve(num_entries() + overflow.size());
+  for (std::size_t i = 0; i < sizes.size(); ++i)
+  {
+    const std::size_t start = new_columns.size();
+    new_columns.insert(new_columns.end(), columns.begin() + offsets[i],
+                       columns.begin() + offsets[i] + sizes[i]);
+    for (; entry != overflow.end() and entry->first == i; ++entry)
+      new_columns.push_back(entry->second);
+
+    // Sort and remove duplicates introduced by overflow entries
+    std::sort(new_columns.begin() + start, new_columns.end());
+    new_columns.erase(std::unique(new_columns.begin() + start,
+                                  new_columns.end()), new_columns.end());
+
+    offsets[i] = start;
+    sizes[i] = new_columns.size() - start;
+  }
+  offsets.back() = new_columns.size();
+
+  new_columns.shrink_to_fit();
+  columns = std::move(new_columns);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>>().swap(overflow);
+  num_unique_overflow = 0;
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::CompactBlock::clear()
+{
+  std::vector<std::uint32_t>().swap(columns);
+  std::vector<std::size_t>().swap(offsets);
+  std::vector<std::uint32_t>().swap(sizes);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>>().swap(overflow);
+  num_unique_overflow = 0;
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::CompactBlock::num_entries() const
+{
+  return std::accumulate(sizes.begin(), sizes.end(), (std::size_t) 0);
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::CompactBlock::memory_usage() const
+{
+  return dolfin::memory_usage(columns) + dolfin::memory_usage(offsets)
+    + dolfin::memory_usage(sizes) + dolfin::memory_usage(overflow);
+}
+//-----------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #ifndef __SPARSITY_PATTERN_H
 #define __SPARSITY_PATTERN_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -55,6 +56,11 @@ namespace dolfin
     /// Whether SparsityPattern is sorted
     enum class Type {sorted, unsorted};
 
+    /// Storage scheme for the rows of the sparsity pattern ('set':
+    /// one set per row, 'compact': a single array of 32-bit local
+    /// column indices with row offsets)
+    enum class Storage {set, compact};
+
     /// Create empty sparsity pattern
     SparsityPattern(MPI_Comm comm, std::size_t primary_dim);
 
@@ -66,6 +72,19 @@ namespace dolfin
     /// Initialize sparsity pattern for a generic tensor
     void init(std::vector<std::shared_ptr<const IndexMap>> index_maps);
 
+    /// Switch to compact storage. The capacity of each local row in
+    /// the diagonal and off-diagonal blocks is given by an upper
+    /// estimate of its number of nonzeros (e.g. computed from cell
+    /// connectivity). Entries that do not fit are kept in an overflow
+    /// list. Rows are sorted and compacted by apply(). Must be called
+    /// after init() and before entries are inserted.
+    void init_compact(const std::vector<std::size_t>& diagonal_capacity,
+                      const std::vector<std::size_t>& off_diagonal_capacity);
+
+    /// Return storage scheme
+    Storage storage() const
+    { return _storage; }
+
     /// Insert a global entry - will be fixed by apply()
     void insert_global(dolfin::la_index i, dolfin::la_index j);
 
@@ -129,6 +148,9 @@ namespace dolfin
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
+    /// Return number of bytes allocated for the sparsity pattern
+    std::size_t memory_usage() const;
+
     /// Return underlying sparsity pattern (diagonal). Options are
     /// 'sorted' and 'unsorted'.
     std::vector<std::vector<std::size_t>> diagonal_pattern(Type type) const;
@@ -140,6 +162,74 @@ namespace dolfin
 
   private:
 
+    // Rows of a sparsity pattern block stored in a single array of
+    // 32-bit column indices. Before compact() each row has a fixed
+    // capacity and entries beyond it are kept in an overflow list.
+    struct CompactBlock
+    {
+      // Allocate rows with given capacities
+      void init(const std::vector<std::size_t>& capacity);
+
+      // Insert column into row (no-op if already present)
+      void insert(std::size_t row, std::uint32_t column);
+
+      // Merge overflow, sort rows and release unused capacity
+      void compact();
+
+      // Clear all data
+      void clear();
+
+      // Number of rows
+      std::size_t num_rows() const
+      { return sizes.size(); }
+
+      // Number of entries (excluding overflow before compact())
+      std::size_t num_entries() const;
+
+      // Number of bytes allocated
+      std::size_t memory_usage() const;
+
+      // Pointer to first column of row
+      const std::uint32_t* row(std::size_t i) const
+      { return columns.data() + offsets[i]; }
+
+      // Column indices, row offsets into columns (size num_rows + 1)
+      // and number of entries in each row
+      std::vector<std::uint32_t> columns;
+      std::vector<std::size_t> offsets;
+      std::vector<std::uint32_t> sizes;
+
+      // Entries (row, column) which did not fit into their row, and
+      // the size of the list after duplicates were last removed
+      std::vector<std::pair<std::uint32_t, std::uint32_t>> overflow;
+      std::size_t num_unique_overflow = 0;
+    };
+
+    // Insert global column J into local row i of the diagonal or
+    // off-diagonal block
+    void insert_diagonal(std::size_t i, std::size_t J);
+    void insert_off_diagonal(std::size_t i, std::size_t J);
+
+    // Number of local rows
+    std::size_t num_rows() const;
+
+    // Return true if the pattern has an off-diagonal block
+    bool has_off_diagonal() const;
+
+    // Number of nonzeros in local row i of the diagonal and
+    // off-diagonal block
+    std::size_t diagonal_row_size(std::size_t i) const;
+    std::size_t off_diagonal_row_size(std::size_t i) const;
+
+    // Global column indices of local row i of the diagonal and
+    // off-diagonal blocks
+    std::vector<std::size_t> diagonal_row(std::size_t i) const;
+    std::vector<std::size_t> off_diagonal_row(std::size_t i) const;
+
+    // Sort and compact rows of compact storage. Columns of the
+    // off-diagonal block are renumbered in increasing global order.
+    void compact();
+
     // Other insertion methods will call this method providing the
     // appropriate mapping of the indices in the entries.
     //
@@ -177,6 +267,18 @@ namespace dolfin
     // Sparsity pattern for non-local entries stored as [i0, j0, i1, j1, ...]
     std::vector<std::size_t> non_local;
 
+    // Storage scheme
+    Storage _storage;
+
+    // Compact storage for diagonal and off-diagonal blocks. Columns
+    // of the diagonal block are relative to the start of the local
+    // range, columns of the off-diagonal block index into
+    // _off_diagonal_columns (global indices).
+    CompactBlock _compact_diagonal;
+    CompactBlock _compact_off_diagonal;
+    std::vector<std::size_t> _off_diagonal_columns;
+    std::unordered_map<std::size_t, std::uint32_t> _off_diagonal_column_map;
+
   };
 
 }
@@ -45,6 +45,7 @@
 #include <dolfin/la/SparsityPattern.h>
 
 #include <dolfin/la/IndexMap.h>
+#include <dolfin/la/GhostScatter.h>
 
 #include <dolfin/la/GenericLinearAlgebraFactory.h>
 #include <dolfin/la/DefaultFactory.h>
@@ -62,6 +63,7 @@
 #include <dolfin/la/test_nullspace.h>
 #include <dolfin/la/BlockVector.h>
 #include <dolfin/la/BlockMatrix.h>
+#include <dolfin/la/EigenBlockView.h>
 #include <dolfin/la/LinearOperator.h>
 
 #endif
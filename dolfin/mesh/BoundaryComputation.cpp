@@ -21,20 +21,22 @@
 // Modified by Oeyvind Evju, 2013
 //
 // First added:  2006-06-21
-// Last changed: 2014-02-06
+// Last changed: 2019-06-18
 
+#include <algorithm>
+#include <cstdint>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/Threads.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "BoundaryMesh.h"
-#include "Cell.h"
-#include "Facet.h"
+#include "ConnectivityView.h"
 #include "Mesh.h"
 #include "MeshData.h"
 #include "MeshEditor.h"
-#include "MeshEntity.h"
 #include "MeshFunction.h"
 #include "MeshGeometry.h"
 #include "MeshTopology.h"
-#include "Vertex.h"
 #include "BoundaryComputation.h"
 
 using namespace dolfin;
@@ -44,9 +46,11 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
                                            const std::string type,
                                            BoundaryMesh& boundary)
 {
-  // We iterate over all facets in the mesh and check if they are on
+  // We check all facets in the mesh (in parallel) and mark those on
   // the boundary. A facet is on the boundary if it is connected to
-  // exactly one cell.
+  // exactly one cell. The lists of boundary facets and vertices are
+  // computed with prefix sums, and the boundary mesh arrays are
+  // handed to the mesh editor in bulk.
 
   log(TRACE, "Computing boundary mesh.");
 
@@ -72,14 +76,10 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
   MeshEditor editor;
   editor.open(boundary, mesh.type().facet_type(), D - 1, mesh.geometry().dim());
 
-  // Generate facet - cell connectivity if not generated
-  mesh.init(D - 1, D);
-
-  // Temporary arrays for assignment of indices to vertices on the boundary
-  std::map<std::size_t, std::size_t> boundary_vertices;
-
-  // Map of index "owners" (process responsible for assigning global index)
-  std::map< std::size_t, std::size_t > global_index_owner;
+  // Generate facet - cell connectivity if not generated, and get
+  // views of facet - cell and facet - vertex connectivity
+  const ConnectivityView facet_cells(mesh, D - 1, D);
+  const ConnectivityView facet_vertices(mesh, D - 1, 0);
 
   // Shared vertices for full mesh
   // FIXME: const_cast
@@ -93,15 +93,17 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
     // Extract shared vertices if vertex is identified as part of globally
     // exterior facet.
     std::vector<std::size_t> boundary_global_indices;
+    if (!shared_vertices.empty())
+      mesh.init(0, D - 1);
+    const ConnectivityView vertex_facets(mesh.topology()(0, D - 1),
+                                         mesh.num_vertices());
     for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
         sv_it=shared_vertices.begin(); sv_it != shared_vertices.end(); ++sv_it)
     {
       std::size_t local_mesh_index = sv_it->first;
-      Vertex v(mesh, local_mesh_index);
-
-      for (FacetIterator f(v); !f.end(); ++f)
+      for (auto f : vertex_facets[local_mesh_index])
       {
-        if (f->num_global_entities(D) == 1)
+        if (facet_cells.size_global(f) == 1)
         {
           const std::size_t global_mesh_index
             = mesh.topology().global_indices(0)[local_mesh_index];
@@ -170,99 +172,70 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
     shared_boundary_vertices = shared_vertices;
   }
 
-  // Determine boundary facet, count boundary vertices and facets, and
-  // assign vertex indices
-  std::size_t num_boundary_vertices = 0;
-  std::size_t num_owned_vertices = 0;
-  std::size_t num_boundary_cells = 0;
-
-  MeshFunction<bool> boundary_facet(reference_to_no_delete_pointer(mesh),
-                                    D - 1, false);
-  for (FacetIterator f(mesh); !f.end(); ++f)
-  {
-    // Boundary facets are connected to exactly one cell
-    if (f->num_entities(D) == 1)
+  // Mark boundary facets. Boundary facets are connected to exactly
+  // one cell.
+  const std::size_t num_threads = parameters["num_threads"];
+  const std::size_t num_facets = facet_cells.size();
+  std::vector<std::uint8_t> boundary_facet(num_facets, 0);
+  Threads::parallel_for(num_facets, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      const bool global_exterior_facet =  (f->num_global_entities(D) == 1);
-      if (global_exterior_facet && exterior)
-        boundary_facet[*f] = true;
-      else if (!global_exterior_facet && interior)
-        boundary_facet[*f] = true;
-
-      if (boundary_facet[*f])
+      for (std::size_t f = begin; f < end; ++f)
       {
-        // Count boundary vertices and assign indices
-        for (VertexIterator v(*f); !v.end(); ++v)
+        if (facet_cells[f].size() == 1)
         {
-          const std::size_t local_mesh_index = v->index();
-
-          if (boundary_vertices.find(local_mesh_index)
-              == boundary_vertices.end())
-          {
-            const std::size_t local_boundary_index = num_boundary_vertices;
-            boundary_vertices[local_mesh_index] = local_boundary_index;
-
-            // Determine "owner" of global_mesh_index
-            std::size_t owner = my_rank;
-
-            std::map<std::int32_t, std::set<unsigned int>>::const_iterator
-              other_processes_it
-              = shared_boundary_vertices.find(local_mesh_index);
-            if (other_processes_it != shared_boundary_vertices.end() && D > 1)
-            {
-              const std::set<unsigned int>& other_processes
-                = other_processes_it->second;
-              const std::size_t min_process
-                = *std::min_element(other_processes.begin(),
-                                    other_processes.end());
-              boundary.topology().shared_entities(0)[local_boundary_index]
-                = other_processes;
-
-              // FIXME: More sophisticated ownership determination
-              if (min_process < owner)
-                owner = min_process;
-            }
-            const std::size_t global_mesh_index
-              = mesh.topology().global_indices(0)[local_mesh_index];
-            global_index_owner[global_mesh_index] = owner;
-
-            // Update counts
-            if (owner == my_rank)
-              num_owned_vertices++;
-            num_boundary_vertices++;
-          }
+          const bool global_exterior_facet = (facet_cells.size_global(f) == 1);
+          boundary_facet[f] = global_exterior_facet ? exterior : interior;
         }
-
-        // Count boundary cells (facets of the mesh)
-        num_boundary_cells++;
       }
-    }
-  }
-
-  // Initiate boundary topology
-  /*
-  boundary.topology().init(0, num_boundary_vertices,
-                           MPI::sum(mesh.mpi_comm(), num_owned_vertices));
-  boundary.topology().init(D - 1, num_boundary_cells,
-                           MPI::sum(mesh.mpi_comm(), num_boundary_cells));
-  */
-
-  // Specify number of vertices and cells
-  editor.init_vertices_global(num_boundary_vertices,
-                              MPI::sum(mesh.mpi_comm(), num_owned_vertices));
-  editor.init_cells_global(num_boundary_cells, MPI::sum(mesh.mpi_comm(),
-                                                        num_boundary_cells));
-
-  // Write vertex map
-  MeshFunction<std::size_t>& vertex_map = boundary.entity_map(0);
-  if (num_boundary_vertices > 0)
+    });
+  const std::vector<std::size_t> boundary_facets
+    = Threads::marked_indices(boundary_facet, num_threads);
+  const std::size_t num_boundary_cells = boundary_facets.size();
+
+  // Mark boundary vertices. Boundary vertices are numbered in the
+  // order of the mesh vertices.
+  std::vector<std::uint8_t> boundary_vertex(mesh.num_vertices(), 0);
+  for (auto f : boundary_facets)
+    for (auto v : facet_vertices[f])
+      boundary_vertex[v] = 1;
+  const std::vector<std::size_t> boundary_vertices
+    = Threads::marked_indices(boundary_vertex, num_threads);
+  const std::size_t num_boundary_vertices = boundary_vertices.size();
+
+  // Map from mesh vertex to boundary vertex
+  std::vector<std::size_t> mesh_to_boundary_vertex(mesh.num_vertices());
+  Threads::parallel_for(num_boundary_vertices, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+        mesh_to_boundary_vertex[boundary_vertices[i]] = i;
+    });
+
+  // Determine "owner" of each boundary vertex (process responsible
+  // for assigning global index)
+  std::vector<std::size_t> vertex_owner(num_boundary_vertices, my_rank);
+  if (D > 1)
   {
-    vertex_map.init(reference_to_no_delete_pointer(boundary), 0,
-                    num_boundary_vertices);
+    for (auto& sv : shared_boundary_vertices)
+    {
+      if (!boundary_vertex[sv.first])
+        continue;
+      const std::size_t local_boundary_index
+        = mesh_to_boundary_vertex[sv.first];
+      const std::set<unsigned int>& other_processes = sv.second;
+      boundary.topology().shared_entities(0)[local_boundary_index]
+        = other_processes;
+
+      // FIXME: More sophisticated ownership determination
+      const std::size_t min_process = *std::min_element(other_processes.begin(),
+                                                        other_processes.end());
+      if (min_process < my_rank)
+        vertex_owner[local_boundary_index] = min_process;
+    }
   }
-  std::map<std::size_t, std::size_t>::const_iterator it;
-  for (it = boundary_vertices.begin(); it != boundary_vertices.end(); ++it)
-    vertex_map[it->second] = it->first;
+  const std::size_t num_owned_vertices
+    = std::count(vertex_owner.begin(), vertex_owner.end(), my_rank);
 
   // Get vertex ownership distribution, and find index to start global
   // numbering from
@@ -274,22 +247,32 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
 
   // Set global indices of owned vertices, request global indices for
   // vertices owned elsewhere
-  std::map<std::size_t, std::size_t> global_indices;
+  const std::vector<std::int64_t>& global_vertex_indices
+    = mesh.topology().global_indices(0);
+  std::vector<std::int64_t> boundary_global_indices(num_boundary_vertices);
+  std::map<std::size_t, std::size_t> shared_global_indices;
   std::vector<std::vector<std::size_t>> request_global_indices(num_processes);
-
+  std::vector<std::vector<std::size_t>> request_local_indices(num_processes);
   std::size_t current_index = start_index;
-  for (std::size_t local_boundary_index = 0;
-       local_boundary_index<num_boundary_vertices; local_boundary_index++)
+  for (std::size_t i = 0; i < num_boundary_vertices; i++)
   {
-    const std::size_t local_mesh_index = vertex_map[local_boundary_index];
     const std::size_t global_mesh_index
-      = mesh.topology().global_indices(0)[local_mesh_index];
-
-    const std::size_t owner = global_index_owner[global_mesh_index];
+      = global_vertex_indices[boundary_vertices[i]];
+    const std::size_t owner = vertex_owner[i];
     if (owner != my_rank)
+    {
       request_global_indices[owner].push_back(global_mesh_index);
+      request_local_indices[owner].push_back(i);
+    }
     else
-      global_indices[global_mesh_index] = current_index++;
+    {
+      boundary_global_indices[i] = current_index++;
+      if (shared_boundary_vertices.find(boundary_vertices[i])
+          != shared_boundary_vertices.end())
+      {
+        shared_global_indices[global_mesh_index] = boundary_global_indices[i];
+      }
+    }
   }
 
   // Send and receive requests from other processes
@@ -306,7 +289,7 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
 
     for (std::size_t j = 0; j < N; j++)
       respond_global_indices[i][j]
-        = global_indices[global_index_requests[i][j]];
+        = shared_global_indices[global_index_requests[i][j]];
   }
 
   // Scatter responses back to requesting processes
@@ -314,35 +297,37 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
   MPI::all_to_all(mesh.mpi_comm(), respond_global_indices,
                   global_index_responses);
 
-  // Update global_indices
+  // Update global indices of vertices owned elsewhere
   for (std::size_t i = 0; i < num_processes; i++)
   {
-    const std::size_t N = global_index_responses[i].size();
     // Check that responses are the same size as the requests made
     dolfin_assert(global_index_responses[i].size()
                   == request_global_indices[i].size());
-    for (std::size_t j = 0; j < N; j++)
+    for (std::size_t j = 0; j < global_index_responses[i].size(); j++)
     {
-      const std::size_t global_mesh_index = request_global_indices[i][j];
-      const std::size_t global_boundary_index = global_index_responses[i][j];
-      global_indices[global_mesh_index] = global_boundary_index;
+      boundary_global_indices[request_local_indices[i][j]]
+        = global_index_responses[i][j];
     }
   }
 
   // Create vertices
-  for (std::size_t local_boundary_index = 0;
-       local_boundary_index < num_boundary_vertices; local_boundary_index++)
-  {
-    const std::size_t local_mesh_index = vertex_map[local_boundary_index];
-    const std::size_t global_mesh_index
-      = mesh.topology().global_indices(0)[local_mesh_index];
-    const std::size_t global_boundary_index = global_indices[global_mesh_index];
-
-    Vertex v(mesh, local_mesh_index);
-
-    editor.add_vertex_global(local_boundary_index, global_boundary_index,
-                             v.point());
-  }
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::vector<double>& x = mesh.geometry().x();
+  std::vector<double> boundary_x(gdim*num_boundary_vertices);
+  Threads::parallel_for(num_boundary_vertices, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const std::size_t v = boundary_vertices[i];
+        std::copy(x.begin() + v*gdim, x.begin() + (v + 1)*gdim,
+                  boundary_x.begin() + i*gdim);
+      }
+    });
+  editor.set_vertices_global(std::move(boundary_x),
+                             std::move(boundary_global_indices),
+                             MPI::sum(mesh.mpi_comm(), num_owned_vertices),
+                             false);
 
   // Find global index to start cell numbering from for current process
   std::vector<std::size_t> cell_distribution(num_processes);
@@ -351,68 +336,119 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
   for (std::size_t i = 0; i < my_rank; i++)
     start_cell_index += cell_distribution[i];
 
-  // Create cells (facets) and map between boundary mesh cells and facets parent
+  // Create cells (facets)
+  const ConnectivityView cell_vertices(mesh, D, 0);
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(D - 1);
+  std::vector<unsigned int> boundary_cells(num_cell_vertices*num_boundary_cells);
+  std::vector<std::int64_t> boundary_cell_indices(num_boundary_cells);
+  Threads::parallel_for(num_boundary_cells, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      std::vector<std::size_t> cell(num_cell_vertices);
+      for (std::size_t c = begin; c < end; ++c)
+      {
+        // Compute new vertex numbers for cell
+        const std::size_t f = boundary_facets[c];
+        const ArrayView<const unsigned int> vertices = facet_vertices[f];
+        for (std::size_t i = 0; i < cell.size(); i++)
+          cell[i] = mesh_to_boundary_vertex[vertices[i]];
+
+        // Reorder vertices so facet is right-oriented w.r.t. facet
+        // normal
+        reorder(cell, mesh, vertices, cell_vertices[facet_cells[f][0]]);
+
+        std::copy(cell.begin(), cell.end(),
+                  boundary_cells.begin() + c*num_cell_vertices);
+        boundary_cell_indices[c] = start_cell_index + c;
+      }
+    });
+  editor.set_cells_global(std::move(boundary_cells),
+                          std::move(boundary_cell_indices),
+                          MPI::sum(mesh.mpi_comm(), num_boundary_cells), false);
+
+  // Create map between boundary mesh vertices and mesh vertices
+  MeshFunction<std::size_t>& vertex_map = boundary.entity_map(0);
+  if (num_boundary_vertices > 0)
+  {
+    vertex_map.init(reference_to_no_delete_pointer(boundary), 0,
+                    num_boundary_vertices);
+    std::copy(boundary_vertices.begin(), boundary_vertices.end(),
+              vertex_map.values());
+  }
+
+  // Create map between boundary mesh cells and facets parent
   MeshFunction<std::size_t>& cell_map = boundary.entity_map(D - 1);
   if (num_boundary_cells > 0)
   {
     cell_map.init(reference_to_no_delete_pointer(boundary), D - 1,
                   num_boundary_cells);
-  }
-  std::vector<std::size_t>
-    cell(boundary.type().num_vertices(boundary.topology().dim()));
-  std::size_t current_cell = 0;
-  for (FacetIterator f(mesh); !f.end(); ++f)
-  {
-    if (boundary_facet[*f])
-    {
-      // Compute new vertex numbers for cell
-      const unsigned int* vertices = f->entities(0);
-      for (std::size_t i = 0; i < cell.size(); i++)
-        cell[i] = boundary_vertices[vertices[i]];
-
-      // Reorder vertices so facet is right-oriented w.r.t. facet
-      // normal
-      reorder(cell, *f);
-
-      // Create mapping from boundary cell to mesh facet if requested
-      if (!cell_map.empty())
-        cell_map[current_cell] = f->index();
-
-      // Add cell
-      editor.add_cell(current_cell, start_cell_index+current_cell, cell);
-      current_cell++;
-    }
+    std::copy(boundary_facets.begin(), boundary_facets.end(),
+              cell_map.values());
   }
 
   // Close mesh editor. Note the argument order=false to prevent
   // ordering from destroying the orientation of facets accomplished
-  // by calling reorder() below.
+  // by calling reorder() above.
   editor.close(false);
 }
 //-----------------------------------------------------------------------------
-void BoundaryComputation::reorder(std::vector<std::size_t>& vertices,
-                                  const Facet& facet)
+void BoundaryComputation::update_coordinates(const Mesh& mesh,
+                                             BoundaryMesh& boundary)
 {
-  // Get mesh
-  const Mesh& mesh = facet.mesh();
+  // Check that boundary mesh matches mesh
+  const MeshFunction<std::size_t>& vertex_map = boundary.entity_map(0);
+  const std::size_t gdim = mesh.geometry().dim();
+  if (vertex_map.size() != boundary.num_vertices()
+      or boundary.geometry().dim() != gdim
+      or mesh.geometry().degree() != 1)
+  {
+    dolfin_error("BoundaryComputation.cpp",
+                 "update coordinates of boundary mesh",
+                 "Boundary mesh was not computed from a mesh of this type");
+  }
 
-  // Get the vertex opposite to the facet (the one we remove)
-  std::size_t vertex = 0;
-  const Cell cell(mesh, facet.entities(mesh.topology().dim())[0]);
-  for (std::size_t i = 0; i < cell.num_entities(0); i++)
+  // Check that boundary vertices are vertices of mesh
+  const std::size_t* vertex_map_end = vertex_map.values() + vertex_map.size();
+  if (std::find_if(vertex_map.values(), vertex_map_end,
+                   [&mesh](std::size_t v) { return v >= mesh.num_vertices(); })
+      != vertex_map_end)
   {
-    bool not_in_facet = true;
-    vertex = cell.entities(0)[i];
-    for (std::size_t j = 0; j < facet.num_entities(0); j++)
+    dolfin_error("BoundaryComputation.cpp",
+                 "update coordinates of boundary mesh",
+                 "Boundary mesh was not computed from this mesh (vertex map refers to vertex outside mesh)");
+  }
+
+  // Copy coordinates of boundary vertices
+  const std::vector<double>& x = mesh.geometry().x();
+  std::vector<double>& boundary_x = boundary.geometry().x();
+  const std::size_t num_threads = parameters["num_threads"];
+  Threads::parallel_for(vertex_map.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      if (vertex == facet.entities(0)[j])
+      for (std::size_t i = begin; i < end; ++i)
       {
-        not_in_facet = false;
-        break;
+        const std::size_t v = vertex_map[i];
+        std::copy(x.begin() + v*gdim, x.begin() + (v + 1)*gdim,
+                  boundary_x.begin() + i*gdim);
       }
-    }
-    if (not_in_facet)
+    });
+}
+//-----------------------------------------------------------------------------
+void BoundaryComputation::reorder(std::vector<std::size_t>& vertices,
+                                  const Mesh& mesh,
+                                  const ArrayView<const unsigned int>& facet_vertices,
+                                  const ArrayView<const unsigned int>& cell_vertices)
+{
+  // Get the vertex opposite to the facet (the one we remove)
+  std::size_t vertex = 0;
+  for (std::size_t i = 0; i < cell_vertices.size(); i++)
+  {
+    vertex = cell_vertices[i];
+    if (std::find(facet_vertices.begin(), facet_vertices.end(), vertex)
+        == facet_vertices.end())
+    {
       break;
+    }
   }
   const Point p = mesh.geometry().point(vertex);
 
@@ -424,10 +460,10 @@ void BoundaryComputation::reorder(std::vector<std::size_t>& vertices,
     break;
   case CellType::Type::triangle:
     {
-      dolfin_assert(facet.num_entities(0) == 2);
+      dolfin_assert(facet_vertices.size() == 2);
 
-      const Point p0 = mesh.geometry().point(facet.entities(0)[0]);
-      const Point p1 = mesh.geometry().point(facet.entities(0)[1]);
+      const Point p0 = mesh.geometry().point(facet_vertices[0]);
+      const Point p1 = mesh.geometry().point(facet_vertices[1]);
       const Point v = p1 - p0;
       const Point n(v.y(), -v.x());
 
@@ -441,11 +477,11 @@ void BoundaryComputation::reorder(std::vector<std::size_t>& vertices,
     break;
   case CellType::Type::tetrahedron:
     {
-      dolfin_assert(facet.num_entities(0) == 3);
+      dolfin_assert(facet_vertices.size() == 3);
 
-      const Point p0 = mesh.geometry().point(facet.entities(0)[0]);
-      const Point p1 = mesh.geometry().point(facet.entities(0)[1]);
-      const Point p2 = mesh.geometry().point(facet.entities(0)[2]);
+      const Point p0 = mesh.geometry().point(facet_vertices[0]);
+      const Point p1 = mesh.geometry().point(facet_vertices[1]);
+      const Point p2 = mesh.geometry().point(facet_vertices[2]);
       const Point v1 = p1 - p0;
       const Point v2 = p2 - p0;
       const Point n  = v1.cross(v2);
@@ -27,8 +27,8 @@
 namespace dolfin
 {
 
+  template <typename T> class ArrayView;
   class BoundaryMesh;
-  class Facet;
   class Mesh;
   template <typename T> class MeshFunction;
 
@@ -38,17 +38,27 @@ namespace dolfin
   {
   public:
 
-    /// Compute the exterior boundary of a given mesh
+    /// Compute the exterior boundary of a given mesh. The local part
+    /// of the computation uses parameters["num_threads"] threads.
     /// @param[in] mesh  input mesh
     /// @param[in] type "internal" or "external"
     /// @param[out] boundary  output boundary mesh
     static void compute_boundary(const Mesh& mesh, const std::string type,
                                  BoundaryMesh& boundary);
 
+    /// Update the vertex coordinates of a boundary mesh from the mesh
+    /// it was computed from, reusing the boundary topology. This is
+    /// valid when only the mesh coordinates have changed.
+    /// @param[in] mesh  input mesh
+    /// @param[in,out] boundary  boundary mesh computed from mesh
+    static void update_coordinates(const Mesh& mesh, BoundaryMesh& boundary);
+
   private:
 
     // Reorder vertices so facet is right-oriented w.r.t. facet normal
-    static void reorder(std::vector<std::size_t>& vertices, const Facet& facet);
+    static void reorder(std::vector<std::size_t>& vertices, const Mesh& mesh,
+                        const ArrayView<const unsigned int>& facet_vertices,
+                        const ArrayView<const unsigned int>& cell_vertices);
 
   };
 
@@ -19,7 +19,7 @@
 // Modified by Joachim B Haga 2012.
 //
 // First added:  2006-06-21
-// Last changed: 2012-10-30
+// Last changed: 2019-06-18
 
 #ifndef __BOUNDARY_MESH_H
 #define __BOUNDARY_MESH_H
@@ -70,6 +70,14 @@ namespace dolfin
     /// to the entity in the original full mesh (const version)
     const MeshFunction<std::size_t>& entity_map(std::size_t d) const;
 
+    /// Update the vertex coordinates from the mesh the boundary mesh
+    /// was created from. This is cheaper than recreating the boundary
+    /// mesh when the mesh has moved but its topology is unchanged.
+    ///
+    /// @param      mesh (_Mesh_)
+    ///         The _Mesh_ object the boundary mesh was created from.
+    void update_coordinates(const Mesh& mesh);
+
   private:
 
     BoundaryMesh() {}
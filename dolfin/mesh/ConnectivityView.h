@@ -0,0 +1,235 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CONNECTIVITY_VIEW_H
+#define __CONNECTIVITY_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/log/log.h>
+#include "Mesh.h"
+#include "MeshConnectivity.h"
+#include "MeshTopology.h"
+
+namespace dolfin
+{
+
+  /// ConnectivityView is a lightweight, read-only view of the
+  /// connections from mesh entities of dimension d0 to mesh entities
+  /// of dimension d1. The connections of each entity are returned as
+  /// a contiguous ArrayView into the MeshConnectivity storage, so no
+  /// MeshEntity objects are created. The view may be used in a
+  /// range-based for loop,
+  ///
+  /// @code{.cpp}
+  ///
+  ///         for (auto vertices : ConnectivityView(mesh, tdim, 0))
+  ///           for (auto v : vertices)
+  ///             foo(v);
+  /// @endcode
+  ///
+  /// or indexed directly, which is safe from multiple threads:
+  ///
+  /// @code{.cpp}
+  ///
+  ///         const ConnectivityView cell_vertices(mesh, tdim, 0);
+  ///         for (std::size_t c = 0; c < cell_vertices.size(); ++c)
+  ///           foo(c, cell_vertices[c]);
+  /// @endcode
+  ///
+  /// The view does not own any data and is invalidated when the
+  /// connectivity is recomputed, cleared or compressed.
+
+  class ConnectivityView
+  {
+  public:
+
+    /// Iterator over the connections of consecutive entities
+    class const_iterator
+      : public std::iterator<std::random_access_iterator_tag,
+                             ArrayView<const unsigned int>,
+                             std::ptrdiff_t>
+    {
+    public:
+
+      /// Create iterator pointing to given entity
+      const_iterator(const ConnectivityView& view, std::size_t entity)
+        : _view(&view), _entity(entity) {}
+
+      /// Return connections of current entity
+      ArrayView<const unsigned int> operator*() const
+      { return (*_view)[_entity]; }
+
+      /// Return index of current entity
+      std::size_t index() const
+      { return _entity; }
+
+      /// Step to next entity
+      const_iterator& operator++()
+      { ++_entity; return *this; }
+
+      /// Step to previous entity
+      const_iterator& operator--()
+      { --_entity; return *this; }
+
+      /// Step forward by n entities
+      const_iterator& operator+=(std::ptrdiff_t n)
+      { _entity += n; return *this; }
+
+      /// Return iterator n entities ahead
+      const_iterator operator+(std::ptrdiff_t n) const
+      { return const_iterator(*_view, _entity + n); }
+
+      /// Return number of entities between iterators
+      std::ptrdiff_t operator-(const const_iterator& it) const
+      { return (std::ptrdiff_t) _entity - (std::ptrdiff_t) it._entity; }
+
+      /// Comparison operator
+      bool operator==(const const_iterator& it) const
+      { return _entity == it._entity; }
+
+      /// Comparison operator
+      bool operator!=(const const_iterator& it) const
+      { return _entity != it._entity; }
+
+      /// Comparison operator
+      bool operator<(const const_iterator& it) const
+      { return _entity < it._entity; }
+
+    private:
+
+      const ConnectivityView* _view;
+      std::size_t _entity;
+
+    };
+
+    /// Create view of the connectivity d0 -- d1 of a mesh, which is
+    /// computed if it does not exist. The range of the view is the
+    /// regular (non-ghost) entities of dimension d0, or all entities
+    /// if include_ghosts is true. Entities outside the range can
+    /// still be accessed with operator[].
+    ConnectivityView(const Mesh& mesh, std::size_t d0, std::size_t d1,
+                     bool include_ghosts=false)
+    {
+      mesh.init(d0);
+      mesh.init(d0, d1);
+      const std::size_t n = include_ghosts ? mesh.topology().size(d0)
+        : mesh.topology().ghost_offset(d0);
+      init(mesh.topology()(d0, d1), n);
+    }
+
+    /// Create view of given connectivity for entities [0, num_entities)
+    ConnectivityView(const MeshConnectivity& connectivity,
+                     std::size_t num_entities)
+    { init(connectivity, num_entities); }
+
+    /// Return number of entities in range
+    std::size_t size() const
+    { return _num_entities; }
+
+    /// Return true if range is empty
+    bool empty() const
+    { return _num_entities == 0; }
+
+    /// Return connections of given entity
+    ArrayView<const unsigned int> operator[] (std::size_t entity) const
+    {
+      dolfin_assert(entity < _connectivity->_num_entities);
+      std::size_t begin, end;
+      if (_offsets32)
+      {
+        begin = _offsets32[entity];
+        end = _offsets32[entity + 1];
+      }
+      else if (_offsets64)
+      {
+        begin = _offsets64[entity];
+        end = _offsets64[entity + 1];
+      }
+      else
+      {
+        begin = entity*_stride;
+        end = begin + _stride;
+      }
+      return ArrayView<const unsigned int>(end - begin, _connections + begin);
+    }
+
+    /// Return global number of connections of given entity
+    std::size_t size_global(std::size_t entity) const
+    { return _connectivity->size_global(entity); }
+
+    /// Return number of connections of each entity if equal for all
+    /// entities, otherwise zero
+    std::size_t stride() const
+    { return (_offsets32 or _offsets64) ? 0 : _stride; }
+
+    /// Return pointer to contiguous array of connections of all
+    /// entities
+    const unsigned int* data() const
+    { return _connections; }
+
+    /// Return iterator to first entity in range
+    const_iterator begin() const
+    { return const_iterator(*this, 0); }
+
+    /// Return iterator beyond last entity in range
+    const_iterator end() const
+    { return const_iterator(*this, _num_entities); }
+
+  private:
+
+    // Extract raw storage of connectivity
+    void init(const MeshConnectivity& connectivity, std::size_t num_entities)
+    {
+      if (connectivity.compressed())
+      {
+        dolfin_error("ConnectivityView.h",
+                     "create view of mesh connectivity",
+                     "Connectivity %d -- %d is compressed",
+                     connectivity._d0, connectivity._d1);
+      }
+
+      _connectivity = &connectivity;
+      _num_entities = std::min(num_entities, connectivity._num_entities);
+      _connections = connectivity._connections.data();
+      _stride = connectivity._stride;
+      _offsets32 = connectivity._offsets32.empty()
+        ? 0 : connectivity._offsets32.data();
+      _offsets64 = connectivity._offsets64.empty()
+        ? 0 : connectivity._offsets64.data();
+    }
+
+    // Viewed connectivity
+    const MeshConnectivity* _connectivity;
+
+    // Number of entities in range
+    std::size_t _num_entities;
+
+    // Raw connectivity storage (see MeshConnectivity)
+    const unsigned int* _connections;
+    std::size_t _stride;
+    const std::uint32_t* _offsets32;
+    const std::uint64_t* _offsets64;
+
+  };
+
+}
+
+#endif
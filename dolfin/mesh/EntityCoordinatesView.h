@@ -0,0 +1,208 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ENTITY_COORDINATES_VIEW_H
+#define __ENTITY_COORDINATES_VIEW_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/geometry/Point.h>
+#include "ConnectivityView.h"
+#include "Mesh.h"
+#include "MeshGeometry.h"
+
+namespace dolfin
+{
+
+  /// EntityCoordinatesView gives direct access to the vertex
+  /// coordinates of mesh entities of a given dimension, by combining
+  /// a ConnectivityView of the entity-vertex connectivity with the
+  /// contiguous coordinate array of the mesh geometry. It replaces
+  /// the use of MeshEntity and VertexIterator in loops which only
+  /// need the geometry of each entity, e.g.
+  ///
+  /// @code{.cpp}
+  ///
+  ///         const EntityCoordinatesView cells(mesh, tdim);
+  ///         std::vector<double> x;
+  ///         for (std::size_t c = 0; c < cells.size(); ++c)
+  ///         {
+  ///           cells.get(c, x);
+  ///           foo(x);
+  ///         }
+  /// @endcode
+  ///
+  /// Only the vertex coordinates are accessed, so for meshes with
+  /// higher degree geometry, Cell::get_coordinate_dofs must be used
+  /// to obtain all coordinate dofs. If the mesh geometry has a
+  /// single precision copy of the coordinates (see
+  /// MeshGeometry::init_single_precision), it is accessed by
+  /// x_single() and bounding_box_single().
+
+  class EntityCoordinatesView
+  {
+  public:
+
+    /// Create view of the vertex coordinates of entities of
+    /// dimension dim. The range of the view is the regular
+    /// (non-ghost) entities, or all entities if include_ghosts is
+    /// true.
+    EntityCoordinatesView(const Mesh& mesh, std::size_t dim,
+                          bool include_ghosts=false)
+      : _vertices(mesh, dim, 0, include_ghosts),
+        _x(mesh.geometry().x().data()),
+        _x_single(mesh.geometry().has_single_precision()
+                  ? mesh.geometry().x_single().data() : 0),
+        _gdim(mesh.geometry().dim()) {}
+
+    /// Return number of entities in range
+    std::size_t size() const
+    { return _vertices.size(); }
+
+    /// Return geometric dimension
+    std::size_t gdim() const
+    { return _gdim; }
+
+    /// Return vertex indices of given entity
+    ArrayView<const unsigned int> vertices(std::size_t entity) const
+    { return _vertices[entity]; }
+
+    /// Return coordinates of given vertex
+    const double* x(std::size_t vertex) const
+    { return _x + vertex*_gdim; }
+
+    /// Return true if single precision coordinates are available
+    bool has_single_precision() const
+    { return _x_single; }
+
+    /// Return single precision coordinates of given vertex
+    const float* x_single(std::size_t vertex) const
+    {
+      dolfin_assert(_x_single);
+      return _x_single + vertex*_gdim;
+    }
+
+    /// Copy vertex coordinates of given entity to array of length
+    /// num_vertices*gdim (vertex by vertex)
+    void get(std::size_t entity, double* coordinates) const
+    { copy(_vertices[entity], coordinates); }
+
+    /// Copy vertex coordinates of given entity to vector (vertex by
+    /// vertex)
+    void get(std::size_t entity, std::vector<double>& coordinates) const
+    {
+      const ArrayView<const unsigned int> vertices = _vertices[entity];
+      coordinates.resize(vertices.size()*_gdim);
+      copy(vertices, coordinates.data());
+    }
+
+    /// Compute axis-aligned bounding box of given entity. The arrays
+    /// xmin and xmax must have length gdim.
+    void bounding_box(std::size_t entity, double* xmin, double* xmax) const
+    {
+      const ArrayView<const unsigned int> vertices = _vertices[entity];
+      dolfin_assert(!vertices.empty());
+      std::copy(x(vertices[0]), x(vertices[0]) + _gdim, xmin);
+      std::copy(x(vertices[0]), x(vertices[0]) + _gdim, xmax);
+      for (std::size_t i = 1; i < vertices.size(); ++i)
+      {
+        const double* xv = x(vertices[i]);
+        for (std::size_t j = 0; j < _gdim; ++j)
+        {
+          xmin[j] = std::min(xmin[j], xv[j]);
+          xmax[j] = std::max(xmax[j], xv[j]);
+        }
+      }
+    }
+
+    /// Compute axis-aligned bounding box of given entity from the
+    /// single precision coordinates. The box is widened by one unit
+    /// in the last place (in single precision) in each direction, so
+    /// that it contains the entity in double precision.
+    void bounding_box_single(std::size_t entity, double* xmin,
+                             double* xmax) const
+    {
+      const ArrayView<const unsigned int> vertices = _vertices[entity];
+      dolfin_assert(!vertices.empty());
+      float fmin[3], fmax[3];
+      std::copy(x_single(vertices[0]), x_single(vertices[0]) + _gdim, fmin);
+      std::copy(x_single(vertices[0]), x_single(vertices[0]) + _gdim, fmax);
+      for (std::size_t i = 1; i < vertices.size(); ++i)
+      {
+        const float* xv = x_single(vertices[i]);
+        for (std::size_t j = 0; j < _gdim; ++j)
+        {
+          fmin[j] = std::min(fmin[j], xv[j]);
+          fmax[j] = std::max(fmax[j], xv[j]);
+        }
+      }
+      for (std::size_t j = 0; j < _gdim; ++j)
+      {
+        xmin[j] = std::nextafter(fmin[j], -std::numeric_limits<float>::max());
+        xmax[j] = std::nextafter(fmax[j], std::numeric_limits<float>::max());
+      }
+    }
+
+    /// Compute midpoint of given entity (average of its vertices)
+    Point midpoint(std::size_t entity) const
+    {
+      const ArrayView<const unsigned int> vertices = _vertices[entity];
+      dolfin_assert(!vertices.empty());
+      double p[3] = {0.0, 0.0, 0.0};
+      for (auto v : vertices)
+        for (std::size_t j = 0; j < _gdim; ++j)
+          p[j] += _x[v*_gdim + j];
+      const double n = vertices.size();
+      return Point(p[0]/n, p[1]/n, p[2]/n);
+    }
+
+    /// Return view of entity-vertex connectivity
+    const ConnectivityView& connectivity() const
+    { return _vertices; }
+
+  private:
+
+    // Copy coordinates of given vertices
+    void copy(const ArrayView<const unsigned int>& vertices,
+              double* coordinates) const
+    {
+      for (auto v : vertices)
+      {
+        const double* xv = _x + v*_gdim;
+        for (std::size_t j = 0; j < _gdim; ++j)
+          *coordinates++ = xv[j];
+      }
+    }
+
+    // Entity-vertex connectivity
+    ConnectivityView _vertices;
+
+    // Vertex coordinates, single precision coordinates (null if not
+    // available) and geometric dimension
+    const double* _x;
+    const float* _x_single;
+    std::size_t _gdim;
+
+  };
+
+}
+
+#endif
@@ -26,7 +26,7 @@
 // Modified by Jan Blechta 2013
 //
 // First added:  2006-05-09
-// Last changed: 2016-05-05
+// Last changed: 2019-06-18
 
 #include <dolfin/ale/ALE.h>
 #include <dolfin/common/Array.h>
@@ -36,6 +36,8 @@
 #include <dolfin/function/Expression.h>
 #include <dolfin/io/File.h>
 #include <dolfin/log/log.h>
+#include <dolfin/log/Table.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include "BoundaryMesh.h"
 #include "Cell.h"
@@ -61,14 +63,16 @@ Mesh::Mesh() : Mesh(MPI_COMM_WORLD)
 }
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm) : Variable("mesh", "DOLFIN mesh"),
-                            Hierarchical<Mesh>(*this), _ordered(false),
+                            Hierarchical<Mesh>(*this),
+                            _tree_coordinates_version(0), _ordered(false),
                             _mpi_comm(comm), _ghost_mode("none")
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 Mesh::Mesh(const Mesh& mesh) : Variable("mesh", "DOLFIN mesh"),
-                               Hierarchical<Mesh>(*this), _ordered(false),
+                               Hierarchical<Mesh>(*this),
+                               _tree_coordinates_version(0), _ordered(false),
                                _mpi_comm(mesh.mpi_comm()),
                                _ghost_mode("none")
 {
@@ -81,8 +85,9 @@ Mesh::Mesh(std::string filename) : Mesh(MPI_COMM_WORLD, filename)
 }
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm, std::string filename)
-  : Variable("mesh", "DOLFIN mesh"), Hierarchical<Mesh>(*this), _ordered(false),
-  _mpi_comm(comm), _ghost_mode("none")
+  : Variable("mesh", "DOLFIN mesh"), Hierarchical<Mesh>(*this),
+  _tree_coordinates_version(0), _ordered(false), _mpi_comm(comm),
+  _ghost_mode("none")
 {
   File file(_mpi_comm.comm(), filename);
   file >> *this;
@@ -90,7 +95,8 @@ Mesh::Mesh(MPI_Comm comm, std::string filename)
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm, LocalMeshData& local_mesh_data)
   : Variable("mesh", "DOLFIN mesh"), Hierarchical<Mesh>(*this),
-  _ordered(false), _mpi_comm(comm), _ghost_mode("none")
+  _tree_coordinates_version(0), _ordered(false), _mpi_comm(comm),
+  _ghost_mode("none")
 {
   const std::string ghost_mode = parameters["ghost_mode"];
   MeshPartitioning::build_distributed_mesh(*this, local_mesh_data, ghost_mode);
@@ -116,6 +122,9 @@ const Mesh& Mesh::operator=(const Mesh& mesh)
   _cell_orientations = mesh._cell_orientations;
   _ghost_mode = mesh._ghost_mode;
 
+  // Bounding box tree is built for the old mesh
+  _tree.reset();
+
   // Rename
   rename(mesh.name(), mesh.label());
 
@@ -192,9 +201,14 @@ void Mesh::init(std::size_t d0, std::size_t d1) const
     return;
   }
 
-  // Skip if already computed
+  // Skip if already computed, but restore raw access to compressed
+  // connectivity
   if (!_topology(d0, d1).empty())
+  {
+    if (_topology(d0, d1).compressed())
+      const_cast<Mesh*>(this)->_topology(d0, d1).decompress();
     return;
+  }
 
   // Check that mesh is ordered
   if (!ordered())
@@ -244,6 +258,14 @@ void Mesh::clean()
   }
 }
 //-----------------------------------------------------------------------------
+std::size_t Mesh::release_derived_data()
+{
+  const std::size_t bytes = memory_usage();
+  clean();
+  _tree.reset();
+  return bytes - memory_usage();
+}
+//-----------------------------------------------------------------------------
 void Mesh::order()
 {
   // Order mesh
@@ -346,11 +368,36 @@ std::shared_ptr<BoundingBoxTree> Mesh::bounding_box_tree() const
   {
     _tree.reset(new BoundingBoxTree());
     _tree->build(*this);
+    _tree_coordinates_version = _geometry.coordinates_version();
+  }
+
+  // Refit tree (or rebuild it if the overlap has grown too large) if
+  // coordinates have changed. This may happen on some processes only,
+  // so the global tree is not updated.
+  else if (_tree_coordinates_version != _geometry.coordinates_version())
+  {
+    const double max_cost_ratio
+      = dolfin::parameters["bounding_box_tree_max_cost_ratio"];
+    _tree->refit(max_cost_ratio, false);
+    _tree_coordinates_version = _geometry.coordinates_version();
   }
 
   return _tree;
 }
 //-----------------------------------------------------------------------------
+void Mesh::update_bounding_box_tree() const
+{
+  bounding_box_tree();
+  dolfin_assert(_tree);
+  _tree->update_global_tree();
+}
+//-----------------------------------------------------------------------------
+void Mesh::set_bounding_box_tree(std::shared_ptr<BoundingBoxTree> tree)
+{
+  _tree = tree;
+  _tree_coordinates_version = _geometry.coordinates_version();
+}
+//-----------------------------------------------------------------------------
 double Mesh::hmin() const
 {
   double h = std::numeric_limits<double>::max();
@@ -401,6 +448,56 @@ std::size_t Mesh::hash() const
   return (kt + kg)*(kt + kg + 1)/2 + kg;
 }
 //-----------------------------------------------------------------------------
+std::size_t Mesh::memory_usage() const
+{
+  return _topology.memory_usage() + _geometry.memory_usage()
+    + _domains.memory_usage() + _data.memory_usage()
+    + (_tree ? _tree->memory_usage() : 0)
+    + dolfin::memory_usage(_cell_orientations);
+}
+//-----------------------------------------------------------------------------
+Table Mesh::memory_usage_table() const
+{
+  Table table("Mesh memory usage");
+  std::size_t total = 0;
+  auto add = [&table, &total](std::string component, std::size_t bytes)
+    {
+      table(component, "bytes") = bytes;
+      total += bytes;
+    };
+
+  // Connectivity for each computed pair of dimensions
+  const std::size_t D = _topology.dim();
+  std::size_t connectivity_bytes = 0;
+  for (std::size_t d0 = 0; d0 <= D; d0++)
+  {
+    for (std::size_t d1 = 0; d1 <= D; d1++)
+    {
+      const MeshConnectivity& c = _topology(d0, d1);
+      if (!c.empty())
+      {
+        connectivity_bytes += c.memory_usage();
+        add("topology " + std::to_string(d0) + "-" + std::to_string(d1),
+            c.memory_usage());
+      }
+    }
+  }
+
+  // Remaining topology data (entity counts, empty connectivity)
+  const std::size_t parallel_bytes = _topology.parallel_memory_usage();
+  add("topology parallel data", parallel_bytes);
+  total += _topology.memory_usage() - connectivity_bytes - parallel_bytes;
+
+  add("geometry", _geometry.memory_usage());
+  add("domains", _domains.memory_usage());
+  add("data", _data.memory_usage());
+  add("bounding box tree", _tree ? _tree->memory_usage() : 0);
+  add("cell orientations", dolfin::memory_usage(_cell_orientations));
+
+  table("total", "bytes") = total;
+  return table;
+}
+//-----------------------------------------------------------------------------
 std::string Mesh::str(bool verbose) const
 {
   std::stringstream s;
@@ -52,6 +52,7 @@ namespace dolfin
   class Point;
   class SubDomain;
   class BoundingBoxTree;
+  class Table;
 
   /// A _Mesh_ consists of a set of connected and numbered mesh entities.
   ///
@@ -257,14 +258,41 @@ namespace dolfin
     /// Get bounding box tree for mesh. The bounding box tree is
     /// initialized and built upon the first call to this
     /// function. The bounding box tree can be used to compute
-    /// collisions between the mesh and other objects. It is the
-    /// responsibility of the caller to use (and possibly rebuild) the
-    /// tree. It is stored as a (mutable) member of the mesh to enable
-    /// sharing of the bounding box tree data structure.
+    /// collisions between the mesh and other objects. It is stored
+    /// as a (mutable) member of the mesh to enable sharing of the
+    /// bounding box tree data structure.
+    ///
+    /// If the mesh coordinates have changed since the tree was built
+    /// (see MeshGeometry::coordinates_version), the tree is refitted
+    /// to the new coordinates, or rebuilt if the refitted tree has a
+    /// cost ratio larger than the parameter
+    /// "bounding_box_tree_max_cost_ratio" (see
+    /// BoundingBoxTree::refit). Changes of the topology are not
+    /// detected, except by MeshEditor which clears the tree. In
+    /// parallel, this function is collective when the tree is first
+    /// built. The refit only updates the tree of this process, and
+    /// update_bounding_box_tree() must be called before process
+    /// collisions are computed with the tree.
     ///
     /// @return std::shared_ptr<BoundingBoxTree>
     std::shared_ptr<BoundingBoxTree> bounding_box_tree() const;
 
+    /// Build or refit the bounding box tree for the current
+    /// coordinates (see bounding_box_tree()) and update its global
+    /// tree, which maps points to the processes whose part of the
+    /// mesh may contain them, after the mesh has moved on any
+    /// process. This function is collective.
+    void update_bounding_box_tree() const;
+
+    /// Set bounding box tree for mesh, which is returned by
+    /// bounding_box_tree() instead of building a new tree, e.g. a
+    /// tree read from file (see HDF5File::read). The tree must have
+    /// been built for the cells of this mesh with the current
+    /// coordinates.
+    ///
+    /// @param tree (std::shared_ptr<BoundingBoxTree>)
+    void set_bounding_box_tree(std::shared_ptr<BoundingBoxTree> tree);
+
     /// Get mesh data.
     ///
     /// @return MeshData&
@@ -296,7 +324,8 @@ namespace dolfin
     ///         Number of created entities.
     std::size_t init(std::size_t dim) const;
 
-    /// Compute connectivity between given pair of dimensions.
+    /// Compute connectivity between given pair of dimensions. If the
+    /// connectivity has been compressed, it is decompressed.
     ///
     /// @param    d0 (std::size_t)
     ///         Topological dimension.
@@ -316,6 +345,13 @@ namespace dolfin
     /// vertices.
     void clean();
 
+    /// Release all data which can be recomputed when needed: the
+    /// connectivity released by clean() and the bounding box tree.
+    ///
+    /// @return std::size_t
+    ///         Number of bytes released.
+    std::size_t release_derived_data();
+
     /// Order all mesh entities.
     ///
     /// See also: UFC documentation (put link here!)
@@ -466,6 +502,22 @@ namespace dolfin
     ///
     std::size_t hash() const;
 
+    /// Return number of bytes allocated for the mesh on this process,
+    /// including computed connectivity and the bounding box tree.
+    ///
+    /// @return std::size_t
+    ///         Number of bytes.
+    std::size_t memory_usage() const;
+
+    /// Return table with the number of bytes allocated for each
+    /// component of the mesh on this process: connectivity for each
+    /// computed pair of dimensions, parallel topology data, geometry,
+    /// domains, data and bounding box tree.
+    ///
+    /// @return Table
+    ///         Table with column "bytes".
+    Table memory_usage_table() const;
+
     /// Informal string representation.
     ///
     /// @param verbose (bool)
@@ -513,6 +565,7 @@ namespace dolfin
     friend class MeshEditor;
     friend class TopologyComputation;
     friend class MeshPartitioning;
+    friend class MeshRenumbering;
 
     // Mesh topology
     MeshTopology _topology;
@@ -531,6 +584,10 @@ namespace dolfin
     // and is allocated and built when bounding_box_tree() is called.
     mutable std::shared_ptr<BoundingBoxTree> _tree;
 
+    // Coordinates version (see MeshGeometry::coordinates_version) for
+    // which the bounding box tree was built or refitted
+    mutable std::size_t _tree_coordinates_version;
+
     // Cell type
     std::unique_ptr<CellType> _cell_type;
 
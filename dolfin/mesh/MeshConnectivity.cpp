@@ -18,10 +18,14 @@
 // Modified by Mikael Mortensen 2014
 //
 // First added:  2006-05-09
-// Last changed: 2014-01-09
+// Last changed: 2019-06-18
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
+#include <utility>
 #include <boost/functional/hash.hpp>
+#include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
 #include "MeshConnectivity.h"
 
@@ -29,13 +33,15 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 MeshConnectivity::MeshConnectivity(std::size_t d0, std::size_t d1)
-  : _d0(d0), _d1(d1)
+  : _d0(d0), _d1(d1), _num_entities(0), _size(0), _stride(0),
+    _compressed(false)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 MeshConnectivity::MeshConnectivity(const MeshConnectivity& connectivity)
-  : _d0(0), _d1(0)
+  : _d0(0), _d1(0), _num_entities(0), _size(0), _stride(0),
+    _compressed(false)
 {
   *this = connectivity;
 }
@@ -51,9 +57,15 @@ MeshConnectivity::operator= (const MeshConnectivity& connectivity)
   // Copy data
   _d0 = connectivity._d0;
   _d1 = connectivity._d1;
+  _num_entities = connectivity._num_entities;
+  _size = connectivity._size;
   _connections = connectivity._connections;
   _num_global_connections = connectivity._num_global_connections;
-  index_to_position = connectivity.index_to_position;
+  _stride = connectivity._stride;
+  _offsets32 = connectivity._offsets32;
+  _offsets64 = connectivity._offsets64;
+  _compressed_connections = connectivity._compressed_connections;
+  _compressed = connectivity._compressed;
 
   return *this;
 }
@@ -61,7 +73,13 @@ MeshConnectivity::operator= (const MeshConnectivity& connectivity)
 void MeshConnectivity::clear()
 {
   std::vector<unsigned int>().swap(_connections);
-  std::vector<unsigned int>().swap(index_to_position);
+  std::vector<std::uint32_t>().swap(_offsets32);
+  std::vector<std::uint64_t>().swap(_offsets64);
+  std::vector<std::uint8_t>().swap(_compressed_connections);
+  _num_entities = 0;
+  _size = 0;
+  _stride = 0;
+  _compressed = false;
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::init(std::size_t num_entities,
@@ -70,17 +88,15 @@ void MeshConnectivity::init(std::size_t num_entities,
   // Clear old data if any
   clear();
 
-  // Compute the total size
-  const std::size_t size = num_entities*num_connections;
+  // Equal number of connections for all entities, so no offsets are
+  // needed
+  _num_entities = num_entities;
+  _stride = num_connections;
+  _size = num_entities*num_connections;
 
   // Allocate
-  _connections.resize(size);
+  _connections.resize(_size);
   std::fill(_connections.begin(), _connections.end(), 0);
-  index_to_position.resize(num_entities + 1);
-
-  // Initialize data
-  for (std::size_t e = 0; e < index_to_position.size(); e++)
-    index_to_position[e] = e*num_connections;
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::init(std::vector<std::size_t>& num_connections)
@@ -89,47 +105,209 @@ void MeshConnectivity::init(std::vector<std::size_t>& num_connections)
   clear();
 
   // Initialize offsets and compute total size
-  const std::size_t num_entities = num_connections.size();
-  index_to_position.resize(num_entities + 1);
-  std::size_t size = 0;
-  for (std::size_t e = 0; e < num_entities; e++)
-  {
-    index_to_position[e] = size;
-    size += num_connections[e];
-  }
-  index_to_position[num_entities] = size;
+  init_offsets(num_connections);
 
   // Initialize connections
-  _connections.resize(size);
+  _connections.resize(_size);
   std::fill(_connections.begin(), _connections.end(), 0);
 }
 //-----------------------------------------------------------------------------
+void MeshConnectivity::set(std::vector<unsigned int>&& connections,
+                           std::size_t num_connections)
+{
+  dolfin_assert(num_connections > 0);
+  dolfin_assert(connections.size() % num_connections == 0);
+
+  // Clear old data if any
+  clear();
+
+  // Take ownership of connections, no offsets needed
+  _num_entities = connections.size()/num_connections;
+  _stride = num_connections;
+  _size = connections.size();
+  _connections = std::move(connections);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::set(std::vector<unsigned int>&& connections,
+                           const std::vector<std::size_t>& offsets)
+{
+  dolfin_assert(!offsets.empty());
+  dolfin_assert(offsets.back() == connections.size());
+
+  // Clear old data if any
+  clear();
+
+  // Take ownership of connections and store offsets
+  _num_entities = offsets.size() - 1;
+  _size = connections.size();
+  _connections = std::move(connections);
+  set_offsets(offsets);
+}
+//-----------------------------------------------------------------------------
 void MeshConnectivity::set(std::size_t entity, std::size_t connection,
                            std::size_t pos)
 {
-  dolfin_assert((entity + 1) < index_to_position.size());
-  dolfin_assert(pos < index_to_position[entity + 1]
-                - index_to_position[entity]);
-  _connections[index_to_position[entity] + pos] = connection;
+  dolfin_assert(!_compressed);
+  dolfin_assert(entity < _num_entities);
+  dolfin_assert(pos < position(entity + 1) - position(entity));
+  _connections[position(entity) + pos] = connection;
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::set(std::size_t entity, std::size_t* connections)
 {
-  dolfin_assert((entity + 1) < index_to_position.size());
+  dolfin_assert(!_compressed);
+  dolfin_assert(entity < _num_entities);
   dolfin_assert(connections);
 
   // Copy data
   const std::size_t num_connections
-    = index_to_position[entity + 1] - index_to_position[entity];
+    = position(entity + 1) - position(entity);
   std::copy(connections, connections + num_connections,
-            _connections.begin() + index_to_position[entity]);
+            _connections.begin() + position(entity));
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::compress()
+{
+  if (_compressed)
+    return;
+
+  // Append variable-length encoding of unsigned integer
+  std::vector<std::uint8_t> bytes;
+  bytes.reserve(_size + _num_entities);
+  auto write_varint = [&bytes](std::uint64_t value)
+    {
+      while (value >= 0x80)
+      {
+        bytes.push_back((value & 0x7f) | 0x80);
+        value >>= 7;
+      }
+      bytes.push_back(value);
+    };
+
+  // Encode number of connections, first connection and (zigzag
+  // encoded) differences to previous connection for each entity
+  std::vector<std::size_t> offsets(_num_entities + 1);
+  for (std::size_t e = 0; e < _num_entities; ++e)
+  {
+    offsets[e] = bytes.size();
+    const std::size_t begin = position(e);
+    const std::size_t end = position(e + 1);
+    write_varint(end - begin);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      if (i == begin)
+        write_varint(_connections[i]);
+      else
+      {
+        const std::int64_t d = (std::int64_t) _connections[i]
+          - (std::int64_t) _connections[i - 1];
+        // Shift as unsigned, as left shift of negative values is
+        // undefined
+        write_varint(((std::uint64_t) d << 1) ^ (std::uint64_t) (d >> 63));
+      }
+    }
+  }
+  offsets[_num_entities] = bytes.size();
+
+  // Replace connections by compressed connections (offsets always
+  // stored, since entities use a variable number of bytes)
+  bytes.shrink_to_fit();
+  std::vector<unsigned int>().swap(_connections);
+  _compressed_connections = std::move(bytes);
+  set_offsets(offsets);
+  _compressed = true;
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::decompress()
+{
+  if (!_compressed)
+    return;
+
+  // Decode connections
+  std::vector<std::size_t> num_connections(_num_entities);
+  std::vector<unsigned int> connections;
+  connections.reserve(_size);
+  for (std::size_t e = 0; e < _num_entities; ++e)
+  {
+    num_connections[e] = size(e);
+    for_each(e, [&connections](unsigned int c) { connections.push_back(c); });
+  }
+
+  // Restore uncompressed storage
+  std::vector<std::uint8_t>().swap(_compressed_connections);
+  _compressed = false;
+  init_offsets(num_connections);
+  _connections = std::move(connections);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::compressed_error() const
+{
+  dolfin_error("MeshConnectivity.cpp",
+               "access mesh connectivity",
+               "Connectivity %d -- %d is compressed. Call MeshConnectivity::decompress() or Mesh::init(%d, %d) first",
+               _d0, _d1, _d0, _d1);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::init_offsets(const std::vector<std::size_t>&
+                                    num_connections)
+{
+  _num_entities = num_connections.size();
+  _size = 0;
+  for (auto n : num_connections)
+    _size += n;
+
+  // No offsets needed if the number of connections is equal for all
+  // entities
+  std::vector<std::uint32_t>().swap(_offsets32);
+  std::vector<std::uint64_t>().swap(_offsets64);
+  if (std::all_of(num_connections.begin(), num_connections.end(),
+                  [&num_connections](std::size_t n)
+                  { return n == num_connections[0]; }))
+  {
+    _stride = num_connections.empty() ? 0 : num_connections[0];
+    return;
+  }
+
+  std::vector<std::size_t> offsets(_num_entities + 1);
+  offsets[0] = 0;
+  for (std::size_t e = 0; e < _num_entities; ++e)
+    offsets[e + 1] = offsets[e] + num_connections[e];
+  set_offsets(offsets);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::set_offsets(const std::vector<std::size_t>& offsets)
+{
+  _stride = 0;
+  std::vector<std::uint32_t>().swap(_offsets32);
+  std::vector<std::uint64_t>().swap(_offsets64);
+  if (offsets.back() <= std::numeric_limits<std::uint32_t>::max())
+    _offsets32.assign(offsets.begin(), offsets.end());
+  else
+    _offsets64.assign(offsets.begin(), offsets.end());
 }
 //-----------------------------------------------------------------------------
 std::size_t MeshConnectivity::hash() const
 {
-  // Compute local hash key
-  boost::hash<std::vector<unsigned int>> uhash;
-  return uhash(_connections);
+  // Compute local hash key (equal for compressed and uncompressed
+  // storage)
+  if (!_compressed)
+  {
+    boost::hash<std::vector<unsigned int>> uhash;
+    return uhash(_connections);
+  }
+
+  std::size_t seed = 0;
+  for (std::size_t e = 0; e < _num_entities; ++e)
+    for_each(e, [&seed](unsigned int c) { boost::hash_combine(seed, c); });
+  return seed;
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshConnectivity::memory_usage() const
+{
+  return sizeof(*this) + dolfin::memory_usage(_connections)
+    + dolfin::memory_usage(_num_global_connections)
+    + dolfin::memory_usage(_offsets32) + dolfin::memory_usage(_offsets64)
+    + dolfin::memory_usage(_compressed_connections);
 }
 //-----------------------------------------------------------------------------
 std::string MeshConnectivity::str(bool verbose) const
@@ -139,21 +317,17 @@ std::string MeshConnectivity::str(bool verbose) const
   if (verbose)
   {
     s << str(false) << std::endl << std::endl;
-    for (std::size_t e = 0; e < index_to_position.size() - 1; e++)
+    for (std::size_t e = 0; e < _num_entities; e++)
     {
       s << "  " << e << ":";
-      for (std::size_t i = index_to_position[e]; i < index_to_position[e + 1];
-           i++)
-      {
-        s << " " << _connections[i];
-      }
+      for_each(e, [&s](unsigned int c) { s << " " << c; });
       s << std::endl;
     }
   }
   else
   {
     s << "<MeshConnectivity " << _d0 << " -- " << _d1 << " of size "
-      << _connections.size() << ">";
+      << _size << (_compressed ? " (compressed)" : "") << ">";
   }
 
   return s.str();
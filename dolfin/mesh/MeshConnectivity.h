@@ -16,11 +16,12 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2006-05-09
-// Last changed: 2010-11-28
+// Last changed: 2019-06-18
 
 #ifndef __MESH_CONNECTIVITY_H
 #define __MESH_CONNECTIVITY_H
 
+#include <cstdint>
 #include <vector>
 #include <dolfin/log/log.h>
 
@@ -35,6 +36,17 @@ namespace dolfin
   /// number of entities and the number of connections for each entity,
   /// which may either be equal for all entities or different, or by
   /// giving the entire (sparse) connectivity pattern.
+  ///
+  /// If all entities have the same number of connections (e.g. cell
+  /// to vertex), no offsets are stored. Otherwise, offsets are stored
+  /// as 32-bit integers, or as 64-bit integers if the total number of
+  /// connections exceeds the 32-bit range.
+  ///
+  /// Connectivity which is rarely used (e.g. vertex to cell) may be
+  /// compressed. Compressed connections are stored as variable-length
+  /// encoded differences and are accessed with for_each(), which
+  /// decodes them on the fly. Raw access to the connections (with
+  /// operator()) raises an error until decompress() is called.
 
   class MeshConnectivity
   {
@@ -54,17 +66,25 @@ namespace dolfin
 
     /// Return true if the total number of connections is equal to zero
     bool empty() const
-    { return _connections.empty(); }
+    { return _size == 0; }
 
     /// Return total number of connections
     std::size_t size() const
-    { return _connections.size(); }
+    { return _size; }
 
     /// Return number of connections for given entity
     std::size_t size(std::size_t entity) const
     {
-      return (entity + 1) < index_to_position.size()
-          ? index_to_position[entity + 1] - index_to_position[entity] : 0;
+      if (entity >= _num_entities)
+        return 0;
+      else if (_compressed)
+      {
+        const std::uint8_t* p = _compressed_connections.data()
+          + position(entity);
+        return read_varint(p);
+      }
+      else
+        return position(entity + 1) - position(entity);
     }
 
     /// Return global number of connections for given entity
@@ -79,16 +99,57 @@ namespace dolfin
       }
     }
 
-    /// Return array of connections for given entity
+    /// Return array of connections for given entity (not available
+    /// for compressed connectivity)
     const unsigned int* operator() (std::size_t entity) const
     {
-      return (entity + 1) < index_to_position.size()
-        ? &_connections[index_to_position[entity]] : 0;
+      if (_compressed)
+        compressed_error();
+      return entity < _num_entities
+        ? _connections.data() + position(entity) : 0;
     }
 
-    /// Return contiguous array of connections for all entities
+    /// Return contiguous array of connections for all entities (not
+    /// available for compressed connectivity)
     const std::vector<unsigned int>& operator() () const
-    { return _connections; }
+    {
+      if (_compressed)
+        compressed_error();
+      return _connections;
+    }
+
+    /// Call f(connection) for each connection of given entity. For
+    /// compressed connectivity the connections are decoded on the fly.
+    template<typename F>
+    void for_each(std::size_t entity, F f) const
+    {
+      if (entity >= _num_entities)
+        return;
+
+      if (!_compressed)
+      {
+        const std::size_t begin = position(entity);
+        const std::size_t end = position(entity + 1);
+        for (std::size_t i = begin; i < end; ++i)
+          f(_connections[i]);
+        return;
+      }
+
+      // First connection is stored as is, the others as (zigzag
+      // encoded) differences to the previous connection
+      const std::uint8_t* p = _compressed_connections.data() + position(entity);
+      const std::size_t n = read_varint(p);
+      std::int64_t connection = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const std::uint64_t v = read_varint(p);
+        if (i == 0)
+          connection = v;
+        else
+          connection += (std::int64_t) (v >> 1) ^ -(std::int64_t) (v & 1);
+        f((unsigned int) connection);
+      }
+    }
 
     /// Clear all data
     void clear();
@@ -101,6 +162,18 @@ namespace dolfin
     /// (individually)
     void init(std::vector<std::size_t>& num_connections);
 
+    /// Set all connections for all entities, with an equal number of
+    /// connections for each entity, taking ownership of the array
+    /// (connections are stored entity by entity)
+    void set(std::vector<unsigned int>&& connections,
+             std::size_t num_connections);
+
+    /// Set all connections for all entities, with offsets into the
+    /// array of connections for each entity (num_entities + 1
+    /// values), taking ownership of the array
+    void set(std::vector<unsigned int>&& connections,
+             const std::vector<std::size_t>& offsets);
+
     /// Set given connection for given entity
     void set(std::size_t entity, std::size_t connection, std::size_t pos);
 
@@ -109,13 +182,14 @@ namespace dolfin
     template<typename T>
     void set(std::size_t entity, const T& connections)
     {
-      dolfin_assert((entity + 1) < index_to_position.size());
+      dolfin_assert(!_compressed);
+      dolfin_assert(entity < _num_entities);
       dolfin_assert(connections.size()
-                    == index_to_position[entity + 1]-index_to_position[entity]);
+                    == position(entity + 1) - position(entity));
 
       // Copy data
       std::copy(connections.begin(), connections.end(),
-                _connections.begin() + index_to_position[entity]);
+                _connections.begin() + position(entity));
     }
 
     /// Set all connections for given entity
@@ -131,17 +205,13 @@ namespace dolfin
       clear();
 
       // Initialize offsets and compute total size
-      index_to_position.resize(connections.size() + 1);
-      std::int32_t size = 0;
+      std::vector<std::size_t> num_connections(connections.size());
       for (std::size_t e = 0; e < connections.size(); e++)
-      {
-        index_to_position[e] = size;
-        size += connections[e].size();
-      }
-      index_to_position[connections.size()] = size;
+        num_connections[e] = connections[e].size();
+      init_offsets(num_connections);
 
       // Initialize connections
-      _connections.reserve(size);
+      _connections.reserve(_size);
       for (auto e = connections.begin(); e != connections.end(); ++e)
         _connections.insert(_connections.end(), e->begin(), e->end());
 
@@ -152,22 +222,86 @@ namespace dolfin
     void
       set_global_size(const std::vector<unsigned int>& num_global_connections)
     {
-      dolfin_assert(num_global_connections.size()
-                    == index_to_position.size() - 1);
+      dolfin_assert(num_global_connections.size() == _num_entities);
       _num_global_connections = num_global_connections;
     }
 
+    /// Compress connections. Connections of each entity are stored as
+    /// variable-length encoded differences, which is efficient when
+    /// the connections of an entity have nearby indices.
+    void compress();
+
+    /// Decompress connections
+    void decompress();
+
+    /// Return true if connections are compressed
+    bool compressed() const
+    { return _compressed; }
+
+    /// Return true if offsets are stored as 64-bit integers
+    bool has_64bit_offsets() const
+    { return !_offsets64.empty(); }
+
+    /// Return true if all entities have the same number of connections
+    /// (no offsets are stored)
+    bool fixed_stride() const
+    { return _offsets32.empty() and _offsets64.empty(); }
+
     /// Hash of connections
     std::size_t hash() const;
 
+    /// Return number of bytes allocated for the connectivity
+    std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
   private:
 
+    // Views access the raw connectivity storage
+    friend class ConnectivityView;
+
+    // Raise error for raw access to compressed connections
+    void compressed_error() const;
+
+    // Position of first connection (or first byte, if compressed) for
+    // entity
+    std::size_t position(std::size_t entity) const
+    {
+      if (!_offsets32.empty())
+        return _offsets32[entity];
+      else if (!_offsets64.empty())
+        return _offsets64[entity];
+      else
+        return entity*_stride;
+    }
+
+    // Initialize offsets (or stride) from number of connections of
+    // each entity, and total size
+    void init_offsets(const std::vector<std::size_t>& num_connections);
+
+    // Store offsets with the smallest width which can hold them
+    void set_offsets(const std::vector<std::size_t>& offsets);
+
+    // Decode variable-length unsigned integer and advance pointer
+    static std::uint64_t read_varint(const std::uint8_t*& p)
+    {
+      std::uint64_t value = 0;
+      for (unsigned int shift = 0; ; shift += 7)
+      {
+        const std::uint8_t byte = *p++;
+        value |= (std::uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+          return value;
+      }
+    }
+
     // Dimensions (only used for pretty-printing)
     std::size_t _d0, _d1;
 
+    // Number of entities and total number of connections
+    std::size_t _num_entities, _size;
+
     // Connections for all entities stored as a contiguous array
     std::vector<unsigned int> _connections;
 
@@ -175,8 +309,18 @@ namespace dolfin
     // computed)
     std::vector<unsigned int> _num_global_connections;
 
-    // Position of first connection for each entity (using local index)
-    std::vector<unsigned int> index_to_position;
+    // Number of connections of each entity, if equal for all entities
+    std::size_t _stride;
+
+    // Position of first connection for each entity (using local
+    // index), with 32-bit or 64-bit width. Both are empty if the
+    // number of connections is equal for all entities.
+    std::vector<std::uint32_t> _offsets32;
+    std::vector<std::uint64_t> _offsets64;
+
+    // Compressed connections, and flag for compressed storage
+    std::vector<std::uint8_t> _compressed_connections;
+    bool _compressed;
 
   };
 
@@ -144,6 +144,20 @@ void MeshData::erase_array(const std::string name, std::size_t dim)
     warning("Mesh data named \"%s\" does not exist.", name.c_str());
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshData::memory_usage() const
+{
+  typedef std::map<std::string, std::vector<std::size_t>> ArrayMap;
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(_arrays)
+    + dolfin::memory_usage(_deprecated_names);
+  for (const auto& arrays : _arrays)
+  {
+    bytes += node_memory_usage<ArrayMap::value_type>(arrays.size());
+    for (const auto& a : arrays)
+      bytes += a.first.capacity() + dolfin::memory_usage(a.second);
+  }
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string MeshData::str(bool verbose) const
 {
   std::stringstream s;
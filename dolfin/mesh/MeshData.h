@@ -19,7 +19,7 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2008-05-19
-// Last changed: 2011-09-15
+// Last changed: 2019-06-18
 
 #ifndef __MESH_DATA_H
 #define __MESH_DATA_H
@@ -52,6 +52,8 @@ namespace dolfin
   /// Sub meshes (used by the class SubMesh)
   ///
   ///   * "parent_vertex_indices" - _std::vector_ <std::size_t> of dimension 0
+  ///   * "parent_entity_indices" - _std::vector_ <std::size_t> of dimension 0 < d < D
+  ///   * "parent_cell_indices"   - _std::vector_ <std::size_t> of dimension D
   ///
   /// Note to developers: use underscore in names in place of spaces.
 
@@ -146,6 +148,9 @@ namespace dolfin
     ///         An informal representation.
     std::string str(bool verbose) const;
 
+    /// Return number of bytes allocated for the data
+    std::size_t memory_usage() const;
+
     /// Friends
     friend class XMLMesh;
 
@@ -21,6 +21,7 @@
 // Last changed: 2011-04-03
 
 #include <limits>
+#include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
 #include "MeshDomains.h"
 
@@ -127,3 +128,13 @@ void MeshDomains::clear()
   _markers.clear();
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshDomains::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(_markers);
+  for (const auto& markers : _markers)
+  {
+    bytes += node_memory_usage<std::pair<std::size_t, std::size_t>>(markers.size());
+  }
+  return bytes;
+}
+//-----------------------------------------------------------------------------
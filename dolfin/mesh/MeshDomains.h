@@ -83,6 +83,9 @@ namespace dolfin
     /// Clear all data
     void clear();
 
+    /// Return number of bytes allocated for the markers
+    std::size_t memory_usage() const;
+
   private:
 
     // Subdomain markers for each geometric dimension
@@ -18,10 +18,17 @@
 // Modified by Benjamin Kehlet, 2012
 //
 // First added:  2006-05-16
-// Last changed: 2014-02-06
+// Last changed: 2019-06-18
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <dolfin/common/Threads.h>
 #include <dolfin/log/log.h>
 #include <dolfin/geometry/Point.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Mesh.h"
 #include "MeshEntity.h"
 #include "MeshFunction.h"
@@ -69,6 +76,9 @@ void MeshEditor::open(Mesh& mesh, CellType::Type type, std::size_t tdim,
   // after close(false)
   mesh._ordered = false;
 
+  // Clear bounding box tree built for the old mesh
+  mesh._tree.reset();
+
   // Initialize temporary storage for local cell data
   _vertices = std::vector<std::size_t>(mesh.type().num_vertices(tdim), 0);
 }
@@ -262,6 +272,171 @@ void MeshEditor::add_cell(std::size_t c, std::size_t v0, std::size_t v1,
   add_cell(c, c, _vertices);
 }
 //-----------------------------------------------------------------------------
+void MeshEditor::set_vertices(std::vector<double>&& x, bool check)
+{
+  // Global indices are equal to local indices
+  std::vector<std::int64_t> global_indices(_gdim > 0 ? x.size()/_gdim : 0);
+  std::iota(global_indices.begin(), global_indices.end(), 0);
+  const std::size_t num_vertices = global_indices.size();
+  set_vertices_global(std::move(x), std::move(global_indices), num_vertices,
+                      check);
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::set_vertices_global(std::vector<double>&& x,
+                                     std::vector<std::int64_t>&& global_indices,
+                                     std::size_t num_global_vertices,
+                                     bool check)
+{
+  // Check if we are currently editing a mesh
+  if (!_mesh)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "No mesh opened, unable to edit");
+  }
+
+  // Higher degree geometry also has points on edges, faces and cells
+  if (_mesh->geometry().degree() != 1)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "Setting all vertices at once is only supported for geometry of degree 1 (degree is %d)",
+                 _mesh->geometry().degree());
+  }
+
+  // Check array sizes
+  if (x.size() % _gdim != 0)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "Size of coordinate array (%d) is not a multiple of the geometric dimension (%d)",
+                 x.size(), _gdim);
+  }
+  const std::size_t num_vertices = x.size()/_gdim;
+  if (global_indices.size() != num_vertices)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "Number of global indices (%d) does not match number of vertices (%d)",
+                 global_indices.size(), num_vertices);
+  }
+
+  // Check coordinates
+  if (check)
+    check_coordinates(x);
+
+  // Initialize mesh data, taking ownership of arrays
+  _num_vertices = num_vertices;
+  next_vertex = num_vertices;
+  _mesh->_topology.init(0, num_vertices, num_global_vertices);
+  _mesh->_topology.init_ghost(0, num_vertices);
+  _mesh->_topology.set_global_indices(0, std::move(global_indices));
+  _mesh->_geometry.set_vertex_coordinates(std::move(x));
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::set_vertices(const Eigen::Ref<const Eigen::Array<double,
+                              Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>>& x, bool check)
+{
+  if ((std::size_t) x.cols() != _gdim)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "Number of columns of coordinate array (%d) does not match geometric dimension (%d)",
+                 x.cols(), _gdim);
+  }
+
+  // Copy coordinates
+  std::vector<double> coordinates(x.size());
+  Eigen::Map<Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic,
+                          Eigen::RowMajor>>(coordinates.data(), x.rows(),
+                                            x.cols()) = x;
+  set_vertices(std::move(coordinates), check);
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::set_cells(std::vector<unsigned int>&& cells, bool check)
+{
+  // Global indices are equal to local indices
+  std::vector<std::int64_t> global_indices;
+  if (_mesh)
+    global_indices.resize(cells.size()/_mesh->type().num_vertices(_tdim));
+  std::iota(global_indices.begin(), global_indices.end(), 0);
+  const std::size_t num_cells = global_indices.size();
+  set_cells_global(std::move(cells), std::move(global_indices), num_cells,
+                   check);
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::set_cells_global(std::vector<unsigned int>&& cells,
+                                  std::vector<std::int64_t>&& global_indices,
+                                  std::size_t num_global_cells,
+                                  bool check)
+{
+  // Check if we are currently editing a mesh
+  if (!_mesh)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set cells in mesh editor",
+                 "No mesh opened, unable to edit");
+  }
+
+  // Check array sizes
+  const std::size_t num_cell_vertices = _mesh->type().num_vertices(_tdim);
+  if (cells.size() % num_cell_vertices != 0)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set cells in mesh editor",
+                 "Size of cell array (%d) is not a multiple of the number of cell vertices (%d)",
+                 cells.size(), num_cell_vertices);
+  }
+  const std::size_t num_cells = cells.size()/num_cell_vertices;
+  if (global_indices.size() != num_cells)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set cells in mesh editor",
+                 "Number of global indices (%d) does not match number of cells (%d)",
+                 global_indices.size(), num_cells);
+  }
+
+  // Check vertices
+  if (check)
+    check_cells(cells);
+
+  // Initialize mesh data, taking ownership of arrays
+  _num_cells = num_cells;
+  next_cell = num_cells;
+  _mesh->_topology.init(_tdim, num_cells, num_global_cells);
+  _mesh->_topology.init_ghost(_tdim, num_cells);
+  _mesh->_topology.set_global_indices(_tdim, std::move(global_indices));
+  _mesh->_topology(_tdim, 0).set(std::move(cells), num_cell_vertices);
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::set_cells(const Eigen::Ref<const Eigen::Array<std::size_t,
+                           Eigen::Dynamic, Eigen::Dynamic,
+                           Eigen::RowMajor>>& cells, bool check)
+{
+  if (_mesh && (std::size_t) cells.cols() != _mesh->type().num_vertices(_tdim))
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set cells in mesh editor",
+                 "Number of columns of cell array (%d) does not match number of cell vertices (%d)",
+                 cells.cols(), _mesh->type().num_vertices(_tdim));
+  }
+
+  // Copy vertex indices. Indices which do not fit in the storage are
+  // mapped to an invalid index, caught by the check.
+  std::vector<unsigned int> cell_vertices(cells.size());
+  const unsigned int invalid = std::numeric_limits<unsigned int>::max();
+  for (Eigen::Index i = 0; i < cells.rows(); ++i)
+  {
+    for (Eigen::Index j = 0; j < cells.cols(); ++j)
+    {
+      const std::size_t v = cells(i, j);
+      cell_vertices[i*cells.cols() + j] = v < invalid ? v : invalid;
+    }
+  }
+  set_cells(std::move(cell_vertices), check);
+}
+//-----------------------------------------------------------------------------
 void MeshEditor::close(bool order)
 {
   // Order mesh if requested
@@ -354,6 +529,70 @@ void MeshEditor::add_cell_common(std::size_t c, std::size_t tdim)
   next_cell++;
 }
 //-----------------------------------------------------------------------------
+void MeshEditor::check_coordinates(const std::vector<double>& x) const
+{
+  // Find first coordinate which is not finite, for each thread
+  const std::size_t num_threads = parameters["num_threads"];
+  std::vector<std::size_t> invalid(std::max<std::size_t>(num_threads, 1),
+                                   x.size());
+  Threads::parallel_for(x.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        if (!std::isfinite(x[i]))
+        {
+          invalid[t] = i;
+          break;
+        }
+      }
+    });
+
+  const std::size_t i = *std::min_element(invalid.begin(), invalid.end());
+  if (i < x.size())
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set vertices in mesh editor",
+                 "Coordinate %d of vertex %d is not finite",
+                 i % _gdim, i/_gdim);
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::check_cells(const std::vector<unsigned int>& cells) const
+{
+  // Vertices are not checked when they have not been specified, as
+  // for add_cell
+  if (_num_vertices == 0)
+    return;
+
+  // Find first vertex index which is out of range, for each thread
+  const std::size_t num_threads = parameters["num_threads"];
+  std::vector<std::size_t> invalid(std::max<std::size_t>(num_threads, 1),
+                                   cells.size());
+  Threads::parallel_for(cells.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        if (cells[i] >= _num_vertices)
+        {
+          invalid[t] = i;
+          break;
+        }
+      }
+    });
+
+  const std::size_t i = *std::min_element(invalid.begin(), invalid.end());
+  if (i < cells.size())
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "set cells in mesh editor",
+                 "Vertex index (%d) of cell %d out of range [0, %d)",
+                 cells[i], i/_mesh->type().num_vertices(_tdim),
+                 _num_vertices);
+  }
+}
+//-----------------------------------------------------------------------------
 void MeshEditor::clear()
 {
   _tdim = 0;
@@ -16,12 +16,14 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2006-05-16
-// Last changed: 2014-02-06
+// Last changed: 2019-06-18
 
 #ifndef __MESH_EDITOR_H
 #define __MESH_EDITOR_H
 
+#include <cstdint>
 #include <vector>
+#include <Eigen/Dense>
 #include "CellType.h"
 #include "Mesh.h"
 
@@ -301,6 +303,105 @@ namespace dolfin
       _mesh->_topology.set_global_index(_tdim, local_index, global_index);
     }
 
+    /// Set all vertices at once (serial version), taking ownership of
+    /// the coordinate array without copying. Replaces init_vertices
+    /// and add_vertex. Only for meshes with affine (degree 1)
+    /// geometry.
+    ///
+    /// @param    x (std::vector<double>)
+    ///         The coordinates, vertex by vertex (num_vertices*gdim
+    ///         values).
+    /// @param    check (bool)
+    ///         Check that all coordinates are finite. The check runs
+    ///         with parameters["num_threads"] threads. Default value
+    ///         is true.
+    ///
+    /// @code{.cpp}
+    ///
+    ///         Mesh mesh;
+    ///         MeshEditor editor;
+    ///         editor.open(mesh, "triangle", 2, 2);
+    ///         editor.set_vertices(std::move(x));
+    ///         editor.set_cells(std::move(cells));
+    ///         editor.close();
+    /// @endcode
+    void set_vertices(std::vector<double>&& x, bool check=true);
+
+    /// Set all vertices at once (distributed version), taking
+    /// ownership of the coordinate and global index arrays without
+    /// copying. Replaces init_vertices_global and add_vertex_global.
+    /// Only for meshes with affine (degree 1) geometry.
+    ///
+    /// @param    x (std::vector<double>)
+    ///         The coordinates, vertex by vertex (num_vertices*gdim
+    ///         values).
+    /// @param    global_indices (std::vector<std::int64_t>)
+    ///         The global vertex indices (num_vertices values).
+    /// @param    num_global_vertices (std::size_t)
+    ///         The number of vertices in distributed mesh.
+    /// @param    check (bool)
+    ///         Check that all coordinates are finite. Default value
+    ///         is true.
+    void set_vertices_global(std::vector<double>&& x,
+                             std::vector<std::int64_t>&& global_indices,
+                             std::size_t num_global_vertices,
+                             bool check=true);
+
+    /// Set all vertices at once (serial version) from array of
+    /// coordinates, with one row per vertex. The array is copied in
+    /// bulk.
+    ///
+    /// @param    x (Eigen::Array)
+    ///         The coordinates (num_vertices x gdim).
+    /// @param    check (bool)
+    ///         Check that all coordinates are finite. Default value
+    ///         is true.
+    void set_vertices(const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic,
+                      Eigen::Dynamic, Eigen::RowMajor>>& x, bool check=true);
+
+    /// Set all cells at once (serial version), taking ownership of
+    /// the cell-vertex array without copying. Replaces init_cells and
+    /// add_cell.
+    ///
+    /// @param    cells (std::vector<unsigned int>)
+    ///         The vertex indices (local indices), cell by cell
+    ///         (num_cells*num_cell_vertices values).
+    /// @param    check (bool)
+    ///         Check that all vertex indices are in range. The check
+    ///         runs with parameters["num_threads"] threads. Default
+    ///         value is true.
+    void set_cells(std::vector<unsigned int>&& cells, bool check=true);
+
+    /// Set all cells at once (distributed version), taking ownership
+    /// of the cell-vertex and global index arrays without copying.
+    /// Replaces init_cells_global and add_cell.
+    ///
+    /// @param    cells (std::vector<unsigned int>)
+    ///         The vertex indices (local indices), cell by cell
+    ///         (num_cells*num_cell_vertices values).
+    /// @param    global_indices (std::vector<std::int64_t>)
+    ///         The global cell indices (num_cells values).
+    /// @param    num_global_cells (std::size_t)
+    ///         The number of cells in distributed mesh.
+    /// @param    check (bool)
+    ///         Check that all vertex indices are in range. Default
+    ///         value is true.
+    void set_cells_global(std::vector<unsigned int>&& cells,
+                          std::vector<std::int64_t>&& global_indices,
+                          std::size_t num_global_cells,
+                          bool check=true);
+
+    /// Set all cells at once (serial version) from array of vertex
+    /// indices, with one row per cell. The array is copied in bulk.
+    ///
+    /// @param    cells (Eigen::Array)
+    ///         The vertex indices (num_cells x num_cell_vertices).
+    /// @param    check (bool)
+    ///         Check that all vertex indices are in range. Default
+    ///         value is true.
+    void set_cells(const Eigen::Ref<const Eigen::Array<std::size_t, Eigen::Dynamic,
+                   Eigen::Dynamic, Eigen::RowMajor>>& cells, bool check=true);
+
     /// Close mesh, finish editing, and order entities locally
     ///
     /// @param    order (bool)
@@ -326,6 +427,12 @@ namespace dolfin
     // Add cell, common part
     void add_cell_common(std::size_t v, std::size_t dim);
 
+    // Check that all coordinates are finite (in parallel)
+    void check_coordinates(const std::vector<double>& x) const;
+
+    // Check that all cell vertices are in range (in parallel)
+    void check_cells(const std::vector<unsigned int>& cells) const;
+
     // Compute boundary indicators (exterior facets)
     void compute_boundary_indicators();
 
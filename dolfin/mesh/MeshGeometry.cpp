@@ -19,23 +19,28 @@
 // Modified by Kristoffer Selim, 2008.
 //
 // First added:  2006-05-19
-// Last changed: 2010-04-29
+// Last changed: 2019-06-18
 
 #include <sstream>
+#include <utility>
 #include <boost/functional/hash.hpp>
 
+#include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
 #include "MeshGeometry.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry() : _dim(0), _degree(1)
+MeshGeometry::MeshGeometry() : _dim(0), _degree(1), _single_precision(false),
+                               _x_single_stale(false), _coordinates_version(0)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry(const MeshGeometry& geometry) : _dim(0)
+MeshGeometry::MeshGeometry(const MeshGeometry& geometry)
+  : _dim(0), _single_precision(false), _x_single_stale(false),
+    _coordinates_version(0)
 {
   *this = geometry;
 }
@@ -53,6 +58,10 @@ const MeshGeometry& MeshGeometry::operator= (const MeshGeometry& geometry)
   // Copy remaining data
   coordinates = geometry.coordinates;
   entity_offsets = geometry.entity_offsets;
+  _single_precision = geometry._single_precision;
+  _x_single = geometry._x_single;
+  _x_single_stale = geometry._x_single_stale;
+  ++_coordinates_version;
 
   return *this;
 }
@@ -110,12 +119,76 @@ void MeshGeometry::init_entities(const std::vector<std::size_t>& num_entities)
     }
   }
   coordinates.resize(_dim*offset);
+  _x_single_stale = true;
+  ++_coordinates_version;
 }
 //-----------------------------------------------------------------------------
 void MeshGeometry::set(std::size_t local_index,
                        const double* x)
 {
   std::copy(x, x +_dim, coordinates.begin() + local_index*_dim);
+  ++_coordinates_version;
+  if (_single_precision and !_x_single_stale)
+    std::copy(x, x + _dim, _x_single.begin() + local_index*_dim);
+}
+//-----------------------------------------------------------------------------
+void MeshGeometry::set_vertex_coordinates(std::vector<double>&& x)
+{
+  // Check that geometry has been initialised and has no points on
+  // higher dimensional entities
+  if (_dim == 0 or _degree != 1)
+  {
+    dolfin_error("MeshGeometry.cpp",
+                 "set vertex coordinates",
+                 "Geometry must be initialised with degree 1 (dimension is %d, degree is %d)",
+                 _dim, _degree);
+  }
+  if (x.size() % _dim != 0)
+  {
+    dolfin_error("MeshGeometry.cpp",
+                 "set vertex coordinates",
+                 "Size of coordinate array (%d) is not a multiple of the geometric dimension (%d)",
+                 x.size(), _dim);
+  }
+
+  // Vertices are the first (and only) block of points
+  entity_offsets.assign(1, std::vector<std::size_t>(1, 0));
+  coordinates = std::move(x);
+  _x_single_stale = true;
+  ++_coordinates_version;
+}
+//-----------------------------------------------------------------------------
+void MeshGeometry::init_single_precision(bool enable)
+{
+  _single_precision = enable;
+  if (enable)
+    update_single_precision();
+  else
+    std::vector<float>().swap(_x_single);
+}
+//-----------------------------------------------------------------------------
+const std::vector<float>& MeshGeometry::x_single() const
+{
+  if (!_single_precision)
+  {
+    dolfin_error("MeshGeometry.cpp",
+                 "access single precision coordinates",
+                 "Single precision coordinates have not been initialized");
+  }
+
+  if (_x_single_stale)
+    update_single_precision();
+  return _x_single;
+}
+//-----------------------------------------------------------------------------
+void MeshGeometry::update_single_precision() const
+{
+  if (!_single_precision)
+    return;
+
+  _x_single.resize(coordinates.size());
+  std::copy(coordinates.begin(), coordinates.end(), _x_single.begin());
+  _x_single_stale = false;
 }
 //-----------------------------------------------------------------------------
 std::size_t MeshGeometry::hash() const
@@ -126,6 +199,15 @@ std::size_t MeshGeometry::hash() const
   return local_hash;
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshGeometry::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(coordinates)
+    + dolfin::memory_usage(_x_single) + dolfin::memory_usage(entity_offsets);
+  for (const auto& offsets : entity_offsets)
+    bytes += dolfin::memory_usage(offsets);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string MeshGeometry::str(bool verbose) const
 {
   std::stringstream s;
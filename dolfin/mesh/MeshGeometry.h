@@ -18,7 +18,7 @@
 // Modified by Garth N. Wells, 2008.
 //
 // First added:  2006-05-08
-// Last changed: 2016-06-10
+// Last changed: 2019-06-18
 
 #ifndef __MESH_GEOMETRY_H
 #define __MESH_GEOMETRY_H
@@ -110,9 +110,10 @@ namespace dolfin
       return &coordinates[n*_dim];
     }
 
-    /// Return array of values for all coordinates
+    /// Return array of values for all coordinates. Marks the single
+    /// precision copy of the coordinates (if any) for update.
     std::vector<double>& x()
-    { return coordinates; }
+    { _x_single_stale = true; ++_coordinates_version; return coordinates; }
 
     /// Return array of values for all coordinates
     const std::vector<double>& x() const
@@ -163,6 +164,51 @@ namespace dolfin
     /// Set value of coordinate
     void set(std::size_t local_index, const double* x);
 
+    /// Set coordinates of all vertices, taking ownership of the array
+    /// (coordinates are stored vertex by vertex). Replaces
+    /// init_entities for geometry of degree 1, which has no points on
+    /// higher dimensional entities.
+    void set_vertex_coordinates(std::vector<double>&& x);
+
+    /// Enable (or disable) a single precision copy of the
+    /// coordinates, for use in geometric searches and output where
+    /// single precision is sufficient. The copy is kept consistent
+    /// with the coordinates: set() updates it, and it is refreshed
+    /// by x_single() after set_vertex_coordinates() or non-const
+    /// access to the coordinates through x().
+    void init_single_precision(bool enable=true);
+
+    /// Return true if the geometry has a single precision copy of
+    /// the coordinates
+    bool has_single_precision() const
+    { return _single_precision; }
+
+    /// Return single precision copy of all coordinates (see
+    /// init_single_precision)
+    const std::vector<float>& x_single() const;
+
+    /// Update single precision copy of the coordinates. This is only
+    /// needed if the coordinates are modified through a reference
+    /// obtained from x() before the last call to x_single().
+    void update_single_precision() const;
+
+    /// Return counter which is incremented whenever the coordinates
+    /// may change: by set(), set_vertex_coordinates(), init_entities(),
+    /// non-const access through x() or mark_coordinates_changed().
+    /// Used to detect that data computed from the coordinates, like
+    /// the bounding box tree of the mesh, is out of date. Changes
+    /// through a reference obtained from x() are only detected at the
+    /// next call to x().
+    std::size_t coordinates_version() const
+    { return _coordinates_version; }
+
+    /// Mark the coordinates as changed after they have been modified
+    /// through a reference obtained earlier (e.g. the coordinates
+    /// array in Python), so that the single precision copy and the
+    /// bounding box tree of the mesh are updated when next used
+    void mark_coordinates_changed()
+    { _x_single_stale = true; ++_coordinates_version; }
+
     /// Hash of coordinate values
     ///
     /// *Returns*
@@ -171,6 +217,9 @@ namespace dolfin
     ///
     std::size_t hash() const;
 
+    /// Return number of bytes allocated for the geometry
+    std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -188,6 +237,15 @@ namespace dolfin
     // Coordinates for all points stored as a contiguous array
     std::vector<double> coordinates;
 
+    // Single precision copy of coordinates (if enabled), and flag
+    // for pending update of the copy
+    bool _single_precision;
+    mutable std::vector<float> _x_single;
+    mutable bool _x_single_stale;
+
+    // Counter for changes of coordinates
+    std::size_t _coordinates_version;
+
   };
 
 }
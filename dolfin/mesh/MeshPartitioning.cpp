@@ -49,6 +49,7 @@
 #include "MeshEntity.h"
 #include "MeshEntityIterator.h"
 #include "MeshFunction.h"
+#include "MeshRenumbering.h"
 #include "MeshTopology.h"
 #include "MeshValueCollection.h"
 #include "Vertex.h"
@@ -326,6 +327,22 @@ void MeshPartitioning::build(Mesh& mesh, const LocalMeshData& mesh_data,
                       vertex_coordinates, vertex_global_to_local,
                       shared_vertices);
 
+  // Re-order owned cells and vertices along a space-filling curve
+  const std::string curve = parameters["space_filling_curve"];
+  if (parameters["reorder_cells_sfc"])
+  {
+    reorder_cells_sfc(curve, num_regular_cells, vertex_coordinates,
+                      vertex_global_to_local, shared_cells,
+                      new_cell_vertices, new_global_cell_indices,
+                      new_cell_partition);
+  }
+  if (parameters["reorder_vertices_sfc"])
+  {
+    reorder_vertices_sfc(curve, num_regular_vertices, shared_vertices,
+                         vertex_indices, vertex_coordinates,
+                         vertex_global_to_local);
+  }
+
   timer.stop();
 
   // Build lcoal mesh from new_mesh_data
@@ -498,6 +515,119 @@ MeshPartitioning::reorder_vertices_gps(MPI_Comm mpi_comm,
     reordered_vertex_indices[i] = vertex_indices[i];
 }
 //-----------------------------------------------------------------------------
+void MeshPartitioning::reorder_cells_sfc(
+  const std::string curve,
+  const std::int32_t num_regular_cells,
+  const boost::multi_array<double, 2>& vertex_coordinates,
+  const std::map<std::int64_t, std::int32_t>& vertex_global_to_local,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+  boost::multi_array<std::int64_t, 2>& cell_vertices,
+  std::vector<std::int64_t>& global_cell_indices,
+  std::vector<int>& cell_partition)
+{
+  log(PROGRESS, "Re-order cells along space-filling curve");
+  Timer timer("Reorder cells along space-filling curve");
+
+  // Compute midpoints of regular cells (ghost cells are not
+  // re-ordered)
+  const std::size_t gdim = vertex_coordinates.shape()[1];
+  const std::size_t num_cell_vertices = cell_vertices.shape()[1];
+  std::vector<double> midpoints(num_regular_cells*gdim, 0.0);
+  for (std::int32_t i = 0; i < num_regular_cells; ++i)
+  {
+    for (std::size_t j = 0; j < num_cell_vertices; ++j)
+    {
+      auto v = vertex_global_to_local.find(cell_vertices[i][j]);
+      dolfin_assert(v != vertex_global_to_local.end());
+      for (std::size_t k = 0; k < gdim; ++k)
+        midpoints[i*gdim + k] += vertex_coordinates[v->second][k];
+    }
+    for (std::size_t k = 0; k < gdim; ++k)
+      midpoints[i*gdim + k] /= num_cell_vertices;
+  }
+
+  // Old index of each re-ordered cell
+  const std::vector<std::size_t> order
+    = MeshRenumbering::compute_space_filling_curve_order(midpoints, gdim,
+                                                         curve);
+
+  // Permute regular cells
+  const boost::multi_array<std::int64_t, 2> old_cell_vertices = cell_vertices;
+  const std::vector<std::int64_t> old_global_cell_indices
+    = global_cell_indices;
+  const std::vector<int> old_cell_partition = cell_partition;
+  std::vector<std::int32_t> remap(num_regular_cells);
+  for (std::int32_t i = 0; i < num_regular_cells; ++i)
+  {
+    const std::size_t j = order[i];
+    cell_vertices[i] = old_cell_vertices[j];
+    global_cell_indices[i] = old_global_cell_indices[j];
+    cell_partition[i] = old_cell_partition[j];
+    remap[j] = i;
+  }
+
+  // Remap shared regular cells
+  std::map<std::int32_t, std::set<unsigned int>> reordered_shared_cells;
+  for (const auto& c : shared_cells)
+  {
+    if (c.first < num_regular_cells)
+      reordered_shared_cells.insert({remap[c.first], c.second});
+    else
+      reordered_shared_cells.insert(c);
+  }
+  std::swap(shared_cells, reordered_shared_cells);
+}
+//-----------------------------------------------------------------------------
+void MeshPartitioning::reorder_vertices_sfc(
+  const std::string curve,
+  const std::int32_t num_regular_vertices,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_vertices,
+  std::vector<std::int64_t>& vertex_indices,
+  boost::multi_array<double, 2>& vertex_coordinates,
+  std::map<std::int64_t, std::int32_t>& vertex_global_to_local)
+{
+  log(PROGRESS, "Re-order vertices along space-filling curve");
+  Timer timer("Reorder vertices along space-filling curve");
+
+  // Old index of each re-ordered regular vertex (ghost vertices are
+  // not re-ordered)
+  const std::size_t gdim = vertex_coordinates.shape()[1];
+  std::vector<double> x(num_regular_vertices*gdim);
+  for (std::int32_t i = 0; i < num_regular_vertices; ++i)
+    for (std::size_t k = 0; k < gdim; ++k)
+      x[i*gdim + k] = vertex_coordinates[i][k];
+  const std::vector<std::size_t> order
+    = MeshRenumbering::compute_space_filling_curve_order(x, gdim, curve);
+
+  // Permute regular vertices
+  const std::vector<std::int64_t> old_vertex_indices = vertex_indices;
+  std::vector<std::int32_t> remap(num_regular_vertices);
+  for (std::int32_t i = 0; i < num_regular_vertices; ++i)
+  {
+    const std::size_t j = order[i];
+    vertex_indices[i] = old_vertex_indices[j];
+    for (std::size_t k = 0; k < gdim; ++k)
+      vertex_coordinates[i][k] = x[j*gdim + k];
+    remap[j] = i;
+  }
+
+  // Remap global-to-local map and shared vertices
+  for (auto& v : vertex_global_to_local)
+  {
+    if (v.second < num_regular_vertices)
+      v.second = remap[v.second];
+  }
+  std::map<std::int32_t, std::set<unsigned int>> reordered_shared_vertices;
+  for (const auto& v : shared_vertices)
+  {
+    if (v.first < num_regular_vertices)
+      reordered_shared_vertices.insert({remap[v.first], v.second});
+    else
+      reordered_shared_vertices.insert(v);
+  }
+  std::swap(shared_vertices, reordered_shared_vertices);
+}
+//-----------------------------------------------------------------------------
 void MeshPartitioning::distribute_cell_layer(MPI_Comm mpi_comm,
   const int num_regular_cells,
   const std::int64_t num_global_vertices,
@@ -1090,25 +1220,21 @@ void MeshPartitioning::build_local_mesh(Mesh& mesh,
   editor.open(mesh, cell_type, tdim, gdim);
 
   // Add vertices
-  editor.init_vertices_global(vertex_coordinates.size(), num_global_vertices);
-  Point point(gdim);
   dolfin_assert(vertex_indices.size() == vertex_coordinates.size());
-  for (std::size_t i = 0; i < vertex_coordinates.size(); ++i)
-  {
-    for (std::int8_t j = 0; j < gdim; ++j)
-      point[j] = vertex_coordinates[i][j];
-    editor.add_vertex_global(i, vertex_indices[i], point);
-  }
+  std::vector<double> x(vertex_coordinates.data(),
+                        vertex_coordinates.data()
+                        + vertex_coordinates.num_elements());
+  editor.set_vertices_global(std::move(x),
+                             std::vector<std::int64_t>(vertex_indices),
+                             num_global_vertices, false);
 
   // Create CellType
   std::unique_ptr<CellType> _cell_type(CellType::create(cell_type));
   dolfin_assert(_cell_type);
 
   // Add cells
-  editor.init_cells_global(cell_global_vertices.size(), num_global_cells);
-
   const std::int8_t num_cell_vertices = _cell_type->num_vertices();
-  std::vector<std::size_t> cell(num_cell_vertices);
+  std::vector<unsigned int> cells(num_cell_vertices*cell_global_vertices.size());
   for (std::size_t i = 0; i < cell_global_vertices.size(); ++i)
   {
     for (std::int8_t j = 0; j < num_cell_vertices; ++j)
@@ -1116,11 +1242,12 @@ void MeshPartitioning::build_local_mesh(Mesh& mesh,
       // Get local cell vertex
       auto iter = vertex_global_to_local.find(cell_global_vertices[i][j]);
       dolfin_assert(iter != vertex_global_to_local.end());
-      cell[j] = iter->second;
+      cells[i*num_cell_vertices + j] = iter->second;
     }
-
-    editor.add_cell(i, global_cell_indices[i], cell);
   }
+  editor.set_cells_global(std::move(cells),
+                          std::vector<std::int64_t>(global_cell_indices),
+                          num_global_cells, false);
 
   // Close mesh: Note that this must be done after creating the global
   // vertex map or otherwise the ordering in mesh.close() will be
@@ -146,6 +146,30 @@ namespace dolfin
      std::vector<std::int64_t>& reordered_vertex_indices,
      std::map<std::int64_t, std::int32_t>& reordered_vertex_global_to_local);
 
+    // Reorder regular cells along a space-filling curve through their
+    // midpoints. cell_vertices, global_cell_indices, cell_partition
+    // and shared_cells are modified.
+    static
+    void reorder_cells_sfc(const std::string curve,
+     const std::int32_t num_regular_cells,
+     const boost::multi_array<double, 2>& vertex_coordinates,
+     const std::map<std::int64_t, std::int32_t>& vertex_global_to_local,
+     std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+     boost::multi_array<std::int64_t, 2>& cell_vertices,
+     std::vector<std::int64_t>& global_cell_indices,
+     std::vector<int>& cell_partition);
+
+    // Reorder regular vertices along a space-filling curve.
+    // vertex_indices, vertex_coordinates, vertex_global_to_local and
+    // shared_vertices are modified.
+    static
+    void reorder_vertices_sfc(const std::string curve,
+     const std::int32_t num_regular_vertices,
+     std::map<std::int32_t, std::set<unsigned int>>& shared_vertices,
+     std::vector<std::int64_t>& vertex_indices,
+     boost::multi_array<double, 2>& vertex_coordinates,
+     std::map<std::int64_t, std::int32_t>& vertex_global_to_local);
+
     // FIXME: Update, making clear exactly what is computed
     // This function takes the partition computed by the partitioner
     // (which tells us to which process each of the local cells stored in
@@ -18,13 +18,17 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2010-11-27
-// Last changed: 2014-02-06
+// Last changed: 2019-06-16
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include <dolfin/log/log.h>
 #include <dolfin/common/Timer.h>
+#include <dolfin/common/MPI.h>
 #include <dolfin/common/utils.h>
 #include "Cell.h"
 #include "Mesh.h"
@@ -35,6 +39,60 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Map integer coordinates to the transposed Hilbert index (J.
+  // Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707,
+  // 2004). X holds n coordinates of b bits each.
+  void hilbert_axes_to_transpose(std::uint32_t* X, unsigned int b,
+                                 unsigned int n)
+  {
+    const std::uint32_t M = std::uint32_t(1) << (b - 1);
+
+    // Inverse undo
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      const std::uint32_t P = Q - 1;
+      for (unsigned int i = 0; i < n; ++i)
+      {
+        if (X[i] & Q)
+          X[0] ^= P;
+        else
+        {
+          const std::uint32_t t = (X[0] ^ X[i]) & P;
+          X[0] ^= t;
+          X[i] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for (unsigned int i = 1; i < n; ++i)
+      X[i] ^= X[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      if (X[n - 1] & Q)
+        t ^= Q - 1;
+    }
+    for (unsigned int i = 0; i < n; ++i)
+      X[i] ^= t;
+  }
+  //---------------------------------------------------------------------------
+  // Interleave the bits of n coordinates of b bits each, most
+  // significant bits first
+  std::uint64_t interleave_bits(const std::uint32_t* X, unsigned int b,
+                                unsigned int n)
+  {
+    std::uint64_t key = 0;
+    for (int bit = b - 1; bit >= 0; --bit)
+      for (unsigned int i = 0; i < n; ++i)
+        key = (key << 1) | ((X[i] >> bit) & 1);
+    return key;
+  }
+  //---------------------------------------------------------------------------
+}
+
 //-----------------------------------------------------------------------------
 dolfin::Mesh MeshRenumbering::renumber_by_color(const Mesh& mesh,
                                  const std::vector<std::size_t> coloring_type)
@@ -266,3 +324,224 @@ void MeshRenumbering::compute_renumbering(const Mesh& mesh,
   }
 }
 //-----------------------------------------------------------------------------
+dolfin::Mesh
+MeshRenumbering::renumber_by_space_filling_curve(const Mesh& mesh,
+                                                 std::string curve)
+{
+  Timer timer("Renumber mesh by space-filling curve");
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_regular_cells = mesh.topology().ghost_offset(tdim);
+  const std::size_t num_regular_vertices = mesh.topology().ghost_offset(0);
+
+  // Compute cell midpoints of owned cells
+  const std::vector<double>& x = mesh.geometry().x();
+  const MeshConnectivity& cell_vertices = mesh.topology()(tdim, 0);
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(tdim);
+  std::vector<double> midpoints(num_regular_cells*gdim, 0.0);
+  for (std::size_t c = 0; c < num_regular_cells; ++c)
+  {
+    const unsigned int* v = cell_vertices(c);
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+      for (std::size_t j = 0; j < gdim; ++j)
+        midpoints[c*gdim + j] += x[v[i]*gdim + j];
+    for (std::size_t j = 0; j < gdim; ++j)
+      midpoints[c*gdim + j] /= num_cell_vertices;
+  }
+
+  // Order owned cells and vertices along curve, keeping ghosts last
+  std::vector<std::size_t> cell_order
+    = compute_space_filling_curve_order(midpoints, gdim, curve);
+  for (std::size_t c = num_regular_cells; c < num_cells; ++c)
+    cell_order.push_back(c);
+
+  const std::vector<double> owned_x(x.begin(),
+                                    x.begin() + num_regular_vertices*gdim);
+  std::vector<std::size_t> vertex_order
+    = compute_space_filling_curve_order(owned_x, gdim, curve);
+  for (std::size_t v = num_regular_vertices; v < num_vertices; ++v)
+    vertex_order.push_back(v);
+
+  return renumber(mesh, cell_order, vertex_order);
+}
+//-----------------------------------------------------------------------------
+dolfin::Mesh MeshRenumbering::renumber(const Mesh& mesh,
+                                       const std::vector<std::size_t>& cell_order,
+                                       const std::vector<std::size_t>& vertex_order)
+{
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_regular_cells = mesh.topology().ghost_offset(tdim);
+  const std::size_t num_regular_vertices = mesh.topology().ghost_offset(0);
+
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "renumber mesh",
+                 "Only meshes with affine geometry can be renumbered");
+  }
+
+  if (cell_order.size() != num_cells or vertex_order.size() != num_vertices)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "renumber mesh",
+                 "Size of ordering does not match number of cells or vertices");
+  }
+
+  // Compute inverse of vertex ordering, checking that the orderings
+  // are permutations which do not move ghosts
+  std::vector<std::size_t> new_vertex_index(num_vertices, num_vertices);
+  for (std::size_t i = 0; i < num_vertices; ++i)
+  {
+    const std::size_t v = vertex_order[i];
+    if (v >= num_vertices or new_vertex_index[v] != num_vertices
+        or (i < num_regular_vertices) != (v < num_regular_vertices))
+    {
+      dolfin_error("MeshRenumbering.cpp",
+                   "renumber mesh",
+                   "Vertex ordering is not a permutation of owned vertices");
+    }
+    new_vertex_index[v] = i;
+  }
+  std::vector<std::size_t> new_cell_index(num_cells, num_cells);
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    const std::size_t c = cell_order[i];
+    if (c >= num_cells or new_cell_index[c] != num_cells
+        or (i < num_regular_cells) != (c < num_regular_cells))
+    {
+      dolfin_error("MeshRenumbering.cpp",
+                   "renumber mesh",
+                   "Cell ordering is not a permutation of owned cells");
+    }
+    new_cell_index[c] = i;
+  }
+
+  // Global indices are kept for distributed meshes
+  const bool distributed = MPI::size(mesh.mpi_comm()) > 1;
+  const MeshTopology& topology = mesh.topology();
+
+  // Create new mesh
+  Mesh new_mesh(mesh.mpi_comm());
+  MeshEditor editor;
+  editor.open(new_mesh, mesh.type().cell_type(), tdim, gdim);
+
+  // Add vertices
+  editor.init_vertices_global(num_vertices, mesh.num_entities_global(0));
+  const std::vector<double>& x = mesh.geometry().x();
+  std::vector<double> point(gdim);
+  for (std::size_t i = 0; i < num_vertices; ++i)
+  {
+    const std::size_t v = vertex_order[i];
+    std::copy(x.begin() + v*gdim, x.begin() + (v + 1)*gdim, point.begin());
+    if (distributed)
+      editor.add_vertex_global(i, topology.global_indices(0)[v], point);
+    else
+      editor.add_vertex(i, point);
+  }
+
+  // Add cells
+  editor.init_cells_global(num_cells, mesh.num_entities_global(tdim));
+  const MeshConnectivity& cell_vertices = topology(tdim, 0);
+  std::vector<std::size_t> cell(mesh.type().num_vertices(tdim));
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    const std::size_t c = cell_order[i];
+    const unsigned int* v = cell_vertices(c);
+    for (std::size_t j = 0; j < cell.size(); ++j)
+      cell[j] = new_vertex_index[v[j]];
+    if (distributed)
+      editor.add_cell(i, topology.global_indices(tdim)[c], cell);
+    else
+      editor.add_cell(i, cell);
+  }
+  editor.close(mesh.ordered());
+
+  // Copy ghost data, remapping shared owned entities
+  MeshTopology& new_topology = new_mesh.topology();
+  new_topology.init_ghost(tdim, num_regular_cells);
+  new_topology.init_ghost(0, num_regular_vertices);
+  new_topology.cell_owner() = topology.cell_owner();
+  if (topology.have_shared_entities(tdim))
+  {
+    for (const auto& e : topology.shared_entities(tdim))
+      new_topology.shared_entities(tdim)[new_cell_index[e.first]] = e.second;
+  }
+  if (topology.have_shared_entities(0))
+  {
+    for (const auto& e : topology.shared_entities(0))
+      new_topology.shared_entities(0)[new_vertex_index[e.first]] = e.second;
+  }
+  new_mesh._ghost_mode = mesh.ghost_mode();
+
+  return new_mesh;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t>
+MeshRenumbering::compute_space_filling_curve_order(const std::vector<double>& x,
+                                                   std::size_t gdim,
+                                                   std::string curve)
+{
+  if (gdim < 1 or gdim > 3)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "compute space-filling curve order",
+                 "Geometric dimension %d is not supported", (int) gdim);
+  }
+  if (curve != "hilbert" and curve != "morton")
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "compute space-filling curve order",
+                 "Unknown space-filling curve \"%s\"", curve.c_str());
+  }
+
+  dolfin_assert(x.size() % gdim == 0);
+  const std::size_t num_points = x.size()/gdim;
+
+  // Compute bounding box of points
+  std::vector<double> xmin(gdim, std::numeric_limits<double>::max());
+  std::vector<double> xmax(gdim, std::numeric_limits<double>::lowest());
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      xmin[j] = std::min(xmin[j], x[i*gdim + j]);
+      xmax[j] = std::max(xmax[j], x[i*gdim + j]);
+    }
+  }
+
+  // Number of bits per coordinate such that the key fits in 64 bits
+  const unsigned int bits = (gdim == 3) ? 21 : 32;
+  const double scale = (double) ((std::uint64_t(1) << bits) - 1);
+
+  // Compute curve index of each point
+  std::vector<std::pair<std::uint64_t, std::size_t>> keys(num_points);
+  std::uint32_t X[3];
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double h = xmax[j] - xmin[j];
+      X[j] = (h > 0.0) ? (std::uint32_t) (scale*(x[i*gdim + j] - xmin[j])/h) : 0;
+    }
+
+    // The Hilbert curve in one dimension is the identity
+    if (curve == "hilbert" and gdim > 1)
+      hilbert_axes_to_transpose(X, bits, gdim);
+    keys[i] = {interleave_bits(X, bits, gdim), i};
+  }
+
+  // Sort points by key (ties by index)
+  std::sort(keys.begin(), keys.end());
+  std::vector<std::size_t> order(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = keys[i].second;
+
+  return order;
+}
+//-----------------------------------------------------------------------------
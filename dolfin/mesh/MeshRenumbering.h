@@ -18,11 +18,13 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2010-11-27
-// Last changed: 2011-01-16
+// Last changed: 2019-06-16
 
 #ifndef __MESH_RENUMBERING_H
 #define __MESH_RENUMBERING_H
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 namespace dolfin
@@ -51,6 +53,56 @@ namespace dolfin
     static Mesh renumber_by_color(const Mesh& mesh,
                                   std::vector<std::size_t> coloring);
 
+    /// Renumber cells and vertices along a space-filling curve
+    /// through the cell midpoints and vertex coordinates, which
+    /// improves the memory locality of assembly and of operations on
+    /// vertex-based data. In parallel, only the cells and vertices
+    /// owned by a process are renumbered. Ghost entities keep their
+    /// positions at the end of the local range, and global indices
+    /// and sharing information are preserved. Only cell-vertex
+    /// connectivity and vertex coordinates are copied to the new
+    /// mesh.
+    ///
+    /// @param  mesh (Mesh)
+    ///         Mesh to be renumbered (affine geometry).
+    /// @param  curve (std::string)
+    ///         Space-filling curve, "hilbert" or "morton".
+    /// @return Mesh
+    static Mesh renumber_by_space_filling_curve(const Mesh& mesh,
+                                                std::string curve="hilbert");
+
+    /// Renumber cells and vertices of a mesh by given orderings,
+    /// where cell_order[i] (vertex_order[i]) is the old index of the
+    /// cell (vertex) with new index i. Ghost entities must not be
+    /// moved. Global indices and sharing information are preserved.
+    ///
+    /// @param  mesh (Mesh)
+    ///         Mesh to be renumbered (affine geometry).
+    /// @param  cell_order (std::vector<std::size_t>)
+    ///         Old cell index for each new cell index.
+    /// @param  vertex_order (std::vector<std::size_t>)
+    ///         Old vertex index for each new vertex index.
+    /// @return Mesh
+    static Mesh renumber(const Mesh& mesh,
+                         const std::vector<std::size_t>& cell_order,
+                         const std::vector<std::size_t>& vertex_order);
+
+    /// Compute the order of points along a space-filling curve
+    /// through their bounding box. Returns the indices of the points
+    /// sorted by their position on the curve.
+    ///
+    /// @param  x (std::vector<double>)
+    ///         Point coordinates (row-major, gdim values per point).
+    /// @param  gdim (std::size_t)
+    ///         Geometric dimension (1, 2 or 3).
+    /// @param  curve (std::string)
+    ///         Space-filling curve, "hilbert" or "morton".
+    /// @return std::vector<std::size_t>
+    static std::vector<std::size_t>
+      compute_space_filling_curve_order(const std::vector<double>& x,
+                                        std::size_t gdim,
+                                        std::string curve="hilbert");
+
   private:
 
     static void compute_renumbering(const Mesh& mesh,
@@ -202,6 +202,50 @@ const std::map<std::int32_t, std::set<unsigned int>>&
   return e->second;
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshTopology::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + dolfin::memory_usage(num_entities)
+    + dolfin::memory_usage(ghost_offset_index)
+    + dolfin::memory_usage(global_num_entities) + parallel_memory_usage();
+  for (const auto& c : connectivity)
+  {
+    bytes += dolfin::memory_usage(c) - c.size()*sizeof(MeshConnectivity);
+    for (const auto& cd : c)
+      bytes += cd.memory_usage();
+  }
+  return bytes;
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshTopology::parallel_memory_usage() const
+{
+  std::size_t bytes = dolfin::memory_usage(_global_indices)
+    + dolfin::memory_usage(_cell_owner);
+  for (const auto& g : _global_indices)
+    bytes += dolfin::memory_usage(g);
+
+  // Shared entities
+  typedef std::map<std::int32_t, std::set<unsigned int>> SharedMap;
+  bytes += node_memory_usage<std::pair<unsigned int, SharedMap>>(_shared_entities.size());
+  for (const auto& e : _shared_entities)
+  {
+    bytes += node_memory_usage<SharedMap::value_type>(e.second.size());
+    for (const auto& p : e.second)
+      bytes += node_memory_usage<unsigned int>(p.second.size());
+  }
+
+  // Colorings
+  bytes += node_memory_usage<decltype(coloring)::value_type>(coloring.size());
+  for (const auto& c : coloring)
+  {
+    bytes += dolfin::memory_usage(c.first) + dolfin::memory_usage(c.second.first)
+      + dolfin::memory_usage(c.second.second);
+    for (const auto& e : c.second.second)
+      bytes += dolfin::memory_usage(e);
+  }
+
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 size_t MeshTopology::hash() const
 {
   return (*this)(dim(), 0).hash();
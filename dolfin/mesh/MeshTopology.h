@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2006-05-08
-// Last changed: 2014-07-02
+// Last changed: 2019-06-18
 
 #ifndef __MESH_TOPOLOGY_H
 #define __MESH_TOPOLOGY_H
@@ -89,6 +89,15 @@ namespace dolfin
     /// dimension dim
     void init_global_indices(std::size_t dim, std::size_t size);
 
+    /// Set global entity numbering for entities of dimension dim,
+    /// taking ownership of the array
+    void set_global_indices(std::size_t dim,
+                            std::vector<std::int64_t>&& global_indices)
+    {
+      dolfin_assert(dim < _global_indices.size());
+      _global_indices[dim] = std::move(global_indices);
+    }
+
     /// Initialise the offset index of ghost entities for this dimension
     void init_ghost(std::size_t dim, std::size_t index);
 
@@ -155,6 +164,13 @@ namespace dolfin
     /// Return hash based on the hash of cell-vertex connectivity
     size_t hash() const;
 
+    /// Return number of bytes allocated for the topology
+    std::size_t memory_usage() const;
+
+    /// Return number of bytes allocated for global indices, shared
+    /// entities, ghost ownership and colorings
+    std::size_t parallel_memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
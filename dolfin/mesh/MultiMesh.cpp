@@ -19,18 +19,20 @@
 // Modified by Benjamin Kehlet 2016
 //
 // First added:  2013-08-05
-// Last changed: 2018-04-03
+// Last changed: 2019-06-18
 
 #include <cmath>
 #include <algorithm>
 #include <dolfin/log/log.h>
 #include <dolfin/common/NoDeleter.h>
+#include <dolfin/common/Threads.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/SimplexQuadrature.h>
 #include <dolfin/geometry/IntersectionConstruction.h>
 #include <dolfin/geometry/ConvexTriangulation.h>
 #include <dolfin/geometry/GeometryPredicates.h>
 #include <dolfin/geometry/MeshPointIntersection.h>
+#include <dolfin/parameter/GlobalParameters.h>
 
 #include "Cell.h"
 #include "Facet.h"
@@ -41,6 +43,31 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Group the collisions (cells_0[k], cells_1[k]) by the cell in
+  // cells_0, keeping their order for each cell. On return, the cells
+  // colliding with cell c are cells[offsets[c]:offsets[c + 1]].
+  void group_collisions(const std::vector<unsigned int>& cells_0,
+                        const std::vector<unsigned int>& cells_1,
+                        std::size_t num_cells,
+                        std::vector<std::size_t>& offsets,
+                        std::vector<unsigned int>& cells)
+  {
+    dolfin_assert(cells_0.size() == cells_1.size());
+    offsets.assign(num_cells + 1, 0);
+    for (auto c : cells_0)
+      offsets[c + 1]++;
+    for (std::size_t c = 0; c < num_cells; ++c)
+      offsets[c + 1] += offsets[c];
+
+    std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+    cells.resize(cells_1.size());
+    for (std::size_t k = 0; k < cells_0.size(); ++k)
+      cells[position[cells_0[k]]++] = cells_1[k];
+  }
+}
+
 //-----------------------------------------------------------------------------
 MultiMesh::MultiMesh() : _is_built(false)
 {
@@ -266,19 +293,36 @@ void MultiMesh::build(std::size_t quadrature_order)
   // Build collision maps, i.e. classify cut, uncut and covered cells
   _build_collision_maps();
 
+  // Clear quadrature rules
+  _quadrature_order = quadrature_order;
+  _quadrature_rules_overlap.clear();
+  _quadrature_rules_overlap.resize(num_parts());
+  _quadrature_rules_cut_cells.clear();
+  _quadrature_rules_cut_cells.resize(num_parts());
+  _quadrature_rules_interface.clear();
+  _quadrature_rules_interface.resize(num_parts());
+  _facet_normals.clear();
+  _facet_normals.resize(num_parts());
+
+  // Build quadrature rules for all cut cells
+  std::vector<std::vector<unsigned int>> cells(num_parts());
+  for (std::size_t i = 0; i < num_parts(); i++)
+    for (const auto& c : _collision_maps_cut_cells[i])
+      cells[i].push_back(c.first);
+
   // For collisions with meshes of same type we get three types of
   // quadrature rules: the cut cell qr, qr of the overlap part and qr
   // of the interface.
 
   // Build quadrature rules of the cut cells' overlap. Do this before
   // we build the quadrature rules of the cut cells
-  _build_quadrature_rules_overlap(quadrature_order);
+  _build_quadrature_rules_overlap(quadrature_order, cells);
 
   // Build quadrature rules of the cut cells
-  _build_quadrature_rules_cut_cells(quadrature_order);
+  _build_quadrature_rules_cut_cells(quadrature_order, cells);
 
   // Build quadrature rules and normals of the interface
-  _build_quadrature_rules_interface(quadrature_order);
+  _build_quadrature_rules_interface(quadrature_order, cells);
 
   // Make sure that cut cells are actually cut
   // TODO: Check if this needed
@@ -291,6 +335,97 @@ void MultiMesh::build(std::size_t quadrature_order)
   end();
 }
 //-----------------------------------------------------------------------------
+void MultiMesh::update(std::size_t part)
+{
+  if (!_is_built)
+  {
+    dolfin_error("MultiMesh.cpp",
+                 "update multimesh",
+                 "Multimesh has not been built. Call MultiMesh.build() before updating");
+  }
+  if (part >= num_parts())
+  {
+    dolfin_error("MultiMesh.cpp",
+                 "update multimesh",
+                 "Illegal part number %d (multimesh has %d parts)",
+                 part, num_parts());
+  }
+
+  begin(PROGRESS, "Updating multimesh for moved part %d.", part);
+
+  // Update boundary mesh and bounding box trees of the moved part.
+  // The trees are rebuilt if their boxes overlap twice as much as
+  // when built.
+  _boundary_meshes[part]->update_coordinates(*_meshes[part]);
+  _trees[part]->refit(2.0);
+  if (_boundary_meshes[part]->num_vertices() > 0)
+    _boundary_trees[part]->refit(2.0);
+
+  // Recompute collisions of the moved part with all other parts
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  for (std::size_t i = 0; i < part; i++)
+    _compute_part_collisions(i, part, num_threads);
+  for (std::size_t j = part + 1; j < num_parts(); j++)
+    _compute_part_collisions(part, j, num_threads);
+
+  // Classify the cells of the moved part and the parts below it
+  // again, keeping the old collision maps and quadrature rules
+  std::vector<std::map<unsigned int,
+                       std::vector<std::pair<std::size_t, unsigned int>>>>
+    old_collision_maps(part + 1);
+  std::vector<std::map<unsigned int, std::vector<quadrature_rule>>>
+    old_overlap(part + 1), old_interface(part + 1);
+  std::vector<std::map<unsigned int, quadrature_rule>> old_cut_cells(part + 1);
+  std::vector<std::map<unsigned int, std::vector<std::vector<double>>>>
+    old_normals(part + 1);
+  for (std::size_t i = 0; i <= part; i++)
+  {
+    std::swap(old_collision_maps[i], _collision_maps_cut_cells[i]);
+    std::swap(old_overlap[i], _quadrature_rules_overlap[i]);
+    std::swap(old_cut_cells[i], _quadrature_rules_cut_cells[i]);
+    std::swap(old_interface[i], _quadrature_rules_interface[i]);
+    std::swap(old_normals[i], _facet_normals[i]);
+    _classify_cells(i);
+  }
+
+  // Reuse the quadrature rules of cut cells below the moved part
+  // which have the same cutting cells as before, none of which are
+  // in the moved part
+  std::vector<std::vector<unsigned int>> cells(num_parts());
+  std::size_t num_reused = 0;
+  for (std::size_t i = 0; i <= part; i++)
+  {
+    for (const auto& c : _collision_maps_cut_cells[i])
+    {
+      const auto it = old_collision_maps[i].find(c.first);
+      const bool reuse = i < part
+        and it != old_collision_maps[i].end()
+        and it->second == c.second
+        and std::none_of(c.second.begin(), c.second.end(),
+                         [part](const std::pair<std::size_t, unsigned int>& cutting)
+                         { return cutting.first == part; });
+      if (reuse)
+      {
+        _quadrature_rules_overlap[i][c.first] = std::move(old_overlap[i][c.first]);
+        _quadrature_rules_cut_cells[i][c.first] = std::move(old_cut_cells[i][c.first]);
+        _quadrature_rules_interface[i][c.first] = std::move(old_interface[i][c.first]);
+        _facet_normals[i][c.first] = std::move(old_normals[i][c.first]);
+        num_reused++;
+      }
+      else
+        cells[i].push_back(c.first);
+    }
+  }
+  log(PROGRESS, "Reusing quadrature rules of %d cut cells.", num_reused);
+
+  // Build quadrature rules of the remaining cut cells
+  _build_quadrature_rules_overlap(_quadrature_order, cells);
+  _build_quadrature_rules_cut_cells(_quadrature_order, cells);
+  _build_quadrature_rules_interface(_quadrature_order, cells);
+
+  end();
+}
+//-----------------------------------------------------------------------------
 void MultiMesh::clear()
 {
   _boundary_meshes.clear();
@@ -299,6 +434,7 @@ void MultiMesh::clear()
   _uncut_cells.clear();
   _covered_cells.clear();
   _collision_maps_cut_cells.clear();
+  _part_collisions.clear();
   _quadrature_rules_cut_cells.clear();
   _quadrature_rules_overlap.clear();
   _quadrature_rules_interface.clear();
@@ -581,171 +717,217 @@ void MultiMesh::_build_collision_maps()
 {
   begin(PROGRESS, "Building collision maps.");
 
-  // Clear collision maps
+  // Compute collisions for all pairs of parts
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  _part_collisions.clear();
+  _part_collisions.resize(num_parts(),
+                          std::vector<PartCollisions>(num_parts()));
+  for (std::size_t i = 0; i < num_parts(); i++)
+    for (std::size_t j = i + 1; j < num_parts(); j++)
+      _compute_part_collisions(i, j, num_threads);
+
+  // Classify cells of all parts
   _uncut_cells.clear();
+  _uncut_cells.resize(num_parts());
   _covered_cells.clear();
+  _covered_cells.resize(num_parts());
   _collision_maps_cut_cells.clear();
-
-  // Iterate over all parts
+  _collision_maps_cut_cells.resize(num_parts());
   for (std::size_t i = 0; i < num_parts(); i++)
-  {
-    // Extract uncut, cut and covered cells:
-    //
-    // 0: uncut   = cell not colliding with any higher domain
-    // 1: cut     = cell colliding with some higher boundary and is not covered
-    // 2: covered = cell colliding with some higher domain but not its boundary
-
-    // Create vector of markers for cells in part `i` (0, 1, or 2)
-    std::vector<char> markers(_meshes[i]->num_cells(), 0);
-
-    // Create local arrays for marking domain and boundary collisions
-    // for cells in part `i`. Note that in contrast to the markers
-    // above which are global to part `i`, these markers are local to
-    // the collision between part `i` and part `j`.
-    std::vector<bool> collides_with_boundary(_meshes[i]->num_cells());
-    std::vector<bool> collides_with_domain(_meshes[i]->num_cells());
-
-    // Create empty collision map for cut cells in part `i`
-    std::map<unsigned int, std::vector<std::pair<std::size_t, unsigned int>>>
-      collision_map_cut_cells;
-
-    // Iterate over covering parts (with higher part number)
-    for (std::size_t j = i + 1; j < num_parts(); j++)
-    {
-      log(PROGRESS, "Computing collisions for mesh %d overlapped by mesh %d.", i, j);
+    _classify_cells(i);
 
-      // Compute domain-boundary collisions
-      const auto& boundary_collisions = _trees[i]->compute_collisions(*_boundary_trees[j]);
-
-      // Reset boundary collision markers
-      std::fill(collides_with_boundary.begin(), collides_with_boundary.end(), false);
+  end();
+}
+//-----------------------------------------------------------------------------
+void MultiMesh::_compute_part_collisions(std::size_t i, std::size_t j,
+                                         std::size_t num_threads)
+{
+  log(PROGRESS, "Computing collisions for mesh %d overlapped by mesh %d.", i, j);
+  dolfin_assert(i < j);
+
+  // Compute domain-boundary and domain-domain collisions, and group
+  // them by the cell in part `i`
+  const std::size_t num_cells = _meshes[i]->num_cells();
+  std::vector<std::size_t> boundary_offsets, domain_offsets;
+  std::vector<unsigned int> boundary_cells, domain_cells;
+  {
+    const auto boundary_collisions
+      = _trees[i]->compute_collisions(*_boundary_trees[j]);
+    group_collisions(boundary_collisions.first, boundary_collisions.second,
+                     num_cells, boundary_offsets, boundary_cells);
+  }
+  {
+    const auto domain_collisions = _trees[i]->compute_collisions(*_trees[j]);
+    group_collisions(domain_collisions.first, domain_collisions.second,
+                     num_cells, domain_offsets, domain_cells);
+  }
 
-      // Iterate over boundary collisions.
-      for (std::size_t k = 0; k < boundary_collisions.first.size(); ++k)
+  // Check the collisions of each cell in part `i` (in parallel over
+  // contiguous ranges of cells):
+  //
+  // cut     = cell colliding with the boundary of part `j`, for which
+  //           all colliding cells of part `j` are stored
+  // covered = cell colliding with the domain but not the boundary of
+  //           part `j`
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, num_cells));
+  std::vector<PartCollisions> collisions(num_threads);
+  Threads::parallel_for(num_cells, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t t)
+    {
+      PartCollisions& pc = collisions[t];
+      pc.cutting_offsets.push_back(0);
+      for (std::size_t c = begin; c < end; ++c)
       {
-	// Get the colliding cell
-	const std::size_t cell_i = boundary_collisions.first[k];
-
-	// Do a careful check if not already marked as colliding
-	if (!collides_with_boundary[cell_i])
-	{
-	  const Cell cell(*_meshes[i], cell_i);
-	  const Cell boundary_cell(*_boundary_meshes[j], boundary_collisions.second[k]);
-	  collides_with_boundary[cell_i] = cell.collides(boundary_cell);
-	}
+        if (boundary_offsets[c] == boundary_offsets[c + 1]
+            and domain_offsets[c] == domain_offsets[c + 1])
+        {
+          continue;
+        }
+        const Cell cell(*_meshes[i], c);
 
-	// Mark as cut cell if not previously covered
-	if (collides_with_boundary[cell_i] and markers[cell_i] != 2)
-	{
-	  // Mark as cut cell
-	  markers[cell_i] = 1;
+        // Do a careful check of the boundary collisions
+        bool collides_with_boundary = false;
+        for (std::size_t k = boundary_offsets[c];
+             k < boundary_offsets[c + 1] and !collides_with_boundary; ++k)
+        {
+          const Cell boundary_cell(*_boundary_meshes[j], boundary_cells[k]);
+          collides_with_boundary = cell.collides(boundary_cell);
+        }
 
-	  // Add empty list of collisions into map if it does not exist
-	  if (collision_map_cut_cells.find(cell_i) == collision_map_cut_cells.end())
-	  {
-            std::vector<std::pair<std::size_t, unsigned int>> collisions;
-            collision_map_cut_cells[cell_i] = collisions;
+        if (collides_with_boundary)
+        {
+          // Store all colliding cells of a cut cell
+          for (std::size_t k = domain_offsets[c]; k < domain_offsets[c + 1]; ++k)
+          {
+            const Cell other_cell(*_meshes[j], domain_cells[k]);
+            if (cell.collides(other_cell))
+              pc.cutting_cells.push_back(domain_cells[k]);
+          }
+          pc.cut_cells.push_back(c);
+          pc.cutting_offsets.push_back(pc.cutting_cells.size());
+        }
+        else
+        {
+          // Mark as covered if colliding with any cell
+          for (std::size_t k = domain_offsets[c]; k < domain_offsets[c + 1]; ++k)
+          {
+            const Cell other_cell(*_meshes[j], domain_cells[k]);
+            if (cell.collides(other_cell))
+            {
+              pc.covered_cells.push_back(c);
+              break;
+            }
           }
         }
       }
+    });
 
-      // Compute domain-domain collisions
-      const auto& domain_collisions = _trees[i]->compute_collisions(*_trees[j]);
+  // Join the collisions of the ranges of cells
+  PartCollisions& pc = _part_collisions[i][j];
+  pc = collisions[0];
+  for (std::size_t t = 1; t < num_threads; ++t)
+  {
+    const std::size_t offset = pc.cutting_cells.size();
+    pc.cut_cells.insert(pc.cut_cells.end(), collisions[t].cut_cells.begin(),
+                        collisions[t].cut_cells.end());
+    for (std::size_t k = 1; k < collisions[t].cutting_offsets.size(); ++k)
+      pc.cutting_offsets.push_back(offset + collisions[t].cutting_offsets[k]);
+    pc.cutting_cells.insert(pc.cutting_cells.end(),
+                            collisions[t].cutting_cells.begin(),
+                            collisions[t].cutting_cells.end());
+    pc.covered_cells.insert(pc.covered_cells.end(),
+                            collisions[t].covered_cells.begin(),
+                            collisions[t].covered_cells.end());
+  }
+}
+//-----------------------------------------------------------------------------
+void MultiMesh::_classify_cells(std::size_t i)
+{
+  // Extract uncut, cut and covered cells:
+  //
+  // 0: uncut   = cell not colliding with any higher domain
+  // 1: cut     = cell colliding with some higher boundary and is not covered
+  // 2: covered = cell colliding with some higher domain but not its boundary
 
-      // Reset domain collision markers
-      std::fill(collides_with_domain.begin(), collides_with_domain.end(), false);
+  // Create vector of markers for cells in part `i` (0, 1, or 2)
+  std::vector<char> markers(_meshes[i]->num_cells(), 0);
 
-      // Iterate over domain collisions
-      dolfin_assert(domain_collisions.first.size() == domain_collisions.second.size());
-      for (std::size_t k = 0; k < domain_collisions.first.size(); k++)
-      {
-        // Get the two colliding cells
-        const std::size_t cell_i = domain_collisions.first[k];
-	const std::size_t cell_j = domain_collisions.second[k];
+  // Create empty collision map for cut cells in part `i`
+  std::map<unsigned int, std::vector<std::pair<std::size_t, unsigned int>>>
+    collision_map_cut_cells;
 
-        // Store collision in collision map if we have a cut cell
-        if (markers[cell_i] == 1)
-        {
-	  const Cell cell(*_meshes[i], cell_i);
-	  const Cell other_cell(*_meshes[j], cell_j);
-	  if (cell.collides(other_cell))
-	  {
-	    collides_with_domain[cell_i] = true;
-	    auto it = collision_map_cut_cells.find(cell_i);
-	    dolfin_assert(it != collision_map_cut_cells.end());
-	    it->second.emplace_back(j, cell_j);
-	  }
-        }
+  // Iterate over covering parts (with higher part number)
+  for (std::size_t j = i + 1; j < num_parts(); j++)
+  {
+    const PartCollisions& pc = _part_collisions[i][j];
 
-        // Possibility to cell as covered if it does not collide with boundary
-        if (!collides_with_boundary[cell_i])
+    // Mark as cut cell if not previously covered, and add collisions
+    // into map
+    for (std::size_t k = 0; k < pc.cut_cells.size(); ++k)
+    {
+      const unsigned int cell_i = pc.cut_cells[k];
+      if (markers[cell_i] != 2)
+      {
+        markers[cell_i] = 1;
+        auto& collisions = collision_map_cut_cells[cell_i];
+        for (std::size_t l = pc.cutting_offsets[k];
+             l < pc.cutting_offsets[k + 1]; ++l)
         {
-	  // Detailed check if it is not marked as colliding with domain
-	  if (!collides_with_domain[cell_i])
-	  {
-	    const Cell cell(*_meshes[i], cell_i);
-	    const Cell other_cell(*_meshes[j], cell_j);
-	    collides_with_domain[cell_i] = cell.collides(other_cell);
-	  }
-
-	  if (collides_with_domain[cell_i])
-	  {
-	    // Remove from collision map if previously marked as as cut cell
-	    if (markers[cell_i] == 1)
-	    {
-	      dolfin_assert(collision_map_cut_cells.find(cell_i) != collision_map_cut_cells.end());
-	      collision_map_cut_cells.erase(cell_i);
-	    }
-
-	    // Mark as covered cell (may already be marked)
-	    markers[cell_i] = 2;
-	  }
-
+          collisions.emplace_back(j, pc.cutting_cells[l]);
         }
       }
     }
 
-    // Extract uncut, cut and covered cells from markers
-    std::vector<unsigned int> uncut_cells;
-    std::vector<unsigned int> cut_cells;
-    std::vector<unsigned int> covered_cells;
-    for (unsigned int c = 0; c < _meshes[i]->num_cells(); c++)
+    // Mark as covered cell (may already be marked), and remove from
+    // collision map if previously marked as cut cell
+    for (const unsigned int cell_i : pc.covered_cells)
     {
-      switch (markers[c])
+      if (markers[cell_i] == 1)
       {
-      case 0:
-        uncut_cells.push_back(c);
-        break;
-      case 1:
-        cut_cells.push_back(c);
-        break;
-      default:
-        covered_cells.push_back(c);
+        dolfin_assert(collision_map_cut_cells.find(cell_i) != collision_map_cut_cells.end());
+        collision_map_cut_cells.erase(cell_i);
       }
+      markers[cell_i] = 2;
     }
+  }
 
-    // Store data for this mesh
-    _uncut_cells.push_back(uncut_cells);
-    _covered_cells.push_back(covered_cells);
-    _collision_maps_cut_cells.push_back(collision_map_cut_cells);
-
-    // Report results
-    log(PROGRESS, "Part %d has %d uncut cells, %d cut cells, and %d covered cells.",
-        i, uncut_cells.size(), cut_cells.size(), covered_cells.size());
+  // Extract uncut, cut and covered cells from markers
+  std::vector<unsigned int> uncut_cells;
+  std::vector<unsigned int> cut_cells;
+  std::vector<unsigned int> covered_cells;
+  for (unsigned int c = 0; c < _meshes[i]->num_cells(); c++)
+  {
+    switch (markers[c])
+    {
+    case 0:
+      uncut_cells.push_back(c);
+      break;
+    case 1:
+      cut_cells.push_back(c);
+      break;
+    default:
+      covered_cells.push_back(c);
+    }
   }
 
-  end();
+  // Store data for this mesh
+  _uncut_cells[i] = uncut_cells;
+  _covered_cells[i] = covered_cells;
+  _collision_maps_cut_cells[i] = collision_map_cut_cells;
+
+  // Report results
+  log(PROGRESS, "Part %d has %d uncut cells, %d cut cells, and %d covered cells.",
+      i, uncut_cells.size(), cut_cells.size(), covered_cells.size());
 }
 //-----------------------------------------------------------------------------
-void MultiMesh::_build_quadrature_rules_overlap(std::size_t quadrature_order)
+void MultiMesh::_build_quadrature_rules_overlap
+(std::size_t quadrature_order,
+ const std::vector<std::vector<unsigned int>>& cells)
 {
   begin(PROGRESS, "Building quadrature rules of cut cells' overlap.");
 
-  // Clear quadrature rules
-  _quadrature_rules_overlap.clear();
-
-  // Resize quadrature rules
-  _quadrature_rules_overlap.resize(num_parts());
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const bool compress = parameters["compress_volume_quadrature"];
 
   // Iterate over all parts
   for (std::size_t cut_part = 0; cut_part < num_parts(); cut_part++)
@@ -755,89 +937,100 @@ void MultiMesh::_build_quadrature_rules_overlap(std::size_t quadrature_order)
     const std::size_t gdim = _meshes[cut_part]->geometry().dim();
     const SimplexQuadrature sq(tdim, quadrature_order);
 
-    // Iterate over cut cells for current part
-    for (const auto& c : collision_map_cut_cells(cut_part))
+    // Iterate over given cut cells for current part (in parallel)
+    const auto& cmap = collision_map_cut_cells(cut_part);
+    const std::vector<unsigned int>& cut_cells = cells[cut_part];
+    std::vector<std::vector<quadrature_rule>> overlap_qrs(cut_cells.size());
+    Threads::parallel_for(cut_cells.size(), num_threads,
+                          [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = c.first;
-      const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
-
-      // Data structure for the first intersections (this is the first
-      // stage in the inclusion exclusion principle). These are the
-      // polyhedra to be used in the exlusion inclusion.
-      std::vector<std::pair<std::size_t, Polyhedron>> initial_polyhedra;
-
-      // Get the cutting cells
-      const std::vector<std::pair<std::size_t, unsigned int>>& cutting_cells = c.second;
-
-      // Data structure for the overlap quadrature rule
-      std::vector<quadrature_rule> overlap_qr(cutting_cells.size());
-
-      // Loop over all cutting cells to construct the polyhedra to be
-      // used in the inclusion-exclusion principle
-      for (const std::pair<std::size_t, unsigned int> cutting : cutting_cells)
+      for (std::size_t k = begin; k < end; ++k)
       {
-	// Get cutting part and cutting cell
-        const std::size_t cutting_part = cutting.first;
-        const std::size_t cutting_cell_index = cutting.second;
-        const Cell cutting_cell(*(_meshes[cutting_part]), cutting_cell_index);
-
-  	// Only allow same type of cell for now
-      	dolfin_assert(cutting_cell.mesh().topology().dim() == tdim);
-      	dolfin_assert(cutting_cell.mesh().geometry().dim() == gdim);
-
-        // Compute the intersection (a polyhedron)
-	const std::vector<Point> intersection
-	  = IntersectionConstruction::intersection(cut_cell, cutting_cell);
-	const std::vector<std::vector<Point>> triangulation
-	  = ConvexTriangulation::triangulate(intersection, gdim, tdim);
-	const Polyhedron polyhedron(triangulation, {cutting_part});
-
-	//dolfin_assert(!ConvexTriangulation::selfintersects(polyhedron.first));
-
-	// FIXME: Flip triangles in polyhedron to maximize minimum angle here?
-	// FIXME: only include large polyhedra
-
-	// Note that this can be empty
-	initial_polyhedra.emplace_back(initial_polyhedra.size(),
-				       polyhedron);
-      }
+        // Get cut cell
+        const unsigned int cut_cell_index = cut_cells[k];
+        const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
+
+        // Data structure for the first intersections (this is the first
+        // stage in the inclusion exclusion principle). These are the
+        // polyhedra to be used in the exlusion inclusion.
+        std::vector<std::pair<std::size_t, Polyhedron>> initial_polyhedra;
+
+        // Get the cutting cells
+        const std::vector<std::pair<std::size_t, unsigned int>>& cutting_cells
+          = cmap.find(cut_cell_index)->second;
+
+        // Data structure for the overlap quadrature rule
+        std::vector<quadrature_rule>& overlap_qr = overlap_qrs[k];
+        overlap_qr.resize(cutting_cells.size());
+
+        // Loop over all cutting cells to construct the polyhedra to be
+        // used in the inclusion-exclusion principle
+        for (const std::pair<std::size_t, unsigned int> cutting : cutting_cells)
+        {
+          // Get cutting part and cutting cell
+          const std::size_t cutting_part = cutting.first;
+          const std::size_t cutting_cell_index = cutting.second;
+          const Cell cutting_cell(*(_meshes[cutting_part]), cutting_cell_index);
+
+          // Only allow same type of cell for now
+          dolfin_assert(cutting_cell.mesh().topology().dim() == tdim);
+          dolfin_assert(cutting_cell.mesh().geometry().dim() == gdim);
+
+          // Compute the intersection (a polyhedron)
+          const std::vector<Point> intersection
+            = IntersectionConstruction::intersection(cut_cell, cutting_cell);
+          const std::vector<std::vector<Point>> triangulation
+            = ConvexTriangulation::triangulate(intersection, gdim, tdim);
+          const Polyhedron polyhedron(triangulation, {cutting_part});
+
+          //dolfin_assert(!ConvexTriangulation::selfintersects(polyhedron.first));
+
+          // FIXME: Flip triangles in polyhedron to maximize minimum angle here?
+          // FIXME: only include large polyhedra
+
+          // Note that this can be empty
+          initial_polyhedra.emplace_back(initial_polyhedra.size(),
+                                       polyhedron);
+        }
 
-      if (cutting_cells.size() > 0)
-	_inclusion_exclusion_overlap(overlap_qr, sq, initial_polyhedra,
-				     tdim, gdim, quadrature_order);
+        if (cutting_cells.size() > 0)
+          _inclusion_exclusion_overlap(overlap_qr, sq, initial_polyhedra,
+                                     tdim, gdim, quadrature_order);
 
-      // Remove any near-trival quadrature rules
-      // TODO: The tolerance here appears to work ok in 2D with few meshes
-      // TODO: It might not be accurate in 3D or a large number of meshes
+        // Remove any near-trival quadrature rules
+        // TODO: The tolerance here appears to work ok in 2D with few meshes
+        // TODO: It might not be accurate in 3D or a large number of meshes
 
-      //const double tolerance = DOLFIN_EPS * cut_cell.volume();
-      //for (std::size_t i = 0; i < overlap_qr.size(); i++)
-      //	remove_quadrature_rule(overlap_qr[i], tolerance);
+        //const double tolerance = DOLFIN_EPS * cut_cell.volume();
+        //for (std::size_t i = 0; i < overlap_qr.size(); i++)
+        //        remove_quadrature_rule(overlap_qr[i], tolerance);
 
-      if (parameters["compress_volume_quadrature"])
-      {
-      	for (std::size_t i = 0; i < overlap_qr.size(); ++i)
+        if (compress)
         {
-      	  SimplexQuadrature::compress(overlap_qr[i], gdim, quadrature_order);
+          for (std::size_t i = 0; i < overlap_qr.size(); ++i)
+          {
+            SimplexQuadrature::compress(overlap_qr[i], gdim, quadrature_order);
+          }
         }
       }
+    });
 
-      // Store quadrature rules for cut cell
-      _quadrature_rules_overlap[cut_part][cut_cell_index] = overlap_qr;
-    }
+    // Store quadrature rules for cut cells
+    for (std::size_t k = 0; k < cut_cells.size(); ++k)
+      _quadrature_rules_overlap[cut_part][cut_cells[k]] = std::move(overlap_qrs[k]);
   }
 
   end();
 }
 //-----------------------------------------------------------------------------
-void MultiMesh::_build_quadrature_rules_cut_cells(std::size_t quadrature_order)
+void MultiMesh::_build_quadrature_rules_cut_cells
+(std::size_t quadrature_order,
+ const std::vector<std::vector<unsigned int>>& cells)
 {
   begin(PROGRESS, "Building quadrature rules of cut cells.");
 
-  // Clear quadrature rules
-  _quadrature_rules_cut_cells.clear();
-  _quadrature_rules_cut_cells.resize(num_parts());
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const bool compress = parameters["compress_volume_quadrature"];
 
   // Iterate over all parts
   for (std::size_t cut_part = 0; cut_part < num_parts(); cut_part++)
@@ -847,40 +1040,50 @@ void MultiMesh::_build_quadrature_rules_cut_cells(std::size_t quadrature_order)
     const std::size_t gdim = _meshes[cut_part]->geometry().dim();
     const SimplexQuadrature sq(tdim, quadrature_order);
 
-    // Iterate over cut cells for current part
-    const auto& cmap = collision_map_cut_cells(cut_part);
-    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    // Iterate over given cut cells for current part (in parallel)
+    const auto& qr_overlaps = _quadrature_rules_overlap[cut_part];
+    const std::vector<unsigned int>& cut_cells = cells[cut_part];
+    std::vector<quadrature_rule> qrs(cut_cells.size());
+    Threads::parallel_for(cut_cells.size(), num_threads,
+                          [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = it->first;
-      const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        // Get cut cell
+        const unsigned int cut_cell_index = cut_cells[i];
+        const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
 
-      // Compute quadrature rule for the cell itself.
-      auto qr = sq.compute_quadrature_rule(cut_cell);
+        // Compute quadrature rule for the cell itself.
+        auto& qr = qrs[i];
+        qr = sq.compute_quadrature_rule(cut_cell);
 
-      // Get the quadrature rule for the overlapping part
-      const auto& qr_overlap = _quadrature_rules_overlap[cut_part][cut_cell_index];
+        // Get the quadrature rule for the overlapping part
+        const auto& qr_overlap = qr_overlaps.find(cut_cell_index)->second;
 
-      // Add the quadrature rule for the overlapping part to the
-      // quadrature rule of the cut cell with flipped sign
-      for (std::size_t k = 0; k < qr_overlap.size(); k++)
-        _add_quadrature_rule(qr, qr_overlap[k], gdim, -1);
+        // Add the quadrature rule for the overlapping part to the
+        // quadrature rule of the cut cell with flipped sign
+        for (std::size_t k = 0; k < qr_overlap.size(); k++)
+          _add_quadrature_rule(qr, qr_overlap[k], gdim, -1);
 
-      if (parameters["compress_volume_quadrature"])
-      {
-      	// Compress
-      	SimplexQuadrature::compress(qr, gdim, quadrature_order);
+        if (compress)
+        {
+          // Compress
+          SimplexQuadrature::compress(qr, gdim, quadrature_order);
+        }
       }
+    });
 
-      // Store quadrature rule for cut cell
-      _quadrature_rules_cut_cells[cut_part][cut_cell_index] = qr;
-    }
+    // Store quadrature rules for cut cells
+    for (std::size_t i = 0; i < cut_cells.size(); ++i)
+      _quadrature_rules_cut_cells[cut_part][cut_cells[i]] = std::move(qrs[i]);
   }
 
   end();
 }
 //------------------------------------------------------------------------------
-void MultiMesh::_build_quadrature_rules_interface(std::size_t quadrature_order)
+void MultiMesh::_build_quadrature_rules_interface
+(std::size_t quadrature_order,
+ const std::vector<std::vector<unsigned int>>& cells)
 {
   begin(PROGRESS, "Building quadrature rules of interface.");
 
@@ -891,11 +1094,8 @@ void MultiMesh::_build_quadrature_rules_interface(std::size_t quadrature_order)
   //   |E_ij \ U_k T_k| = |E_ij| - |E_ij \cap U_k T_k|
   //                    = |E_ij| - |U_k E_ij \cap T_k|
 
-  // Clear and resize quadrature rules and normals
-  _quadrature_rules_interface.clear();
-  _quadrature_rules_interface.resize(num_parts());
-  _facet_normals.clear();
-  _facet_normals.resize(num_parts());
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const bool compress = parameters["compress_interface_quadrature"];
 
   // First we prebuild a map from the boundary facets to full mesh
   // cells for all meshes: Loop over all boundary mesh facets to find
@@ -912,6 +1112,14 @@ void MultiMesh::_build_quadrature_rules_interface(std::size_t quadrature_order)
   for (std::size_t part = 0; part < num_parts(); ++part)
     full_to_bdry[part] = _boundary_facets_to_full_mesh(part);
 
+  // Initialize cell-facet connectivity, which is needed below, before
+  // computing in parallel
+  for (std::size_t part = 0; part < num_parts(); ++part)
+  {
+    const std::size_t tdim = _meshes[part]->topology().dim();
+    _meshes[part]->init(tdim, tdim - 1);
+  }
+
   // Iterate over all parts
   for (std::size_t cut_part = 0; cut_part < num_parts(); cut_part++)
   {
@@ -923,191 +1131,205 @@ void MultiMesh::_build_quadrature_rules_interface(std::size_t quadrature_order)
     const std::size_t gdim = _meshes[cut_part]->geometry().dim();
     const SimplexQuadrature sq(tdim_interface, quadrature_order);
 
-    // Iterate over cut cells for current part
+    // Iterate over given cut cells for current part (in parallel)
     const std::map<unsigned int,
                    std::vector<std::pair<std::size_t,
                                          unsigned int>>>&
       cmap = collision_map_cut_cells(cut_part);
-    for (const auto cut_i: cmap)
+    const std::vector<unsigned int>& cut_cells = cells[cut_part];
+    std::vector<std::vector<quadrature_rule>> interface_qrs(cut_cells.size());
+    std::vector<std::vector<std::vector<double>>>
+      interface_normals_list(cut_cells.size());
+    Threads::parallel_for(cut_cells.size(), num_threads,
+                          [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      // Get cut cell
-      const std::size_t cut_cell_index_i = cut_i.first;
-      const Cell cut_cell_i(*(_meshes[cut_part]), cut_cell_index_i);
-
-      // Get the cutting cells
-      const auto& cutting_cells_j = cut_i.second;
-
-      // Data structures for the interface quadrature rule and the normals
-      const std::size_t num_cutting_cells
-	= std::distance(cutting_cells_j.begin(), cutting_cells_j.end());
-      std::vector<quadrature_rule> interface_qr(num_cutting_cells);
-      std::vector<std::vector<double>> interface_normals(num_cutting_cells);
-
-      // Loop over all cutting cells to construct the polyhedra to be
-      // used in the inclusion-exclusion principle
-      for (std::vector<std::pair<std::size_t, unsigned int>>::const_iterator
-	     cutting_j = cutting_cells_j.begin();
-	   cutting_j != cutting_cells_j.end(); ++cutting_j)
+      for (std::size_t c = begin; c < end; ++c)
       {
-	// Get cutting part and cutting cell
-        const std::size_t cutting_part_j = cutting_j->first;
-        const std::size_t cutting_cell_index_j = cutting_j->second;
-        const Cell cutting_cell_j(*(_meshes[cutting_part_j]), cutting_cell_index_j);
-	const std::size_t local_cutting_cell_j_index = cutting_j - cutting_cells_j.begin();
-	dolfin_assert(cutting_part_j > cut_part);
-
-	// Find and store the cutting cells Tk. These are fed into the
-	// inc exc together with the edge Eij.
-	std::vector<std::pair<std::size_t, Polyhedron>> initial_polygons;
-
-	// Find and save all cutting cells with part number > i
-	// (this is always true), and part number != j.
-	for (const std::pair<size_t, unsigned int>& cutting_k: cut_i.second)
-	{
-	  const std::size_t cutting_part_k = cutting_k.first;
-	  if (cutting_part_k != cutting_part_j)
-	  {
-	    const std::size_t cutting_cell_index_k = cutting_k.second;
-	    const Cell cutting_cell_k(*(_meshes[cutting_part_k]),
-				      cutting_cell_index_k);
-
-	    // Store key and the cutting cell as a polygon (this
-	    // is really a Simplex, but store as polyhedron to
-	    // minimize interface change to inc exc).
-	    const MeshGeometry& geometry = _meshes[cutting_part_k]->geometry();
-	    const unsigned int* vertices = cutting_cell_k.entities(0);
-	    Simplex cutting_cell_k_simplex(tdim_bulk + 1);
-	    for (std::size_t i = 0; i < cutting_cell_k_simplex.size(); ++i)
-	      cutting_cell_k_simplex[i] = geometry.point(vertices[i]);
-	    const Polyhedron cutting_cell_k_polyhedron({cutting_cell_k_simplex},
-						       {cutting_part_k});
-	    initial_polygons.emplace_back(initial_polygons.size(),
-					  cutting_cell_k_polyhedron);
-	  }
-	}
-
-	// Iterate over boundary cells of this cutting cell (for
-	// triangles we have one or two sides that cut). Here we can
-	// optionally use a full (polygon) E_ij used in the E_ij \cap
-	// T_k, or we can only take a part (a simplex) of the Eij.
-
-	// Loop over all Eij parts (i.e. boundary parts of T_j)
-	for (const auto boundary_cell_index_j: full_to_bdry[cutting_part_j][cutting_cell_index_j])
+        // Get cut cell
+        const std::size_t cut_cell_index_i = cut_cells[c];
+        const Cell cut_cell_i(*(_meshes[cut_part]), cut_cell_index_i);
+
+        // Get the cutting cells
+        const auto& cutting_cells_j = cmap.find(cut_cell_index_i)->second;
+
+        // Data structures for the interface quadrature rule and the normals
+        const std::size_t num_cutting_cells
+          = std::distance(cutting_cells_j.begin(), cutting_cells_j.end());
+        std::vector<quadrature_rule>& interface_qr = interface_qrs[c];
+        std::vector<std::vector<double>>& interface_normals
+          = interface_normals_list[c];
+        interface_qr.resize(num_cutting_cells);
+        interface_normals.resize(num_cutting_cells);
+
+        // Loop over all cutting cells to construct the polyhedra to be
+        // used in the inclusion-exclusion principle
+        for (std::vector<std::pair<std::size_t, unsigned int>>::const_iterator
+               cutting_j = cutting_cells_j.begin();
+             cutting_j != cutting_cells_j.end(); ++cutting_j)
         {
-          // Get the boundary facet as a cell in the boundary mesh
-          // (remember that this is of one less topological dimension)
-          const Cell boundary_cell_j(*_boundary_meshes[cutting_part_j],
-				     boundary_cell_index_j.first);
-	  dolfin_assert(boundary_cell_j.mesh().topology().dim() == tdim_interface);
-
-	  // Get the normal by constructing a Facet using the full_to_bdry data
-	  const Facet boundary_facet_j(*_meshes[cutting_part_j],
-				       boundary_cell_index_j.second);
-	  const std::size_t local_facet_index = cutting_cell_j.index(boundary_facet_j);
-	  const Point facet_normal = cutting_cell_j.normal(local_facet_index);
-
-	  // Triangulate intersection of cut cell and boundary cell
-	  const std::vector<Point> Eij_part_points
-	    = IntersectionConstruction::intersection(cut_cell_i, boundary_cell_j);
-
-	  // Check that the triangulation is not part of the cut cell boundary
-	  // FIXME: How can we avoid is_degenerate warnings in
-	  // _is_overlapped_interface by checking the input?
-	  if (Eij_part_points.size() < tdim_interface + 1 or
-	      _is_overlapped_interface(Eij_part_points, cut_cell_i, facet_normal))
-	    continue;
-
-	  const std::vector<std::vector<Point>> triangulation
-	    = ConvexTriangulation::triangulate(Eij_part_points,
-					       gdim, tdim_interface);
-	  const Polyhedron Eij_part(triangulation, {cutting_part_j});
-
-	  for (const Simplex& Eij : Eij_part.first)
-	  {
-	    dolfin_assert(Eij.size() == tdim_interface + 1);
-
-	    // Store the |Eij| and normals
-	    const std::size_t num_pts
-	      = _add_quadrature_rule(interface_qr[local_cutting_cell_j_index],
-				     sq, Eij, gdim, quadrature_order, 1.);
-	    _add_normal(interface_normals[local_cutting_cell_j_index],
-			facet_normal, num_pts, gdim);
-
-	    // No need to run inc exc if there are no cutting cells
-	    if (initial_polygons.size())
-	    {
-	      // Call inclusion exclusion
-	      _inclusion_exclusion_interface
-		(interface_qr[local_cutting_cell_j_index],
-		 interface_normals[local_cutting_cell_j_index],
-		 sq, Eij, facet_normal, initial_polygons,
-		 tdim_interface, gdim, quadrature_order);
-	    }
-
-	    // // Remove any near-trival quadrature rules
-	    // // TODO: Investigate the tolerance
-	    // double cut_size;
-	    // if  (Eij.size() == 2)
-	    //   cut_size = (Eij[1] - Eij[0]).norm();
-	    // else if (Eij.size() == 3)
-	    //   cut_size = (Eij[1] - Eij[0]).cross(Eij[2] - Eij[0]).norm() / 2;
-	    //const double tolerance = DOLFIN_EPS * cut_size;
-	    //remove_quadrature_rule(interface_qr[local_cutting_cell_j_index], tolerance);
-
-	    // TODO: Investigate if we should compress here or below
-	    if (parameters["compress_interface_quadrature"])
-	    {
-	      const std::vector<std::size_t> indices
-	    	= SimplexQuadrature::compress(interface_qr[local_cutting_cell_j_index],
-					      gdim, quadrature_order);
-	      // Reorder the normals
-	      if (indices.size())
-	      {
-		std::vector<double> normals(gdim*indices.size());
-		for (std::size_t j = 0; j < indices.size(); ++j)
-		  for (std::size_t d = 0; d < gdim; ++d)
-		    normals[gdim*j + d]
-		      = interface_normals[local_cutting_cell_j_index][gdim*indices[j] + d];
-		interface_normals[local_cutting_cell_j_index] = normals;
-
-		dolfin_assert(gdim*interface_qr[local_cutting_cell_j_index].second.size()
-			      == normals.size());
-	      }
-
-	    }
+          // Get cutting part and cutting cell
+          const std::size_t cutting_part_j = cutting_j->first;
+          const std::size_t cutting_cell_index_j = cutting_j->second;
+          const Cell cutting_cell_j(*(_meshes[cutting_part_j]), cutting_cell_index_j);
+          const std::size_t local_cutting_cell_j_index = cutting_j - cutting_cells_j.begin();
+          dolfin_assert(cutting_part_j > cut_part);
+
+          // Find and store the cutting cells Tk. These are fed into the
+          // inc exc together with the edge Eij.
+          std::vector<std::pair<std::size_t, Polyhedron>> initial_polygons;
+
+          // Find and save all cutting cells with part number > i
+          // (this is always true), and part number != j.
+          for (const std::pair<size_t, unsigned int>& cutting_k: cutting_cells_j)
+          {
+            const std::size_t cutting_part_k = cutting_k.first;
+            if (cutting_part_k != cutting_part_j)
+            {
+              const std::size_t cutting_cell_index_k = cutting_k.second;
+              const Cell cutting_cell_k(*(_meshes[cutting_part_k]),
+                                      cutting_cell_index_k);
+
+              // Store key and the cutting cell as a polygon (this
+              // is really a Simplex, but store as polyhedron to
+              // minimize interface change to inc exc).
+              const MeshGeometry& geometry = _meshes[cutting_part_k]->geometry();
+              const unsigned int* vertices = cutting_cell_k.entities(0);
+              Simplex cutting_cell_k_simplex(tdim_bulk + 1);
+              for (std::size_t i = 0; i < cutting_cell_k_simplex.size(); ++i)
+                cutting_cell_k_simplex[i] = geometry.point(vertices[i]);
+              const Polyhedron cutting_cell_k_polyhedron({cutting_cell_k_simplex},
+                                                       {cutting_part_k});
+              initial_polygons.emplace_back(initial_polygons.size(),
+                                          cutting_cell_k_polyhedron);
+            }
+          }
 
-	  }
-	} // end loop over boundary_cell_j
-      } // end loop over cutting_j
-
-      // // TODO: Investigate if we should compress here or above
-      // if (parameters["compress_interface_quadrature"])
-      // {
-      // 	for (std::size_t i = 0; i < interface_qr.size(); ++i)
-      // 	{
-      // 	  const std::vector<std::size_t> indices
-      // 	    = SimplexQuadrature::compress(interface_qr[i],
-      // 					  gdim, quadrature_order);
-
-      // 	  if (indices.size())
-      // 	  {
-      // 	    // Reorder the normals
-      // 	    std::vector<double> normals(gdim*indices.size());
-      // 	    for (std::size_t j = 0; j < indices.size(); ++j)
-      // 	      for (std::size_t d = 0; d < gdim; ++d)
-      // 		normals[gdim*j + d] = interface_normals[i][gdim*indices[j] + d];
-      // 	    interface_normals[i] = normals;
-      // 	  }
-
-      // 	  dolfin_assert(gdim*interface_qr[i].second.size()
-      // 			== interface_normals[i].size());
-      // 	}
-      // }
-
-      _quadrature_rules_interface[cut_part][cut_cell_index_i] = interface_qr;
-      _facet_normals[cut_part][cut_cell_index_i] = interface_normals;
-
-    } // end loop over cut_i
+          // Iterate over boundary cells of this cutting cell (for
+          // triangles we have one or two sides that cut). Here we can
+          // optionally use a full (polygon) E_ij used in the E_ij \cap
+          // T_k, or we can only take a part (a simplex) of the Eij.
+
+          // Loop over all Eij parts (i.e. boundary parts of T_j)
+          for (const auto boundary_cell_index_j: full_to_bdry[cutting_part_j][cutting_cell_index_j])
+          {
+            // Get the boundary facet as a cell in the boundary mesh
+            // (remember that this is of one less topological dimension)
+            const Cell boundary_cell_j(*_boundary_meshes[cutting_part_j],
+                                     boundary_cell_index_j.first);
+            dolfin_assert(boundary_cell_j.mesh().topology().dim() == tdim_interface);
+
+            // Get the normal by constructing a Facet using the full_to_bdry data
+            const Facet boundary_facet_j(*_meshes[cutting_part_j],
+                                       boundary_cell_index_j.second);
+            const std::size_t local_facet_index = cutting_cell_j.index(boundary_facet_j);
+            const Point facet_normal = cutting_cell_j.normal(local_facet_index);
+
+            // Triangulate intersection of cut cell and boundary cell
+            const std::vector<Point> Eij_part_points
+              = IntersectionConstruction::intersection(cut_cell_i, boundary_cell_j);
+
+            // Check that the triangulation is not part of the cut cell boundary
+            // FIXME: How can we avoid is_degenerate warnings in
+            // _is_overlapped_interface by checking the input?
+            if (Eij_part_points.size() < tdim_interface + 1 or
+                _is_overlapped_interface(Eij_part_points, cut_cell_i, facet_normal))
+              continue;
+
+            const std::vector<std::vector<Point>> triangulation
+              = ConvexTriangulation::triangulate(Eij_part_points,
+                                               gdim, tdim_interface);
+            const Polyhedron Eij_part(triangulation, {cutting_part_j});
+
+            for (const Simplex& Eij : Eij_part.first)
+            {
+              dolfin_assert(Eij.size() == tdim_interface + 1);
+
+              // Store the |Eij| and normals
+              const std::size_t num_pts
+                = _add_quadrature_rule(interface_qr[local_cutting_cell_j_index],
+                                     sq, Eij, gdim, quadrature_order, 1.);
+              _add_normal(interface_normals[local_cutting_cell_j_index],
+                          facet_normal, num_pts, gdim);
+
+              // No need to run inc exc if there are no cutting cells
+              if (initial_polygons.size())
+              {
+                // Call inclusion exclusion
+                _inclusion_exclusion_interface
+                  (interface_qr[local_cutting_cell_j_index],
+                   interface_normals[local_cutting_cell_j_index],
+                   sq, Eij, facet_normal, initial_polygons,
+                   tdim_interface, gdim, quadrature_order);
+              }
+
+              // // Remove any near-trival quadrature rules
+              // // TODO: Investigate the tolerance
+              // double cut_size;
+              // if  (Eij.size() == 2)
+              //   cut_size = (Eij[1] - Eij[0]).norm();
+              // else if (Eij.size() == 3)
+              //   cut_size = (Eij[1] - Eij[0]).cross(Eij[2] - Eij[0]).norm() / 2;
+              //const double tolerance = DOLFIN_EPS * cut_size;
+              //remove_quadrature_rule(interface_qr[local_cutting_cell_j_index], tolerance);
+
+              // TODO: Investigate if we should compress here or below
+              if (compress)
+              {
+                const std::vector<std::size_t> indices
+                  = SimplexQuadrature::compress(interface_qr[local_cutting_cell_j_index],
+                                              gdim, quadrature_order);
+                // Reorder the normals
+                if (indices.size())
+                {
+                  std::vector<double> normals(gdim*indices.size());
+                  for (std::size_t j = 0; j < indices.size(); ++j)
+                    for (std::size_t d = 0; d < gdim; ++d)
+                      normals[gdim*j + d]
+                        = interface_normals[local_cutting_cell_j_index][gdim*indices[j] + d];
+                  interface_normals[local_cutting_cell_j_index] = normals;
+
+                  dolfin_assert(gdim*interface_qr[local_cutting_cell_j_index].second.size()
+                              == normals.size());
+                }
+
+              }
+
+            }
+          } // end loop over boundary_cell_j
+        } // end loop over cutting_j
+
+        // // TODO: Investigate if we should compress here or above
+        // if (parameters["compress_interface_quadrature"])
+        // {
+        //        for (std::size_t i = 0; i < interface_qr.size(); ++i)
+        //        {
+        //          const std::vector<std::size_t> indices
+        //            = SimplexQuadrature::compress(interface_qr[i],
+        //                                          gdim, quadrature_order);
+
+        //          if (indices.size())
+        //          {
+        //            // Reorder the normals
+        //            std::vector<double> normals(gdim*indices.size());
+        //            for (std::size_t j = 0; j < indices.size(); ++j)
+        //              for (std::size_t d = 0; d < gdim; ++d)
+        //                normals[gdim*j + d] = interface_normals[i][gdim*indices[j] + d];
+        //            interface_normals[i] = normals;
+        //          }
+
+        //          dolfin_assert(gdim*interface_qr[i].second.size()
+        //                        == interface_normals[i].size());
+        //        }
+        // }
+      } // end loop over cut_i
+    });
+
+    // Store quadrature rules and normals for cut cells
+    for (std::size_t c = 0; c < cut_cells.size(); ++c)
+    {
+      _quadrature_rules_interface[cut_part][cut_cells[c]] = std::move(interface_qrs[c]);
+      _facet_normals[cut_part][cut_cells[c]] = std::move(interface_normals_list[c]);
+    }
   } // end loop over parts
 
   end();
@@ -1165,10 +1387,20 @@ MultiMesh::_add_quadrature_rule(quadrature_rule& qr,
                                 std::size_t quadrature_order,
                                 double factor) const
 {
-  // Compute quadrature rule for simplex
-  const auto dqr = sq.compute_quadrature_rule(simplex, gdim);
-  // Add quadrature rule
-  const std::size_t num_points = _add_quadrature_rule(qr, dqr, gdim, factor);
+  // Copy vertex coordinates of simplex
+  dolfin_assert(simplex.size() <= 4 and gdim <= 3);
+  double x[12];
+  for (std::size_t v = 0; v < simplex.size(); ++v)
+    for (std::size_t j = 0; j < gdim; ++j)
+      x[v*gdim + j] = simplex[v][j];
+
+  // Compute quadrature rule for simplex directly at the end of qr
+  const std::size_t num_points = sq.size();
+  const std::size_t offset = qr.second.size();
+  qr.first.resize(gdim*(offset + num_points));
+  qr.second.resize(offset + num_points);
+  sq.compute_quadrature_rules(x, 1, gdim, qr.first.data() + gdim*offset,
+                              qr.second.data() + offset, factor);
 
   return num_points;
 }
@@ -1237,8 +1469,6 @@ void MultiMesh::_inclusion_exclusion_overlap
  std::size_t gdim,
  std::size_t quadrature_order) const
 {
-  begin(PROGRESS, "The inclusion exclusion principle.");
-
   // Exclusion-inclusion principle. There are N stages in the
   // principle, where N = polyhedra.size(). The first stage is
   // simply the polyhedra themselves A, B, C, ... etc. The second
@@ -1372,8 +1602,6 @@ void MultiMesh::_inclusion_exclusion_overlap
       }
 
   } // end loop over stages
-
-  end();
 }
 //------------------------------------------------------------------------------
 void MultiMesh::_inclusion_exclusion_interface
@@ -1387,8 +1615,6 @@ void MultiMesh::_inclusion_exclusion_interface
  std::size_t gdim,
  std::size_t quadrature_order) const
 {
-  begin(PROGRESS, "The inclusion exclusion principle for the interface.");
-
   dolfin_assert(Eij.size() == tdim_interface + 1);
   const std::size_t tdim_bulk = tdim_interface + 1;
 
@@ -1569,8 +1795,6 @@ void MultiMesh::_inclusion_exclusion_interface
     qr.second.insert(qr.second.end(), qr_stage.second.begin(), qr_stage.second.end());
     normals.insert(normals.end(), normals_stage.begin(), normals_stage.end());
   } // end loop over stages
-
-  end();
 }
 //------------------------------------------------------------------------------
 std::vector<std::vector<std::pair<std::size_t, std::size_t>>>
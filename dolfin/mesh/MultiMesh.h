@@ -18,7 +18,7 @@
 // Modified by August Johansson 2018
 //
 // First added:  2014-03-03
-// Last changed: 2018-04-03
+// Last changed: 2019-06-18
 
 #ifndef __MULTI_MESH_H
 #define __MULTI_MESH_H
@@ -347,9 +347,27 @@ namespace dolfin
     ///         The mesh
     void add(std::shared_ptr<const Mesh> mesh);
 
-    /// Build multimesh
+    /// Build multimesh. The collisions between the parts and the
+    /// quadrature rules of the cut cells are computed in parallel
+    /// using the number of threads given by the global parameter
+    /// "num_threads".
     void build(std::size_t quadrature_order=2);
 
+    /// Update multimesh after the vertex coordinates of one part have
+    /// changed (e.g. after the part has been moved), but not its
+    /// topology. Only the collisions which involve the given part are
+    /// recomputed, and only the quadrature rules of cut cells in the
+    /// given part or cut by the given part. The cells of the given
+    /// part and of the parts below it are classified again, so cells
+    /// marked as covered by mark_covered() or auto_cover() must be
+    /// marked again for these parts. The quadrature order of the
+    /// last build is used.
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The part number of the moved part
+    void update(std::size_t part);
+
     /// Check whether multimesh has been built
     bool is_built() const { return _is_built; }
 
@@ -393,6 +411,9 @@ namespace dolfin
     // Flag for whether multimesh has been built
     bool _is_built;
 
+    // Quadrature order of last build
+    std::size_t _quadrature_order;
+
     // List of meshes
     std::vector<std::shared_ptr<const Mesh> > _meshes;
 
@@ -508,6 +529,33 @@ namespace dolfin
     std::vector<std::map<unsigned int, std::vector<std::vector<double> > > >
     _facet_normals;
 
+    // Collisions between the cells of part i and part j > i, which
+    // are computed independently for each pair of parts and merged
+    // into the collision maps above. The collisions of the pairs
+    // which do not involve a moved part are reused by update().
+    struct PartCollisions
+    {
+      // Cells colliding with the boundary of part j (sorted), and for
+      // each of these the colliding cells of part j, stored as
+      // cutting_cells[cutting_offsets[k]:cutting_offsets[k + 1]]
+      std::vector<unsigned int> cut_cells;
+      std::vector<std::size_t> cutting_offsets;
+      std::vector<unsigned int> cutting_cells;
+
+      // Cells colliding with the domain but not with the boundary of
+      // part j (sorted)
+      std::vector<unsigned int> covered_cells;
+    };
+
+    // Collisions between parts. Access data by
+    //
+    //     c = _part_collisions[i][j]
+    //
+    // where
+    //
+    //     c = collisions of cells in part i with part j > i
+    std::vector<std::vector<PartCollisions> > _part_collisions;
+
     // Build boundary meshes
     void _build_boundary_meshes();
 
@@ -519,14 +567,30 @@ namespace dolfin
     //void _build_collision_maps_same_topology();
     //void _build_collision_maps_different_topology();
 
-    // Build quadrature rules for the cut cells
-    void _build_quadrature_rules_cut_cells(std::size_t quadrature_order);
-
-    // Build quadrature rules for the overlap
-    void _build_quadrature_rules_overlap(std::size_t quadrature_order);
-
-    // Build quadrature rules and normals for the interface
-    void _build_quadrature_rules_interface(std::size_t quadrature_order);
+    // Compute collisions between the cells of part i and part j > i
+    void _compute_part_collisions(std::size_t i, std::size_t j,
+                                  std::size_t num_threads);
+
+    // Classify the cells of part i as uncut, cut or covered and build
+    // the collision map of its cut cells from the part collisions
+    void _classify_cells(std::size_t i);
+
+    // Build quadrature rules for the given cut cells of each part
+    void _build_quadrature_rules_cut_cells
+      (std::size_t quadrature_order,
+       const std::vector<std::vector<unsigned int> >& cells);
+
+    // Build quadrature rules for the overlap of the given cut cells of
+    // each part
+    void _build_quadrature_rules_overlap
+      (std::size_t quadrature_order,
+       const std::vector<std::vector<unsigned int> >& cells);
+
+    // Build quadrature rules and normals for the interface of the
+    // given cut cells of each part
+    void _build_quadrature_rules_interface
+      (std::size_t quadrature_order,
+       const std::vector<std::vector<unsigned int> >& cells);
 
     // Help function to determine if interface intersection is
     // (exactly) overlapped by a cutting cell
@@ -16,21 +16,29 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2009-02-11
-// Last changed: 2014-02-06
+// Last changed: 2019-06-18
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <map>
+#include <numeric>
+#include <unordered_map>
 #include <vector>
 
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Threads.h>
 #include <dolfin/log/log.h>
-#include "Cell.h"
+#include <dolfin/parameter/GlobalParameters.h>
+#include "ConnectivityView.h"
 #include "Mesh.h"
+#include "MeshData.h"
 #include "MeshEditor.h"
-#include "MeshEntityIterator.h"
 #include "MeshFunction.h"
+#include "MeshGeometry.h"
+#include "MeshTopology.h"
 #include "SubDomain.h"
 #include "SubMesh.h"
-#include "Vertex.h"
 #include "MeshValueCollection.h"
 
 using namespace dolfin;
@@ -44,26 +52,25 @@ SubMesh::SubMesh(const Mesh& mesh, const SubDomain& sub_domain)
   sub_domains = 0;
   sub_domain.mark(sub_domains, 1);
 
-  // Copy data into std::vector
-  const std::vector<std::size_t> _sub_domains(sub_domains.values(),
-                                              sub_domains.values()
-                                              + sub_domains.size());
-
   // Create sub mesh
-  init(mesh, _sub_domains, 1);
+  init(mesh, sub_domains.values(), 1);
 }
 //-----------------------------------------------------------------------------
 SubMesh::SubMesh(const Mesh& mesh,
                  const MeshFunction<std::size_t>& sub_domains,
                  std::size_t sub_domain)
 {
-  // Copy data into std::vector
-  const std::vector<std::size_t> _sub_domains(sub_domains.values(),
-                                              sub_domains.values()
-                                              + sub_domains.size());
+  // Check that mesh function holds cell markers of mesh
+  if (sub_domains.dim() != mesh.topology().dim()
+      or sub_domains.size() != mesh.num_cells())
+  {
+    dolfin_error("SubMesh.cpp",
+                 "construct SubMesh",
+                 "Mesh function does not hold cell markers of the mesh");
+  }
 
   // Create sub mesh
-  init(mesh, _sub_domains, sub_domain);
+  init(mesh, sub_domains.values(), sub_domain);
 }
 //----------------------------------------------------------------------------
 SubMesh::SubMesh(const Mesh& mesh, std::size_t sub_domain)
@@ -90,7 +97,7 @@ SubMesh::SubMesh(const Mesh& mesh, std::size_t sub_domain)
     sub_domains[it->first] = it->second;
 
   // Create sub mesh
-  init(mesh, sub_domains, sub_domain);
+  init(mesh, sub_domains.data(), sub_domain);
 }
 //-----------------------------------------------------------------------------
 SubMesh::~SubMesh()
@@ -98,134 +105,380 @@ SubMesh::~SubMesh()
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-void SubMesh::init(const Mesh& mesh,
-                   const std::vector<std::size_t>& sub_domains,
-                   std::size_t sub_domain)
+bool SubMesh::update(const Mesh& mesh,
+                     const MeshFunction<std::size_t>& sub_domains,
+                     std::size_t sub_domain)
 {
-  // Open mesh for editing
-  MeshEditor editor;
+  // Check that mesh function holds cell markers of mesh
   const std::size_t D = mesh.topology().dim();
-  editor.open(*this, mesh.type().cell_type(), D,
-              mesh.geometry().dim());
+  if (sub_domains.dim() != D or sub_domains.size() != mesh.num_cells()
+      or topology().dim() != D or !data().exists("parent_cell_indices", D))
+  {
+    dolfin_error("SubMesh.cpp",
+                 "update SubMesh",
+                 "Mesh function does not hold cell markers of the parent mesh");
+  }
 
-  // Build set of cells that are in sub-mesh
-  std::vector<bool> parent_cell_in_subdomain(mesh.num_cells(), false);
-  std::set<std::size_t> submesh_cells;
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  // Check if cells of sub mesh have changed on any process
+  const std::vector<std::size_t> cells
+    = marked_cells(mesh, sub_domains.values(), sub_domain);
+  const std::size_t changed = (cells != parent_entity_indices(D));
+  if (MPI::max(mesh.mpi_comm(), changed) == 0)
+    return false;
+
+  // Update the vertices and entities extracted from the parent mesh
+  // from those of the current sub mesh, at a cost proportional to
+  // the size of the sub mesh and the change in cells
+  std::map<std::size_t, std::vector<std::size_t>> entities;
+  for (std::size_t d = 0; d < D; ++d)
   {
-    if (sub_domains[cell->index()] == sub_domain)
+    const std::string name = d == 0 ? "parent_vertex_indices"
+      : "parent_entity_indices";
+    if (data().exists(name, d) and !topology()(D, d).empty()
+        and !topology()(D, d).compressed())
     {
-      parent_cell_in_subdomain[cell->index()] = true;
-      submesh_cells.insert(cell->index());
+      entities[d] = updated_entities(mesh, d, cells);
     }
   }
 
-  // Map from parent vertex index to submesh vertex index
-  std::map<std::size_t, std::size_t> parent_to_submesh_vertex_indices;
-
-  // Map from submesh cell to parent cell
-  std::vector<std::size_t> submesh_cell_parent_indices;
-  submesh_cell_parent_indices.reserve(submesh_cells.size());
+  // Release data of old sub mesh and rebuild
+  release_derived_data();
+  for (std::size_t d = 0; d <= D; ++d)
+  {
+    for (auto name : {"parent_vertex_indices", "parent_entity_indices",
+                      "parent_cell_indices"})
+    {
+      if (data().exists(name, d))
+        data().erase_array(name, d);
+    }
+  }
+  build(mesh, cells, entities);
+  init_domains(mesh);
 
-  // Vector from parent cell index to submesh cell index
-  std::vector<std::size_t> parent_to_submesh_cell_indices(mesh.num_cells(), 0);
+  return true;
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::size_t>&
+SubMesh::parent_entity_indices(std::size_t dim) const
+{
+  const std::size_t D = topology().dim();
+  std::string name = "parent_entity_indices";
+  if (dim == 0)
+    name = "parent_vertex_indices";
+  else if (dim == D)
+    name = "parent_cell_indices";
+
+  if (dim > D or !data().exists(name, dim))
+  {
+    dolfin_error("SubMesh.cpp",
+                 "return parent entity indices of SubMesh",
+                 "Entities of dimension %d have not been mapped to the parent mesh",
+                 dim);
+  }
 
-  // Add sub-mesh cells
-  editor.init_cells_global(submesh_cells.size(), submesh_cells.size());
-  std::size_t current_cell = 0;
-  std::size_t current_vertex = 0;
-  for (std::set<std::size_t>::iterator cell_it = submesh_cells.begin();
-       cell_it != submesh_cells.end(); ++cell_it)
+  return data().array(name, dim);
+}
+//-----------------------------------------------------------------------------
+void SubMesh::init(const Mesh& mesh, const std::size_t* sub_domains,
+                   std::size_t sub_domain)
+{
+  // Compute parent entities which carry markers, so they are
+  // extracted with the sub mesh
+  const MeshDomains& parent_domains = mesh.domains();
+  for (std::size_t dim_t = 0; dim_t <= parent_domains.max_dim(); dim_t++)
   {
-    // Data structure to hold new vertex indices for cell
-    std::vector<std::size_t> cell_vertices;
+    if (parent_domains.num_marked(dim_t) > 0)
+      mesh.init(dim_t);
+  }
+
+  // Build sub mesh from marked cells
+  build(mesh, marked_cells(mesh, sub_domains, sub_domain), {});
 
-    // Create cell
-    Cell cell(mesh, *cell_it);
+  // Map markers from parent mesh
+  init_domains(mesh);
+}
+//-----------------------------------------------------------------------------
+void SubMesh::build(const Mesh& mesh, const std::vector<std::size_t>& cells,
+                    const std::map<std::size_t, std::vector<std::size_t>>& entities)
+{
+  // The sub mesh arrays are filled directly from views of the parent
+  // mesh. Vertices are numbered locally in the order of the parent
+  // mesh vertices, and globally in the order of their global indices
+  // in the parent mesh, so that the local vertex order of each cell
+  // (and hence the ordering of the mesh) is preserved.
 
-    // Iterate over cell vertices
-    for (VertexIterator vertex(cell); !vertex.end(); ++vertex)
+  // Open mesh for editing
+  MeshEditor editor;
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  editor.open(*this, mesh.type().cell_type(), D, gdim);
+
+  // Find vertices of sub mesh cells, unless given
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const ConnectivityView cell_vertices(mesh, D, 0, true);
+  auto given_vertices = entities.find(0);
+  const std::vector<std::size_t> vertices = given_vertices != entities.end()
+    ? given_vertices->second : attached_entities(mesh, 0, cells);
+
+  // Map from parent vertex to sub mesh vertex
+  std::vector<std::size_t>
+    parent_to_sub_vertex(mesh.num_vertices(),
+                         std::numeric_limits<std::size_t>::max());
+  Threads::parallel_for(vertices.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+        parent_to_sub_vertex[vertices[i]] = i;
+    });
+
+  // Number vertices across processes
+  std::vector<std::int64_t> vertex_global_indices;
+  std::map<std::int32_t, std::set<unsigned int>> shared_vertices;
+  const std::size_t num_global_vertices
+    = number_entities(mesh, 0, vertices, parent_to_sub_vertex,
+                      vertex_global_indices, shared_vertices);
+
+  // Copy vertex coordinates
+  const std::vector<double>& x = mesh.geometry().x();
+  std::vector<double> sub_x(gdim*vertices.size());
+  Threads::parallel_for(vertices.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
     {
-      const std::size_t parent_vertex_index = vertex->index();
-
-      // Look for parent vertex in map
-      std::map<std::size_t, std::size_t>::iterator vertex_it
-        = parent_to_submesh_vertex_indices.find(parent_vertex_index);
-
-      // If vertex has been inserted, get new index, otherwise
-      // increment and insert
-      std::size_t submesh_vertex_index = 0;
-      if (vertex_it != parent_to_submesh_vertex_indices.end())
-        submesh_vertex_index = vertex_it->second;
-      else
+      for (std::size_t i = begin; i < end; ++i)
       {
-        submesh_vertex_index = current_vertex++;
-        parent_to_submesh_vertex_indices[parent_vertex_index]
-          = submesh_vertex_index;
+        const std::size_t v = vertices[i];
+        std::copy(x.begin() + v*gdim, x.begin() + (v + 1)*gdim,
+                  sub_x.begin() + i*gdim);
       }
-
-      // Add vertex to list of cell vertices (new indexing)
-      cell_vertices.push_back(submesh_vertex_index);
+    });
+  editor.set_vertices_global(std::move(sub_x),
+                             std::move(vertex_global_indices),
+                             num_global_vertices, false);
+
+  // Create cells, numbered consecutively across processes
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(D);
+  const std::size_t cell_offset
+    = MPI::global_offset(mesh.mpi_comm(), cells.size(), true);
+  std::vector<unsigned int> sub_cells(num_cell_vertices*cells.size());
+  std::vector<std::int64_t> cell_global_indices(cells.size());
+  Threads::parallel_for(cells.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t c = begin; c < end; ++c)
+      {
+        const ArrayView<const unsigned int> parent_vertices
+          = cell_vertices[cells[c]];
+        for (std::size_t i = 0; i < num_cell_vertices; ++i)
+        {
+          sub_cells[c*num_cell_vertices + i]
+            = parent_to_sub_vertex[parent_vertices[i]];
+        }
+        cell_global_indices[c] = cell_offset + c;
+      }
+    });
+  editor.set_cells_global(std::move(sub_cells), std::move(cell_global_indices),
+                          MPI::sum(mesh.mpi_comm(), cells.size()), false);
+  topology().shared_entities(0) = std::move(shared_vertices);
+
+  // Close editor and order the sub mesh if needed, which is only
+  // the case if the parent mesh is not ordered
+  editor.close(false);
+  const bool same_order = ordered();
+  if (!same_order)
+    order();
+
+  // Build submesh-to-parent map for vertices and cells
+  data().create_array("parent_vertex_indices", 0) = vertices;
+  data().create_array("parent_cell_indices", D) = cells;
+
+  // Extract entities which have been computed for the parent
+  // mesh. This relies on the cell vertices being in the same order
+  // as in the parent mesh, and on the parent entities being
+  // ordered. The decisions are made on all processes together, since
+  // numbering the entities is collective.
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t inherit = mesh.ordered() and same_order;
+  if (MPI::min(mpi_comm, inherit) == 0)
+  {
+    // Otherwise, map only entities which carry markers, after
+    // computing them for the sub mesh
+    const MeshDomains& parent_domains = mesh.domains();
+    for (std::size_t d = 1; d < D and d <= parent_domains.max_dim(); ++d)
+    {
+      if (parent_domains.num_marked(d) > 0)
+        map_entities(mesh, d, cells, vertices);
     }
-
-    // Add parent cell index to list
-    submesh_cell_parent_indices.push_back(cell.index());
-
-    // Store parent cell -> submesh cell indices
-    parent_to_submesh_cell_indices[cell.index()] = current_cell;
-
-    // Add cell to mesh
-    editor.add_cell(current_cell++, cell_vertices);
+    return;
   }
-
-  // Vector to hold submesh vertex -> parent vertex
-  std::vector<std::size_t> parent_vertex_indices;
-  parent_vertex_indices.resize(parent_to_submesh_vertex_indices.size());
-
-  // Initialise mesh editor
-  editor.init_vertices_global(parent_to_submesh_vertex_indices.size(),
-                              parent_to_submesh_vertex_indices.size());
-
-  // Add vertices
-  for (std::map<std::size_t, std::size_t>::iterator it
-         = parent_to_submesh_vertex_indices.begin();
-       it != parent_to_submesh_vertex_indices.end(); ++it)
+  for (std::size_t d = 1; d < D; ++d)
   {
-    Vertex vertex(mesh, it->first);
-    if (MPI::size(mesh.mpi_comm()) > 1)
-      not_working_in_parallel("SubMesh::init");
+    // Skip entities which have not been computed, and compressed
+    // connectivity unless needed for markers
+    const bool compressed = mesh.topology()(D, d).compressed()
+      or mesh.topology()(d, 0).compressed();
+    const std::size_t extract
+      = (mesh.topology().size(d) > 0 or mesh.num_cells() == 0)
+      and (!compressed or mesh.domains().num_marked(d) > 0);
+    if (MPI::min(mpi_comm, extract) == 0)
+      continue;
 
-    // FIXME: Get global vertex index
-    editor.add_vertex(it->second, vertex.point());
-    parent_vertex_indices[it->second] = it->first;
+    auto given_entities = entities.find(d);
+    if (given_entities != entities.end())
+      init_entities(mesh, d, cells, given_entities->second,
+                    parent_to_sub_vertex);
+    else
+    {
+      init_entities(mesh, d, cells, attached_entities(mesh, d, cells),
+                    parent_to_sub_vertex);
+    }
   }
+}
+//-----------------------------------------------------------------------------
+void SubMesh::init_entities(const Mesh& mesh, std::size_t dim,
+                            const std::vector<std::size_t>& cells,
+                            const std::vector<std::size_t>& entities,
+                            const std::vector<std::size_t>& parent_to_sub_vertex)
+{
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const ConnectivityView cell_entities(mesh, D, dim, true);
+  const ConnectivityView entity_vertices(mesh, dim, 0, true);
+
+  // Map from parent entity to sub mesh entity
+  std::vector<std::size_t>
+    parent_to_sub(mesh.num_entities(dim),
+                  std::numeric_limits<std::size_t>::max());
+  Threads::parallel_for(entities.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+        parent_to_sub[entities[i]] = i;
+    });
+
+  // Entity - vertex connectivity
+  const std::size_t num_entity_vertices = mesh.type().num_vertices(dim);
+  std::vector<unsigned int> sub_entity_vertices(num_entity_vertices
+                                                *entities.size());
+  Threads::parallel_for(entities.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t e = begin; e < end; ++e)
+      {
+        const ArrayView<const unsigned int> parent_vertices
+          = entity_vertices[entities[e]];
+        for (std::size_t i = 0; i < num_entity_vertices; ++i)
+        {
+          sub_entity_vertices[e*num_entity_vertices + i]
+            = parent_to_sub_vertex[parent_vertices[i]];
+        }
+      }
+    });
 
-  // Close editor
-  editor.close();
-
-  // Build submesh-to-parent map for vertices
-  std::vector<std::size_t>& parent_vertex_indices_mf
-    = data().create_array("parent_vertex_indices", 0);
-  parent_vertex_indices_mf.resize(num_vertices());
-  for (std::map<std::size_t, std::size_t>::iterator it
-         = parent_to_submesh_vertex_indices.begin();
-       it != parent_to_submesh_vertex_indices.end(); ++it)
+  // Cell - entity connectivity
+  const std::size_t num_cell_entities = mesh.type().num_entities(dim);
+  std::vector<unsigned int> sub_cell_entities(num_cell_entities*cells.size());
+  Threads::parallel_for(cells.size(), num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t c = begin; c < end; ++c)
+      {
+        const ArrayView<const unsigned int> parent_entities
+          = cell_entities[cells[c]];
+        for (std::size_t i = 0; i < num_cell_entities; ++i)
+        {
+          sub_cell_entities[c*num_cell_entities + i]
+            = parent_to_sub[parent_entities[i]];
+        }
+      }
+    });
+
+  // Initialise entities. Global indices are transferred if the
+  // parent entities have been numbered, otherwise they are computed
+  // when needed.
+  MeshTopology& topology = this->topology();
+  std::size_t num_global_entities = 0;
+  const std::size_t have_global_indices
+    = mesh.topology().have_global_indices(dim);
+  if (MPI::max(mesh.mpi_comm(), have_global_indices) > 0)
   {
-    parent_vertex_indices_mf[it->second] = it->first;
+    std::vector<std::int64_t> global_indices;
+    std::map<std::int32_t, std::set<unsigned int>> shared_entities;
+    num_global_entities = number_entities(mesh, dim, entities, parent_to_sub,
+                                          global_indices, shared_entities);
+    topology.set_global_indices(dim, std::move(global_indices));
+    topology.shared_entities(dim) = std::move(shared_entities);
   }
-
-  // Build submesh-to-parent map for cells
-  std::vector<std::size_t>& parent_cell_indices
-    = data().create_array("parent_cell_indices", D);
-  parent_cell_indices.resize(num_cells());
-  current_cell = 0;
-  for (std::vector<std::size_t>::iterator it
-         = submesh_cell_parent_indices.begin();
-       it != submesh_cell_parent_indices.end(); ++it)
+  topology.init(dim, entities.size(), num_global_entities);
+  topology.init_ghost(dim, entities.size());
+  if (num_entity_vertices > 0 and !entities.empty())
+    topology(dim, 0).set(std::move(sub_entity_vertices), num_entity_vertices);
+  if (num_cell_entities > 0 and !cells.empty())
+    topology(D, dim).set(std::move(sub_cell_entities), num_cell_entities);
+
+  // Build submesh-to-parent map for entities
+  data().create_array("parent_entity_indices", dim) = entities;
+}
+//-----------------------------------------------------------------------------
+void SubMesh::map_entities(const Mesh& mesh, std::size_t dim,
+                           const std::vector<std::size_t>& cells,
+                           const std::vector<std::size_t>& vertices)
+{
+  std::vector<std::size_t> parent_entities;
+  if (!cells.empty())
   {
-    parent_cell_indices[current_cell++] = *it;
+    // Compute entities of sub mesh, which is ordered
+    const std::size_t D = mesh.topology().dim();
+    init(dim);
+    const ConnectivityView cell_entities(*this, D, dim, true);
+    const ConnectivityView entity_vertices(*this, dim, 0, true);
+    const ConnectivityView parent_cell_entities(mesh, D, dim, true);
+    const ConnectivityView parent_entity_vertices(mesh, dim, 0, true);
+    parent_entities.resize(num_entities(dim));
+
+    // Match the entities of each sub mesh cell with the entities of
+    // the parent cell by their (sorted) parent vertices, as the local
+    // numbering of the entities of the cells may differ
+    const std::size_t num_cell_entities = mesh.type().num_entities(dim);
+    const std::size_t num_entity_vertices = mesh.type().num_vertices(dim);
+    std::vector<std::size_t> key(num_entity_vertices);
+    std::vector<std::size_t> parent_key(num_entity_vertices);
+    for (std::size_t c = 0; c < cells.size(); ++c)
+    {
+      const ArrayView<const unsigned int> sub = cell_entities[c];
+      const ArrayView<const unsigned int> parent
+        = parent_cell_entities[cells[c]];
+      for (std::size_t i = 0; i < num_cell_entities; ++i)
+      {
+        const ArrayView<const unsigned int> sub_vertices
+          = entity_vertices[sub[i]];
+        for (std::size_t k = 0; k < num_entity_vertices; ++k)
+          key[k] = vertices[sub_vertices[k]];
+        std::sort(key.begin(), key.end());
+
+        for (std::size_t j = 0; j < num_cell_entities; ++j)
+        {
+          const ArrayView<const unsigned int> parent_vertices
+            = parent_entity_vertices[parent[j]];
+          std::copy(parent_vertices.begin(), parent_vertices.end(),
+                    parent_key.begin());
+          std::sort(parent_key.begin(), parent_key.end());
+          if (parent_key == key)
+          {
+            parent_entities[sub[i]] = parent[j];
+            break;
+          }
+        }
+      }
+    }
   }
 
+  // Build submesh-to-parent map for entities
+  data().create_array("parent_entity_indices", dim)
+    = std::move(parent_entities);
+}
+//-----------------------------------------------------------------------------
+void SubMesh::init_domains(const Mesh& mesh)
+{
   // Initialise present MeshDomain
   const MeshDomains& parent_domains = mesh.domains();
   this->domains().init(parent_domains.max_dim());
@@ -237,86 +490,231 @@ void SubMesh::init(const Mesh& mesh,
     if (parent_domains.num_marked(dim_t) == 0)
       continue;
 
-    // Initialise connectivity
-    mesh.init(dim_t, D);
-
-    // FIXME: Can avoid building this map for cell and vertices
-
-    // Build map from submesh entity (parent vertex list) -> (submesh index)
-    mesh.init(dim_t);
-    std::map<std::vector<std::size_t>, std::size_t> entity_map;
-    for (MeshEntityIterator e(*this, dim_t); !e.end(); ++e)
-    {
-      // Build list of entity vertex indices and sort
-      std::vector<std::size_t> vertex_list;
-      for (VertexIterator v(*e); !v.end(); ++v)
-        vertex_list.push_back(parent_vertex_indices[v->index()]);
-      std::sort(vertex_list.begin(), vertex_list.end());
-      entity_map.insert(std::make_pair(vertex_list, e->index()));
-    }
-
-    // Get submesh marker map
+    // Build map from parent entity to sub mesh entity. Parent
+    // entities are included in the sub mesh if attached to a sub
+    // mesh cell.
+    const std::vector<std::size_t>& parent_entities
+      = parent_entity_indices(dim_t);
+    std::vector<std::size_t>
+      parent_to_sub(mesh.num_entities(dim_t),
+                    std::numeric_limits<std::size_t>::max());
+    for (std::size_t i = 0; i < parent_entities.size(); ++i)
+      parent_to_sub[parent_entities[i]] = i;
+
+    // Map markers from parent mesh to submesh
     std::map<std::size_t, std::size_t>& submesh_markers
       = this->domains().markers(dim_t);
-
-    // Get values map from parent MeshValueCollection
     const std::map<std::size_t, std::size_t>& parent_markers
       = parent_domains.markers(dim_t);
+    for (auto& marker : parent_markers)
+    {
+      const std::size_t e = parent_to_sub[marker.first];
+      if (e != std::numeric_limits<std::size_t>::max())
+        submesh_markers[e] = marker.second;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> SubMesh::marked_cells(const Mesh& mesh,
+                                               const std::size_t* sub_domains,
+                                               std::size_t sub_domain)
+{
+  // Mark owned cells in sub domain
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const std::size_t num_cells
+    = mesh.topology().ghost_offset(mesh.topology().dim());
+  std::vector<std::uint8_t> cell_marker(num_cells);
+  Threads::parallel_for(num_cells, num_threads,
+                        [&](std::size_t begin, std::size_t end, std::size_t)
+    {
+      for (std::size_t c = begin; c < end; ++c)
+        cell_marker[c] = (sub_domains[c] == sub_domain);
+    });
 
-    // Iterate over all parents marker values
-    std::map<std::size_t, std::size_t>::const_iterator itt;
-    for (itt = parent_markers.begin(); itt != parent_markers.end(); itt++)
+  return Threads::marked_indices(cell_marker, num_threads);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t>
+SubMesh::attached_entities(const Mesh& mesh, std::size_t dim,
+                           const std::vector<std::size_t>& cells)
+{
+  // Mark entities of cells, numbered in the order of the parent mesh
+  // entities
+  const std::size_t num_threads = dolfin::parameters["num_threads"];
+  const ConnectivityView cell_entities(mesh, mesh.topology().dim(), dim,
+                                       true);
+  std::vector<std::uint8_t> entity_marker(mesh.num_entities(dim), 0);
+  for (auto c : cells)
+    for (auto e : cell_entities[c])
+      entity_marker[e] = 1;
+
+  return Threads::marked_indices(entity_marker, num_threads);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t>
+SubMesh::updated_entities(const Mesh& mesh, std::size_t dim,
+                          const std::vector<std::size_t>& cells) const
+{
+  const std::size_t D = topology().dim();
+  const std::vector<std::size_t>& old_cells = parent_entity_indices(D);
+  const std::vector<std::size_t>& old_entities = parent_entity_indices(dim);
+  const ConnectivityView sub_cell_entities(*this, D, dim, true);
+  const ConnectivityView cell_entities(mesh, D, dim, true);
+
+  // Keep entities of the current sub mesh attached to kept cells, and
+  // collect the parent entities of added cells (both lists of cells
+  // are sorted)
+  std::vector<std::uint8_t> kept(old_entities.size(), 0);
+  std::vector<std::size_t> added;
+  auto old_cell = old_cells.begin();
+  for (auto c : cells)
+  {
+    while (old_cell != old_cells.end() and *old_cell < c)
+      ++old_cell;
+    if (old_cell != old_cells.end() and *old_cell == c)
+    {
+      for (auto e : sub_cell_entities[old_cell - old_cells.begin()])
+        kept[e] = 1;
+    }
+    else
     {
-      // Create parent entity
-      const MeshEntity parent_entity(mesh, dim_t, itt->first);
+      for (auto e : cell_entities[c])
+        added.push_back(e);
+    }
+  }
+  std::sort(added.begin(), added.end());
+  added.erase(std::unique(added.begin(), added.end()), added.end());
 
-      // FIXME: Need to check all attached cells
-      std::size_t parent_cell_index = std::numeric_limits<std::size_t>::max();
-      if (dim_t == D)
-      {
-        parent_cell_index = itt->first;
-      }
-      else
-      {
-        // Get first parent cell index attached to parent entity
-        for (std::size_t i = 0; i < parent_entity.num_entities(D); ++i)
-        {
-          if (sub_domains[parent_entity.entities(D)[i]] == sub_domain)
-          {
-            parent_cell_index = parent_entity.entities(D)[i];
-            break;
-          }
-        }
-      }
+  // Merge kept and added entities
+  std::vector<std::size_t> entities;
+  for (std::size_t i = 0; i < old_entities.size(); ++i)
+  {
+    if (kept[i])
+      entities.push_back(old_entities[i]);
+  }
+  std::vector<std::size_t> merged;
+  merged.reserve(entities.size() + added.size());
+  std::set_union(entities.begin(), entities.end(), added.begin(), added.end(),
+                 std::back_inserter(merged));
 
-      // Check if the cell is included in the submesh
-      if (sub_domains[parent_cell_index] == sub_domain)
-      {
-        // Map markers from parent mesh to submesh
-	if (dim_t == D)
-        {
-          // Get submesh cell index
-          const std::size_t submesh_cell_index
-            = parent_to_submesh_cell_indices[parent_cell_index];
-	  submesh_markers[submesh_cell_index] = itt->second;
-        }
-	else
-	{
-          std::vector<std::size_t> parent_vertex_list;
-          for (VertexIterator v(parent_entity); !v.end(); ++v)
-            parent_vertex_list.push_back(v->index());
-          std::sort(parent_vertex_list.begin(), parent_vertex_list.end());
-
-          // Get submesh entity index
-          std::map<std::vector<std::size_t>, std::size_t>::const_iterator
-            submesh_it = entity_map.find(parent_vertex_list);
-          dolfin_assert(submesh_it != entity_map.end());
-
-          submesh_markers[submesh_it->second] = itt->second;
-	}
-      }
+  return merged;
+}
+//-----------------------------------------------------------------------------
+std::size_t SubMesh::number_entities(
+  const Mesh& mesh, std::size_t dim,
+  const std::vector<std::size_t>& parent_entities,
+  const std::vector<std::size_t>& parent_to_sub,
+  std::vector<std::int64_t>& global_indices,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_entities)
+{
+  const std::size_t num_entities = parent_entities.size();
+  global_indices.resize(num_entities);
+  shared_entities.clear();
+
+  // Sub mesh entities are numbered in the order of the global indices
+  // of the parent entities, so that the sub mesh is ordered (see
+  // MeshOrdering) if the parent mesh is
+  const MeshTopology& parent_topology = mesh.topology();
+  const std::vector<std::int64_t>& parent_global_indices
+    = parent_topology.global_indices(dim);
+
+  // Number entities locally if not running in parallel
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  if (num_processes == 1)
+  {
+    std::vector<std::size_t> order(num_entities);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t i, std::size_t j)
+              {
+                return parent_global_indices[parent_entities[i]]
+                  < parent_global_indices[parent_entities[j]];
+              });
+    for (std::size_t i = 0; i < num_entities; ++i)
+      global_indices[order[i]] = i;
+    return num_entities;
+  }
+
+  // Send global index of shared parent entities in sub mesh to the
+  // processes sharing the parent entity
+  const std::map<std::int32_t, std::set<unsigned int>> no_shared_entities;
+  const std::map<std::int32_t, std::set<unsigned int>>& parent_shared
+    = parent_topology.have_shared_entities(dim)
+    ? parent_topology.shared_entities(dim) : no_shared_entities;
+  std::unordered_map<std::int64_t, std::size_t> global_to_sub;
+  std::vector<std::vector<std::int64_t>> send_entities(num_processes);
+  for (auto& e : parent_shared)
+  {
+    const std::size_t sub_index = parent_to_sub[e.first];
+    if (sub_index == std::numeric_limits<std::size_t>::max())
+      continue;
+    const std::int64_t global_index = parent_global_indices[e.first];
+    global_to_sub[global_index] = sub_index;
+    for (auto p : e.second)
+      send_entities[p].push_back(global_index);
+  }
+  std::vector<std::vector<std::int64_t>> recv_entities(num_processes);
+  MPI::all_to_all(mpi_comm, send_entities, recv_entities);
+
+  // Sub mesh entities are shared with the processes which have sent
+  // them
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    for (auto global_index : recv_entities[p])
+    {
+      auto it = global_to_sub.find(global_index);
+      if (it != global_to_sub.end())
+        shared_entities[it->second].insert(p);
     }
   }
 
+  // Send the parent global index of each sub mesh entity to the
+  // process holding it in a block distribution of the parent
+  // entities
+  const std::size_t num_global_parent = parent_topology.size_global(dim);
+  for (auto& send : send_entities)
+    send.clear();
+  for (auto e : parent_entities)
+  {
+    const std::int64_t global_index = parent_global_indices[e];
+    send_entities[MPI::index_owner(mpi_comm, global_index,
+                                   num_global_parent)].push_back(global_index);
+  }
+  MPI::all_to_all(mpi_comm, send_entities, recv_entities);
+
+  // Number the distinct received parent entities consecutively in
+  // the order of their global index
+  const std::pair<std::int64_t, std::int64_t> range
+    = MPI::local_range(mpi_comm, num_global_parent);
+  std::vector<std::int64_t> numbering(range.second - range.first, -1);
+  for (auto& recv : recv_entities)
+    for (auto global_index : recv)
+      numbering[global_index - range.first] = 1;
+  const std::size_t num_numbered
+    = std::count(numbering.begin(), numbering.end(), 1);
+  std::int64_t index = MPI::global_offset(mpi_comm, num_numbered, true);
+  for (auto& n : numbering)
+  {
+    if (n != -1)
+      n = index++;
+  }
+
+  // Return global indices in the order they were received
+  for (auto& recv : recv_entities)
+    for (auto& global_index : recv)
+      global_index = numbering[global_index - range.first];
+  MPI::all_to_all(mpi_comm, recv_entities, send_entities);
+  std::vector<std::size_t> pos(num_processes, 0);
+  for (std::size_t i = 0; i < num_entities; ++i)
+  {
+    const std::int64_t global_index
+      = parent_global_indices[parent_entities[i]];
+    const std::size_t p = MPI::index_owner(mpi_comm, global_index,
+                                           num_global_parent);
+    global_indices[i] = send_entities[p][pos[p]++];
+  }
+
+  return MPI::sum(mpi_comm, num_numbered);
 }
 //-----------------------------------------------------------------------------
@@ -16,12 +16,15 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2009-02-11
-// Last changed: 2013-02-11
+// Last changed: 2019-06-18
 
 #ifndef __SUB_MESH_H
 #define __SUB_MESH_H
 
+#include <cstdint>
 #include <map>
+#include <set>
+#include <vector>
 #include "Mesh.h"
 
 namespace dolfin
@@ -35,7 +38,23 @@ namespace dolfin
   /// multiphysics applications by creating meshes for subdomains as
   /// subsets of a single global mesh. A mapping from the vertices of
   /// the sub mesh to the vertices of the parent mesh is stored as the
-  /// mesh data named "parent_vertex_indices".
+  /// mesh data named "parent_vertex_indices", and a mapping from the
+  /// cells of the sub mesh to the cells of the parent mesh as the
+  /// mesh data named "parent_cell_indices".
+  ///
+  /// For a distributed mesh, each process extracts the sub mesh from
+  /// the cells it owns (ghost cells are not included), and vertices
+  /// shared with other processes are numbered consistently. Vertices
+  /// and cells of the sub mesh are numbered locally in the order of
+  /// the parent mesh, and vertices are numbered globally in the order
+  /// of their global indices in the parent mesh. The sub mesh is
+  /// therefore ordered if the parent mesh is, and in that case mesh
+  /// entities of intermediate dimension which have been computed for
+  /// the parent mesh are extracted with their connectivity instead of
+  /// being recomputed, and mapped to the parent mesh by the mesh data
+  /// named "parent_entity_indices". Otherwise, only entities which
+  /// carry markers in the parent mesh are computed for the sub mesh
+  /// and mapped to the parent mesh.
 
   class SubMesh : public Mesh
   {
@@ -54,12 +73,97 @@ namespace dolfin
     /// Destructor
     ~SubMesh();
 
+    // Bring init functions from Mesh into scope
+    using Mesh::init;
+
+    /// Rebuild sub mesh from changed markers. The sub mesh is left
+    /// unchanged if it contains the same cells as before, otherwise
+    /// it is rebuilt (and objects such as function spaces created on
+    /// the sub mesh become invalid). The vertices and entities of the
+    /// rebuilt sub mesh are found from those of the current sub mesh
+    /// and the changed cells. This is collective.
+    ///
+    /// @param  mesh (_Mesh_)
+    ///         The parent mesh the sub mesh was created from.
+    /// @param  sub_domains (_MeshFunction_)
+    ///         Cell markers.
+    /// @param  sub_domain (std::size_t)
+    ///         Marker of the cells in the sub mesh.
+    ///
+    /// @return bool
+    ///         True if the sub mesh was rebuilt.
+    bool update(const Mesh& mesh, const MeshFunction<std::size_t>& sub_domains,
+                std::size_t sub_domain);
+
+    /// Return map from sub mesh entities of given dimension to
+    /// entities of the parent mesh
+    ///
+    /// @param  dim (std::size_t)
+    ///         Topological dimension.
+    ///
+    /// @return std::vector<std::size_t>
+    ///         Parent entity index of each sub mesh entity.
+    const std::vector<std::size_t>& parent_entity_indices(std::size_t dim) const;
+
   private:
 
-    /// Create sub mesh
-    void init(const Mesh& mesh, const std::vector<std::size_t>& sub_domains,
+    // Create sub mesh
+    void init(const Mesh& mesh, const std::size_t* sub_domains,
               std::size_t sub_domain);
 
+    // Build sub mesh from given (sorted) cells of parent mesh. The
+    // (sorted) parent entities attached to the cells may be given for
+    // some dimensions, otherwise they are computed.
+    void build(const Mesh& mesh, const std::vector<std::size_t>& cells,
+               const std::map<std::size_t, std::vector<std::size_t>>& entities);
+
+    // Extract given mesh entities of dimension dim, with entity -
+    // vertex and cell - entity connectivity, from the parent mesh
+    void init_entities(const Mesh& mesh, std::size_t dim,
+                       const std::vector<std::size_t>& cells,
+                       const std::vector<std::size_t>& entities,
+                       const std::vector<std::size_t>& parent_to_sub_vertex);
+
+    // Compute mesh entities of dimension dim for the sub mesh, and
+    // map them to the entities of the parent mesh. Used for marked
+    // entities when these can not be extracted from the parent mesh.
+    void map_entities(const Mesh& mesh, std::size_t dim,
+                      const std::vector<std::size_t>& cells,
+                      const std::vector<std::size_t>& vertices);
+
+    // Return (sorted) parent entities of dimension dim attached to
+    // given cells of parent mesh
+    static std::vector<std::size_t>
+      attached_entities(const Mesh& mesh, std::size_t dim,
+                        const std::vector<std::size_t>& cells);
+
+    // Return (sorted) parent entities of dimension dim attached to
+    // given cells of parent mesh, computed from the entities of this
+    // sub mesh and the change in cells
+    std::vector<std::size_t>
+      updated_entities(const Mesh& mesh, std::size_t dim,
+                       const std::vector<std::size_t>& cells) const;
+
+    // Map MeshValueCollections of parent mesh to sub mesh
+    void init_domains(const Mesh& mesh);
+
+    // Return (sorted) indices of owned cells of mesh with given marker
+    static std::vector<std::size_t>
+      marked_cells(const Mesh& mesh, const std::size_t* sub_domains,
+                   std::size_t sub_domain);
+
+    // Compute global indices and shared entities of sub mesh
+    // entities of dimension dim from those of the parent entities,
+    // and return the global number of entities. Global indices are
+    // in the order of the global indices of the parent entities.
+    static std::size_t
+      number_entities(const Mesh& mesh, std::size_t dim,
+                      const std::vector<std::size_t>& parent_entities,
+                      const std::vector<std::size_t>& parent_to_sub,
+                      std::vector<std::int64_t>& global_indices,
+                      std::map<std::int32_t, std::set<unsigned int>>&
+                      shared_entities);
+
   };
 
 }
@@ -16,18 +16,21 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 #include <boost/multi_array.hpp>
-#include <boost/unordered_map.hpp>
-#include <boost/version.hpp>
 
+#include <dolfin/common/RadixSort.h>
+#include <dolfin/common/Threads.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Cell.h"
 #include "CellType.h"
 #include "Mesh.h"
@@ -185,7 +188,7 @@ std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
   const CellType& cell_type = mesh.type();
 
   // Initialize local array of entities
-  const std::int8_t num_entities = cell_type.num_entities(dim);
+  const int num_entities = cell_type.num_entities(dim);
   const int num_vertices = cell_type.num_vertices(dim);
 
   // Create map from cell vertices to entity vertices
@@ -198,123 +201,145 @@ std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
 
   dolfin_assert(N == num_vertices);
 
-  // Create data structure to hold entities
-  // ([vertices key], (cell_local_index, cell index), [entity vertices], entity index)
-  std::vector<std::tuple<std::array<std::int32_t, N>,
-                         std::pair<std::int8_t, std::int32_t>,
-                         std::array<std::int32_t, N>, std::int32_t>>
-    keyed_entities(num_entities*mesh.num_cells());
-
-  // Loop over cells to build list of keyed (by vertices) entities
-  int entity_counter = 0;
-  for (CellIterator c(mesh, "all"); !c.end(); ++c)
+  const std::size_t num_threads = parameters["num_threads"];
+  const MeshConnectivity& cv = topology(topology.dim(), 0);
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t ghost_offset = topology.ghost_offset(topology.dim());
+
+  // Create data structure to hold entities, keyed by the sorted
+  // vertices. The local index is stored as num_entities - 1 - i for
+  // entities of non-ghost cells and as num_entities + i for entities
+  // of ghost cells. This ensures that non-ghosts come before ghosts
+  // when sorted. The index is corrected later.
+  struct KeyedEntity
   {
-    // Get vertices from cell
-    const unsigned int* vertices = c->entities(0);
-    dolfin_assert(vertices);
+    std::array<std::uint32_t, N> key;
+    std::int32_t cell;
+    std::int32_t local;
+  };
+  std::vector<KeyedEntity> keyed_entities(num_entities*num_cells);
 
-    // Iterate over entities of cell
-    const int cell_index = c->index();
-    for (std::int8_t i = 0; i < num_entities; ++i)
+  // Loop over cells to build list of keyed (by vertices) entities
+  Threads::parallel_for(num_cells, num_threads,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
     {
-      // Get entity vertices
-      auto& entity = std::get<2>(keyed_entities[entity_counter]);
-      for (std::int8_t j = 0; j < num_vertices; ++j)
-        entity[j] = vertices[e_vertices[i][j]];
-
-      // Sort entity vertices to create key
-      auto& entity_key = std::get<0>(keyed_entities[entity_counter]);
-      std::partial_sort_copy(entity.begin(), entity.end(),
-                             entity_key.begin(), entity_key.end());
-
-      // Attach (local index, cell index), making local_index negative
-      // if it is not a ghost cell. This ensures that non-ghosts come
-      // before ghosts when sorted. The index is corrected later.
-      if (!c->is_ghost())
-        std::get<1>(keyed_entities[entity_counter]) = {-i - 1, cell_index};
-      else
-        std::get<1>(keyed_entities[entity_counter]) = {i, cell_index};
-
-      // Increment entity counter
-      ++entity_counter;
-    }
+      for (std::size_t c = begin; c < end; ++c)
+      {
+        // Get vertices from cell
+        const unsigned int* vertices = cv(c);
+        dolfin_assert(vertices);
+
+        // Iterate over entities of cell
+        for (int i = 0; i < num_entities; ++i)
+        {
+          // Sort entity vertices to create key
+          KeyedEntity& entity = keyed_entities[c*num_entities + i];
+          for (int j = 0; j < N; ++j)
+            entity.key[j] = vertices[e_vertices[i][j]];
+          std::sort(entity.key.begin(), entity.key.end());
+
+          entity.cell = c;
+          entity.local = (c < ghost_offset) ? (num_entities - 1 - i)
+            : (num_entities + i);
+        }
+      }
+    });
+
+  // Sort entities by key with a stable radix sort, one vertex at a
+  // time. For the same key, those belonging to non-ghost cells will
+  // appear before those belonging to ghost cells, and entities of
+  // the same local index are ordered by cell index.
+  const std::uint32_t max_vertex = std::max<std::size_t>(mesh.num_vertices(), 1) - 1;
+  RadixSort::sort(keyed_entities,
+                  [](const KeyedEntity& e) { return e.local; },
+                  2*num_entities - 1, num_threads);
+  for (int j = N - 1; j >= 0; --j)
+  {
+    RadixSort::sort(keyed_entities,
+                    [j](const KeyedEntity& e) { return e.key[j]; },
+                    max_vertex, num_threads);
   }
 
-  // Sort entities by key. For the same key, those beloning to
-  // non-ghost cells will appear before those belonging to ghost
-  // cells.
-  std::sort(keyed_entities.begin(), keyed_entities.end());
-
-  // Compute entity indices (using -1, -2, -3, etc, for ghost
-  // entities)
-  std::int32_t nonghost_index(0), ghost_index(-1);
-  std::array<std::int32_t, N> previous_key;
-  std::fill(previous_key.begin(), previous_key.end(), -1);
-  for (auto e = keyed_entities.begin(); e!= keyed_entities.end(); ++e)
+  // Split sorted entities into chunks (one per thread) which start
+  // with a new key
+  const std::size_t n = keyed_entities.size();
+  const std::size_t num_chunks = std::max<std::size_t>(1, std::min(num_threads, n));
+  std::vector<std::size_t> chunks(num_chunks + 1, n);
+  for (std::size_t t = 0; t < num_chunks; ++t)
   {
-    const auto& key = std::get<0>(*e);
-    if (key == previous_key)
+    std::size_t i = std::max(t*n/num_chunks, t > 0 ? chunks[t - 1] : 0);
+    while (i > 0 and i < n
+           and keyed_entities[i].key == keyed_entities[i - 1].key)
     {
-      // Repeated entity, reuse entity index
-      std::get<3>(*e) = std::get<3>(*(e - 1));
+      ++i;
     }
-    else
+    chunks[t] = i;
+  }
+
+  // Count new entities (non-ghost and ghost) in each chunk
+  std::vector<std::int32_t> num_new(2*num_chunks, 0);
+  Threads::parallel_for(num_chunks, num_chunks,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
     {
-      // New entity, so give index (negative for ghosts)
-      const auto local_index = std::get<1>(*e).first;
-      if (local_index < 0)
-        std::get<3>(*e) = nonghost_index++;
-      else
-        std::get<3>(*e) = ghost_index--;
-
-      // Update key
-      previous_key = key;
-    }
+      for (std::size_t i = chunks[begin]; i < chunks[end]; ++i)
+      {
+        const KeyedEntity& e = keyed_entities[i];
+        if (i == chunks[begin] or e.key != keyed_entities[i - 1].key)
+          ++num_new[2*begin + (e.local < num_entities ? 0 : 1)];
+      }
+    });
 
-    // Re-map local index (make all positive)
-    auto& local_index = std::get<1>(*e).first;
-    local_index = (local_index < 0) ? (-local_index - 1) : local_index;
+  // Total number of entities, and first entity index for each chunk
+  // (ghost entities are numbered after all regular entities)
+  std::int32_t num_nonghost_entities = 0, num_ghost_entities = 0;
+  for (std::size_t t = 0; t < num_chunks; ++t)
+  {
+    const std::int32_t nonghost = num_new[2*t], ghost = num_new[2*t + 1];
+    num_new[2*t] = num_nonghost_entities;
+    num_new[2*t + 1] = num_ghost_entities;
+    num_nonghost_entities += nonghost;
+    num_ghost_entities += ghost;
   }
-
-  // Total number of entities
-  const std::int32_t num_nonghost_entities = nonghost_index;
-  const std::int32_t num_ghost_entities = -(ghost_index + 1);
   const std::int32_t num_mesh_entities = num_nonghost_entities + num_ghost_entities;
 
   // List of vertex indices connected to entity e
-  std::vector<std::array<int, N>> connectivity_ev(num_mesh_entities) ;
+  std::vector<std::array<unsigned int, N>> connectivity_ev(num_mesh_entities);
 
   // List of entity e indices connected to cell
   boost::multi_array<int, 2>
-    connectivity_ce(boost::extents[mesh.num_cells()][num_entities]);
+    connectivity_ce(boost::extents[num_cells][num_entities]);
 
-  // Build connectivity arrays (with ghost entities at the end)
-  //std::int32_t previous_index = -1;
-  std::int32_t previous_index = std::numeric_limits<std::int32_t>::min();
-  for (auto& entity : keyed_entities)
-  {
-    // Get entity index, and remap for ghosts (negative entity index)
-    // to true index
-    auto& e_index = std::get<3>(entity);
-    if (e_index < 0)
-      e_index = num_nonghost_entities - (e_index + 1);
-
-    // Add to enity-to-vertex map if entity is new
-    if (e_index != previous_index)
+  // Compute entity indices and build connectivity arrays (with ghost
+  // entities at the end)
+  Threads::parallel_for(num_chunks, num_chunks,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
     {
-      dolfin_assert(e_index < (std::int32_t) connectivity_ev.size());
-      connectivity_ev[e_index] = std::get<2>(entity);
+      std::int32_t nonghost_index = num_new[2*begin];
+      std::int32_t ghost_index = num_nonghost_entities + num_new[2*begin + 1];
+      std::int32_t e_index = -1;
+      for (std::size_t i = chunks[begin]; i < chunks[end]; ++i)
+      {
+        const KeyedEntity& e = keyed_entities[i];
 
-      // Update index
-      previous_index = e_index;
-    }
+        // Re-map local index
+        const int local_index = (e.local < num_entities)
+          ? (num_entities - 1 - e.local) : (e.local - num_entities);
 
-    // Add to cell-to-entity map
-    const auto& cell = std::get<1>(entity);
-    const auto local_index = cell.first;
-    const auto cell_index = cell.second;
-    connectivity_ce[cell_index][local_index] = e_index;
-  }
+        // New entity, so give index and add to entity-to-vertex map
+        if (i == chunks[begin] or e.key != keyed_entities[i - 1].key)
+        {
+          e_index = (e.local < num_entities) ? nonghost_index++ : ghost_index++;
+          dolfin_assert(e_index < (std::int32_t) connectivity_ev.size());
+
+          const unsigned int* vertices = cv(e.cell);
+          for (int j = 0; j < N; ++j)
+            connectivity_ev[e_index][j] = vertices[e_vertices[local_index][j]];
+        }
+
+        // Add to cell-to-entity map
+        connectivity_ce[e.cell][local_index] = e_index;
+      }
+    });
 
   // Initialise connectivity data structure
   topology.init(dim, num_mesh_entities, 0);
@@ -378,44 +403,116 @@ void TopologyComputation::compute_from_map(Mesh& mesh,
   dolfin_assert(d1 > 0);
   dolfin_assert(d0 > d1);
 
+  // Call specialised function for number of vertices of entity d1
+  const std::size_t num_entity_vertices = mesh.type().num_vertices(d1);
+  switch (num_entity_vertices)
+  {
+  case 2:
+    compute_from_map_by_key_matching<2>(mesh, d0, d1);
+    break;
+  case 3:
+    compute_from_map_by_key_matching<3>(mesh, d0, d1);
+    break;
+  case 4:
+    compute_from_map_by_key_matching<4>(mesh, d0, d1);
+    break;
+  default:
+    dolfin_error("TopologyComputation.cpp",
+                 "compute connectivity from map",
+                 "Entities with %d vertices not supported",
+                 num_entity_vertices);
+  }
+}
+//----------------------------------------------------------------------------
+template<int N>
+void TopologyComputation::compute_from_map_by_key_matching(Mesh& mesh,
+                                                           std::size_t d0,
+                                                           std::size_t d1)
+{
   // Get the type of entity d0
   std::unique_ptr<CellType> cell_type(CellType::create(mesh.type()
                                                        .entity_type(d0)));
+  const std::size_t num_entities = cell_type->num_entities(d1);
 
   MeshConnectivity& connectivity = mesh.topology()(d0, d1);
-  connectivity.init(mesh.num_entities(d0), cell_type->num_entities(d1));
+  connectivity.init(mesh.num_entities(d0), num_entities);
 
-  // Make a map from the sorted d1 entity vertices to the d1 entity index
-  boost::unordered_map<std::vector<unsigned int>, unsigned int>
-    entity_to_index;
-  entity_to_index.reserve(mesh.num_entities(d1));
-
-  const std::size_t num_verts_d1 = mesh.type().num_vertices(d1);
-  std::vector<unsigned int> key(num_verts_d1);
-  for (MeshEntityIterator e(mesh, d1, "all"); !e.end(); ++e)
+  // Create map from d0 entity vertices to d1 entity vertices
+  boost::multi_array<unsigned int, 2> e_vertices;
+  std::vector<unsigned int> v(cell_type->num_vertices());
+  std::iota(v.begin(), v.end(), 0);
+  cell_type->create_entities(e_vertices, d1, v.data());
+  dolfin_assert(e_vertices.shape()[1] == N);
+
+  const std::size_t num_threads = parameters["num_threads"];
+  const MeshConnectivity& c0 = mesh.topology()(d0, 0);
+  const MeshConnectivity& c1 = mesh.topology()(d1, 0);
+  const std::size_t n0 = mesh.num_entities(d0);
+  const std::size_t n1 = mesh.num_entities(d1);
+
+  // Sort d1 entities, and d1 entities of each d0 entity, by their
+  // sorted vertices
+  struct KeyedEntity
   {
-    std::partial_sort_copy(e->entities(0), e->entities(0) + num_verts_d1,
-                           key.begin(), key.end());
-    entity_to_index.insert({key, e->index()});
-  }
+    std::array<std::uint32_t, N> key;
+    std::uint32_t index;
+  };
+  std::vector<KeyedEntity> entities(n1), sub_entities(n0*num_entities);
+  Threads::parallel_for(n1, num_threads,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
+    {
+      for (std::size_t e = begin; e < end; ++e)
+      {
+        std::copy(c1(e), c1(e) + N, entities[e].key.begin());
+        std::sort(entities[e].key.begin(), entities[e].key.end());
+        entities[e].index = e;
+      }
+    });
+  Threads::parallel_for(n0, num_threads,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
+    {
+      for (std::size_t e = begin; e < end; ++e)
+      {
+        const unsigned int* vertices = c0(e);
+        for (std::size_t i = 0; i < num_entities; ++i)
+        {
+          KeyedEntity& entity = sub_entities[e*num_entities + i];
+          for (int j = 0; j < N; ++j)
+            entity.key[j] = vertices[e_vertices[i][j]];
+          std::sort(entity.key.begin(), entity.key.end());
+          entity.index = e*num_entities + i;
+        }
+      }
+    });
 
-  // Search for d1 entities of d0 in map, and recover index
-  std::vector<std::size_t> entities;
-  boost::multi_array<unsigned int, 2> keys;
-  for (MeshEntityIterator e(mesh, d0, "all"); !e.end(); ++e)
+  const std::uint32_t max_vertex = std::max<std::size_t>(mesh.num_vertices(), 1) - 1;
+  for (int j = N - 1; j >= 0; --j)
   {
-    entities.clear();
-    cell_type->create_entities(keys, d1, e->entities(0));
-    for (const auto &p : keys)
-    {
-      std::partial_sort_copy(p.begin(), p.end(), key.begin(), key.end());
-      const auto it = entity_to_index.find(key);
-      dolfin_assert(it != entity_to_index.end());
-      entities.push_back(it->second);
-    }
-    connectivity.set(e->index(), entities.data());
+    auto key = [j](const KeyedEntity& e) { return e.key[j]; };
+    RadixSort::sort(entities, key, max_vertex, num_threads);
+    RadixSort::sort(sub_entities, key, max_vertex, num_threads);
   }
 
+  // Match sorted lists to recover index of each d1 entity
+  auto less = [](const KeyedEntity& a, const KeyedEntity& b)
+    { return a.key < b.key; };
+  Threads::parallel_for(sub_entities.size(), num_threads,
+    [&](std::size_t begin, std::size_t end, std::size_t thread)
+    {
+      if (begin == end)
+        return;
+      auto e1 = std::lower_bound(entities.begin(), entities.end(),
+                                 sub_entities[begin], less);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const KeyedEntity& entity = sub_entities[i];
+        while (e1 != entities.end() and e1->key < entity.key)
+          ++e1;
+        dolfin_assert(e1 != entities.end() and e1->key == entity.key);
+        connectivity.set(entity.index/num_entities, e1->index,
+                         entity.index % num_entities);
+      }
+    });
 }
 //-----------------------------------------------------------------------------
 void TopologyComputation::compute_from_intersection(Mesh& mesh,
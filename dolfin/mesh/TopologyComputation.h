@@ -67,6 +67,9 @@ namespace dolfin
     //The function is templated over the number of vertices that make up an
     //entity of dimension dim. This avoid dynamic memoryt allocations, yielding
     //significant performance improvements
+    //
+    // The list is sorted with a stable radix sort on the vertex indices,
+    // and the parallel parts use parameters["num_threads"] threads
     template<int N>
     static std::int32_t compute_entities_by_key_matching(Mesh& mesh, int dim);
 
@@ -74,11 +77,19 @@ namespace dolfin
     static void compute_from_transpose(Mesh& mesh, std::size_t d0,
                                        std::size_t d1);
 
-    // Direct lookup of entity from vertices in a map
+    // Direct lookup of entity from vertices
     static void compute_from_map(Mesh& mesh,
                                  std::size_t d0,
                                  std::size_t d1);
 
+    // Lookup of entity from vertices by matching sorted lists of
+    // keyed entities, templated over the number of vertices of
+    // entities of dimension d1
+    template<int N>
+    static void compute_from_map_by_key_matching(Mesh& mesh,
+                                                 std::size_t d0,
+                                                 std::size_t d1);
+
     // Compute connectivity from intersection
     static void compute_from_intersection(Mesh& mesh, std::size_t d0,
                                           std::size_t d1, std::size_t d);
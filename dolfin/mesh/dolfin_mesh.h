@@ -20,6 +20,8 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/FacetCell.h>
 #include <dolfin/mesh/MeshConnectivity.h>
+#include <dolfin/mesh/ConnectivityView.h>
+#include <dolfin/mesh/EntityCoordinatesView.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/DynamicMeshEditor.h>
 #include <dolfin/mesh/LocalMeshValueCollection.h>
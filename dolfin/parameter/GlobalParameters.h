@@ -18,7 +18,7 @@
 // Modified by Fredrik Valdmanis, 2011
 //
 // First added:  2009-07-02
-// Last changed: 2013-06-21
+// Last changed: 2019-06-18
 
 #ifndef __GLOBAL_PARAMETERS_H
 #define __GLOBAL_PARAMETERS_H
@@ -58,6 +58,10 @@ namespace dolfin
       // Allow extrapolation in function interpolation
       p.add("allow_extrapolation", false);
 
+      // Number of threads used by thread-parallel algorithms (mesh
+      // topology computation)
+      p.add("num_threads", 1);
+
       //-- Input
 
       // Warn if reading large XML files in parallel (MB)
@@ -97,6 +101,16 @@ namespace dolfin
       p.add("reorder_cells_gps", false);
       p.add("reorder_vertices_gps", false);
 
+      // Mesh ordering along a space-filling curve through cell
+      // midpoints and vertex coordinates
+      p.add("reorder_cells_sfc", false);
+      p.add("reorder_vertices_sfc", false);
+      p.add("space_filling_curve", "hilbert", {"hilbert", "morton"});
+
+      // Maximum cost ratio of bounding box tree of mesh refitted after
+      // the coordinates have changed (rebuilt if larger)
+      p.add("bounding_box_tree_max_cost_ratio", 2.0);
+
       // Set default graph/mesh partitioner
       std::string default_mesh_partitioner = "SCOTCH";
       #ifdef HAS_PARMETIS
@@ -153,6 +167,10 @@ namespace dolfin
             default_backend,
             allowed_backends);
 
+      // Sparsity pattern row storage ("compact" uses a single array
+      // of 32-bit local column indices)
+      p.add("sparsity_pattern_storage", "set", {"set", "compact"});
+
       // Add nested parameter sets
       p.add(KrylovSolver::default_parameters());
       p.add(LUSolver::default_parameters());
@@ -62,6 +62,7 @@ from .cpp.fem import (FiniteElement, DofMap, Assembler, MultiMeshAssembler,
 
 from .cpp.geometry import (BoundingBoxTree,
                            Point,
+                           PointLocator,
                            MeshPointIntersection,
                            intersect)
 from .cpp.generation import (IntervalMesh, BoxMesh, RectangleMesh,
@@ -115,7 +116,7 @@ from .cpp.mesh import (Mesh, MeshTopology, MeshGeometry, MeshEntity,
                        MeshColoring, CellType, Cell, Facet, Face,
                        Edge, Vertex, cells, facets, faces, edges,
                        entities, vertices, SubDomain, BoundaryMesh,
-                       MeshEditor, MeshQuality, SubMesh,
+                       MeshEditor, MeshQuality, MeshRenumbering, SubMesh,
                        DomainBoundary, PeriodicBoundaryComputation,
                        MeshTransformation, SubsetIterator, MultiMesh,
                        MeshPartitioning)
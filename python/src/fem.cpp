@@ -224,6 +224,7 @@ namespace dolfin_wrappers
       .def("global_dimension", &dolfin::GenericDofMap::global_dimension,
            "The dimension of the global finite element function space")
       .def("index_map", &dolfin::GenericDofMap::index_map)
+      .def("memory_usage", &dolfin::GenericDofMap::memory_usage)
       .def("neighbours", &dolfin::GenericDofMap::neighbours)
       .def("off_process_owner", &dolfin::GenericDofMap::off_process_owner)
       .def("shared_nodes", &dolfin::GenericDofMap::shared_nodes)
@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <limits>
 #include <memory>
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
@@ -29,6 +30,11 @@
 #include <dolfin/geometry/CollisionPredicates.h>
 #include <dolfin/geometry/IntersectionConstruction.h>
 #include <dolfin/geometry/Point.h>
+#include <dolfin/geometry/PointLocator.h>
+#include <dolfin/geometry/predicates.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
 
 namespace py = pybind11;
@@ -44,8 +50,15 @@ namespace dolfin_wrappers
       .def(py::init<>())
       .def("build", (void (dolfin::BoundingBoxTree::*)(const dolfin::Mesh&))
            &dolfin::BoundingBoxTree::build)
-      .def("build", (void (dolfin::BoundingBoxTree::*)(const dolfin::Mesh&, std::size_t))
-           &dolfin::BoundingBoxTree::build)
+      .def("memory_usage", &dolfin::BoundingBoxTree::memory_usage)
+      .def("build", (void (dolfin::BoundingBoxTree::*)(const dolfin::Mesh&, std::size_t, std::string))
+           &dolfin::BoundingBoxTree::build, py::arg("mesh"), py::arg("tdim"),
+           py::arg("builder")="median")
+      .def("refit", &dolfin::BoundingBoxTree::refit,
+           py::arg("max_cost_ratio")=std::numeric_limits<double>::max(),
+           py::arg("update_global")=true)
+      .def("update_global_tree", &dolfin::BoundingBoxTree::update_global_tree)
+      .def("cost_ratio", &dolfin::BoundingBoxTree::cost_ratio)
       .def("compute_collisions", (std::vector<unsigned int> (dolfin::BoundingBoxTree::*)(const dolfin::Point&) const)
            &dolfin::BoundingBoxTree::compute_collisions)
       .def("compute_collisions",
@@ -58,9 +71,59 @@ namespace dolfin_wrappers
            (std::pair<std::vector<unsigned int>, std::vector<unsigned int>>
             (dolfin::BoundingBoxTree::*)(const dolfin::BoundingBoxTree&) const)
 	   &dolfin::BoundingBoxTree::compute_entity_collisions)
+      .def("compute_process_collisions", &dolfin::BoundingBoxTree::compute_process_collisions)
       .def("compute_first_collision", &dolfin::BoundingBoxTree::compute_first_collision)
       .def("compute_first_entity_collision", &dolfin::BoundingBoxTree::compute_first_entity_collision)
-      .def("compute_closest_entity", &dolfin::BoundingBoxTree::compute_closest_entity);
+      .def("compute_first_entity_collisions", &dolfin::BoundingBoxTree::compute_first_entity_collisions)
+      .def("compute_first_entity_collisions",
+           [](const dolfin::BoundingBoxTree& self,
+              py::array_t<double, py::array::c_style | py::array::forcecast> x)
+           {
+             auto b = x.request();
+             if (b.ndim != 2 or b.shape[1] > 3)
+               throw py::value_error("Expected array of points with shape (num_points, gdim)");
+             std::vector<dolfin::Point> points;
+             points.reserve(b.shape[0]);
+             for (std::size_t i = 0; i < (std::size_t) b.shape[0]; ++i)
+               points.push_back(dolfin::Point(b.shape[1], x.data(i, 0)));
+             const std::vector<unsigned int> cells
+               = self.compute_first_entity_collisions(points);
+             return py::array_t<unsigned int>(cells.size(), cells.data());
+           })
+      .def("compute_closest_entity", &dolfin::BoundingBoxTree::compute_closest_entity)
+      .def("compute_closest_entities",
+           (std::vector<std::pair<unsigned int, double>>
+            (dolfin::BoundingBoxTree::*)(const dolfin::Point&, std::size_t) const)
+           &dolfin::BoundingBoxTree::compute_closest_entities, py::arg("point"), py::arg("k"))
+      .def("compute_closest_entities",
+           (std::vector<std::pair<unsigned int, double>>
+            (dolfin::BoundingBoxTree::*)(const std::vector<dolfin::Point>&) const)
+           &dolfin::BoundingBoxTree::compute_closest_entities)
+      .def("compute_closest_entities",
+           [](const dolfin::BoundingBoxTree& self,
+              py::array_t<double, py::array::c_style | py::array::forcecast> x)
+           {
+             auto b = x.request();
+             if (b.ndim != 2 or b.shape[1] > 3)
+               throw py::value_error("Expected array of points with shape (num_points, gdim)");
+             std::vector<dolfin::Point> points;
+             points.reserve(b.shape[0]);
+             for (std::size_t i = 0; i < (std::size_t) b.shape[0]; ++i)
+               points.push_back(dolfin::Point(b.shape[1], x.data(i, 0)));
+             const std::vector<std::pair<unsigned int, double>> closest
+               = self.compute_closest_entities(points);
+             py::array_t<unsigned int> cells(closest.size());
+             py::array_t<double> distances(closest.size());
+             for (std::size_t i = 0; i < closest.size(); ++i)
+             {
+               cells.mutable_at(i) = closest[i].first;
+               distances.mutable_at(i) = closest[i].second;
+             }
+             return py::make_tuple(cells, distances);
+           })
+      .def("compute_entities_within_radius",
+           &dolfin::BoundingBoxTree::compute_entities_within_radius,
+           py::arg("point"), py::arg("r"));
 
     // dolfin::Point
     py::class_<dolfin::Point>(m, "Point")
@@ -131,6 +194,39 @@ namespace dolfin_wrappers
       .def("distance", &dolfin::Point::distance)
       .def("dot", &dolfin::Point::dot);
 
+    // dolfin::PointLocator
+    py::class_<dolfin::PointLocator, std::shared_ptr<dolfin::PointLocator>>
+      (m, "PointLocator", "Locate points on a distributed mesh")
+      .def(py::init<const dolfin::Mesh&, const std::vector<dolfin::Point>&>())
+      .def("size", &dolfin::PointLocator::size)
+      .def("owners", &dolfin::PointLocator::owners)
+      .def("num_owned", &dolfin::PointLocator::num_owned)
+      .def("owned_cells", &dolfin::PointLocator::owned_cells)
+      .def("evaluate", [](const dolfin::PointLocator& self, py::object u)
+           {
+             // Evaluate Function at the query points
+             auto _u = u.attr("_cpp_object").cast<const dolfin::Function*>();
+             const dolfin::Mesh& mesh = *_u->function_space()->mesh();
+             const std::size_t gdim = mesh.geometry().dim();
+             const std::size_t value_size = _u->value_size();
+             ufc::cell ufc_cell;
+             std::vector<double> x(gdim), values;
+             self.evaluate(value_size,
+                           [&](unsigned int c, const dolfin::Point& point,
+                               double* v)
+                           {
+                             std::copy(point.coordinates(),
+                                       point.coordinates() + gdim, x.begin());
+                             const dolfin::Array<double> _x(gdim, x.data());
+                             dolfin::Array<double> _v(value_size, v);
+                             const dolfin::Cell cell(mesh, c);
+                             cell.get_cell_data(ufc_cell);
+                             _u->eval(_v, _x, cell, ufc_cell);
+                           }, values);
+             return py::array_t<double>(std::vector<std::size_t>{self.size(), value_size},
+                                        values.data());
+           }, "Evaluate Function at the query points (NaN outside the mesh)");
+
     // dolfin::MeshPointIntersection
     py::class_<dolfin::MeshPointIntersection,
                std::shared_ptr<dolfin::MeshPointIntersection>>
@@ -160,6 +256,9 @@ namespace dolfin_wrappers
 
     // dolfin/geometry free functions
     m.def("intersect", &dolfin::intersect);
+    m.def("set_predicate_statistics", &dolfin::set_predicate_statistics);
+    m.def("predicate_statistics", &dolfin::predicate_statistics);
+    m.def("reset_predicate_statistics", &dolfin::reset_predicate_statistics);
 
   }
 }
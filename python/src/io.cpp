@@ -29,6 +29,7 @@
 #include <dolfin/io/XDMFFile.h>
 #include <dolfin/io/X3DOM.h>
 #include <dolfin/function/Function.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/mesh/Mesh.h>
@@ -261,6 +262,16 @@ namespace dolfin_wrappers
              auto _u = u.attr("_cpp_object").cast<dolfin::Function*>();
              self.read(*_u, name);
            }, py::arg("u"), py::arg("name"))
+      // topology cache
+      .def("write_topology_cache", &dolfin::HDF5File::write_topology_cache,
+           py::arg("mesh"), py::arg("name"))
+      .def("read_topology_cache", &dolfin::HDF5File::read_topology_cache,
+           py::arg("mesh"), py::arg("name"))
+      // bounding box tree
+      .def("write", (void (dolfin::HDF5File::*)(const dolfin::BoundingBoxTree&, std::string))
+           &dolfin::HDF5File::write, py::arg("tree"), py::arg("name"))
+      .def("read", (bool (dolfin::HDF5File::*)(dolfin::BoundingBoxTree&, std::string, const dolfin::Mesh&) const)
+           &dolfin::HDF5File::read, py::arg("tree"), py::arg("name"), py::arg("mesh"))
       // write
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::Mesh&, std::string)) &dolfin::HDF5File::write)
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshValueCollection<bool>&, std::string))
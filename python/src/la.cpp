@@ -32,6 +32,7 @@
 #include <dolfin/la/solve.h>
 #include <dolfin/la/BlockVector.h>
 #include <dolfin/la/BlockMatrix.h>
+#include <dolfin/la/EigenBlockView.h>
 #include <dolfin/la/GenericLinearOperator.h>
 #include <dolfin/la/GenericLinearSolver.h>
 #include <dolfin/la/GenericTensor.h>
@@ -131,6 +132,7 @@ namespace dolfin_wrappers
     // dolfin::IndexMap
     py::class_<dolfin::IndexMap, std::shared_ptr<dolfin::IndexMap>> index_map(m, "IndexMap");
     index_map.def("size", &dolfin::IndexMap::size)
+      .def("memory_usage", &dolfin::IndexMap::memory_usage)
       .def("block_size", &dolfin::IndexMap::block_size)
       .def("local_range", &dolfin::IndexMap::local_range)
       .def("local_to_global_unowned",
@@ -154,6 +156,7 @@ namespace dolfin_wrappers
       .def("apply", &dolfin::SparsityPattern::apply)
       .def("str", &dolfin::SparsityPattern::str)
       .def("num_nonzeros", &dolfin::SparsityPattern::num_nonzeros)
+      .def("memory_usage", &dolfin::SparsityPattern::memory_usage)
       .def("num_nonzeros_diagonal", [](const dolfin::SparsityPattern& instance)
            {
              std::vector<std::size_t> num_nonzeros;
@@ -670,7 +673,13 @@ namespace dolfin_wrappers
 
     // dolfin::BlockMatrix
     py::class_<dolfin::BlockMatrix, std::shared_ptr<dolfin::BlockMatrix>>
-      (m, "BlockMatrix")
+      block_matrix(m, "BlockMatrix");
+
+    py::enum_<dolfin::BlockMatrix::Ordering>(block_matrix, "Ordering")
+      .value("field_split", dolfin::BlockMatrix::Ordering::field_split)
+      .value("interleaved", dolfin::BlockMatrix::Ordering::interleaved);
+
+    block_matrix
       .def(py::init<std::size_t, std::size_t>(), py::arg("m")=0, py::arg("n")=0)
       .def("__getitem__", [](dolfin::BlockMatrix& self, py::tuple index)
            {
@@ -689,7 +698,27 @@ namespace dolfin_wrappers
              std::size_t j = index[1].cast<std::size_t>();
              self.set_block(i, j, m);
            })
-      .def("mult", &dolfin::BlockMatrix::mult, py::arg("x"), py::arg("y"), py::arg("transposed")=false);
+      .def("mult", &dolfin::BlockMatrix::mult, py::arg("x"), py::arg("y"), py::arg("transposed")=false)
+      .def("monolithic", &dolfin::BlockMatrix::monolithic,
+           py::arg("ordering")=dolfin::BlockMatrix::Ordering::field_split);
+
+    // dolfin::EigenBlockView
+    py::class_<dolfin::EigenBlockView, std::shared_ptr<dolfin::EigenBlockView>,
+               dolfin::GenericLinearOperator>(m, "EigenBlockView")
+      .def(py::init<std::shared_ptr<const dolfin::EigenMatrix>,
+           const std::vector<std::size_t>&, const std::vector<std::size_t>&,
+           dolfin::BlockMatrix::Ordering, std::size_t, std::size_t>())
+      .def_static("split", &dolfin::EigenBlockView::split)
+      .def("getrow", [](const dolfin::EigenBlockView& self, std::size_t row)
+           {
+             std::vector<double> values;
+             std::vector<std::size_t> columns;
+             self.getrow(row, columns, values);
+             auto _columns = py::array_t<std::size_t>(columns.size(), columns.data());
+             auto _values = py::array_t<double>(values.size(), values.data());
+             return std::make_pair(_columns, _values);
+           }, py::arg("row"))
+      .def("nnz", &dolfin::EigenBlockView::nnz);
 
     // dolfin::BlockVector
     py::class_<dolfin::BlockVector, std::shared_ptr<dolfin::BlockVector>>
@@ -755,7 +784,10 @@ namespace dolfin_wrappers
       .def(py::init([](const MPICommWrapper comm, std::size_t N)
         { return std::unique_ptr<dolfin::EigenVector>(new dolfin::EigenVector(comm.get(), N)); }))
       .def("array_view", [](dolfin::EigenVector& self) -> Eigen::Ref<Eigen::VectorXd> { return *self.vec(); },
-           "Return a writable numpy array view of the data in the EigenVector");
+           "Return a writable numpy array view of the data in the EigenVector")
+      .def("update_ghost_values", &dolfin::EigenVector::update_ghost_values)
+      .def("num_ghosts", &dolfin::EigenVector::num_ghosts)
+      .def("memory_usage", &dolfin::EigenVector::memory_usage);
 
     // dolfin::EigenMatrix
     py::class_<dolfin::EigenMatrix, std::shared_ptr<dolfin::EigenMatrix>,
@@ -763,6 +795,7 @@ namespace dolfin_wrappers
       (m, "EigenMatrix", "DOLFIN EigenMatrix object")
       .def(py::init<>())
       .def(py::init<std::size_t, std::size_t>())
+      .def("memory_usage", &dolfin::EigenMatrix::memory_usage)
       .def("sparray", (dolfin::EigenMatrix::eigen_matrix_type& (dolfin::EigenMatrix::*)()) &dolfin::EigenMatrix::mat,
            py::return_value_policy::reference_internal)
       .def("data_view", [](dolfin::EigenMatrix& instance)
@@ -793,7 +826,14 @@ namespace dolfin_wrappers
     // dolfin::GenericLinearSolver
     py::class_<dolfin::GenericLinearSolver, std::shared_ptr<dolfin::GenericLinearSolver>,
                dolfin::Variable>
-      (m, "GenericLinearSolver", "DOLFIN GenericLinearSolver object");
+      (m, "GenericLinearSolver", "DOLFIN GenericLinearSolver object")
+      .def("solve_multiple", [](dolfin::GenericLinearSolver& self,
+                                std::vector<std::shared_ptr<dolfin::GenericVector>> x,
+                                std::vector<std::shared_ptr<dolfin::GenericVector>> b)
+           {
+             std::vector<std::shared_ptr<const dolfin::GenericVector>> _b(b.begin(), b.end());
+             return self.solve_multiple(x, _b);
+           }, py::arg("x"), py::arg("b"));
 
     #ifdef HAS_PETSC
     py::class_<dolfin::PETScOptions>(m, "PETScOptions")
@@ -831,6 +871,7 @@ namespace dolfin_wrappers
       .def("get_options_prefix", &dolfin::PETScVector::get_options_prefix)
       .def("set_options_prefix", &dolfin::PETScVector::set_options_prefix)
       .def("update_ghost_values", &dolfin::PETScVector::update_ghost_values)
+      .def("memory_usage", &dolfin::PETScVector::memory_usage)
       .def("vec", &dolfin::PETScVector::vec, "Return underlying PETSc Vec object");
 
     // dolfin::PETScBaseMatrix
@@ -862,6 +903,7 @@ namespace dolfin_wrappers
       .def("get_options_prefix", &dolfin::PETScMatrix::get_options_prefix)
       .def("set_options_prefix", &dolfin::PETScMatrix::set_options_prefix)
       .def("set_nullspace", &dolfin::PETScMatrix::set_nullspace)
+      .def("memory_usage", &dolfin::PETScMatrix::memory_usage)
       .def("set_near_nullspace", &dolfin::PETScMatrix::set_near_nullspace);
 
     py::class_<dolfin::PETScPreconditioner, std::shared_ptr<dolfin::PETScPreconditioner>,
@@ -48,6 +48,8 @@ namespace dolfin_wrappers
     // dolfin::Table
     py::class_<dolfin::Table, std::shared_ptr<dolfin::Table>, dolfin::Variable>(m, "Table")
       .def(py::init<std::string>())
+      .def("get", &dolfin::Table::get)
+      .def("get_value", &dolfin::Table::get_value)
       .def("str", &dolfin::Table::str);
 
     // dolfin/log free functions
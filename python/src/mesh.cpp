@@ -43,6 +43,7 @@
 #include <dolfin/mesh/MeshPartitioning.h>
 #include <dolfin/mesh/MeshValueCollection.h>
 #include <dolfin/mesh/MeshQuality.h>
+#include <dolfin/mesh/MeshRenumbering.h>
 #include <dolfin/mesh/SubDomain.h>
 #include <dolfin/mesh/SubMesh.h>
 #include <dolfin/mesh/SubsetIterator.h>
@@ -51,6 +52,7 @@
 #include <dolfin/mesh/MeshTransformation.h>
 #include <dolfin/mesh/MultiMesh.h>
 #include <dolfin/function/Expression.h>
+#include <dolfin/log/Table.h>
 
 #include "casters.h"
 
@@ -94,7 +96,20 @@ namespace dolfin_wrappers
       .def("dim", &dolfin::MeshGeometry::dim, "Geometrical dimension")
       .def("degree", &dolfin::MeshGeometry::degree, "Degree")
       .def("get_entity_index", &dolfin::MeshGeometry::get_entity_index)
-      .def("num_entity_coordinates", &dolfin::MeshGeometry::num_entity_coordinates);
+      .def("num_entity_coordinates", &dolfin::MeshGeometry::num_entity_coordinates)
+      .def("init_single_precision", &dolfin::MeshGeometry::init_single_precision,
+           py::arg("enable")=true)
+      .def("has_single_precision", &dolfin::MeshGeometry::has_single_precision)
+      .def("update_single_precision", &dolfin::MeshGeometry::update_single_precision)
+      .def("mark_coordinates_changed", &dolfin::MeshGeometry::mark_coordinates_changed)
+      .def("x_single", [](const dolfin::MeshGeometry& self)
+           {
+             const std::vector<float>& x = self.x_single();
+             return Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+               (x.data(), self.num_points(), self.dim());
+           },
+           py::return_value_policy::reference_internal)
+      .def("memory_usage", &dolfin::MeshGeometry::memory_usage);
 
     // dolfin::MeshTopology class
     py::class_<dolfin::MeshTopology, std::shared_ptr<dolfin::MeshTopology>, dolfin::Variable>
@@ -110,6 +125,7 @@ namespace dolfin_wrappers
            &dolfin::MeshTopology::operator(), py::return_value_policy::reference_internal)
       .def("size", &dolfin::MeshTopology::size)
       .def("hash", &dolfin::MeshTopology::hash)
+      .def("memory_usage", &dolfin::MeshTopology::memory_usage)
       .def("init_global_indices", &dolfin::MeshTopology::init_global_indices)
       .def("have_global_indices", &dolfin::MeshTopology::have_global_indices)
       .def("ghost_offset", &dolfin::MeshTopology::ghost_offset)
@@ -134,6 +150,8 @@ namespace dolfin_wrappers
       .def(py::init([](const MPICommWrapper comm, const std::string filename)
                     { return std::unique_ptr<dolfin::Mesh>(new dolfin::Mesh(comm.get(), filename)); }))
       .def("bounding_box_tree", &dolfin::Mesh::bounding_box_tree)
+      .def("update_bounding_box_tree", &dolfin::Mesh::update_bounding_box_tree)
+      .def("set_bounding_box_tree", &dolfin::Mesh::set_bounding_box_tree)
       .def("cells", [](const dolfin::Mesh& self)
            {
              const unsigned int tdim = self.topology().dim();
@@ -147,10 +165,12 @@ namespace dolfin_wrappers
            &dolfin::Mesh::color)
       .def("coordinates", [](dolfin::Mesh& self)
            {
+             // Access through const x() does not mark the coordinates
+             // as changed (see MeshGeometry::mark_coordinates_changed)
+             const dolfin::MeshGeometry& geometry = self.geometry();
              return Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-               (self.geometry().x().data(),
-                self.geometry().num_points(),
-                self.geometry().dim());
+               (const_cast<double*>(geometry.x().data()),
+                geometry.num_points(), geometry.dim());
            },
            py::return_value_policy::reference_internal)
       .def("domains", (dolfin::MeshDomains& (dolfin::Mesh::*)())
@@ -160,6 +180,9 @@ namespace dolfin_wrappers
       .def("geometry", (dolfin::MeshGeometry& (dolfin::Mesh::*)()) &dolfin::Mesh::geometry,
            py::return_value_policy::reference, "Mesh geometry")
       .def("hash", &dolfin::Mesh::hash)
+      .def("memory_usage", &dolfin::Mesh::memory_usage)
+      .def("memory_usage_table", &dolfin::Mesh::memory_usage_table)
+      .def("release_derived_data", &dolfin::Mesh::release_derived_data)
       .def("hmax", &dolfin::Mesh::hmax)
       .def("hmin", &dolfin::Mesh::hmin)
       .def("id", &dolfin::Mesh::id)
@@ -222,7 +245,8 @@ namespace dolfin_wrappers
       .def("get_marker", &dolfin::MeshDomains::get_marker)
       .def("init", &dolfin::MeshDomains::init)
       .def("markers", (std::map<std::size_t, std::size_t>& (dolfin::MeshDomains::*)(std::size_t))
-           &dolfin::MeshDomains::markers);
+           &dolfin::MeshDomains::markers)
+      .def("memory_usage", &dolfin::MeshDomains::memory_usage);
 
     // dolfin::BoundaryMesh
     py::class_<dolfin::BoundaryMesh, std::shared_ptr<dolfin::BoundaryMesh>, dolfin::Mesh>
@@ -232,7 +256,8 @@ namespace dolfin_wrappers
       .def("entity_map", (dolfin::MeshFunction<std::size_t>& (dolfin::BoundaryMesh::*)(std::size_t))
            &dolfin::BoundaryMesh::entity_map)
       .def("entity_map", (const dolfin::MeshFunction<std::size_t>& (dolfin::BoundaryMesh::*)(std::size_t) const)
-           &dolfin::BoundaryMesh::entity_map);
+           &dolfin::BoundaryMesh::entity_map)
+      .def("update_coordinates", &dolfin::BoundaryMesh::update_coordinates);
 
     // dolfin::MeshConnectivity class
     py::class_<dolfin::MeshConnectivity, std::shared_ptr<dolfin::MeshConnectivity>>
@@ -245,7 +270,13 @@ namespace dolfin_wrappers
       .def("size", (std::size_t (dolfin::MeshConnectivity::*)() const)
            &dolfin::MeshConnectivity::size)
       .def("size", (std::size_t (dolfin::MeshConnectivity::*)(std::size_t) const)
-           &dolfin::MeshConnectivity::size);
+           &dolfin::MeshConnectivity::size)
+      .def("compress", &dolfin::MeshConnectivity::compress)
+      .def("decompress", &dolfin::MeshConnectivity::decompress)
+      .def("compressed", &dolfin::MeshConnectivity::compressed)
+      .def("fixed_stride", &dolfin::MeshConnectivity::fixed_stride)
+      .def("hash", &dolfin::MeshConnectivity::hash)
+      .def("memory_usage", &dolfin::MeshConnectivity::memory_usage);
 
     // dolfin::MeshEntity class
     py::class_<dolfin::MeshEntity, std::shared_ptr<dolfin::MeshEntity>>
@@ -480,6 +511,10 @@ namespace dolfin_wrappers
            &dolfin::MeshEditor::add_vertex_global)
       .def("add_cell", (void (dolfin::MeshEditor::*)(std::size_t, const std::vector<std::size_t>&))
            &dolfin::MeshEditor::add_cell)
+      .def("set_vertices", (void (dolfin::MeshEditor::*)(const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>&, bool))
+           &dolfin::MeshEditor::set_vertices, py::arg("x"), py::arg("check") = true)
+      .def("set_cells", (void (dolfin::MeshEditor::*)(const Eigen::Ref<const Eigen::Array<std::size_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>&, bool))
+           &dolfin::MeshEditor::set_cells, py::arg("cells"), py::arg("check") = true)
       .def("close", &dolfin::MeshEditor::close, py::arg("order") = true);
 
     // dolfin::MeshQuality
@@ -494,12 +529,27 @@ namespace dolfin_wrappers
       .def_static("dihedral_angles_min_max", &dolfin::MeshQuality::dihedral_angles_min_max)
       .def_static("dihedral_angles_matplotlib_histogram", &dolfin::MeshQuality::dihedral_angles_matplotlib_histogram);
 
+    // dolfin::MeshRenumbering
+    py::class_<dolfin::MeshRenumbering>
+      (m, "MeshRenumbering", "DOLFIN MeshRenumbering class")
+      .def_static("renumber_by_space_filling_curve",
+                  &dolfin::MeshRenumbering::renumber_by_space_filling_curve,
+                  py::arg("mesh"), py::arg("curve")="hilbert")
+      .def_static("renumber", &dolfin::MeshRenumbering::renumber,
+                  py::arg("mesh"), py::arg("cell_order"), py::arg("vertex_order"))
+      .def_static("compute_space_filling_curve_order",
+                  &dolfin::MeshRenumbering::compute_space_filling_curve_order,
+                  py::arg("x"), py::arg("gdim"), py::arg("curve")="hilbert");
+
     // dolfin::SubMesh
     py::class_<dolfin::SubMesh, std::shared_ptr<dolfin::SubMesh>, dolfin::Mesh>
       (m, "SubMesh", "DOLFIN SubMesh")
       .def(py::init<const dolfin::Mesh&, std::size_t>())
       .def(py::init<const dolfin::Mesh&, const dolfin::SubDomain&>())
-      .def(py::init<const dolfin::Mesh&, const dolfin::MeshFunction<std::size_t>&, std::size_t>());
+      .def(py::init<const dolfin::Mesh&, const dolfin::MeshFunction<std::size_t>&, std::size_t>())
+      .def("update", &dolfin::SubMesh::update, py::arg("mesh"), py::arg("sub_domains"),
+           py::arg("sub_domain"))
+      .def("parent_entity_indices", &dolfin::SubMesh::parent_entity_indices);
 
     // dolfin::SubDomain trampoline class for user overloading from
     // Python
@@ -571,6 +621,7 @@ namespace dolfin_wrappers
       .def(py::init<>())
       .def("add", &dolfin::MultiMesh::add)
       .def("build", &dolfin::MultiMesh::build, py::arg("quadrature_order") = 2)
+      .def("update", &dolfin::MultiMesh::update)
       .def("num_parts", &dolfin::MultiMesh::num_parts)
       .def("compute_volume", &dolfin::MultiMesh::compute_volume)
       .def("part", &dolfin::MultiMesh::part)
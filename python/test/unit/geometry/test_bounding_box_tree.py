@@ -23,7 +23,7 @@ import numpy
 from dolfin import BoundingBoxTree
 from dolfin import UnitIntervalMesh, UnitSquareMesh, UnitCubeMesh
 from dolfin import Point
-from dolfin import MeshEntity
+from dolfin import MeshEntity, cells
 from dolfin import MPI
 from dolfin_utils.test import skip_in_parallel
 
@@ -217,6 +217,88 @@ def test_compute_entity_collisions_3d():
     entities = tree.compute_entity_collisions(p)
     assert set(entities) == reference
 
+@skip_in_parallel
+def test_compute_entity_collisions_sah_builder():
+
+    mesh = UnitCubeMesh(8, 8, 8)
+    x = mesh.coordinates()
+    x[:, 0] = x[:, 0]**4
+
+    tree_median = BoundingBoxTree()
+    tree_median.build(mesh, 3)
+    tree_sah = BoundingBoxTree()
+    tree_sah.build(mesh, 3, builder="sah")
+
+    for p in [Point(0.3, 0.3, 0.3), Point(0.001, 0.5, 0.9), Point(0.9, 0.1, 0.5)]:
+        entities_median = tree_median.compute_entity_collisions(p)
+        entities_sah = tree_sah.compute_entity_collisions(p)
+        assert len(entities_sah) > 0
+        assert set(entities_sah) == set(entities_median)
+
+    with pytest.raises(RuntimeError):
+        tree_sah.build(mesh, 3, builder="foo")
+
+def test_refit():
+
+    mesh = UnitCubeMesh(8, 8, 8)
+    tree = mesh.bounding_box_tree()
+    points = [Point(0.3, 0.3, 0.3), Point(0.05, 0.5, 0.9), Point(0.9, 0.1, 0.5)]
+
+    # Translation keeps the quality of the tree
+    x = mesh.coordinates()
+    x[:, 0] += 0.5
+    assert not tree.refit()
+    assert abs(tree.cost_ratio() - 1.0) < 1e-10
+
+    # Refitted tree gives same collisions as a new tree
+    x[:, 1] = x[:, 1]**3
+    tree.refit()
+    tree_new = BoundingBoxTree()
+    tree_new.build(mesh, 3)
+    for p in points:
+        assert set(tree.compute_entity_collisions(p)) == \
+            set(tree_new.compute_entity_collisions(p))
+
+    # Cached tree of the mesh is refitted when coordinates are marked
+    # as changed
+    x = mesh.coordinates()
+    x[:, 2] *= 2.0
+    mesh.geometry().mark_coordinates_changed()
+    tree_new.build(mesh, 3)
+    assert mesh.bounding_box_tree() is tree
+    for p in points:
+        assert set(tree.compute_entity_collisions(p)) == \
+            set(tree_new.compute_entity_collisions(p))
+
+    # Rebuild if the cost ratio exceeds the limit
+    x[:, 0] = x[:, 0]**4
+    assert tree.refit(0.0)
+    assert abs(tree.cost_ratio() - 1.0) < 1e-10
+
+def test_refit_local():
+
+    # Move the mesh on process 0 only, which refits the cached tree on
+    # that process only
+    mesh = UnitCubeMesh(MPI.comm_world, 4, 4, 4)
+    tree = mesh.bounding_box_tree()
+    rank = MPI.rank(mesh.mpi_comm())
+    if rank == 0:
+        mesh.coordinates()[:] += 1.0
+        mesh.geometry().mark_coordinates_changed()
+    assert mesh.bounding_box_tree() is tree
+
+    # Process collisions need the global tree to be updated first
+    if rank == 0 and MPI.size(mesh.mpi_comm()) > 1:
+        with pytest.raises(RuntimeError):
+            tree.compute_process_collisions(Point(0.5, 0.5, 0.5))
+    mesh.update_bounding_box_tree()
+
+    # Vertex of process 0 is found in process 0 on all processes
+    x = [MPI.max(mesh.mpi_comm(),
+                 mesh.coordinates()[0, i] if rank == 0 else -1.0)
+         for i in range(3)]
+    assert 0 in tree.compute_process_collisions(Point(*x))
+
 #--- compute_entity_collisions with tree ---
 
 @skip_in_parallel
@@ -303,6 +385,27 @@ def test_compute_entity_collisions_tree_3d():
         assert set(entities_A) == references[i][0]
         assert set(entities_B) == references[i][1]
 
+@skip_in_parallel
+@pytest.mark.parametrize("create_mesh", [lambda: UnitSquareMesh(5, 4),
+                                         lambda: UnitCubeMesh(2, 3, 2)])
+def test_compute_entity_collisions_tree_all_pairs(create_mesh):
+    "Compare collisions between trees with all pairs of colliding cells"
+
+    mesh_A = create_mesh()
+    mesh_B = create_mesh()
+    x = mesh_B.coordinates()
+    x[:] = 0.6*x**2 + 0.3
+
+    entities_A, entities_B = \
+        mesh_A.bounding_box_tree().compute_entity_collisions(mesh_B.bounding_box_tree())
+
+    reference = set((cell_A.index(), cell_B.index())
+                    for cell_A in cells(mesh_A) for cell_B in cells(mesh_B)
+                    if cell_A.collides(cell_B))
+    assert len(reference) > 0
+    assert len(entities_A) == len(reference)
+    assert set(zip(entities_A, entities_B)) == reference
+
 #--- compute_first_collision with point ---
 
 @skip_in_parallel
@@ -423,6 +526,22 @@ def test_compute_first_entity_collision_3d():
     first = tree.compute_first_entity_collision(p)
     assert first in reference
 
+@skip_in_parallel
+def test_compute_first_entity_collisions():
+
+    mesh = UnitCubeMesh(8, 8, 8)
+    tree = mesh.bounding_box_tree()
+
+    x = numpy.random.RandomState(0).uniform(-0.1, 1.1, size=(1000, 3))
+    points = [Point(*p) for p in x]
+    reference = [tree.compute_first_entity_collision(p) for p in points]
+    assert tree.compute_first_entity_collisions(points) == reference
+    assert (tree.compute_first_entity_collisions(x) == reference).all()
+
+    # Points outside the mesh are marked by the maximum unsigned int
+    not_found = numpy.iinfo(numpy.uint32).max
+    assert (tree.compute_first_entity_collisions(x) == not_found).any()
+
 #--- compute_closest_entity with point ---
 
 @skip_in_parallel
@@ -481,3 +600,35 @@ def test_compute_closest_entity_3d():
     entity, distance = tree.compute_closest_entity(p)
     assert entity == reference[0]
     assert round(distance - reference[1], 7) == 0
+
+@skip_in_parallel
+@pytest.mark.parametrize('mesh', [UnitSquareMesh(6, 5), UnitCubeMesh(3, 2, 3)])
+def test_compute_closest_entities(mesh):
+
+    tree = mesh.bounding_box_tree()
+    gdim = mesh.geometry().dim()
+    x = numpy.random.RandomState(0).uniform(-0.5, 1.5, size=(50, gdim))
+    points = [Point(*p) for p in x]
+
+    for p in points:
+        # Reference: distances to all cells, sorted
+        distance = {c.index(): c.distance(p) for c in cells(mesh)}
+        reference = sorted(distance.values())
+
+        # Entities at (almost) the same distance may come in any order
+        closest = tree.compute_closest_entities(p, 5)
+        assert numpy.allclose([d for (e, d) in closest], reference[:5])
+        assert all(abs(distance[e] - d) < 1e-12 for (e, d) in closest)
+        assert tree.compute_closest_entity(p) == closest[0]
+
+        r = reference[10] + 1e-10
+        within = tree.compute_entities_within_radius(p, r)
+        assert sorted(e for (e, d) in within) \
+            == sorted(e for e in distance if distance[e] <= r)
+
+    # Batched version
+    reference = [tree.compute_closest_entity(p) for p in points]
+    assert tree.compute_closest_entities(points) == reference
+    entities, distances = tree.compute_closest_entities(x)
+    assert (entities == [r[0] for r in reference]).all()
+    assert numpy.allclose(distances, [r[1] for r in reference])
@@ -18,7 +18,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2014-02-16
-# Last changed: 2017-09-21
+# Last changed: 2019-06-18
 
 import pytest
 from dolfin import *
@@ -99,6 +99,30 @@ def test_point_on_small_segment():
     assert cpp.geometry.CollisionPredicates.collides_segment_point_2d(q0, q1, c)
     assert not cpp.geometry.CollisionPredicates.collides_segment_point_2d(q0, q1, d)
 
+@skip_in_parallel
+def test_predicate_statistics():
+    """Test counting of filtered and exact evaluations of orient2d"""
+    cpp.geometry.set_predicate_statistics(True)
+    cpp.geometry.reset_predicate_statistics()
+    q0 = Point(0, 0)
+    q1 = Point(0.3, 0.3)
+
+    # Sign is decided by the floating-point filter
+    assert not cpp.geometry.CollisionPredicates.collides_segment_point_2d(q0, q1, Point(0.1, 0.5))
+    stats = cpp.geometry.predicate_statistics()
+    assert stats["orient2d"] > 0
+    assert stats["orient2d_exact"] == 0
+
+    # Collinear points need exact arithmetic
+    assert cpp.geometry.CollisionPredicates.collides_segment_point_2d(q0, q1, Point(0.1, 0.1))
+    stats = cpp.geometry.predicate_statistics()
+    assert stats["orient2d_exact"] > 0
+    assert stats["orient2d_exact"] <= stats["orient2d"]
+
+    cpp.geometry.set_predicate_statistics(False)
+    cpp.geometry.reset_predicate_statistics()
+    assert cpp.geometry.predicate_statistics()["orient2d"] == 0
+
 @skip_in_parallel
 def test_segment_collides_point_3D():
     """Test if segment collide with point in 3D"""
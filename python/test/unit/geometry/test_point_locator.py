@@ -0,0 +1,52 @@
+"""Unit tests for PointLocator"""
+
+# Copyright (C) 2019
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import numpy
+
+from dolfin import PointLocator
+from dolfin import UnitSquareMesh, FunctionSpace, Expression, interpolate
+from dolfin import Point, MPI
+
+
+def test_point_locator_evaluate():
+    mesh = UnitSquareMesh(MPI.comm_world, 8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = interpolate(Expression("x[0] + 2*x[1]", degree=1), V)
+
+    # Different points on each process, the last one outside the mesh
+    rank = MPI.rank(mesh.mpi_comm())
+    points = [Point(0.1*i, 0.05*(rank % 10)) for i in range(11)]
+    points.append(Point(1.5, 0.5))
+    locator = PointLocator(mesh, points)
+    assert locator.size() == len(points)
+
+    # Each point inside the mesh is owned by exactly one process
+    owners = locator.owners()
+    assert all(p >= 0 for p in owners[:-1])
+    assert owners[-1] == -1
+    assert MPI.sum(mesh.mpi_comm(), locator.num_owned()) \
+        == MPI.sum(mesh.mpi_comm(), len(points) - 1)
+
+    # Evaluate repeatedly using the same routing
+    for k in range(2):
+        values = locator.evaluate(u)
+        assert values.shape == (len(points), 1)
+        for p, v in zip(points[:-1], values[:-1]):
+            assert numpy.isclose(v[0], p.x() + 2*p.y())
+        assert numpy.isnan(values[-1][0])
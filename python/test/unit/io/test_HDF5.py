@@ -237,6 +237,70 @@ def test_save_and_read_mesh_3D(tempdir):
     dim = mesh0.topology().dim()
     assert mesh0.num_entities_global(dim) == mesh1.num_entities_global(dim)
 
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_save_and_read_topology_cache(tempdir):
+    filename = os.path.join(tempdir, "topology_cache.h5")
+
+    # Write mesh and computed topology to file
+    mesh0 = UnitCubeMesh(6, 6, 6)
+    mesh0.init(1)
+    mesh0.init(2)
+    mesh0.init(2, 3)
+    with HDF5File(mesh0.mpi_comm(), filename, "w") as f:
+        f.write(mesh0, "/mesh")
+        f.write_topology_cache(mesh0, "/topology")
+
+    # Read mesh and restore topology
+    mesh1 = Mesh()
+    with HDF5File(mesh0.mpi_comm(), filename, "r") as f:
+        f.read(mesh1, "/mesh", False)
+        assert f.read_topology_cache(mesh1, "/topology")
+
+    for d in range(4):
+        assert mesh1.num_entities(d) == mesh0.num_entities(d)
+    assert mesh1.topology()(1, 0)() == mesh0.topology()(1, 0)()
+    assert mesh1.topology()(2, 0)() == mesh0.topology()(2, 0)()
+    assert mesh1.topology()(2, 3)() == mesh0.topology()(2, 3)()
+
+    # Cache is rejected for a different mesh
+    mesh2 = UnitCubeMesh(5, 6, 6)
+    with HDF5File(mesh0.mpi_comm(), filename, "r") as f:
+        assert not f.read_topology_cache(mesh2, "/topology")
+        assert not f.read_topology_cache(mesh2, "/missing")
+    assert mesh2.topology().size(1) == 0
+
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_save_and_read_bounding_box_tree(tempdir):
+    filename = os.path.join(tempdir, "bounding_box_tree.h5")
+
+    mesh0 = UnitCubeMesh(6, 6, 6)
+    tree0 = mesh0.bounding_box_tree()
+    with HDF5File(mesh0.mpi_comm(), filename, "w") as f:
+        f.write(tree0, "/tree")
+
+    # Read tree for same mesh and use it for the mesh
+    mesh1 = UnitCubeMesh(6, 6, 6)
+    tree1 = BoundingBoxTree()
+    with HDF5File(mesh0.mpi_comm(), filename, "r") as f:
+        assert f.read(tree1, "/tree", mesh1)
+    mesh1.set_bounding_box_tree(tree1)
+
+    for p in [Point(0.3, 0.2, 0.7), Point(0.5, 0.5, 0.5), Point(1.1, 0.2, 0.3)]:
+        assert mesh1.bounding_box_tree().compute_entity_collisions(p) \
+            == tree0.compute_entity_collisions(p)
+        assert mesh1.bounding_box_tree().compute_process_collisions(p) \
+            == tree0.compute_process_collisions(p)
+        assert mesh1.bounding_box_tree().compute_closest_entity(p) \
+            == tree0.compute_closest_entity(p)
+
+    # Tree is rejected for a different mesh
+    mesh2 = UnitCubeMesh(5, 6, 6)
+    with HDF5File(mesh0.mpi_comm(), filename, "r") as f:
+        assert not f.read(BoundingBoxTree(), "/tree", mesh2)
+        assert not f.read(BoundingBoxTree(), "/missing", mesh1)
+
 @skip_if_not_HDF5
 @xfail_with_serial_hdf5_in_parallel
 def test_mpi_atomicity(tempdir):
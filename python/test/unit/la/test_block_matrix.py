@@ -0,0 +1,90 @@
+"Unit tests for BlockMatrix"
+
+# Copyright (C) 2019
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+import numpy as np
+from dolfin import *
+from dolfin_utils.test import *
+
+
+@fixture
+def blocks():
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "CG", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    forms = [[u*v*dx, inner(grad(u), grad(v))*dx],
+             [u.dx(0)*v*dx, 2.0*u*v*dx]]
+    A = BlockMatrix(2, 2)
+    for i in range(2):
+        for j in range(2):
+            A_ij = EigenMatrix()
+            assemble(forms[i][j], tensor=A_ij)
+            A[i, j] = A_ij
+    return A
+
+
+@skip_in_parallel
+@pytest.mark.parametrize("ordering", [BlockMatrix.Ordering.field_split,
+                                      BlockMatrix.Ordering.interleaved])
+def test_monolithic(blocks, ordering):
+    A = blocks.monolithic(ordering)
+    n = blocks[0, 0].size(0)
+    assert A.size(0) == 2*n and A.size(1) == 2*n
+
+    views = EigenBlockView.split(A, [n, n], [n, n], ordering)
+    for i in range(2):
+        for j in range(2):
+            B = blocks[i, j].array()
+            view = views[i][j]
+            assert view.size(0) == n and view.size(1) == n
+            assert view.nnz() == sum(len(blocks[i, j].getrow(k)[0])
+                                     for k in range(n))
+            for k in range(n):
+                cols, vals = view.getrow(k)
+                row = np.zeros(n)
+                row[cols] = vals
+                assert np.allclose(row, B[k])
+
+            # Product with view matches product with block
+            x = EigenVector(MPI.comm_self, n)
+            x[:] = np.arange(n, dtype=np.float_)
+            y0, y1 = EigenVector(), EigenVector()
+            blocks[i, j].mult(x, y0)
+            view.mult(x, y1)
+            assert np.allclose(y0.get_local(), y1.get_local())
+
+
+@skip_in_parallel
+def test_mult(blocks):
+    n = blocks[0, 0].size(0)
+    x = BlockVector(2)
+    y = BlockVector(2)
+    for i in range(2):
+        x[i] = EigenVector(MPI.comm_self, n)
+        x[i][:] = np.arange(n, dtype=np.float_) + i
+        y[i] = EigenVector(MPI.comm_self, n)
+    blocks.mult(x, y)
+
+    A = blocks.monolithic()
+    xm = EigenVector(MPI.comm_self, 2*n)
+    xm[:] = np.concatenate([x[0].get_local(), x[1].get_local()])
+    ym = EigenVector()
+    A.mult(xm, ym)
+    assert np.allclose(ym.get_local(),
+                       np.concatenate([y[0].get_local(), y[1].get_local()]))
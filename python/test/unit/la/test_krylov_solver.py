@@ -250,3 +250,67 @@ def test_krylov_tpetra():
 
     # Number of iterations should be around 15
     assert n_iter < 50
+
+
+@pytest.mark.parametrize('backend', ["PETSc",
+                                     pytest.param(("Eigen"),
+                                                  marks=skip_in_parallel)])
+def test_krylov_solver_multiple(backend, pushpop_parameters):
+    """Test (block) CG with multiple right-hand sides against single
+    solves"""
+
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    A = assemble(u*v*dx + inner(grad(u), grad(v))*dx)
+    b = [assemble(Expression("sin(k*x[0])*x[1]", k=k, degree=2)*v*dx)
+         for k in range(1, 5)]
+
+    solver = KrylovSolver(A, "cg")
+    solver.parameters["relative_tolerance"] = 1.0e-12
+    x = [Vector() for i in range(len(b))]
+    solver.solve_multiple(x, b)
+
+    for xi, bi in zip(x, b):
+        y = Vector()
+        LUSolver(A).solve(y, bi)
+        assert round((xi - y).norm("l2")/y.norm("l2"), 8) == 0
+
+
+@pytest.mark.parametrize('backend', ["PETSc",
+                                     pytest.param(("Eigen"),
+                                                  marks=skip_in_parallel)])
+def test_krylov_solver_pipelined(backend, pushpop_parameters):
+    """Test pipelined CG against standard CG"""
+
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    A = assemble(u*v*dx + inner(grad(u), grad(v))*dx)
+    b = assemble(Expression("sin(x[0])*x[1]", degree=2)*v*dx)
+
+    y = Vector()
+    solver = KrylovSolver(A, "cg", "jacobi")
+    solver.parameters["relative_tolerance"] = 1.0e-12
+    solver.solve(y, b)
+
+    x = Vector()
+    solver = KrylovSolver(A, "cg", "jacobi")
+    solver.parameters["relative_tolerance"] = 1.0e-12
+    solver.parameters["pipelined"] = True
+    solver.solve(x, b)
+    assert round((x - y).norm("l2")/y.norm("l2"), 8) == 0
+
+    x = Vector()
+    solver = KrylovSolver(A, "pipecg", "jacobi")
+    solver.parameters["relative_tolerance"] = 1.0e-12
+    solver.solve(x, b)
+    assert round((x - y).norm("l2")/y.norm("l2"), 8) == 0
@@ -117,3 +117,33 @@ def test_lu_solver_reuse(backend):
 
     # Reset backend
     parameters["linear_algebra_backend"] = prev_backend
+
+
+@pytest.mark.parametrize('backend', backends)
+def test_lu_solver_multiple(backend):
+    """Test solve with multiple right-hand sides against single
+    solves"""
+
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+
+    prev_backend = parameters["linear_algebra_backend"]
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(12, 12)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    A = assemble(u*v*dx + inner(grad(u), grad(v))*dx)
+    b = [assemble(Expression("sin(k*x[0])*x[1]", k=k, degree=2)*v*dx)
+         for k in range(1, 5)]
+
+    solver = LUSolver(A)
+    x = [Vector() for i in range(len(b))]
+    solver.solve_multiple(x, b)
+
+    for xi, bi in zip(x, b):
+        y = Vector()
+        LUSolver(A).solve(y, bi)
+        assert round((xi - y).norm("l2"), 10) == 0
+
+    parameters["linear_algebra_backend"] = prev_backend
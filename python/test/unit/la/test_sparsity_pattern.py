@@ -164,3 +164,32 @@ def test_insert_local_global(mesh, V):
             assert nnz_d[local_row] == (nnz_on_diagonal if local_row in primary_dim_local_entries else 0)
         else:
             assert nnz_od[local_row] == (nnz_off_diagonal if local_row in primary_dim_local_entries else 0)
+
+
+def test_compact_storage(mesh, V):
+    dm = V.dofmap()
+    index_map = dm.index_map()
+
+    def build_pattern():
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity.SPARSE)
+        tl.init([index_map, index_map], TensorLayout.Ghosts.UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        sp.init([index_map, index_map])
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, True, False, False,
+                                     False, init=True, finalize=True)
+        return sp
+
+    prev_storage = parameters["sparsity_pattern_storage"]
+    parameters["sparsity_pattern_storage"] = "set"
+    sp_set = build_pattern()
+    parameters["sparsity_pattern_storage"] = "compact"
+    sp_compact = build_pattern()
+    parameters["sparsity_pattern_storage"] = prev_storage
+
+    assert sp_set.num_nonzeros() == sp_compact.num_nonzeros()
+    assert np.array_equal(sp_set.num_nonzeros_diagonal(),
+                          sp_compact.num_nonzeros_diagonal())
+    assert np.array_equal(sp_set.num_nonzeros_off_diagonal(),
+                          sp_compact.num_nonzeros_off_diagonal())
+    assert sp_set.str(True) == sp_compact.str(True)
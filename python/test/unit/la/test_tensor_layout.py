@@ -103,3 +103,32 @@ def test_layout_and_pattern_interface(backend, mesh, element):
     bc.apply(A)
     bc.apply(b)
     solve(A, x, b)
+
+
+@skip_in_serial
+def test_eigen_ghosted_vector(mesh):
+    V = FunctionSpace(mesh, "P", 1)
+    c = mesh.mpi_comm()
+    i = V.dofmap().index_map()
+
+    t = TensorLayout(c, 0, TensorLayout.Sparsity.DENSE)
+    t.init([i], TensorLayout.Ghosts.GHOSTED)
+    x = EigenVector(c)
+    x.init(t)
+    assert x.num_ghosts() == i.size(IndexMap.MapSize.UNOWNED)
+
+    # Set owned entries to their global index and update ghosts
+    r0, r1 = x.local_range()
+    x.set_local(np.arange(r0, r1, dtype=np.float64))
+    x.apply("insert")
+    n_owned = r1 - r0
+    ghosts = x.get_local(list(range(n_owned, n_owned + x.num_ghosts())))
+    assert (ghosts == i.local_to_global_unowned()).all()
+
+    # Insert into ghost entries and check that the values are sent
+    # to the owners and back to all ghosting processes
+    x.zero()
+    ghost_rows = np.arange(n_owned, n_owned + x.num_ghosts())
+    x[ghost_rows] = 1.0
+    assert (x.get_local(list(ghost_rows)) == 1.0).all()
+    assert x.sum() > 0.0
@@ -20,7 +20,7 @@
 # Modified by Oeyvind Evju 2013
 #
 # First added:  2011-10-09
-# Last changed: 2013-10-11
+# Last changed: 2019-06-18
 
 import pytest
 import numpy
@@ -55,3 +55,36 @@ def test_3D_mesh():
     assert MPI.sum(mesh.mpi_comm(), bmesh1.num_cells()) == 6*8*8*2
     assert bmesh1.num_entities_global(2) == 6*8*8*2
     assert bmesh1.topology().dim() == 2
+
+
+def test_vertex_order():
+    mesh = UnitSquareMesh(8, 8)
+    bmesh = BoundaryMesh(mesh, "exterior")
+
+    # Boundary vertices are numbered in the order of the mesh vertices
+    vertex_map = bmesh.entity_map(0).array()
+    assert (numpy.diff(vertex_map) > 0).all()
+
+
+def test_update_coordinates():
+    mesh = UnitCubeMesh(4, 4, 4)
+    bmesh = BoundaryMesh(mesh, "exterior")
+    vertex_map = bmesh.entity_map(0).array()
+
+    # Move mesh and update boundary mesh coordinates
+    mesh.coordinates()[:] *= 2.0
+    bmesh.update_coordinates(mesh)
+    assert numpy.allclose(bmesh.coordinates(),
+                          mesh.coordinates()[vertex_map])
+
+    # Boundary mesh of another mesh is rejected
+    with pytest.raises(RuntimeError):
+        bmesh.update_coordinates(UnitSquareMesh(2, 2))
+
+
+def test_update_coordinates_other_mesh():
+    # Boundary mesh of a mesh of the same type but with fewer vertices
+    mesh = UnitCubeMesh(MPI.comm_self, 4, 4, 4)
+    bmesh = BoundaryMesh(mesh, "exterior")
+    with pytest.raises(RuntimeError):
+        bmesh.update_coordinates(UnitCubeMesh(MPI.comm_self, 1, 1, 1))
@@ -756,3 +756,90 @@ def test_mesh_connectivity_lifetime():
     assert sys.getrefcount(conn) == rc + 1
     del cells
     assert sys.getrefcount(conn) == rc
+
+
+def test_mesh_connectivity_compression():
+    """Check that compressed connectivity round trips"""
+    mesh = UnitCubeMesh(4, 4, 4)
+    mesh.init(0, 3)
+    connectivity = mesh.topology()(0, 3)
+    assert not connectivity.fixed_stride()
+    assert mesh.topology()(3, 0).fixed_stride()
+
+    cells = [connectivity(v).copy() for v in range(mesh.num_vertices())]
+    size, h = connectivity.size(), connectivity.hash()
+    connectivity.compress()
+    assert connectivity.compressed()
+    assert connectivity.size() == size
+    assert connectivity.hash() == h
+    assert connectivity.size(0) == len(cells[0])
+    with pytest.raises(RuntimeError):
+        connectivity(0)
+    with pytest.raises(RuntimeError):
+        connectivity()
+
+    connectivity.decompress()
+    assert not connectivity.compressed()
+    for v in range(mesh.num_vertices()):
+        assert (connectivity(v) == cells[v]).all()
+
+    # Mesh.init restores raw access to compressed connectivity
+    connectivity.compress()
+    mesh.init(0, 3)
+    assert not connectivity.compressed()
+    assert connectivity.hash() == h
+
+
+def test_mesh_memory_usage():
+    """Check memory usage accounting and release of derived data"""
+    mesh = UnitCubeMesh(4, 4, 4)
+    before = mesh.memory_usage()
+    assert before > 0
+    mesh.init(1)
+    assert mesh.memory_usage() > before
+    assert mesh.topology().memory_usage() < mesh.memory_usage()
+
+    table = mesh.memory_usage_table()
+    assert table.get_value("total", "bytes") == mesh.memory_usage()
+
+    num_edges = mesh.num_entities(1)
+    assert mesh.release_derived_data() > 0
+    assert mesh.memory_usage() <= before
+    mesh.init(1)
+    assert mesh.num_entities(1) == num_edges
+
+
+def test_single_precision_geometry():
+    """Check that single precision coordinates follow the mesh and are
+    used by the bounding box tree"""
+    mesh = UnitCubeMesh(4, 4, 4)
+    geometry = mesh.geometry()
+    assert not geometry.has_single_precision()
+    with pytest.raises(RuntimeError):
+        geometry.x_single()
+
+    bytes = geometry.memory_usage()
+    geometry.init_single_precision()
+    assert geometry.has_single_precision()
+    assert geometry.memory_usage() > bytes
+    x = geometry.x_single()
+    assert x.dtype == numpy.float32
+    assert numpy.allclose(x, mesh.coordinates())
+
+    # Copy is updated when mesh moves
+    mesh.translate(Point(0.1, 0.2, 0.3))
+    assert numpy.allclose(geometry.x_single(), mesh.coordinates())
+    mesh.coordinates()[:] *= 2.0
+    geometry.update_single_precision()
+    assert numpy.allclose(geometry.x_single(), mesh.coordinates())
+
+    # Boxes built from single precision coordinates contain all cells
+    tree = BoundingBoxTree()
+    tree.build(mesh)
+    for v in vertices(mesh):
+        cell = tree.compute_first_entity_collision(v.point())
+        assert cell < mesh.num_cells()
+
+    geometry.init_single_precision(False)
+    assert not geometry.has_single_precision()
+
@@ -18,8 +18,9 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 #
 # First added:  2006-08-08
-# Last changed: 2014-02-06
+# Last changed: 2019-06-18
 
+import pytest
 from dolfin import *
 import numpy
 
@@ -44,3 +45,49 @@ def test_triangle_mesh():
 
     # Close editor
     editor.close()
+
+
+def test_bulk_triangle_mesh():
+
+    # Build mesh from arrays of coordinates and cells
+    reference = UnitSquareMesh(MPI.comm_self, 4, 4)
+    mesh = Mesh(MPI.comm_self)
+    editor = MeshEditor()
+    editor.open(mesh, "triangle", 2, 2)
+    editor.set_vertices(reference.coordinates())
+    editor.set_cells(reference.cells().astype('uint'))
+    editor.close()
+
+    assert mesh.num_vertices() == reference.num_vertices()
+    assert mesh.num_cells() == reference.num_cells()
+    assert numpy.allclose(mesh.coordinates(), reference.coordinates())
+    assert (mesh.cells() == reference.cells()).all()
+    assert round(sum(c.volume() for c in cells(mesh)) - 1.0, 7) == 0
+
+
+def test_bulk_validation():
+
+    mesh = Mesh(MPI.comm_self)
+    editor = MeshEditor()
+    editor.open(mesh, "triangle", 2, 2)
+    x = numpy.array([[0.0, 0.0], [1.0, 0.0], [0.0, 1.0]])
+
+    # Coordinates must be finite
+    x[1, 1] = numpy.nan
+    with pytest.raises(RuntimeError):
+        editor.set_vertices(x)
+    x[1, 1] = 0.0
+    editor.set_vertices(x)
+
+    # Vertex indices must be in range
+    with pytest.raises(RuntimeError):
+        editor.set_cells(numpy.array([[0, 1, 3]], dtype='uint'))
+    editor.set_cells(numpy.array([[0, 1, 2]], dtype='uint'))
+    editor.close()
+    assert mesh.num_cells() == 1
+
+    # Bulk vertices are only supported for affine geometry
+    mesh = Mesh(MPI.comm_self)
+    editor.open(mesh, "triangle", 2, 2, 2)
+    with pytest.raises(RuntimeError):
+        editor.set_vertices(x)
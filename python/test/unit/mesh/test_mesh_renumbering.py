@@ -0,0 +1,100 @@
+"Unit tests for the MeshRenumbering class"
+
+# Copyright (C) 2019
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+import numpy
+from dolfin import *
+from dolfin_utils.test import skip_in_parallel, pushpop_parameters
+
+
+def test_space_filling_curve_order():
+    # Points on a 4 x 4 grid
+    x = [[i, j] for j in range(4) for i in range(4)]
+    x = numpy.array(x, dtype=float).flatten()
+
+    # Hilbert curve visits grid points along unit steps
+    order = MeshRenumbering.compute_space_filling_curve_order(x, 2, "hilbert")
+    assert sorted(order) == list(range(16))
+    p = x.reshape(-1, 2)[order]
+    assert numpy.allclose(numpy.abs(numpy.diff(p, axis=0)).sum(axis=1), 1.0)
+
+    # Morton curve visits each 2 x 2 block in turn
+    order = MeshRenumbering.compute_space_filling_curve_order(x, 2, "morton")
+    assert sorted(order[:4]) == [0, 1, 4, 5]
+
+    with pytest.raises(RuntimeError):
+        MeshRenumbering.compute_space_filling_curve_order(x, 2, "peano")
+
+
+@pytest.mark.parametrize('curve', ['hilbert', 'morton'])
+def test_renumber_by_space_filling_curve(curve):
+    mesh = UnitCubeMesh(6, 6, 6)
+    new_mesh = MeshRenumbering.renumber_by_space_filling_curve(mesh, curve)
+    assert new_mesh.num_cells() == mesh.num_cells()
+    assert new_mesh.num_vertices() == mesh.num_vertices()
+    assert new_mesh.ghost_mode() == mesh.ghost_mode()
+
+    # Same set of cells
+    def cell_midpoints(m):
+        mp = [tuple(numpy.round(c.midpoint()[:], 8)) for c in cells(m)]
+        return sorted(mp)
+    assert cell_midpoints(new_mesh) == cell_midpoints(mesh)
+
+    # Same volume, and owned vertices/cells stay owned
+    comm = mesh.mpi_comm()
+    vol = sum(c.volume() for c in cells(mesh) if not c.is_ghost())
+    new_vol = sum(c.volume() for c in cells(new_mesh) if not c.is_ghost())
+    assert round(MPI.sum(comm, new_vol) - MPI.sum(comm, vol), 10) == 0
+    tdim = mesh.topology().dim()
+    for d in (0, tdim):
+        assert new_mesh.topology().ghost_offset(d) \
+            == mesh.topology().ghost_offset(d)
+
+
+@skip_in_parallel
+def test_renumber_improves_locality():
+    mesh = UnitSquareMesh(16, 16)
+
+    # Shuffle cells and vertices
+    numpy.random.seed(1)
+    cell_order = numpy.random.permutation(mesh.num_cells())
+    vertex_order = numpy.random.permutation(mesh.num_vertices())
+    shuffled = MeshRenumbering.renumber(mesh, cell_order, vertex_order)
+
+    # Mean vertex index spread within cells
+    def spread(m):
+        v = m.cells()
+        return numpy.mean(v.max(axis=1) - v.min(axis=1))
+
+    new_mesh = MeshRenumbering.renumber_by_space_filling_curve(shuffled)
+    assert spread(new_mesh) < 0.1*spread(shuffled)
+
+
+def test_reorder_space_filling_curve_on_build(pushpop_parameters):
+    for mode in ["none", "shared_facet", "shared_vertex"]:
+        parameters["ghost_mode"] = mode
+        parameters["reorder_cells_sfc"] = True
+        parameters["reorder_vertices_sfc"] = True
+        mesh = UnitSquareMesh(8, 8)
+        assert MPI.sum(mesh.mpi_comm(),
+                       mesh.topology().ghost_offset(2)) == 128
+        mesh.init(1)
+        assert MPI.sum(mesh.mpi_comm(), sum(c.volume() for c in cells(mesh)
+                                            if not c.is_ghost())) \
+            == pytest.approx(1.0)
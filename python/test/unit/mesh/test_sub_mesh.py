@@ -112,3 +112,110 @@ def test_facet_domain_propagation(datadir):
                 (outer_facets.array() == value).sum())
         assert ((parent_facets.array() == value).sum() ==
                 (outer_facets.array() == value).sum())
+
+
+def test_parent_entity_maps():
+    """Check that entities computed for the parent mesh are extracted
+    with the sub mesh and mapped to the parent entities."""
+    mesh = UnitCubeMesh(6, 6, 6)
+    mesh.init(1)
+    mesh.init(2)
+    domains = MeshFunction("size_t", mesh, 3, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(domains, 1)
+    submesh = SubMesh(mesh, domains, 1)
+
+    for d in range(4):
+        assert submesh.topology().size(d) > 0
+        parent_entities = submesh.parent_entity_indices(d)
+        parent_vertices = submesh.parent_entity_indices(0)
+        assert len(parent_entities) == submesh.num_entities(d)
+        for e in entities(submesh, d):
+            p = MeshEntity(mesh, d, parent_entities[e.index()])
+            assert [parent_vertices[v] for v in e.entities(0)] == \
+                list(p.entities(0))
+
+    # Global number of entities matches a serial sub mesh
+    serial_mesh = UnitCubeMesh(MPI.comm_self, 6, 6, 6)
+    serial_domains = MeshFunction("size_t", serial_mesh, 3, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(serial_domains, 1)
+    serial_submesh = SubMesh(serial_mesh, serial_domains, 1)
+    for d in range(4):
+        serial_submesh.init(d)
+        submesh.init_global(d)
+        assert submesh.num_entities_global(d) == \
+            serial_submesh.num_entities(d)
+
+
+@skip_in_parallel
+def test_unordered_parent_facet_markers():
+    """Map facet markers of a parent mesh which is not ordered, so
+    facets are computed for the sub mesh instead of being extracted."""
+    mesh = UnitSquareMesh(4, 4)
+    mesh.init(1)
+    mesh.domains().init(2)
+    for f in range(mesh.num_facets()):
+        mesh.domains().set_marker((f, f), 1)
+
+    # Reverse global vertex numbering, so cells are no longer ordered
+    num_vertices = mesh.num_vertices()
+    for v in range(num_vertices):
+        mesh.topology().set_global_index(0, v, num_vertices - 1 - v)
+
+    domains = MeshFunction("size_t", mesh, 2, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(domains, 1)
+    submesh = SubMesh(mesh, domains, 1)
+    assert submesh.ordered()
+
+    markers = submesh.domains().markers(1)
+    assert len(markers) == submesh.num_facets()
+    parent_facets = submesh.parent_entity_indices(1)
+    parent_vertices = submesh.parent_entity_indices(0)
+    for f, value in markers.items():
+        assert parent_facets[f] == value
+        p = MeshEntity(mesh, 1, value)
+        e = MeshEntity(submesh, 1, f)
+        assert sorted(parent_vertices[v] for v in e.entities(0)) == \
+            sorted(p.entities(0))
+
+
+def test_update():
+    """Rebuild SubMesh from changed markers."""
+    mesh = UnitSquareMesh(8, 8)
+    domains = MeshFunction("size_t", mesh, 2, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(domains, 1)
+    submesh = SubMesh(mesh, domains, 1)
+    num_cells = submesh.num_entities_global(2)
+    assert not submesh.update(mesh, domains, 1)
+    assert submesh.num_entities_global(2) == num_cells
+
+    CompiledSubDomain("x[0] < 0.75 + DOLFIN_EPS").mark(domains, 1)
+    assert submesh.update(mesh, domains, 1)
+    assert submesh.num_entities_global(2) == SubMesh(mesh, domains, 1).num_entities_global(2)
+    assert submesh.num_entities_global(2) > num_cells
+    assert len(submesh.data().array("parent_cell_indices", 2)) == \
+        submesh.num_cells()
+
+
+def test_update_same_as_new():
+    """Updated SubMesh matches a SubMesh built from the same markers."""
+    mesh = UnitCubeMesh(4, 4, 4)
+    mesh.init(1)
+    mesh.init(2)
+    domains = MeshFunction("size_t", mesh, 3, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(domains, 1)
+    submesh = SubMesh(mesh, domains, 1)
+
+    CompiledSubDomain("x[1] < 0.25 + DOLFIN_EPS").mark(domains, 0)
+    CompiledSubDomain("x[2] > 0.75 - DOLFIN_EPS").mark(domains, 1)
+    assert submesh.update(mesh, domains, 1)
+    new_submesh = SubMesh(mesh, domains, 1)
+    assert submesh.ordered()
+    for d in range(4):
+        assert submesh.num_entities(d) == new_submesh.num_entities(d)
+    for name, d in (("parent_vertex_indices", 0),
+                    ("parent_entity_indices", 1),
+                    ("parent_entity_indices", 2),
+                    ("parent_cell_indices", 3)):
+        assert (submesh.data().array(name, d)
+                == new_submesh.data().array(name, d)).all()
+    assert (submesh.coordinates() == new_submesh.coordinates()).all()
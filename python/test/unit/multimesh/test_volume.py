@@ -21,7 +21,7 @@
 # Modified by Simon Funke 2017
 #
 # First added:  2016-05-03
-# Last changed: 2017-05-25
+# Last changed: 2019-06-18
 
 import pytest
 
@@ -200,3 +200,39 @@ def test_volume_2d_six_meshes():
     print("approximative volume ", approximate_volume)
     print("approximate volume error %1.16e" % (exact_volume - approximate_volume))
     assert abs(exact_volume - approximate_volume) < DOLFIN_EPS_LARGE
+
+@skip_in_parallel
+def test_volume_2d_update():
+    "Update multimesh after moving a part and compare to rebuild"
+
+    def create_meshes(offset):
+        mesh_0 = UnitSquareMesh(8, 8)
+        mesh_1 = RectangleMesh(Point(0.2, 0.2), Point(0.6, 0.6), 4, 4)
+        mesh_1.rotate(15.0)
+        mesh_2 = RectangleMesh(Point(0.4, 0.3), Point(0.8, 0.7), 4, 4)
+        mesh_2.translate(Point(offset, 0.0))
+        return [mesh_0, mesh_1, mesh_2]
+
+    # Build multimesh and move top part in a few steps
+    meshes = create_meshes(0.0)
+    multimesh = MultiMesh()
+    for mesh in meshes:
+        multimesh.add(mesh)
+    multimesh.build()
+    for step in range(1, 4):
+        meshes[2].translate(Point(-0.05, 0.0))
+        multimesh.update(2)
+
+        # Rebuild from scratch and compare
+        reference = MultiMesh()
+        for mesh in create_meshes(-0.05*step):
+            reference.add(mesh)
+        reference.build()
+
+        for part in range(multimesh.num_parts()):
+            assert multimesh.cut_cells(part) == reference.cut_cells(part)
+            assert multimesh.uncut_cells(part) == reference.uncut_cells(part)
+            assert multimesh.covered_cells(part) == reference.covered_cells(part)
+        assert abs(multimesh.compute_volume() - 1.0) < DOLFIN_EPS_LARGE
+        assert abs(multimesh.compute_area() - reference.compute_area()) \
+            < DOLFIN_EPS_LARGE
@@ -0,0 +1,130 @@
+// Copyright (C) 2019
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Unit tests for simplex quadrature
+
+#include <dolfin/geometry/SimplexQuadrature.h>
+#include <catch.hpp>
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+TEST_CASE("Simplex quadrature test")
+{
+  SECTION("batch of triangles")
+  {
+    const std::vector<std::vector<Point>> triangles
+      = {{Point(0., 0.), Point(1., 0.), Point(0., 1.)},
+         {Point(0.3, 0.1), Point(0.2, 0.9), Point(1.5, 0.4)},
+         {Point(-1., 2.), Point(0.5, 2.5), Point(0., 4.)}};
+    const std::size_t gdim = 2;
+
+    const SimplexQuadrature sq(2, 3);
+    const std::size_t n = sq.size();
+
+    std::vector<double> x;
+    for (const std::vector<Point>& t : triangles)
+      for (const Point& p : t)
+        x.insert(x.end(), p.coordinates(), p.coordinates() + gdim);
+    std::vector<double> points(triangles.size()*n*gdim);
+    std::vector<double> weights(triangles.size()*n);
+    sq.compute_quadrature_rules(x.data(), triangles.size(), gdim,
+                                points.data(), weights.data(), -2.0);
+
+    for (std::size_t s = 0; s < triangles.size(); ++s)
+    {
+      // Compare to quadrature rule of single triangle
+      const auto qr = sq.compute_quadrature_rule(triangles[s], gdim);
+      REQUIRE(qr.second.size() == n);
+      double area = 0.0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        CHECK(weights[s*n + i] == -2.0*qr.second[i]);
+        for (std::size_t d = 0; d < gdim; ++d)
+          CHECK(points[(s*n + i)*gdim + d] == qr.first[i*gdim + d]);
+        area += qr.second[i];
+      }
+
+      // Check that weights sum to area
+      const Point e0 = triangles[s][1] - triangles[s][0];
+      const Point e1 = triangles[s][2] - triangles[s][0];
+      CHECK(area == Approx(0.5*std::abs(e0.cross(e1)[2])));
+    }
+  }
+
+  SECTION("reference rules are shared")
+  {
+    const SimplexQuadrature sq0(3, 2);
+    const SimplexQuadrature sq1(3, 2);
+    const std::vector<Point> tet = {Point(0., 0., 0.), Point(1., 0., 0.),
+                                    Point(0., 1., 0.), Point(0., 0., 1.)};
+    const auto qr0 = sq0.compute_quadrature_rule(tet, 3);
+    const auto qr1 = sq1.compute_quadrature_rule(tet, 3);
+    CHECK(qr0 == qr1);
+
+    double volume = 0.0;
+    for (double w : qr0.second)
+      volume += w;
+    CHECK(volume == Approx(1.0/6.0));
+  }
+
+  SECTION("compress rule of many triangles")
+  {
+    const std::size_t order = 2;
+    const SimplexQuadrature sq(2, order);
+
+    // Quadrature rule for union of triangles in unit square
+    std::pair<std::vector<double>, std::vector<double>> qr;
+    const std::size_t m = 20;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      for (std::size_t j = 0; j < m; ++j)
+      {
+        const Point x0(double(i)/m, double(j)/m);
+        const Point x1(double(i + 1)/m, double(j)/m);
+        const Point x2(double(i)/m, double(j + 1)/m);
+        const Point x3(double(i + 1)/m, double(j + 1)/m);
+        for (const auto& t : {std::vector<Point>{x0, x1, x2},
+                              std::vector<Point>{x1, x3, x2}})
+        {
+          const auto q = sq.compute_quadrature_rule(t, 2);
+          qr.first.insert(qr.first.end(), q.first.begin(), q.first.end());
+          qr.second.insert(qr.second.end(), q.second.begin(), q.second.end());
+        }
+      }
+    }
+
+    const std::vector<std::size_t> indices
+      = SimplexQuadrature::compress(qr, 2, order);
+    CHECK(indices.size() == qr.second.size());
+    CHECK(qr.second.size() <= 6);
+
+    // Check that integral of x^a y^b for a + b <= order is exact
+    for (std::size_t a = 0; a <= order; ++a)
+    {
+      for (std::size_t b = 0; a + b <= order; ++b)
+      {
+        double integral = 0.0;
+        for (std::size_t i = 0; i < qr.second.size(); ++i)
+          integral += qr.second[i]*std::pow(qr.first[2*i], a)
+            *std::pow(qr.first[2*i + 1], b);
+        CHECK(integral == Approx(1.0/((a + 1)*(b + 1))));
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
@@ -142,6 +142,50 @@ TEST_CASE("Mesh iterators")
     CHECK(n == 4*mesh.num_cells());
   }
 
+  SECTION("Test connectivity views")
+  {
+    // Compare views with iterators
+    UnitCubeMesh mesh(5, 5, 5);
+    const std::size_t D = mesh.topology().dim();
+    const ConnectivityView cell_vertices(mesh, D, 0);
+    CHECK(cell_vertices.size() == mesh.num_cells());
+    CHECK(cell_vertices.stride() == (std::size_t) 4);
+
+    std::size_t n = 0;
+    bool same = true;
+    for (auto vertices : cell_vertices)
+    {
+      Cell cell(mesh, n++);
+      same = same && std::equal(vertices.begin(), vertices.end(),
+                                cell.entities(0));
+    }
+    CHECK(n == mesh.num_cells());
+    CHECK(same);
+
+    const ConnectivityView facet_cells(mesh, D - 1, D);
+    n = 0;
+    for (FacetIterator f(mesh); !f.end(); ++f)
+      n += (facet_cells[f->index()].size() == f->num_entities(D));
+    CHECK(n == mesh.num_facets());
+  }
+
+  SECTION("Test coordinate views")
+  {
+    // Compare midpoints and vertex coordinates with cells
+    UnitSquareMesh mesh(4, 3);
+    const EntityCoordinatesView cells(mesh, 2);
+    std::vector<double> x0, x1;
+    bool same = true;
+    for (CellIterator c(mesh); !c.end(); ++c)
+    {
+      cells.get(c->index(), x0);
+      c->get_vertex_coordinates(x1);
+      same = same && x0 == x1
+        && cells.midpoint(c->index()).distance(c->midpoint()) < DOLFIN_EPS;
+    }
+    CHECK(same);
+  }
+
   SECTION("Test boundary computation")
   {
     // Compute boundary of mesh